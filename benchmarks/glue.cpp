@@ -0,0 +1,74 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+/* Headless glue
+giada-benchmark links the core only, with no UI. The core calls into the glue
+layer in two places: channel creation (to install the UI callbacks) and MIDI
+learn dispatching. Neither needs to do anything here: there's no UI to notify
+and no MIDI device to learn from. */
+
+#include "glue/channel.h"
+#include "glue/main.h"
+#include "glue/plugin.h"
+
+namespace giada::c::channel
+{
+void setCallbacks(m::Channel&) {}
+
+void  pressChannel(ID, int, Thread, Frame) {}
+void  releaseChannel(ID, Thread, Frame) {}
+void  killChannel(ID, Thread, Frame) {}
+float setChannelVolume(ID, float v, Thread, bool) { return v; }
+float setChannelPitch(ID, float v, Thread) { return v; }
+void  toggleMuteChannel(ID, Thread) {}
+void  toggleSoloChannel(ID, Thread) {}
+void  toggleArmChannel(ID, Thread) {}
+void  toggleReadActionsChannel(ID, Thread) {}
+void  sendMidiToChannel(ID, m::MidiEvent, Thread) {}
+} // namespace giada::c::channel
+
+/* -------------------------------------------------------------------------- */
+
+namespace giada::c::main
+{
+void toggleMetronome() {}
+void setMasterInVolume(float, Thread) {}
+void setMasterOutVolume(float, Thread) {}
+void multiplyBeats() {}
+void divideBeats() {}
+void toggleSequencer() {}
+void rewindSequencer() {}
+void toggleActionRecording() {}
+void toggleInputRecording() {}
+} // namespace giada::c::main
+
+/* -------------------------------------------------------------------------- */
+
+namespace giada::c::plugin
+{
+void setParameter(ID, ID, int, float, Thread) {}
+} // namespace giada::c::plugin
@@ -0,0 +1,440 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+/* giada-benchmark
+Headless benchmark of the rendering engine. Builds a set of synthetic patches
+(sample, pitched, MIDI and action-driven channels) on an Engine with no audio 
+or MIDI device, drives the render path for many blocks and reports as JSON the
+block time percentiles, the throughput and the process-wide memory allocations
+per block, so that results can be diffed between releases.
+
+With --profile the per-stage and per-channel timings collected by the engine
+profiler are added to each scenario.
+
+Usage: giada-benchmark [--blocks N] [--sample-rate N] [--buffer-size N]
+                       [--render-threads N] [--output path] [--profile] */
+
+#include "core/conf.h"
+#include "core/const.h"
+#include "core/dsp.h"
+#include "core/engine.h"
+#include "core/waveFactory.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+giada::m::Engine g_engine;
+
+/* -------------------------------------------------------------------------- */
+
+/* Count all memory allocations, process-wide: there's no cheap way to tell 
+render pool threads apart from the others here. The render path is expected 
+not to allocate at all, and in headless mode nothing else runs while a block 
+is being rendered, so any allocation counted is still worth a look. */
+
+namespace
+{
+std::atomic<std::size_t> allocations_ = 0;
+} // namespace
+
+void* operator new(std::size_t size)
+{
+	allocations_.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size == 0 ? 1 : size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+/* -------------------------------------------------------------------------- */
+
+namespace
+{
+using namespace giada;
+using namespace giada::m;
+
+constexpr ID    COLUMN_ID      = 1;
+constexpr float BPM            = 120.0f;
+constexpr int   BEATS          = 4;
+constexpr int   BARS           = 1;
+constexpr float PITCH          = 1.37f;
+constexpr float SAMPLE_SECONDS = 2.0f;
+
+struct Options_
+{
+	int         blocks        = 20000;
+	int         sampleRate    = G_DEFAULT_SAMPLERATE;
+	int         bufferSize    = G_DEFAULT_BUFSIZE;
+	int         renderThreads = 0;
+	std::string output        = "";
+	bool        profile       = false;
+};
+
+/* Scenario_
+A synthetic patch. Sample and pitched channels play loops, action channels
+are retriggered by 'actionsPerLoop' recorded actions, MIDI channels play as many
+notes per loop. */
+
+struct Scenario_
+{
+	std::string name;
+	int         sampleChannels  = 0;
+	int         pitchedChannels = 0;
+	int         actionChannels  = 0;
+	int         midiChannels    = 0;
+	int         actionsPerLoop  = 0;
+};
+
+struct Result_
+{
+	double      p50            = 0.0; // Microseconds
+	double      p99            = 0.0;
+	double      max            = 0.0;
+	double      mean           = 0.0;
+	double      realtimeFactor = 0.0;
+	double      allocsPerBlock = 0.0; // Process-wide
+	std::size_t maxAllocs      = 0;
+};
+
+/* -------------------------------------------------------------------------- */
+
+bool parseOptions_(int argc, char** argv, Options_& o)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+		if (hasValue && strcmp(argv[i], "--blocks") == 0)
+			o.blocks = std::atoi(argv[++i]);
+		else if (hasValue && strcmp(argv[i], "--sample-rate") == 0)
+			o.sampleRate = std::atoi(argv[++i]);
+		else if (hasValue && strcmp(argv[i], "--buffer-size") == 0)
+			o.bufferSize = std::atoi(argv[++i]);
+		else if (hasValue && strcmp(argv[i], "--render-threads") == 0)
+			o.renderThreads = std::atoi(argv[++i]);
+		else if (hasValue && strcmp(argv[i], "--output") == 0)
+			o.output = argv[++i];
+		else if (strcmp(argv[i], "--profile") == 0)
+			o.profile = true;
+		else
+			return false;
+	}
+	return o.blocks > 0 && o.sampleRate > 0 && o.bufferSize > 0 && o.renderThreads >= 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* makeSample_
+Writes a stereo noise burst with a decaying envelope to 'path'. The generator
+is seeded, so every run gets the very same sample. */
+
+bool makeSample_(const std::string& path, int sampleRate)
+{
+	const int             frames = static_cast<int>(SAMPLE_SECONDS * sampleRate);
+	std::unique_ptr<Wave> wave   = waveFactory::createEmpty(frames, G_MAX_IO_CHANS, sampleRate, "benchmark.wav");
+
+	mcl::AudioBuffer& buffer = wave->getWritableBuffer();
+	std::uint32_t     seed   = 12345;
+
+	for (int i = 0; i < frames; i++)
+	{
+		const float env = 1.0f - i / static_cast<float>(frames);
+		for (int j = 0; j < G_MAX_IO_CHANS; j++)
+		{
+			seed         = seed * 1664525u + 1013904223u;
+			buffer[i][j] = env * ((seed >> 8) / 8388608.0f - 1.0f);
+		}
+	}
+
+	return waveFactory::save(*wave, path) == G_RES_OK;
+}
+
+/* -------------------------------------------------------------------------- */
+
+ID addSampleChannel_(const std::string& samplePath, SamplePlayerMode mode, float pitch)
+{
+	ChannelsApi& api = g_engine.getChannelsApi();
+	const ID     id  = api.add(COLUMN_ID, ChannelType::SAMPLE).id;
+
+	api.loadSampleChannel(id, samplePath);
+	api.setSamplePlayerMode(id, mode);
+	api.setPitch(id, pitch);
+	return id;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* load_
+Brings the engine back to a clean state and builds the scenario on it, with
+the sequencer running. */
+
+void load_(const Scenario_& s, const std::string& samplePath)
+{
+	g_engine.reset(PluginManager::SortMethod::NAME);
+
+	MainApi&         mainApi   = g_engine.getMainApi();
+	ChannelsApi&     chansApi  = g_engine.getChannelsApi();
+	ActionEditorApi& actionApi = g_engine.getActionEditorApi();
+
+	mainApi.setBpm(BPM);
+	mainApi.setBeats(BEATS, BARS);
+
+	const Frame framesInLoop = mainApi.getFramesInLoop();
+	const Frame actionStep   = s.actionsPerLoop > 0 ? framesInLoop / s.actionsPerLoop : 0;
+
+	for (int i = 0; i < s.sampleChannels; i++)
+		chansApi.press(addSampleChannel_(samplePath, SamplePlayerMode::LOOP_BASIC, G_DEFAULT_PITCH), G_MAX_VELOCITY);
+
+	for (int i = 0; i < s.pitchedChannels; i++)
+		chansApi.press(addSampleChannel_(samplePath, SamplePlayerMode::LOOP_BASIC, PITCH), G_MAX_VELOCITY);
+
+	for (int i = 0; i < s.actionChannels; i++)
+	{
+		const ID id = addSampleChannel_(samplePath, SamplePlayerMode::SINGLE_RETRIG, G_DEFAULT_PITCH);
+		for (int a = 0; a < s.actionsPerLoop; a++)
+			actionApi.recordSampleAction(id, MidiEvent::CHANNEL_NOTE_ON, a * actionStep, 0);
+		chansApi.toggleReadActions(id);
+	}
+
+	for (int i = 0; i < s.midiChannels; i++)
+	{
+		const ID id = chansApi.add(COLUMN_ID, ChannelType::MIDI).id;
+		for (int a = 0; a < s.actionsPerLoop; a++)
+			actionApi.recordMidiAction(id, /*note=*/60 + a % 12, G_MAX_VELOCITY, a * actionStep, a * actionStep + actionStep / 2);
+		chansApi.press(id, G_MAX_VELOCITY);
+	}
+
+	mainApi.startSequencer();
+}
+
+/* -------------------------------------------------------------------------- */
+
+double percentile_(const std::vector<double>& sorted, double p)
+{
+	const std::size_t i = static_cast<std::size_t>(p * (sorted.size() - 1));
+	return sorted[i];
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* run_
+Renders one loop worth of blocks to warm up caches and let all channels start
+playing, then measures 'blocks' blocks one by one. */
+
+Result_ run_(const Options_& o)
+{
+	using Clock = std::chrono::steady_clock;
+
+	mcl::AudioBuffer out(o.bufferSize, G_MAX_IO_CHANS);
+	mcl::AudioBuffer in(o.bufferSize, G_MAX_IO_CHANS);
+
+	const int warmUpBlocks = g_engine.getMainApi().getFramesInLoop() / o.bufferSize + 1;
+	for (int i = 0; i < warmUpBlocks; i++)
+		g_engine.renderBlock(out, in);
+
+	std::vector<double> times(o.blocks);
+	std::size_t         allocs    = 0;
+	std::size_t         maxAllocs = 0;
+
+	for (int i = 0; i < o.blocks; i++)
+	{
+		const std::size_t allocsBefore = allocations_.load();
+		const auto        start        = Clock::now();
+
+		g_engine.renderBlock(out, in);
+
+		const auto        end         = Clock::now();
+		const std::size_t blockAllocs = allocations_.load() - allocsBefore;
+
+		times[i] = std::chrono::duration<double, std::micro>(end - start).count();
+		allocs += blockAllocs;
+		maxAllocs = std::max(maxAllocs, blockAllocs);
+	}
+
+	double total = 0.0;
+	for (double t : times)
+		total += t;
+
+	std::sort(times.begin(), times.end());
+
+	const double renderedUs = o.blocks * (o.bufferSize * 1000000.0 / o.sampleRate);
+
+	Result_ r;
+	r.p50            = percentile_(times, 0.50);
+	r.p99            = percentile_(times, 0.99);
+	r.max            = times.back();
+	r.mean           = total / o.blocks;
+	r.realtimeFactor = renderedUs / total;
+	r.allocsPerBlock = allocs / static_cast<double>(o.blocks);
+	r.maxAllocs      = maxAllocs;
+	return r;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* toJson_
+Profiler statistics, one entry per stage and channel. */
+
+nlohmann::json toJson_(const std::vector<Profiler::Stats>& stats)
+{
+	nlohmann::json j = nlohmann::json::array();
+	for (const Profiler::Stats& s : stats)
+	{
+		nlohmann::json js;
+		js["stage"]                         = Profiler::getName(s.stage);
+		if (s.channelId != 0)
+			js["channel_id"] = s.channelId;
+		js["count"]                         = s.count;
+		js["us"]["min"]                     = s.min;
+		js["us"]["mean"]                    = s.mean;
+		js["us"]["p99"]                     = s.p99;
+		js["us"]["max"]                     = s.max;
+		j.push_back(js);
+	}
+	return j;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::string toString_(dsp::Isa isa)
+{
+	switch (isa)
+	{
+	case dsp::Isa::AVX2:
+		return "avx2";
+	case dsp::Isa::SSE2:
+		return "sse2";
+	default:
+		return "scalar";
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char** argv)
+{
+	Options_ opts;
+	if (!parseOptions_(argc, argv, opts))
+	{
+		std::fprintf(stderr, "Usage: %s [--blocks N] [--sample-rate N] [--buffer-size N] [--render-threads N] [--output path] [--profile]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const std::vector<Scenario_> scenarios = {
+	    {"samples-16", 16, 0, 0, 0, 0},
+	    {"samples-64", 64, 0, 0, 0, 0},
+	    {"pitched-16", 0, 16, 0, 0, 0},
+	    {"pitched-64", 0, 64, 0, 0, 0},
+	    {"actions-16", 0, 0, 16, 0, 64},
+	    {"midi-16", 0, 0, 0, 16, 64},
+	    {"mixed-64", 32, 16, 8, 8, 32},
+	};
+
+	m::Conf conf;
+	conf.samplerate    = opts.sampleRate;
+	conf.buffersize    = opts.bufferSize;
+	conf.renderThreads = opts.renderThreads;
+
+	g_engine.onMidiReceived = []() {};
+	g_engine.onMidiSent     = []() {};
+	g_engine.onModelSwap    = [](m::model::SwapType) {};
+	g_engine.onWavesLoaded  = []() {};
+	g_engine.initHeadless(conf);
+
+	const std::string samplePath = (std::filesystem::temp_directory_path() / "giada-benchmark.wav").string();
+	if (!makeSample_(samplePath, opts.sampleRate))
+	{
+		std::fprintf(stderr, "Unable to write %s\n", samplePath.c_str());
+		return EXIT_FAILURE;
+	}
+
+	nlohmann::json j;
+	j["version"]        = G_VERSION_STR;
+	j["sample_rate"]    = opts.sampleRate;
+	j["buffer_size"]    = opts.bufferSize;
+	j["render_threads"] = opts.renderThreads;
+	j["blocks"]         = opts.blocks;
+	j["isa"]            = toString_(m::dsp::getIsa());
+	j["budget_us"]      = opts.bufferSize * 1000000.0 / opts.sampleRate;
+	j["scenarios"]      = nlohmann::json::array();
+
+	for (const Scenario_& s : scenarios)
+	{
+		load_(s, samplePath);
+		g_engine.getMainApi().setProfilingEnabled(opts.profile);
+		const Result_ r = run_(opts);
+
+		std::fprintf(stderr, "%-12s p50=%8.2fus p99=%8.2fus max=%8.2fus x%.1f realtime, %.2f process allocs/block\n",
+		    s.name.c_str(), r.p50, r.p99, r.max, r.realtimeFactor, r.allocsPerBlock);
+
+		nlohmann::json js;
+		js["name"]                          = s.name;
+		js["sample_channels"]               = s.sampleChannels;
+		js["pitched_channels"]              = s.pitchedChannels;
+		js["action_channels"]               = s.actionChannels;
+		js["midi_channels"]                 = s.midiChannels;
+		js["actions_per_loop"]              = s.actionsPerLoop;
+		js["block_us"]["p50"]               = r.p50;
+		js["block_us"]["p99"]               = r.p99;
+		js["block_us"]["max"]               = r.max;
+		js["block_us"]["mean"]              = r.mean;
+		js["realtime_factor"]               = r.realtimeFactor;
+		js["process_allocations_per_block"] = r.allocsPerBlock;
+		js["process_max_allocations"]       = r.maxAllocs;
+		if (opts.profile)
+			js["profile"] = toJson_(g_engine.getMainApi().getProfilerStats());
+		j["scenarios"].push_back(js);
+	}
+
+	g_engine.reset(m::PluginManager::SortMethod::NAME);
+	std::filesystem::remove(samplePath);
+
+	if (opts.output.empty())
+	{
+		std::cout << j.dump(4) << "\n";
+		return EXIT_SUCCESS;
+	}
+
+	std::ofstream file(opts.output);
+	file << j.dump(4) << "\n";
+	return file.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
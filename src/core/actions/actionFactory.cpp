@@ -26,25 +26,13 @@
 
 #include "core/actions/actionFactory.h"
 #include "core/midiEvent.h"
-#include <cassert>
+#include <utility>
 
 namespace giada::m::actionFactory
 {
 namespace
 {
 IdManager actionId_;
-
-/* -------------------------------------------------------------------------- */
-
-const Action* getActionPtrById_(int id, const Actions::Map& source)
-{
-	for (const auto& [_, actions] : source)
-		for (const Action& action : actions)
-			if (action.id == id)
-				return &action;
-	return nullptr;
-}
-
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -81,58 +69,34 @@ ID getNewActionId()
 
 /* -------------------------------------------------------------------------- */
 
-Actions::Map deserializeActions(const std::vector<Patch::Action>& pactions)
+ActionTimeline deserializeActions(const std::vector<Patch::Action>& pactions)
 {
-	Actions::Map out;
-
-	/* First pass: add actions with no relationship, that is with no prev/next
-	pointers filled in. */
+	/* Actions are linked together by ID: no further pass is needed to resolve
+	relationships. */
 
+	std::vector<Action> out;
+	out.reserve(pactions.size());
 	for (const Patch::Action& paction : pactions)
-		out[paction.frame].push_back(makeAction(paction));
-
-	/* Second pass: fill in previous and next actions, if any. Is this the
-	fastest/smartest way to do it? Maybe not. Optimizations are welcome. */
-
-	for (const Patch::Action& paction : pactions)
-	{
-		if (paction.nextId == 0 && paction.prevId == 0)
-			continue;
-		Action* curr = const_cast<Action*>(getActionPtrById_(paction.id, out));
-		assert(curr != nullptr);
-		if (paction.nextId != 0)
-		{
-			curr->next = getActionPtrById_(paction.nextId, out);
-			assert(curr->next != nullptr);
-		}
-		if (paction.prevId != 0)
-		{
-			curr->prev = getActionPtrById_(paction.prevId, out);
-			assert(curr->prev != nullptr);
-		}
-	}
-
-	return out;
+		out.push_back(makeAction(paction));
+	return ActionTimeline(std::move(out));
 }
 
 /* -------------------------------------------------------------------------- */
 
-std::vector<Patch::Action> serializeActions(const Actions::Map& actions)
+std::vector<Patch::Action> serializeActions(const ActionTimeline& actions)
 {
 	std::vector<Patch::Action> out;
-	for (const auto& kv : actions) // TODO - const auto& [_, actionsInFrame]
+	out.reserve(actions.size());
+	for (const Action& a : actions.getAll())
 	{
-		for (const Action& a : kv.second)
-		{
-			out.push_back({
-			    a.id,
-			    a.channelId,
-			    a.frame,
-			    a.event.getRaw(),
-			    a.prevId,
-			    a.nextId,
-			});
-		}
+		out.push_back({
+		    a.id,
+		    a.channelId,
+		    a.frame,
+		    a.event.getRaw(),
+		    a.prevId,
+		    a.nextId,
+		});
 	}
 	return out;
 }
@@ -28,7 +28,7 @@
 #define G_ACTION_FACTORY_H
 
 #include "core/actions/action.h"
-#include "core/actions/actions.h"
+#include "core/actions/actionTimeline.h"
 #include "core/idManager.h"
 #include "core/patch.h"
 
@@ -53,8 +53,8 @@ ID getNewActionId();
 /* (de)serializeActions
 Creates new Actions given the patch raw data and vice versa. */
 
-Actions::Map               deserializeActions(const std::vector<Patch::Action>&);
-std::vector<Patch::Action> serializeActions(const Actions::Map&);
+ActionTimeline             deserializeActions(const std::vector<Patch::Action>&);
+std::vector<Patch::Action> serializeActions(const ActionTimeline&);
 } // namespace giada::m::actionFactory
 
 #endif
@@ -70,9 +70,11 @@ void ActionRecorder::reset()
 
 bool ActionRecorder::isBoundaryEnvelopeAction(const Action& a) const
 {
-	assert(a.prev != nullptr);
-	assert(a.next != nullptr);
-	return a.prev->frame > a.frame || a.next->frame < a.frame;
+	const Action prev = getAction(a.prevId);
+	const Action next = getAction(a.nextId);
+	assert(prev.isValid());
+	assert(next.isValid());
+	return prev.frame > a.frame || next.frame < a.frame;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -231,8 +233,8 @@ void ActionRecorder::deleteMidiAction(ID channelId, const Action& a)
 
 	/* Check if 'next' exist first: could be orphaned. */
 
-	if (a.next != nullptr)
-		deleteAction(channelId, a.id, a.next->id);
+	if (getAction(a.nextId).isValid())
+		deleteAction(channelId, a.id, a.nextId);
 	else
 		deleteAction(channelId, a.id);
 }
@@ -241,8 +243,8 @@ void ActionRecorder::deleteMidiAction(ID channelId, const Action& a)
 
 void ActionRecorder::deleteSampleAction(ID channelId, const Action& a)
 {
-	if (a.next != nullptr) // For ChannelMode::SINGLE_PRESS combo
-		deleteAction(channelId, a.id, a.next->id);
+	if (getAction(a.nextId).isValid()) // For ChannelMode::SINGLE_PRESS combo
+		deleteAction(channelId, a.id, a.nextId);
 	else
 		deleteAction(channelId, a.id);
 }
@@ -264,13 +266,13 @@ void ActionRecorder::deleteEnvelopeAction(ID channelId, const Action& a)
 	}
 	else
 	{
-		assert(a.prev != nullptr);
-		assert(a.next != nullptr);
+		const Action a1     = getAction(a.prevId);
+		const Action a1prev = getAction(a1.prevId);
+		const Action a3     = getAction(a.nextId);
+		const Action a3next = getAction(a3.nextId);
 
-		const Action a1     = *a.prev;
-		const Action a1prev = *a1.prev;
-		const Action a3     = *a.next;
-		const Action a3next = *a3.next;
+		assert(a1.isValid());
+		assert(a3.isValid());
 
 		/* Original status:   a1--->a--->a3
 		   Modified status:   a1-------->a3 
@@ -289,7 +291,7 @@ void ActionRecorder::deleteEnvelopeAction(ID channelId, const Action& a)
 void ActionRecorder::updateMidiAction(ID channelId, const Action& a, int note, int velocity,
     Frame f1, Frame f2, Frame framesInLoop)
 {
-	deleteAction(channelId, a.id, a.next->id);
+	deleteAction(channelId, a.id, a.nextId);
 	recordMidiAction(channelId, note, velocity, f1, f2, framesInLoop);
 }
 
@@ -298,7 +300,7 @@ void ActionRecorder::updateMidiAction(ID channelId, const Action& a, int note, i
 void ActionRecorder::updateSampleAction(ID channelId, const Action& a, int type, Frame f1, Frame f2)
 {
 	if (isSinglePressMode(channelId))
-		deleteAction(channelId, a.id, a.next->id);
+		deleteAction(channelId, a.id, a.nextId);
 	else
 		deleteAction(channelId, a.id);
 
@@ -421,13 +423,21 @@ void ActionRecorder::recordFirstEnvelopeAction(ID channelId, Frame frame, int va
 	const MidiEvent e1 = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_CC, 0, G_MAX_VELOCITY);
 	const MidiEvent e2 = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_CC, 0, value);
 
-	const Action a1 = rec(channelId, 0, e1);
-	const Action a2 = rec(channelId, frame, e2);
-	const Action a3 = rec(channelId, lastFrameInLoop, e1);
+	Action a1 = actionFactory::makeAction(0, channelId, 0, e1);
+	Action a2 = actionFactory::makeAction(0, channelId, frame, e2);
+	Action a3 = actionFactory::makeAction(0, channelId, lastFrameInLoop, e1);
+
+	/* Link them before recording, so that the timeline is rebuilt only once. */
+
+	a1.prevId = a3.id; // Circular loop (begin)
+	a1.nextId = a2.id;
+	a2.prevId = a1.id;
+	a2.nextId = a3.id;
+	a3.prevId = a2.id;
+	a3.nextId = a1.id; // Circular loop (end)
 
-	updateSiblings(a1.id, /*prev=*/a3.id, /*next=*/a2.id); // Circular loop (begin)
-	updateSiblings(a2.id, /*prev=*/a1.id, /*next=*/a3.id);
-	updateSiblings(a3.id, /*prev=*/a2.id, /*next=*/a1.id); // Circular loop (end)
+	std::vector<Action> actions = {a1, a2, a3};
+	m_actions.rec(actions);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -435,7 +445,7 @@ void ActionRecorder::recordFirstEnvelopeAction(ID channelId, Frame frame, int va
 void ActionRecorder::recordNonFirstEnvelopeAction(ID channelId, Frame frame, int value)
 {
 	const Action a1 = getClosestAction(channelId, frame, MidiEvent::CHANNEL_CC);
-	const Action a3 = a1.next != nullptr ? *a1.next : Action{};
+	const Action a3 = getAction(a1.nextId);
 
 	assert(a1.isValid());
 	assert(a3.isValid());
@@ -453,11 +463,21 @@ void ActionRecorder::recordNonFirstEnvelopeAction(ID channelId, Frame frame, int
 
 /* -------------------------------------------------------------------------- */
 
-const std::vector<Action>* ActionRecorder::getActionsOnFrame(Frame f) const
+Action ActionRecorder::getAction(ID id) const
+{
+	return m_actions.getAction(id);
+}
+
+ActionTimeline::Span ActionRecorder::getActionsOnFrame(Frame f) const
 {
 	return m_actions.getActionsOnFrame(f);
 }
 
+ActionTimeline::Span ActionRecorder::getActionsInRange(Frame from, Frame to) const
+{
+	return m_actions.getActionsInRange(from, to);
+}
+
 bool ActionRecorder::hasActions(ID channelId, int type) const
 {
 	return m_actions.hasActions(channelId, type);
@@ -0,0 +1,192 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/actions/actionTimeline.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace giada::m
+{
+namespace
+{
+bool comesBefore_(const Action& a, const Action& b)
+{
+	return a.frame != b.frame ? a.frame < b.frame : a.channelId < b.channelId;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::ActionTimeline(std::vector<Action> actions)
+: m_actions(std::move(actions))
+{
+	/* Stable sort: actions on the same frame and channel keep their recording
+	order. */
+
+	if (!std::is_sorted(m_actions.begin(), m_actions.end(), comesBefore_))
+		std::stable_sort(m_actions.begin(), m_actions.end(), comesBefore_);
+
+	buildIndex();
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline ActionTimeline::withActions(std::vector<Action> actions) const
+{
+	std::stable_sort(actions.begin(), actions.end(), comesBefore_);
+
+	ActionTimeline out;
+	out.m_actions.reserve(m_actions.size() + actions.size());
+	std::merge(m_actions.begin(), m_actions.end(), actions.begin(), actions.end(),
+	    std::back_inserter(out.m_actions), comesBefore_);
+	out.buildIndex();
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline ActionTimeline::withoutActions(const std::function<bool(const Action&)>& f) const
+{
+	ActionTimeline out;
+	out.m_actions.reserve(m_actions.size());
+	std::copy_if(m_actions.begin(), m_actions.end(), std::back_inserter(out.m_actions),
+	    [&f](const Action& a) { return !f(a); });
+	out.buildIndex();
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTimeline::buildIndex()
+{
+	auto index = std::make_shared<Index>();
+
+	index->frames.reserve(m_actions.size());
+	index->ids.reserve(m_actions.size());
+
+	for (std::size_t i = 0; i < m_actions.size(); i++)
+	{
+		const Action& a = m_actions[i];
+		index->frames.push_back(a.frame);
+		index->channels[a.channelId].push_back(i);
+		index->ids[a.id] = i;
+	}
+
+	m_index = std::move(index);
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::Span ActionTimeline::getChannelActions(Span actions, ID channelId)
+{
+	const auto first = std::partition_point(actions.begin(), actions.end(),
+	    [channelId](const Action& a) { return a.channelId < channelId; });
+	const auto last = std::partition_point(first, actions.end(),
+	    [channelId](const Action& a) { return a.channelId == channelId; });
+	return {first, last};
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool        ActionTimeline::empty() const { return m_actions.empty(); }
+std::size_t ActionTimeline::size() const { return m_actions.size(); }
+
+const std::vector<Action>& ActionTimeline::getAll() const { return m_actions; }
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::Span ActionTimeline::getActionsOnFrame(Frame f) const
+{
+	return getActionsInRange(f, f + 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionTimeline::Span ActionTimeline::getActionsInRange(Frame from, Frame to) const
+{
+	const std::size_t first = lowerBound(from);
+	const std::size_t last  = lowerBound(to);
+	return Span(m_actions).subspan(first, last - first);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::vector<Action> ActionTimeline::getActionsOnChannel(ID channelId) const
+{
+	std::vector<Action> out;
+	forEachActionOnChannel(channelId, [&out](const Action& a) { out.push_back(a); });
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool ActionTimeline::hasActions(ID channelId, int type) const
+{
+	const auto it = m_index->channels.find(channelId);
+	if (it == m_index->channels.end())
+		return false;
+	if (type == 0)
+		return true;
+	return std::any_of(it->second.begin(), it->second.end(), [this, type](std::size_t i) {
+		return m_actions[i].event.getStatus() == type;
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool ActionTimeline::contains(ID channelId, Frame f, const MidiEvent& e) const
+{
+	for (const Action& a : getChannelActions(getActionsOnFrame(f), channelId))
+		if (a.event.getRaw() == e.getRaw())
+			return true;
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Action* ActionTimeline::find(ID id) const
+{
+	const auto it = m_index->ids.find(id);
+	return it != m_index->ids.end() ? &m_actions[it->second] : nullptr;
+}
+
+Action* ActionTimeline::find(ID id)
+{
+	return const_cast<Action*>(std::as_const(*this).find(id));
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t ActionTimeline::lowerBound(Frame f) const
+{
+	const std::vector<Frame>& frames = m_index->frames;
+	return std::lower_bound(frames.begin(), frames.end(), f) - frames.begin();
+}
+} // namespace giada::m
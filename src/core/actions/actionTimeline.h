@@ -0,0 +1,170 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_ACTION_TIMELINE_H
+#define G_ACTION_TIMELINE_H
+
+#include "core/actions/action.h"
+#include "core/types.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace giada::m
+{
+/* ActionTimeline
+Flat container of recorded actions, optimized for the realtime thread. Actions
+are stored contiguously, sorted by frame and then by channel. Frames are also
+mirrored in a separate array (structure of arrays), so that binary searches 
+walk through tightly packed data. Actions refer to each other by ID: two 
+additional indexes map action IDs and channel IDs to positions in the 
+timeline. A timeline is never changed while being read by the realtime thread:
+the Actions class builds a new one and swaps it in through the model. Frames
+and indexes depend only on the positions of the actions, so they are shared 
+between a timeline and its copies: editing an action in a copy (without 
+moving it) doesn't rebuild them. */
+
+class ActionTimeline
+{
+public:
+	using Span = std::span<const Action>;
+
+	ActionTimeline() = default;
+
+	/* ActionTimeline (1)
+	Builds a timeline out of a vector of actions in any order. Sorting is 
+	skipped if they are sorted already. */
+
+	explicit ActionTimeline(std::vector<Action>);
+
+	/* withActions
+	Returns a new timeline with 'actions', in any order, added to this one. Only
+	the new actions are sorted, then merged with the existing ones: on the same
+	frame and channel, existing actions come first. */
+
+	ActionTimeline withActions(std::vector<Action>) const;
+
+	/* withoutActions
+	Returns a new timeline without the actions matching 'f'. No sorting 
+	required. */
+
+	ActionTimeline withoutActions(const std::function<bool(const Action&)>& f) const;
+
+	/* getChannelActions
+	Given a span of actions sitting on the same frame, returns the sub-span of
+	those belonging to channel 'channelId'. */
+
+	static Span getChannelActions(Span, ID channelId);
+
+	bool        empty() const;
+	std::size_t size() const;
+
+	/* getAll
+	Returns all actions, sorted by frame. */
+
+	const std::vector<Action>& getAll() const;
+
+	/* getActionsOnFrame
+	Returns all actions recorded on frame 'f'. Empty span if none. */
+
+	Span getActionsOnFrame(Frame f) const;
+
+	/* getActionsInRange
+	Returns all actions recorded in range [from, to), sorted by frame. */
+
+	Span getActionsInRange(Frame from, Frame to) const;
+
+	/* getActionsOnChannel
+	Returns a copy of the actions belonging to channel 'channelId', sorted by
+	frame. */
+
+	std::vector<Action> getActionsOnChannel(ID channelId) const;
+
+	/* hasActions
+	Tells whether channel 'channelId' has any action, optionally filtered by
+	MidiEvent status 'type'. */
+
+	bool hasActions(ID channelId, int type = 0) const;
+
+	/* contains
+	Tells whether an action with the same channel, frame and event exists. */
+
+	bool contains(ID channelId, Frame f, const MidiEvent&) const;
+
+	/* find
+	Returns a pointer to the action with ID 'id', or nullptr if not found. The
+	non-const version allows in-place changes that don't alter frame and channel
+	(i.e. the sorting keys). Pointers are valid until the timeline changes. */
+
+	const Action* find(ID id) const;
+	Action*       find(ID id);
+
+	/* forEachActionOnChannel
+	Applies a read-only callback to each action of channel 'channelId', in frame
+	order. */
+
+	template <typename F>
+	void forEachActionOnChannel(ID channelId, F&& f) const
+	{
+		const auto it = m_index->channels.find(channelId);
+		if (it == m_index->channels.end())
+			return;
+		for (const std::size_t i : it->second)
+			f(m_actions[i]);
+	}
+
+private:
+	struct Index
+	{
+		std::vector<Frame> frames;
+
+		/* channels
+		Positions of each channel's actions in the timeline, sorted by frame. */
+
+		std::unordered_map<ID, std::vector<std::size_t>> channels;
+
+		/* ids
+		Position of each action in the timeline, by action ID. */
+
+		std::unordered_map<ID, std::size_t> ids;
+	};
+
+	/* buildIndex
+	Rebuilds frames and indexes out of the actions, which must be sorted. */
+
+	void buildIndex();
+
+	std::size_t lowerBound(Frame f) const;
+
+	std::vector<Action>          m_actions;
+	std::shared_ptr<const Index> m_index = std::make_shared<const Index>();
+};
+} // namespace giada::m
+
+#endif
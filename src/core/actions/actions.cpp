@@ -33,6 +33,8 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <set>
+#include <tuple>
 
 namespace giada::m
 {
@@ -45,8 +47,7 @@ Actions::Actions(model::Model& model)
 
 void Actions::clearAll()
 {
-	model::DataLock lock = m_model.lockData();
-	m_model.getAllShared<Map>().clear();
+	m_model.replaceShared(ActionTimeline());
 }
 
 /* -------------------------------------------------------------------------- */
@@ -81,74 +82,70 @@ void Actions::deleteAction(ID currId, ID nextId)
 
 void Actions::updateKeyFrames(std::function<Frame(Frame old)> f)
 {
-	Map temp;
+	/* Copy all existing actions by cloning them, with just a difference: they
+	have a new frame value. The new timeline is sorted again only if 'f' has
+	changed the order of the actions. */
 
-	/* Copy all existing actions in local map by cloning them, with just a
-	difference: they have a new frame value. */
-
-	for (const auto& [oldFrame, actions] : m_model.getAllShared<Map>())
+	std::vector<Action> actions = getTimeline().getAll();
+	for (Action& a : actions)
 	{
-		Frame newFrame = f(oldFrame);
-		for (const Action& a : actions)
-		{
-			Action copy = a;
-			copy.frame  = newFrame;
-			temp[newFrame].push_back(copy);
-		}
-		G_DEBUG("{} -> {}", oldFrame, newFrame);
+		const Frame newFrame = f(a.frame);
+		G_DEBUG("{} -> {}", a.frame, newFrame);
+		a.frame = newFrame;
 	}
 
-	updateMapPointers(temp);
-
-	model::DataLock lock        = m_model.lockData();
-	m_model.getAllShared<Map>() = std::move(temp);
+	replaceTimeline(std::move(actions));
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Actions::updateEvent(ID id, MidiEvent e)
 {
-	model::DataLock lock = m_model.lockData();
+	/* The timeline is never changed in place, as the realtime thread might be
+	reading it: edit a copy and swap it in instead. The event is not a sorting
+	key, so the copy shares frames and indexes with the original: only the 
+	actions are copied. */
+
+	ActionTimeline timeline(getTimeline());
 
-	findAction(m_model.getAllShared<Map>(), id)->event = e;
+	Action* a = timeline.find(id);
+	assert(a != nullptr);
+
+	a->event = e;
+
+	m_model.replaceShared(std::move(timeline));
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Actions::updateSiblings(ID id, ID prevId, ID nextId)
 {
-	model::DataLock lock = m_model.lockData();
+	/* Same as updateEvent(): siblings are not sorting keys either. */
+
+	ActionTimeline timeline(getTimeline());
 
-	Action* pcurr = findAction(m_model.getAllShared<Map>(), id);
-	Action* pprev = findAction(m_model.getAllShared<Map>(), prevId);
-	Action* pnext = findAction(m_model.getAllShared<Map>(), nextId);
+	Action* pcurr = timeline.find(id);
+	Action* pprev = timeline.find(prevId);
+	Action* pnext = timeline.find(nextId);
 
-	pcurr->prev   = pprev;
-	pcurr->prevId = pprev->id;
-	pcurr->next   = pnext;
-	pcurr->nextId = pnext->id;
+	assert(pcurr != nullptr);
+
+	pcurr->prevId = prevId;
+	pcurr->nextId = nextId;
 
 	if (pprev != nullptr)
-	{
-		pprev->next   = pcurr;
-		pprev->nextId = pcurr->id;
-	}
+		pprev->nextId = id;
 	if (pnext != nullptr)
-	{
-		pnext->prev   = pcurr;
-		pnext->prevId = pcurr->id;
-	}
+		pnext->prevId = id;
+
+	m_model.replaceShared(std::move(timeline));
 }
 
 /* -------------------------------------------------------------------------- */
 
 bool Actions::hasActions(ID channelId, int type) const
 {
-	for (const auto& [frame, actions] : m_model.getAllShared<Map>())
-		for (const Action& a : actions)
-			if (a.channelId == channelId && (type == 0 || type == a.event.getStatus()))
-				return true;
-	return false;
+	return getTimeline().hasActions(channelId, type);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -157,18 +154,12 @@ Action Actions::rec(ID channelId, Frame frame, MidiEvent event)
 {
 	/* Skip duplicates. */
 
-	if (exists(channelId, frame, event))
+	if (getTimeline().contains(channelId, frame, event))
 		return {};
 
-	Action a = actionFactory::makeAction(0, channelId, frame, event);
+	const Action a = actionFactory::makeAction(0, channelId, frame, event);
 
-	/* If key frame doesn't exist yet, the [] operator in std::map is smart 
-	enough to insert a new item first. No plug-in data for now. */
-
-	model::DataLock lock = m_model.lockData();
-
-	m_model.getAllShared<Map>()[frame].push_back(a);
-	updateMapPointers(m_model.getAllShared<Map>());
+	m_model.replaceShared(getTimeline().withActions({a}));
 
 	return a;
 }
@@ -180,42 +171,55 @@ void Actions::rec(std::vector<Action>& actions)
 	if (actions.size() == 0)
 		return;
 
-	model::DataLock lock = m_model.lockData();
+	const ActionTimeline& timeline = getTimeline();
+
+	/* Skip duplicates, either already in the timeline or in the incoming
+	vector itself. All actions are then merged in at once. */
 
-	Map& map = m_model.getAllShared<Map>();
+	std::vector<Action> out;
+	out.reserve(actions.size());
 
+	std::set<std::tuple<ID, Frame, uint32_t>> added;
 	for (const Action& a : actions)
-		if (!exists(a.channelId, a.frame, a.event, map))
-			map[a.frame].push_back(a);
-	updateMapPointers(map);
+		if (!timeline.contains(a.channelId, a.frame, a.event) &&
+		    added.insert({a.channelId, a.frame, a.event.getRaw()}).second)
+			out.push_back(a);
+
+	m_model.replaceShared(timeline.withActions(std::move(out)));
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Actions::rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2)
 {
-	model::DataLock lock = m_model.lockData();
+	Action a1 = actionFactory::makeAction(0, channelId, f1, e1);
+	Action a2 = actionFactory::makeAction(0, channelId, f2, e2);
+	a1.nextId = a2.id;
+	a2.prevId = a1.id;
 
-	Map& map = m_model.getAllShared<Map>();
+	m_model.replaceShared(getTimeline().withActions({a1, a2}));
+}
+
+/* -------------------------------------------------------------------------- */
 
-	map[f1].push_back(actionFactory::makeAction(0, channelId, f1, e1));
-	map[f2].push_back(actionFactory::makeAction(0, channelId, f2, e2));
+Action Actions::getAction(ID id) const
+{
+	const Action* a = getTimeline().find(id);
+	return a != nullptr ? *a : Action{};
+}
 
-	Action* a1 = findAction(map, map[f1].back().id);
-	Action* a2 = findAction(map, map[f2].back().id);
-	a1->nextId = a2->id;
-	a2->prevId = a1->id;
+/* -------------------------------------------------------------------------- */
 
-	updateMapPointers(map);
+ActionTimeline::Span Actions::getActionsOnFrame(Frame frame) const
+{
+	return getTimeline().getActionsOnFrame(frame);
 }
 
 /* -------------------------------------------------------------------------- */
 
-const std::vector<Action>* Actions::getActionsOnFrame(Frame frame) const
+ActionTimeline::Span Actions::getActionsInRange(Frame from, Frame to) const
 {
-	if (m_model.getAllShared<Map>().count(frame) == 0)
-		return nullptr;
-	return &m_model.getAllShared<Map>().at(frame);
+	return getTimeline().getActionsInRange(from, to);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -223,8 +227,8 @@ const std::vector<Action>* Actions::getActionsOnFrame(Frame frame) const
 Action Actions::getClosestAction(ID channelId, Frame f, int type) const
 {
 	Action out = {};
-	forEachAction([&](const Action& a) {
-		if (a.event.getStatus() != type || a.channelId != channelId)
+	getTimeline().forEachActionOnChannel(channelId, [&](const Action& a) {
+		if (a.event.getStatus() != type)
 			return;
 		if (!out.isValid() || (a.frame <= f && a.frame > out.frame))
 			out = a;
@@ -236,87 +240,35 @@ Action Actions::getClosestAction(ID channelId, Frame f, int type) const
 
 std::vector<Action> Actions::getActionsOnChannel(ID channelId) const
 {
-	std::vector<Action> out;
-	forEachAction([&](const Action& a) {
-		if (a.channelId == channelId)
-			out.push_back(a);
-	});
-	return out;
+	return getTimeline().getActionsOnChannel(channelId);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Actions::forEachAction(std::function<void(const Action&)> f) const
 {
-	for (auto& [_, actions] : m_model.getAllShared<Map>())
-		for (const Action& action : actions)
-			f(action);
-}
-
-/* -------------------------------------------------------------------------- */
-
-Action* Actions::findAction(Map& src, ID id)
-{
-	for (auto& [frame, actions] : src)
-		for (Action& a : actions)
-			if (a.id == id)
-				return &a;
-	assert(false);
-	return nullptr;
+	for (const Action& action : getTimeline().getAll())
+		f(action);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void Actions::updateMapPointers(Map& src)
+const ActionTimeline& Actions::getTimeline() const
 {
-	for (auto& kv : src)
-	{
-		for (Action& action : kv.second)
-		{
-			if (action.nextId != 0)
-				action.next = findAction(src, action.nextId);
-			if (action.prevId != 0)
-				action.prev = findAction(src, action.prevId);
-		}
-	}
+	return m_model.getAllShared<ActionTimeline>();
 }
 
 /* -------------------------------------------------------------------------- */
 
-void Actions::optimize(Map& map)
+void Actions::replaceTimeline(std::vector<Action> actions)
 {
-	for (auto it = map.cbegin(); it != map.cend();)
-		it->second.size() == 0 ? it = map.erase(it) : ++it;
+	m_model.replaceShared(ActionTimeline(std::move(actions)));
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Actions::removeIf(std::function<bool(const Action&)> f)
 {
-	model::DataLock lock = m_model.lockData();
-
-	Map& map = m_model.getAllShared<Map>();
-	for (auto& [frame, actions] : map)
-		actions.erase(std::remove_if(actions.begin(), actions.end(), f), actions.end());
-	optimize(map);
-	updateMapPointers(map);
-}
-
-/* -------------------------------------------------------------------------- */
-
-bool Actions::exists(ID channelId, Frame frame, const MidiEvent& event, const Map& target) const
-{
-	for (const auto& [_, actions] : target)
-		for (const Action& a : actions)
-			if (a.channelId == channelId && a.frame == frame && a.event.getRaw() == event.getRaw())
-				return true;
-	return false;
-}
-
-/* -------------------------------------------------------------------------- */
-
-bool Actions::exists(ID channelId, Frame frame, const MidiEvent& event) const
-{
-	return exists(channelId, frame, event, m_model.getAllShared<Map>());
+	m_model.replaceShared(getTimeline().withoutActions(f));
 }
 } // namespace giada::m
@@ -28,12 +28,12 @@
 #define G_ACTIONS_H
 
 #include "action.h"
+#include "core/actions/actionTimeline.h"
 #include "core/idManager.h"
 #include "core/midiEvent.h"
 #include "core/patch.h"
 #include "core/types.h"
 #include <functional>
-#include <map>
 #include <memory>
 #include <vector>
 
@@ -47,13 +47,11 @@ namespace giada::m
 class Actions
 {
 public:
-	using Map = std::map<Frame, std::vector<Action>>;
-
 	Actions(model::Model& model);
 
 	/* forEachAction
     Applies a read-only callback on each action recorded. NEVER do anything
-    inside the callback that might alter the ActionMap. */
+    inside the callback that might alter the ActionTimeline. */
 
 	void forEachAction(std::function<void(const Action&)> f) const;
 
@@ -67,11 +65,24 @@ public:
 
 	Action getClosestAction(ID channelId, Frame f, int type) const;
 
+	/* getAction
+    Returns a copy of the action with ID 'id', or an invalid action if not 
+    found. */
+
+	Action getAction(ID id) const;
+
 	/* getActionsOnFrame
-    Returns a pointer to a vector of actions recorded on frame 'f', or nullptr 
-    if the frame has no actions. */
+    Returns a span of actions recorded on frame 'f'. Empty if the frame has no 
+    actions. */
+
+	ActionTimeline::Span getActionsOnFrame(Frame f) const;
 
-	const std::vector<Action>* getActionsOnFrame(Frame f) const;
+	/* getActionsInRange
+    Returns a span of all actions in range [from, to), sorted by frame. Useful 
+    to walk through the actions in a block without looking up each single 
+    frame. */
+
+	ActionTimeline::Span getActionsInRange(Frame from, Frame to) const;
 
 	/* hasActions
     Checks if the channel has at least one action recorded. */
@@ -104,8 +115,8 @@ public:
 	void deleteAction(ID currId, ID nextId);
 
 	/* updateKeyFrames
-    Update all the key frames in the internal map of actions, according to a 
-    lambda function 'f'. */
+    Update all the key frames in the internal timeline, according to a lambda 
+    function 'f'. */
 
 	void updateKeyFrames(std::function<Frame(Frame old)> f);
 
@@ -126,7 +137,7 @@ public:
 	Action rec(ID channelId, Frame frame, MidiEvent e);
 
 	/* rec (2)
-    Transfer a vector of actions into the current ActionMap. This is called by 
+    Transfer a vector of actions into the current timeline. This is called by 
     recordHandler when a live session is over and consolidation is required. */
 
 	void rec(std::vector<Action>& actions);
@@ -138,22 +149,14 @@ public:
 	void rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2);
 
 private:
-	bool exists(ID channelId, Frame frame, const MidiEvent& event, const Map& target) const;
-	bool exists(ID channelId, Frame frame, const MidiEvent& event) const;
-
-	Action* findAction(Map& src, ID id);
-
-	/* updateMapPointers
-    Updates all prev/next actions pointers into the action map. This is required
-    after an action has been recorded, since pushing back new actions in a Action 
-    vector makes it reallocating the existing ones. */
-
-	void updateMapPointers(Map& src);
+	const ActionTimeline& getTimeline() const;
 
-	/* optimize
-    Removes frames without actions. */
+	/* replaceTimeline
+    Builds a new timeline out of 'actions' and swaps it with the current one. 
+    The realtime thread keeps reading the old one until the end of its block:
+    the model frees it later on. */
 
-	void optimize(Map& map);
+	void replaceTimeline(std::vector<Action> actions);
 
 	void removeIf(std::function<bool(const Action&)> f);
 
@@ -41,6 +41,13 @@ ActionEditorApi::ActionEditorApi(Engine& e, model::Model& m, Sequencer& s, Actio
 
 /* -------------------------------------------------------------------------- */
 
+Action ActionEditorApi::getAction(ID id) const
+{
+	return m_actionRecorder.getAction(id);
+}
+
+/* -------------------------------------------------------------------------- */
+
 std::vector<Action> ActionEditorApi::getActionsOnChannel(ID channelId) const
 {
 	return m_actionRecorder.getActionsOnChannel(channelId);
@@ -50,10 +57,10 @@ std::vector<Action> ActionEditorApi::getActionsOnChannel(ID channelId) const
 
 std::vector<Patch::Action> ActionEditorApi::serializeActions() const
 {
-	return actionFactory::serializeActions(m_model.getAllShared<Actions::Map>());
+	return actionFactory::serializeActions(m_model.getAllShared<ActionTimeline>());
 }
 
-Actions::Map ActionEditorApi::deserializeActions(const std::vector<Patch::Action>& as) const
+ActionTimeline ActionEditorApi::deserializeActions(const std::vector<Patch::Action>& as) const
 {
 	return actionFactory::deserializeActions(as);
 }
@@ -72,7 +79,8 @@ void ActionEditorApi::deleteMidiAction(ID channelId, const Action& a)
 	/* Send a note-off first in case we are deleting it in a middle of a
 	key_on/key_off sequence. */
 
-	m_engine.getChannelsApi().sendMidi(channelId, a.next->event);
+	if (const Action next = m_actionRecorder.getAction(a.nextId); next.isValid())
+		m_engine.getChannelsApi().sendMidi(channelId, next.event);
 	m_actionRecorder.deleteMidiAction(channelId, a);
 }
 
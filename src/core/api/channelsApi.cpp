@@ -99,6 +99,13 @@ void ChannelsApi::loadPreviewChannel(ID sourceChannelId)
 	m_channelManager.loadWaveInPreviewChannel(sourceChannelId);
 }
 
+int ChannelsApi::setStreaming(ID channelId, bool value)
+{
+	const int                sampleRate  = m_kernelAudio.getSampleRate();
+	const Resampler::Quality rsmpQuality = m_model.get().kernelAudio.rsmpQuality;
+	return m_channelManager.setStreaming(channelId, value, sampleRate, rsmpQuality);
+}
+
 /* -------------------------------------------------------------------------- */
 
 void ChannelsApi::remove(ID channelId)
@@ -156,26 +163,26 @@ void ChannelsApi::move(ID channelId, ID columnId, int position)
 
 /* -------------------------------------------------------------------------- */
 
-void ChannelsApi::press(ID channelId, int velocity)
+void ChannelsApi::press(ID channelId, int velocity, Frame localFrame)
 {
 	const bool  canRecordActions = m_recorder.canRecordActions();
 	const bool  canQuantize      = m_sequencer.canQuantize();
 	const Frame currentFrameQ    = m_sequencer.getCurrentFrameQuantized();
-	m_channelManager.keyPress(channelId, velocity, canRecordActions, canQuantize, currentFrameQ);
+	m_channelManager.keyPress(channelId, velocity, canRecordActions, canQuantize, currentFrameQ, localFrame);
 }
 
-void ChannelsApi::release(ID channelId)
+void ChannelsApi::release(ID channelId, Frame localFrame)
 {
 	const bool  canRecordActions = m_recorder.canRecordActions();
 	const Frame currentFrameQ    = m_sequencer.getCurrentFrameQuantized();
-	m_channelManager.keyRelease(channelId, canRecordActions, currentFrameQ);
+	m_channelManager.keyRelease(channelId, canRecordActions, currentFrameQ, localFrame);
 }
 
-void ChannelsApi::kill(ID channelId)
+void ChannelsApi::kill(ID channelId, Frame localFrame)
 {
 	const bool  canRecordActions = m_recorder.canRecordActions();
 	const Frame currentFrameQ    = m_sequencer.getCurrentFrameQuantized();
-	m_channelManager.keyKill(channelId, canRecordActions, currentFrameQ);
+	m_channelManager.keyKill(channelId, canRecordActions, currentFrameQ, localFrame);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -63,15 +63,20 @@ public:
 	int      loadSampleChannel(ID channelId, const std::string& filePath);
 	void     loadSampleChannel(ID channelId, Wave&);
 	void     loadPreviewChannel(ID sourceChannelId);
+	int      setStreaming(ID channelId, bool value);
 	void     remove(ID);
 	void     freeSampleChannel(ID);
 	void     freePreviewChannel();
 	void     clone(ID);
 	void     move(ID channelId, ID columnId, int position);
 
-	void press(ID, int velocity);
-	void release(ID);
-	void kill(ID);
+	/* press, release, kill
+	Manual events on a channel. 'localFrame' is the offset in the next audio 
+	block the event should take effect at (e.g. for timestamped MIDI input). */
+
+	void press(ID, int velocity, Frame localFrame = 0);
+	void release(ID, Frame localFrame = 0);
+	void kill(ID, Frame localFrame = 0);
 	void setVolume(ID, float);
 	void setPitch(ID, float);
 	void setPan(ID, float);
@@ -27,19 +27,21 @@
 #include "mainApi.h"
 #include "core/channels/channelManager.h"
 #include "core/engine.h"
+#include "core/eventDispatcher.h"
 #include "core/kernelAudio.h"
-#include "core/midiSynchronizer.h"
 #include "core/mixer.h"
+#include "utils/log.h"
 
 namespace giada::m
 {
-MainApi::MainApi(KernelAudio& ka, Mixer& m, Sequencer& s, MidiSynchronizer& ms, ChannelManager& cm, Recorder& r)
+MainApi::MainApi(KernelAudio& ka, Mixer& m, Sequencer& s, ChannelManager& cm, Recorder& r, Profiler& p, EventDispatcher& ed)
 : m_kernelAudio(ka)
 , m_mixer(m)
 , m_sequencer(s)
-, m_midiSynchronizer(ms)
 , m_channelManager(cm)
 , m_recorder(r)
+, m_profiler(p)
+, m_eventDispatcher(ed)
 {
 }
 
@@ -99,6 +101,16 @@ Peak MainApi::getPeakIn() const { return m_mixer.getPeakIn(); }
 
 /* -------------------------------------------------------------------------- */
 
+float MainApi::getDspLoad() const { return m_kernelAudio.getDspLoad(); }
+float MainApi::getDspLoadPeak() const { return m_kernelAudio.getDspLoadPeak(); }
+int   MainApi::countXruns() const { return m_kernelAudio.countXruns(); }
+
+const std::vector<KernelAudio::Xrun>& MainApi::getXruns() { return m_kernelAudio.getXruns(); }
+
+int MainApi::countDroppedEvents() const { return m_eventDispatcher.countDroppedEvents(); }
+
+/* -------------------------------------------------------------------------- */
+
 Mixer::RecordInfo MainApi::getRecordInfo() const
 {
 	return m_mixer.getRecordInfo();
@@ -201,7 +213,6 @@ void MainApi::setBpm(float bpm)
 	if (m_mixer.isRecordingInput())
 		return;
 	m_sequencer.setBpm(bpm, m_kernelAudio.getSampleRate());
-	m_midiSynchronizer.setClockBpm(bpm);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -299,4 +310,22 @@ void MainApi::startActionRecOnCallback()
 {
 	m_recorder.startActionRecOnCallback();
 }
+
+/* -------------------------------------------------------------------------- */
+
+bool MainApi::isProfilingEnabled() const
+{
+	return m_profiler.isEnabled();
+}
+
+std::vector<Profiler::Stats> MainApi::getProfilerStats() const
+{
+	return m_profiler.getStats();
+}
+
+void MainApi::setProfilingEnabled(bool v)
+{
+	m_profiler.setEnabled(v);
+	u::log::print("[MainApi::setProfilingEnabled] profiling %s\n", v ? "enabled" : "disabled");
+}
 } // namespace giada::m
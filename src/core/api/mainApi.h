@@ -27,20 +27,21 @@
 #ifndef G_MAIN_API_H
 #define G_MAIN_API_H
 
+#include "core/kernelAudio.h"
 #include "core/mixer.h"
+#include "core/profiler.h"
 
 namespace giada::m
 {
 class Engine;
-class KernelAudio;
+class EventDispatcher;
 class Sequencer;
-class MidiSynchronizer;
 class ChannelManager;
 class Recorder;
 class MainApi
 {
 public:
-	MainApi(KernelAudio&, Mixer&, Sequencer&, MidiSynchronizer&, ChannelManager&, Recorder&);
+	MainApi(KernelAudio&, Mixer&, Sequencer&, ChannelManager&, Recorder&, Profiler&, EventDispatcher&);
 
 	bool              isRecordingInput() const;
 	bool              isRecordingActions() const;
@@ -51,6 +52,9 @@ public:
 	bool              getInToOut() const;
 	Peak              getPeakOut() const;
 	Peak              getPeakIn() const;
+	float             getDspLoad() const;
+	float             getDspLoadPeak() const;
+	int               countXruns() const;
 	Mixer::RecordInfo getRecordInfo() const;
 	int               getBeats() const;
 	int               getBars() const;
@@ -63,6 +67,24 @@ public:
 	int               getFramesInSeq() const;
 	int               getFramesInBeat() const;
 	SeqStatus         getSequencerStatus() const;
+	bool              isProfilingEnabled() const;
+
+	/* getProfilerStats
+	Returns min/mean/p99/max timings for each audio callback stage and each
+	channel, collected so far. Empty if profiling is disabled. */
+
+	std::vector<Profiler::Stats> getProfilerStats() const;
+
+	/* getXruns
+	Returns the latest over/underflows reported by the audio driver. */
+
+	const std::vector<KernelAudio::Xrun>& getXruns();
+
+	/* countDroppedEvents
+	Returns the number of engine events (e.g. JACK transport changes) dropped so
+	far because the event queue was full. */
+
+	int countDroppedEvents() const;
 
 	void toggleMetronome();
 	void setMasterInVolume(float);
@@ -85,14 +107,16 @@ public:
 	void stopInputRecording();
 	void toggleInputRecording();
 	void startActionRecOnCallback();
+	void setProfilingEnabled(bool);
 
 private:
-	KernelAudio&      m_kernelAudio;
-	Mixer&            m_mixer;
-	Sequencer&        m_sequencer;
-	MidiSynchronizer& m_midiSynchronizer;
-	ChannelManager&   m_channelManager;
-	Recorder&         m_recorder;
+	KernelAudio&     m_kernelAudio;
+	Mixer&           m_mixer;
+	Sequencer&       m_sequencer;
+	ChannelManager&  m_channelManager;
+	Recorder&        m_recorder;
+	Profiler&        m_profiler;
+	EventDispatcher& m_eventDispatcher;
 };
 } // namespace giada::m
 
@@ -142,9 +142,10 @@ void PluginsApi::scan(const std::string& dir, const std::function<void(float)>&
 
 /* -------------------------------------------------------------------------- */
 
-void PluginsApi::process(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins, juce::MidiBuffer* events)
+void PluginsApi::process(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins, juce::MidiBuffer* events,
+    juce::AudioBuffer<float>* workBuf)
 {
-	m_pluginHost.processStack(outBuf, plugins, events);
+	m_pluginHost.processStack(outBuf, plugins, events, workBuf);
 }
 
 /* -------------------------------------------------------------------------- */
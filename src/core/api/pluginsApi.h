@@ -61,7 +61,8 @@ public:
 	void setParameter(ID pluginId, int paramIndex, float value);
 
 	void scan(const std::string& dir, const std::function<void(float)>& progress);
-	void process(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>&, juce::MidiBuffer* events = nullptr);
+	void process(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>&, juce::MidiBuffer* events = nullptr,
+	    juce::AudioBuffer<float>* workBuf = nullptr);
 
 	const Patch::Plugin     serialize(const Plugin&) const;
 	std::unique_ptr<Plugin> deserialize(const Patch::Plugin&);
@@ -33,6 +33,23 @@
 
 namespace giada::m
 {
+namespace
+{
+/* resetBeginEnd_
+Same as ChannelManager::resetBeginEnd(), for a channel being edited through 
+ChannelManager::editWave(). */
+
+void resetBeginEnd_(Channel& ch)
+{
+	ch.samplePlayer->begin = 0;
+	ch.samplePlayer->end   = ch.samplePlayer->getWaveSize();
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 SampleEditorApi::SampleEditorApi(KernelAudio& k, model::Model& m, ChannelManager& cm)
 : m_kernelAudio(k)
 , m_model(m)
@@ -45,9 +62,10 @@ SampleEditorApi::SampleEditorApi(KernelAudio& k, model::Model& m, ChannelManager
 void SampleEditorApi::cut(ID channelId, Frame a, Frame b)
 {
 	copy(channelId, a, b);
-	model::DataLock lock = m_model.lockData();
-	wfx::cut(getWave(channelId), a, b);
-	resetBeginEnd(channelId);
+	m_channelManager.editWave(channelId, [a, b](Wave& wave, Channel& ch) {
+		wfx::cut(wave, a, b);
+		resetBeginEnd_(ch);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -67,89 +85,78 @@ void SampleEditorApi::paste(ID channelId, Frame a)
 		return;
 	}
 
-	/* Get the existing wave in channel. */
+	/* Paste copied data to a copy of the existing wave in channel, then just
+	brutally restore begin/end points. */
 
-	Wave& wave = getWave(channelId);
-
-	/* Temporary disable wave reading in channel. From now on, the audio
-	    thread won't be reading any wave, so editing it is safe.  */
-
-	model::DataLock lock = m_model.lockData();
-
-	/* Paste copied data to destination wave. */
-
-	wfx::paste(*m_waveBuffer, wave, a);
-
-	/* Pass the old wave that contains the pasted data to channel. */
-
-	m_channelManager.getChannel(channelId).samplePlayer->setWave(&wave, 1.0f);
-
-	/* Just brutally restore begin/end points. */
-
-	resetBeginEnd(channelId);
+	m_channelManager.editWave(channelId, [this, a](Wave& wave, Channel& ch) {
+		wfx::paste(*m_waveBuffer, wave, a);
+		resetBeginEnd_(ch);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::silence(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::silence(getWave(channelId), a, b);
+	m_channelManager.editWave(channelId, [a, b](Wave& wave, Channel&) {
+		wfx::silence(wave, a, b);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::fade(ID channelId, Frame a, Frame b, wfx::Fade type)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::fade(getWave(channelId), a, b, type);
+	m_channelManager.editWave(channelId, [a, b, type](Wave& wave, Channel&) {
+		wfx::fade(wave, a, b, type);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::smoothEdges(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::smooth(getWave(channelId), a, b);
+	m_channelManager.editWave(channelId, [a, b](Wave& wave, Channel&) {
+		wfx::smooth(wave, a, b);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::reverse(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::reverse(getWave(channelId), a, b);
+	m_channelManager.editWave(channelId, [a, b](Wave& wave, Channel&) {
+		wfx::reverse(wave, a, b);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::normalize(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::normalize(getWave(channelId), a, b);
+	m_channelManager.editWave(channelId, [a, b](Wave& wave, Channel&) {
+		wfx::normalize(wave, a, b);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::trim(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::trim(getWave(channelId), a, b);
-	resetBeginEnd(channelId);
+	m_channelManager.editWave(channelId, [a, b](Wave& wave, Channel& ch) {
+		wfx::trim(wave, a, b);
+		resetBeginEnd_(ch);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::shift(ID channelId, Frame offset)
 {
-	const Channel&      ch           = m_channelManager.getChannel(channelId);
-	const SamplePlayer& samplePlayer = ch.samplePlayer.value();
-	const Frame         oldShift     = samplePlayer.shift;
-
-	m::model::DataLock lock = m_model.lockData();
-	m::wfx::shift(getWave(channelId), offset - oldShift);
-	// Model has been swapped by DataLock constructor, needs to get Channel again
-	m_channelManager.getChannel(channelId).samplePlayer->shift = offset;
+	m_channelManager.editWave(channelId, [offset](Wave& wave, Channel& ch) {
+		m::wfx::shift(wave, offset - ch.samplePlayer->shift);
+		ch.samplePlayer->shift = offset;
+	});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -34,6 +34,10 @@
 #include "core/waveFactory.h"
 #include "utils/fs.h"
 #include "utils/log.h"
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <unordered_set>
 
 namespace giada::m
 {
@@ -48,7 +52,7 @@ bool StorageApi::LoadState::isGood() const
 
 StorageApi::StorageApi(Engine& e, model::Model& m, Patch& p, PluginManager& pm,
     MidiSynchronizer& ms, Mixer& mx, ChannelManager& cm, KernelAudio& ka, Sequencer& s,
-    ActionRecorder& ar)
+    ActionRecorder& ar, OfflineRenderer& r)
 : m_engine(e)
 , m_model(m)
 , m_patch(p)
@@ -59,7 +63,13 @@ StorageApi::StorageApi(Engine& e, model::Model& m, Patch& p, PluginManager& pm,
 , m_kernelAudio(ka)
 , m_sequencer(s)
 , m_actionRecorder(ar)
+, m_offlineRenderer(r)
+, m_pendingRatio(1.0f)
 {
+	m_waveLoader.onLoaded = [this]() {
+		assert(onWavesLoaded != nullptr);
+		onWavesLoaded();
+	};
 }
 
 /* -------------------------------------------------------------------------- */
@@ -69,6 +79,11 @@ bool StorageApi::storeProject(const std::string& projectName, const std::string&
 {
 	progress(0.0f);
 
+	/* Waves still being loaded in background are not in the model yet: wait 
+	for them, otherwise their channels would be saved as empty. */
+
+	finishLoading();
+
 	if (!u::fs::mkdir(projectPath))
 	{
 		u::log::print("[StorageApi::storeProject] Unable to make project directory!\n");
@@ -77,14 +92,9 @@ bool StorageApi::storeProject(const std::string& projectName, const std::string&
 
 	u::log::print("[StorageApi::storeProject] Project dir created: %s\n", projectPath);
 
-	/* Update all existing file paths in Waves, so that they point to the project
-	folder they belong to. */
-
-	for (std::unique_ptr<Wave>& w : m_model.getAllShared<model::WavePtrs>())
-	{
-		w->setPath(waveFactory::makeUniqueWavePath(projectPath, *w, m_model.getAllShared<model::WavePtrs>()));
-		waveFactory::save(*w, w->getPath()); // TODO - error checking
-	}
+	std::vector<std::string> replaced;
+	if (!storeWaves(projectPath, replaced))
+		return false;
 
 	progress(0.3f);
 
@@ -101,6 +111,17 @@ bool StorageApi::storeProject(const std::string& projectName, const std::string&
 
 	u::log::print("[StorageApi::storeProject] Project patch saved as %s\n", patchPath);
 
+	/* The new patch no longer points to the files that have been converted: 
+	remove them. Done last, so that a failed save leaves the old project 
+	intact. */
+
+	for (const std::string& path : replaced)
+	{
+		std::error_code ec;
+		if (std::filesystem::remove(path, ec))
+			u::log::print("[StorageApi::storeProject] Replaced file %s removed\n", path);
+	}
+
 	progress(1.0f);
 
 	return true;
@@ -129,11 +150,19 @@ StorageApi::LoadState StorageApi::loadProject(const std::string& projectPath, Pl
 
 	progress(0.3f);
 
+	/* Decode the waves while the current project keeps playing: this is by far
+	the slowest part. With progressive loading this is left to the background
+	loader instead, started once the model is ready. */
+
+	std::vector<std::unique_ptr<Wave>> waves;
+	if (!m_model.get().behaviors.progressiveLoading)
+		waves = decodeWaves([&progress](float p) { progress(0.3f + p * 0.3f); });
+
 	/* Then suspend Mixer, reset and fill the model. */
 
 	m_mixer.disable();
 	m_engine.reset(pluginSortMethod);
-	LoadState state = loadPatch();
+	LoadState state = loadPatch(std::move(waves));
 
 	progress(0.6f);
 
@@ -158,7 +187,7 @@ StorageApi::LoadState StorageApi::loadProject(const std::string& projectPath, Pl
 
 	/* Restore MIDI clock output. */
 
-	m_midiSynchronizer.startSendClock(m_model.get().sequencer.bpm);
+	m_midiSynchronizer.startSendClock();
 
 	progress(1.0f);
 
@@ -168,6 +197,112 @@ StorageApi::LoadState StorageApi::loadProject(const std::string& projectPath, Pl
 
 /* -------------------------------------------------------------------------- */
 
+int StorageApi::bounce(const OfflineRenderer::Request& req, std::function<void(float)> progress)
+{
+	const int res = m_offlineRenderer.render(req, m_kernelAudio.getSampleRate(), m_kernelAudio.getBufferSize(), progress);
+
+	progress(1.0f);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool StorageApi::storeWaves(const std::string& projectPath, std::vector<std::string>& replaced)
+{
+	model::WavePtrs& waves     = m_model.getAllShared<model::WavePtrs>();
+	const WaveFormat preferred = m_model.get().behaviors.compressProjectAudio ? WaveFormat::FLAC : WaveFormat::WAV;
+
+	/* Waves already in the project folder keep their file name: reserve those
+	first, so that no other Wave can be written over them. */
+
+	std::unordered_set<std::string> taken;
+	std::unordered_set<ID>          inPlace;
+	for (const std::unique_ptr<Wave>& w : waves)
+		if (w->getPath() == u::fs::join(projectPath, w->getBasename(/*ext=*/true)) && taken.insert(w->getPath()).second)
+			inPlace.insert(w->id);
+
+	/* Pick what to write and where on this thread, then encode everything in
+	parallel. */
+
+	std::vector<waveFactory::SaveRequest> requests;
+	std::vector<Wave*>                    toSave;
+	for (auto it = waves.begin(); it != waves.end(); ++it)
+	{
+		Wave& w = **it;
+
+		/* Waves sharing their audio data are stored once, as a single file. 
+		They will share it again when the project is loaded. */
+
+		const auto twin = std::find_if(waves.begin(), it, [&w](const std::unique_ptr<Wave>& o) { return w.isSharingBuffer(*o); });
+		if (twin != it)
+			continue;
+
+		/* Skip Waves whose file in the project folder is up to date. A dirty
+		Wave might still hold the same data it was saved with: the hash tells.
+		A FLAC file is always fine, a WAV one is converted if FLAC is preferred
+		and lossless for this Wave. */
+
+		const bool inProject = inPlace.contains(w.id) && u::fs::fileExists(w.getPath());
+		const bool unchanged = inProject && (!w.isDirty() || w.computeHash() == w.getHash());
+		if (unchanged && waveFactory::getFormat(w.getPath()) == WaveFormat::FLAC)
+			continue;
+
+		const WaveFormat format = waveFactory::getSaveFormat(w, preferred);
+		if (unchanged && format == WaveFormat::WAV)
+			continue;
+
+		const std::string path = inProject && waveFactory::getFormat(w.getPath()) == format
+		                             ? w.getPath()
+		                             : waveFactory::makeUniqueWavePath(projectPath, w, taken, format);
+		taken.insert(path);
+		requests.push_back({&w, path, format});
+		toSave.push_back(&w);
+	}
+
+	const std::vector<int> results = waveFactory::saveWaves(requests);
+
+	for (std::size_t i = 0; i < requests.size(); i++)
+	{
+		if (results[i] != G_RES_OK)
+		{
+			u::log::print("[StorageApi::storeWaves] Unable to save %s\n", requests[i].path);
+			return false;
+		}
+		if (inPlace.contains(toSave[i]->id) && toSave[i]->getPath() != requests[i].path)
+			replaced.push_back(toSave[i]->getPath());
+		toSave[i]->setPath(requests[i].path);
+		toSave[i]->setHash(toSave[i]->computeHash());
+	}
+
+	/* Every Wave now matches its file. Twins take the path of the Wave they 
+	share data with, which might have just changed. */
+
+	for (auto it = waves.begin(); it != waves.end(); ++it)
+	{
+		Wave&      w    = **it;
+		const auto twin = std::find_if(waves.begin(), it, [&w](const std::unique_ptr<Wave>& o) { return w.isSharingBuffer(*o); });
+		if (twin != it)
+		{
+			w.setPath((*twin)->getPath());
+			w.setHash((*twin)->getHash());
+		}
+		w.setDirty(false);
+	}
+
+	/* Keep the files that some Wave still points to. */
+
+	std::erase_if(replaced, [&waves](const std::string& path) {
+		return std::any_of(waves.begin(), waves.end(), [&path](const std::unique_ptr<Wave>& w) { return w->getPath() == path; });
+	});
+
+	u::log::print("[StorageApi::storeWaves] %d of %d waves written\n", requests.size(), waves.size());
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void StorageApi::storePatch(const std::string& projectName, const v::Model& uiModel)
 {
 	m_patch.columns.clear();
@@ -188,7 +323,7 @@ void StorageApi::storePatch(const std::string& projectName, const v::Model& uiMo
 	for (const auto& p : m_model.getAllShared<model::PluginPtrs>())
 		m_patch.plugins.push_back(m_pluginManager.serializePlugin(*p));
 
-	m_patch.actions = actionFactory::serializeActions(m_model.getAllShared<Actions::Map>());
+	m_patch.actions = actionFactory::serializeActions(m_model.getAllShared<ActionTimeline>());
 
 	m_patch.waves.clear();
 	for (const auto& w : m_model.getAllShared<model::WavePtrs>())
@@ -201,16 +336,37 @@ void StorageApi::storePatch(const std::string& projectName, const v::Model& uiMo
 
 /* -------------------------------------------------------------------------- */
 
-StorageApi::LoadState StorageApi::loadPatch()
+std::vector<std::unique_ptr<Wave>> StorageApi::decodeWaves(std::function<void(float)> progress) const
+{
+	std::vector<std::unique_ptr<Wave>> waves(m_patch.waves.size());
+	std::size_t                        done = 0;
+
+	waveFactory::deserializeWaves(m_patch.waves, m_kernelAudio.getSampleRate(), m_model.get().kernelAudio.rsmpQuality,
+	    [&waves, &done, &progress](std::size_t i, std::unique_ptr<Wave> w) {
+		    waves[i] = std::move(w);
+		    progress(++done / static_cast<float>(waves.size()));
+	    });
+
+	return waves;
+}
+
+/* -------------------------------------------------------------------------- */
+
+StorageApi::LoadState StorageApi::loadPatch(std::vector<std::unique_ptr<Wave>> waves)
 {
 	const int   sampleRate      = m_kernelAudio.getSampleRate();
 	const int   bufferSize      = m_kernelAudio.getBufferSize();
 	const float sampleRateRatio = sampleRate / static_cast<float>(m_patch.samplerate);
+	const bool  progressive     = m_model.get().behaviors.progressiveLoading;
+
+	/* Waves decoded so far keep their patch ID: make sure no new Wave gets one
+	of them, now that the ID numbering has been reset. */
 
-	/* Lock the model's data. Real-time thread can't read from it until this method
-	goes out of scope. */
+	waveFactory::reserveIds(m_patch.waves);
 
-	model::DataLock lock = m_model.lockData(model::SwapType::NONE);
+	/* Mixer is disabled at this point (see loadProject()): the realtime thread 
+	doesn't touch channels, so the model can be filled in freely and published
+	all at once at the end. */
 
 	/* Clear and re-initialize channels first. */
 
@@ -231,13 +387,12 @@ StorageApi::LoadState StorageApi::loadPatch()
 	}
 
 	m_model.getAllShared<model::WavePtrs>().clear();
-	for (const Patch::Wave& pwave : m_patch.waves)
+	for (std::size_t i = 0; i < waves.size() && !progressive; i++)
 	{
-		std::unique_ptr<Wave> w = waveFactory::deserializeWave(pwave, sampleRate, m_model.get().kernelAudio.rsmpQuality);
-		if (w != nullptr)
-			m_model.getAllShared<model::WavePtrs>().push_back(std::move(w));
+		if (waves[i] != nullptr)
+			m_model.getAllShared<model::WavePtrs>().push_back(std::move(waves[i]));
 		else
-			state.missingWaves.push_back(pwave.path);
+			state.missingWaves.push_back(m_patch.waves[i].path);
 	}
 
 	/* Then load up channels, actions and global properties. */
@@ -245,11 +400,16 @@ StorageApi::LoadState StorageApi::loadPatch()
 	for (const Patch::Channel& pchannel : m_patch.channels)
 	{
 		channelFactory::Data data = m_engine.getChannelsApi().deserializeChannel(pchannel, sampleRateRatio, bufferSize);
+		if (progressive && pchannel.type == ChannelType::SAMPLE && pchannel.waveId != 0)
+		{
+			data.shared->playStatus.store(ChannelStatus::LOADING);
+			m_pendingChannels[pchannel.waveId].push_back(pchannel.id);
+		}
 		m_model.get().channels.add(data.channel);
 		m_model.addShared(std::move(data.shared));
 	}
 
-	m_model.getAllShared<Actions::Map>() = m_engine.getActionEditorApi().deserializeActions(m_patch.actions);
+	m_model.replaceShared(m_engine.getActionEditorApi().deserializeActions(m_patch.actions));
 
 	m_model.get().sequencer.status   = SeqStatus::STOPPED;
 	m_model.get().sequencer.bars     = m_patch.bars;
@@ -257,6 +417,106 @@ StorageApi::LoadState StorageApi::loadPatch()
 	m_model.get().sequencer.bpm      = m_patch.bpm;
 	m_model.get().sequencer.quantize = m_patch.quantize;
 
+	m_model.swap(model::SwapType::NONE);
+
+	if (progressive && !m_patch.waves.empty())
+		startLoading(sampleRateRatio);
+
+	return state;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StorageApi::startLoading(float sampleRateRatio)
+{
+	m_pendingRatio = sampleRateRatio;
+	m_pendingMissing.clear();
+	m_waveLoader.start(m_patch.waves, m_kernelAudio.getSampleRate(), m_model.get().kernelAudio.rsmpQuality);
+}
+
+/* -------------------------------------------------------------------------- */
+
+StorageApi::LoadState StorageApi::attachLoadedWaves()
+{
+	std::vector<WaveLoader::Loaded> loaded = m_waveLoader.take();
+	if (loaded.empty())
+		return {};
+
+	std::vector<ChannelShared*> ready;
+	std::vector<ChannelShared*> failed;
+
+	for (auto& [index, wave] : loaded)
+	{
+		const Patch::Wave& pwave = m_waveLoader.getWave(index);
+		const auto         it    = m_pendingChannels.find(pwave.id);
+
+		if (wave == nullptr)
+		{
+			u::log::print("[StorageApi::attachLoadedWaves] Unable to load wave %s\n", pwave.path);
+			m_pendingMissing.push_back(pwave.path);
+		}
+
+		if (it != m_pendingChannels.end())
+		{
+			/* Some channels might have been deleted or given another sample in 
+			the meantime: skip them. */
+
+			const std::vector<ID>& ids      = it->second;
+			std::vector<Channel*>  channels = m_model.get().channels.getIf([&ids](const Channel& c) {
+				return c.shared->playStatus.load() == ChannelStatus::LOADING &&
+				       std::find(ids.begin(), ids.end(), c.id) != ids.end();
+			});
+
+			for (Channel* ch : channels)
+			{
+				if (wave != nullptr)
+				{
+					ch->samplePlayer->setWave(wave.get(), m_pendingRatio);
+					ready.push_back(ch->shared);
+				}
+				else
+					failed.push_back(ch->shared);
+			}
+			m_pendingChannels.erase(it);
+		}
+
+		if (wave != nullptr)
+			m_model.addShared(std::move(wave));
+	}
+
+	m_model.swap(model::SwapType::HARD);
+
+	/* Channels become playable only now that the audio thread sees their 
+	Wave. */
+
+	for (ChannelShared* shared : ready)
+		shared->playStatus.store(ChannelStatus::OFF);
+	for (ChannelShared* shared : failed)
+		shared->playStatus.store(ChannelStatus::MISSING);
+
+	/* Report the missing Waves all together, once the last one is in. */
+
+	LoadState state;
+	if (m_waveLoader.isDone())
+		state.missingWaves = std::move(m_pendingMissing);
+	m_pendingMissing.clear();
 	return state;
 }
+
+/* -------------------------------------------------------------------------- */
+
+StorageApi::LoadState StorageApi::finishLoading()
+{
+	m_waveLoader.wait();
+	return attachLoadedWaves();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StorageApi::cancelLoading()
+{
+	m_waveLoader.cancel();
+	m_pendingChannels.clear();
+	m_pendingMissing.clear();
+}
 } // namespace giada::m
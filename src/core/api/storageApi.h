@@ -28,10 +28,14 @@
 #define G_STORAGE_API_H
 
 #include "core/model/model.h"
+#include "core/offlineRenderer.h"
 #include "core/types.h"
+#include "core/waveLoader.h"
 #include "gui/model.h"
 #include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace giada::m
@@ -56,7 +60,8 @@ public:
 	};
 
 	StorageApi(Engine&, model::Model&, Patch&, PluginManager&, MidiSynchronizer&,
-	    Mixer&, ChannelManager&, KernelAudio&, Sequencer&, ActionRecorder&);
+	    Mixer&, ChannelManager&, KernelAudio&, Sequencer&, ActionRecorder&,
+	    OfflineRenderer&);
 
 	/* storeProject
 	Saves the current project. Returns true on success. */
@@ -70,9 +75,65 @@ public:
 
 	LoadState loadProject(const std::string& projectPath, PluginManager::SortMethod, std::function<void(float)> progress);
 
+	/* bounce
+	Renders the master output and/or some channels to audio files, faster than
+	realtime. See OfflineRenderer::Request for the details. Returns G_RES_OK on
+	success or an error code. */
+
+	int bounce(const OfflineRenderer::Request&, std::function<void(float)> progress);
+
+	/* attachLoadedWaves
+	Progressive loading only: hands the Waves decoded so far in background to
+	the channels waiting for them. Must be called on the main thread. Once the
+	last Wave is in, the returned LoadState lists those that failed to load. */
+
+	LoadState attachLoadedWaves();
+
+	/* finishLoading
+	Progressive loading only: waits for all Waves to be decoded and attaches 
+	them to their channels. Returns the same as attachLoadedWaves(). */
+
+	LoadState finishLoading();
+
+	/* cancelLoading
+	Progressive loading only: stops decoding Waves in background and forgets 
+	about those not yet attached. */
+
+	void cancelLoading();
+
+	/* onWavesLoaded
+	Callback fired by the background loader when new Waves are ready to be
+	attached. Called on a non-main thread. */
+
+	std::function<void()> onWavesLoaded;
+
 private:
-	void      storePatch(const std::string& projectName, const v::Model&);
-	LoadState loadPatch();
+	void storePatch(const std::string& projectName, const v::Model&);
+
+	/* decodeWaves
+	Decodes and resamples all Waves in the current patch, in parallel, without
+	touching the model. Returns one Wave for each Patch::Wave, nullptr if it 
+	couldn't be loaded. */
+
+	std::vector<std::unique_ptr<Wave>> decodeWaves(std::function<void(float)> progress) const;
+
+	/* loadPatch
+	Fills the model with the current patch and the Waves from decodeWaves() 
+	(none with progressive loading). The Mixer must be disabled. */
+
+	LoadState loadPatch(std::vector<std::unique_ptr<Wave>> waves);
+
+	/* storeWaves
+	Writes the Waves into the project folder. Files that have been replaced by
+	a new one (e.g. WAV converted to FLAC) are added to 'replaced', to be 
+	removed once the patch is saved. */
+
+	bool storeWaves(const std::string& projectPath, std::vector<std::string>& replaced);
+
+	/* startLoading
+	Spawns the background loader for the Waves in the current patch. */
+
+	void startLoading(float sampleRateRatio);
 
 	Engine&           m_engine;
 	model::Model&     m_model;
@@ -84,6 +145,16 @@ private:
 	KernelAudio&      m_kernelAudio;
 	Sequencer&        m_sequencer;
 	ActionRecorder&   m_actionRecorder;
+	OfflineRenderer&  m_offlineRenderer;
+
+	/* Progressive loading state. Waves are decoded by m_waveLoader, everything
+	else belongs to the main thread. m_pendingMissing collects the paths of the
+	Waves that failed to load, reported all together at the end. */
+
+	WaveLoader                              m_waveLoader;
+	std::unordered_map<ID, std::vector<ID>> m_pendingChannels; // Wave ID -> channel IDs
+	std::vector<std::string>                m_pendingMissing;
+	float                                   m_pendingRatio;
 };
 } // namespace giada::m
 
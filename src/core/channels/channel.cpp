@@ -28,37 +28,22 @@
 #include "core/actions/actionRecorder.h"
 #include "core/channels/sampleAdvancer.h"
 #include "core/conf.h"
+#include "core/dsp.h"
 #include "core/engine.h"
 #include "core/midiMapper.h"
 #include "core/model/model.h"
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
+#include "core/profiler.h"
 #include "core/recorder.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 
 extern giada::m::Engine g_engine;
 
 namespace giada::m
 {
-namespace
-{
-mcl::AudioBuffer::Pan calcPanning_(float pan)
-{
-	/* TODO - precompute the AudioBuffer::Pan when pan value changes instead of
-	building it on the fly. */
-
-	/* Center pan (0.5f)? Pass-through. */
-
-	if (pan == 0.5f)
-		return {1.0f, 1.0f};
-	return {1.0f - pan, pan};
-}
-} // namespace
-
-/* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
-
 Channel::Channel(ChannelType type, ID id, ID columnId, int position, ChannelShared& s)
 : shared(&s)
 , id(id)
@@ -72,6 +57,7 @@ Channel::Channel(ChannelType type, ID id, ID columnId, int position, ChannelShar
 , key(0)
 , hasActions(false)
 , height(G_GUI_UNIT)
+, locked(false)
 , midiLighter(g_engine.getMidiMapper())
 , m_mute(false)
 , m_solo(false)
@@ -122,6 +108,7 @@ Channel::Channel(const Patch::Channel& p, ChannelShared& s, float samplerateRati
 , name(p.name)
 , height(p.height)
 , plugins(plugins)
+, locked(false)
 , midiLearner(p)
 , midiLighter(g_engine.getMidiMapper(), p)
 , m_mute(p.mute)
@@ -129,6 +116,8 @@ Channel::Channel(const Patch::Channel& p, ChannelShared& s, float samplerateRati
 {
 	shared->readActions.store(p.readActions);
 	shared->recStatus.store(p.readActions ? ChannelStatus::PLAY : ChannelStatus::OFF);
+	shared->volume.reset(volume);
+	shared->pan.reset(pan);
 
 	switch (type)
 	{
@@ -156,6 +145,9 @@ Channel::Channel(const Patch::Channel& p, ChannelShared& s, float samplerateRati
 		break;
 	}
 
+	if (samplePlayer)
+		shared->pitch.reset(samplePlayer->pitch);
+
 	initCallbacks();
 }
 
@@ -190,6 +182,7 @@ Channel& Channel::operator=(const Channel& other)
 	name       = other.name;
 	height     = other.height;
 	plugins    = other.plugins;
+	locked     = other.locked;
 
 	midiLearner          = other.midiLearner;
 	midiLighter          = other.midiLighter;
@@ -333,9 +326,9 @@ void Channel::advance(const Sequencer::EventBuffer& events, Range<Frame> block,
 
 void Channel::render(mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool mixerHasSolos, bool seqIsRunning) const
 {
-	if (id == Mixer::MASTER_OUT_CHANNEL_ID)
-		renderMasterOut(*out);
-	else if (id == Mixer::MASTER_IN_CHANNEL_ID)
+	assert(id != Mixer::MASTER_OUT_CHANNEL_ID);
+
+	if (id == Mixer::MASTER_IN_CHANNEL_ID)
 		renderMasterIn(*in);
 	else
 		renderChannel(*out, *in, mixerHasSolos, seqIsRunning);
@@ -343,12 +336,13 @@ void Channel::render(mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool mixerHasS
 
 /* -------------------------------------------------------------------------- */
 
-void Channel::renderMasterOut(mcl::AudioBuffer& out) const
+void Channel::renderMasterOut(mcl::AudioBuffer& out, SmoothedParam::Ramp vol) const
 {
-	shared->audioBuffer.set(out, /*gain=*/1.0f);
+	dsp::set(shared->audioBuffer, out, /*gain=*/1.0f);
 	if (plugins.size() > 0)
 		g_engine.getPluginsApi().process(shared->audioBuffer, plugins, nullptr);
-	out.set(shared->audioBuffer, volume);
+	out.clear();
+	dsp::sum(out, shared->audioBuffer, vol);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -363,10 +357,40 @@ void Channel::renderMasterIn(mcl::AudioBuffer& in) const
 
 void Channel::renderChannel(mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool mixerHasSolos, bool seqIsRunning) const
 {
+	renderBuffer(in, seqIsRunning);
+	mixBuffer(out, mixerHasSolos);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Channel::renderBuffer(mcl::AudioBuffer& in, bool seqIsRunning, bool profile) const
+{
+	if (profile)
+		shared->pluginsTime = 0;
+
+	/* Locked channels are skipped, here and in mixBuffer(): another thread is
+	changing their data in place (e.g. a streamed Wave). */
+
+	if (locked)
+		return;
+
+	/* An idle channel with nothing new coming in keeps its silent buffer: skip
+	rendering and the plug-in stack altogether. */
+
+	const bool input = hasInput();
+	if (!input && shared->idleTracker.isIdle())
+		return;
+	shared->idleTracker.wake();
+
 	shared->audioBuffer.clear();
 
 	if (samplePlayer && isPlaying())
 	{
+		/* Pairs with the fence in SampleReactor::play(): a channel seen playing
+		also has its Render in the queue. */
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
 		SamplePlayer::Render render;
 		while (shared->renderQueue->pop(render))
 			;
@@ -380,12 +404,44 @@ void Channel::renderChannel(mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool mi
 	contain plug-ins that take MIDI events (i.e. synths). Otherwise process the
 	plug-in stack internally with no MIDI events. */
 
+	const Profiler::Time pluginsStart = profile ? Profiler::now() : Profiler::Time();
+
 	if (midiReceiver)
 		midiReceiver->render(*shared, plugins, g_engine.getPluginHost());
 	else if (plugins.size() > 0)
-		g_engine.getPluginsApi().process(shared->audioBuffer, plugins, nullptr);
+		g_engine.getPluginsApi().process(shared->audioBuffer, plugins, nullptr, &shared->pluginBuffer);
+
+	if (profile)
+		shared->pluginsTime = Profiler::elapsed(pluginsStart);
+
+	shared->idleTracker.update(input, shared->audioBuffer, [this]() {
+		return plugins.empty() ? 0 : g_engine.getPluginHost().getTailFrames(plugins);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Channel::mixBuffer(mcl::AudioBuffer& out, bool mixerHasSolos) const
+{
+	/* Always advance the smoothed parameters, even if the channel is not 
+	audible, so that they don't ramp from a stale value when it gets back. */
+
+	const SmoothedParam::Ramp volRamp = shared->volume.advance_RT();
+	const SmoothedParam::Ramp panRamp = shared->pan.advance_RT();
+
+	if (isAudible(mixerHasSolos) && !shared->idleTracker.isIdle() && !locked)
+		dsp::sum(out, shared->audioBuffer, {volRamp.from * volume_i, volRamp.to * volume_i}, panRamp);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Channel::hasInput() const
+{
+	/* A playing MIDI channel is never idle: a held note might produce silence
+	just for a while. */
 
-	if (isAudible(mixerHasSolos))
-		out.sum(shared->audioBuffer, volume * volume_i, calcPanning_(pan));
+	return (samplePlayer && isPlaying()) ||
+	       (audioReceiver && armed && audioReceiver->inputMonitor) ||
+	       (midiReceiver && (isPlaying() || !shared->midiQueue.isEmpty()));
 }
 } // namespace giada::m
\ No newline at end of file
@@ -47,6 +47,7 @@
 #include "core/queue.h"
 #include "core/resampler.h"
 #include "core/sequencer.h"
+#include "core/smoothedParam.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include <optional>
 
@@ -72,10 +73,27 @@ public:
 	void advance(const Sequencer::EventBuffer&, Range<Frame>, Frame quantizerStep) const;
 
 	/* render
-	Renders audio data to I/O buffers. */
+	Renders audio data to I/O buffers. Not for the master output channel: see
+	renderMasterOut(). */
 
 	void render(mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool mixerHasSolos, bool seqIsRunning) const;
 
+	/* renderMasterOut
+	Processes the output buffer through the master plug-in stack, applying the
+	master output volume. The Mixer owns the volume ramp, as it also uses it 
+	later on in the block. */
+
+	void renderMasterOut(mcl::AudioBuffer& out, SmoothedParam::Ramp vol) const;
+
+	/* renderBuffer, mixBuffer
+	The two halves of render() for non-internal channels. renderBuffer() fills
+	the internal shared buffer, mixBuffer() sums it into the output buffer with
+	volume and panning applied. Splitting them allows the Mixer to render
+	channels concurrently while still mixing them in a deterministic order. */
+
+	void renderBuffer(mcl::AudioBuffer& in, bool seqIsRunning, bool profile = false) const;
+	void mixBuffer(mcl::AudioBuffer& out, bool mixerHasSolos) const;
+
 	bool isPlaying() const;
 	bool isInternal() const;
 	bool isMuted() const;
@@ -84,6 +102,12 @@ public:
 	bool canActionRec() const;
 	bool hasWave() const;
 
+	/* hasInput
+	True if something is feeding the channel in this block: a playing sample,
+	the monitored audio input or MIDI events. */
+
+	bool hasInput() const;
+
 	/* isAudible
 	True if this channel is currently audible: not muted or not included in a 
 	solo session. */
@@ -108,6 +132,12 @@ public:
 	Pixel                height;
 	std::vector<Plugin*> plugins;
 
+	/* locked
+	If true, the channel is neither advanced nor rendered: another thread is 
+	editing its shared data in place. See model::DataLock. */
+
+	bool locked;
+
 	MidiLearner             midiLearner;
 	MidiLighter<KernelMidi> midiLighter;
 
@@ -122,7 +152,6 @@ public:
 	std::optional<MidiActionRecorder>   midiActionRecorder;
 
 private:
-	void renderMasterOut(mcl::AudioBuffer&) const;
 	void renderMasterIn(mcl::AudioBuffer&) const;
 	void renderChannel(mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool mixerHasSolos, bool seqIsRunning) const;
 
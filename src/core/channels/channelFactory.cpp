@@ -102,6 +102,11 @@ Data create(const Channel& o, int bufferSize, Resampler::Quality quality)
 	ch.id     = channelId_.generate();
 	ch.shared = shared.get();
 
+	shared->volume.reset(o.volume);
+	shared->pan.reset(o.pan);
+	if (o.samplePlayer)
+		shared->pitch.reset(o.samplePlayer->pitch);
+
 	c::channel::setCallbacks(ch); // UI callbacks
 
 	return {ch, std::move(shared)};
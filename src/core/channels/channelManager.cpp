@@ -111,6 +111,20 @@ Channel& ChannelManager::addChannel(ChannelType type, ID columnId, int position,
 
 int ChannelManager::loadSampleChannel(ID channelId, const std::string& fname, int sampleRate, Resampler::Quality quality)
 {
+	/* The same file might be loaded in another channel already: share its 
+	audio data instead of decoding it again. */
+
+	for (const std::unique_ptr<Wave>& w : m_model.getAllShared<model::WavePtrs>())
+	{
+		if (w->getPath() != fname || w->getRate() != sampleRate || w->isLogical() || w->isEdited() || w->isStreamed())
+			continue;
+		std::unique_ptr<Wave> wave = waveFactory::createFromWave(*w);
+		wave->setLogical(false);
+		m_model.addShared(std::move(wave));
+		loadSampleChannel(channelId, m_model.backShared<Wave>());
+		return G_RES_OK;
+	}
+
 	waveFactory::Result res = waveFactory::createFromFile(fname, /*id=*/0, sampleRate, quality);
 	if (res.status != G_RES_OK)
 		return res.status;
@@ -132,8 +146,8 @@ void ChannelManager::loadSampleChannel(ID channelId, Wave& wave)
 	loadSampleChannel(channel, &newWave);
 	m_model.swap(model::SwapType::HARD);
 
-	/* Remove the old Wave, if any. It is safe to do it now: the audio thread is 
-	already processing the new layout. */
+	/* Remove the old Wave, if any. The model frees it as soon as the audio 
+	thread is done with the old layout. */
 
 	if (oldWave != nullptr)
 		m_model.removeShared<Wave>(*oldWave);
@@ -143,6 +157,70 @@ void ChannelManager::loadSampleChannel(ID channelId, Wave& wave)
 
 /* -------------------------------------------------------------------------- */
 
+int ChannelManager::setStreaming(ID channelId, bool value, int sampleRate, Resampler::Quality quality)
+{
+	Channel& ch = m_model.get().channels.get(channelId);
+
+	assert(ch.samplePlayer && ch.samplePlayer->hasWave());
+
+	const Wave* oldWave = ch.samplePlayer->getWave();
+
+	if (oldWave->isStreamed() == value)
+		return G_RES_OK;
+	if (oldWave->isLogical() || oldWave->isEdited())
+		return G_RES_ERR_WRONG_DATA;
+
+	waveFactory::Result res = waveFactory::createFromFile(oldWave->getPath(), /*id=*/0, sampleRate, quality, value);
+	if (res.status != G_RES_OK)
+		return res.status;
+
+	const Frame begin = ch.samplePlayer->begin;
+	const Frame end   = ch.samplePlayer->end;
+	const Frame shift = ch.samplePlayer->shift;
+
+	m_model.addShared(std::move(res.wave));
+	ch.samplePlayer->loadWave(*ch.shared, &m_model.backShared<Wave>(), begin, end, shift);
+	m_model.swap(model::SwapType::HARD);
+
+	/* Safe to remove the old Wave now, same as in loadSampleChannel(). */
+
+	m_model.removeShared<Wave>(*oldWave);
+
+	triggerOnChannelsAltered();
+
+	return G_RES_OK;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ChannelManager::editWave(ID channelId, std::function<void(Wave&, Channel&)> f)
+{
+	Channel&    ch      = m_model.get().channels.get(channelId);
+	const Wave* oldWave = ch.samplePlayer->getWave();
+
+	assert(oldWave != nullptr && !oldWave->isStreamed());
+
+	/* The copy shares the audio data with the current Wave until written: the
+	audio thread keeps reading untouched data. */
+
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(*oldWave);
+	wave->setLogical(oldWave->isLogical());
+	wave->setEdited(oldWave->isEdited());
+
+	m_model.addShared(std::move(wave));
+
+	Wave& newWave = m_model.backShared<Wave>();
+	ch.samplePlayer->setWave(&newWave, 1.0f);
+	f(newWave, ch);
+	m_model.swap(model::SwapType::HARD);
+
+	/* Safe to remove the old Wave now, same as in loadSampleChannel(). */
+
+	m_model.removeShared<Wave>(*oldWave);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void ChannelManager::cloneChannel(ID channelId, int bufferSize, const std::vector<Plugin*>& plugins)
 {
 	const Channel&           oldChannel     = m_model.get().channels.get(channelId);
@@ -280,7 +358,7 @@ void ChannelManager::finalizeInputRec(const mcl::AudioBuffer& buffer, Frame reco
 
 /* -------------------------------------------------------------------------- */
 
-void ChannelManager::keyPress(ID channelId, int velocity, bool canRecordActions, bool canQuantize, Frame currentFrameQuantized)
+void ChannelManager::keyPress(ID channelId, int velocity, bool canRecordActions, bool canQuantize, Frame currentFrameQuantized, Frame localFrame)
 {
 	Channel& ch = m_model.get().channels.get(channelId);
 
@@ -289,28 +367,28 @@ void ChannelManager::keyPress(ID channelId, int velocity, bool canRecordActions,
 	if (ch.sampleActionRecorder && ch.hasWave() && canRecordActions && !ch.samplePlayer->isAnyLoopMode())
 		ch.sampleActionRecorder->keyPress(channelId, *ch.shared, currentFrameQuantized, ch.samplePlayer->mode, ch.hasActions);
 	if (ch.sampleReactor && ch.hasWave())
-		ch.sampleReactor->keyPress(channelId, *ch.shared, ch.samplePlayer->mode, velocity, canQuantize, ch.samplePlayer->isAnyLoopMode(), ch.samplePlayer->velocityAsVol, ch.volume_i);
+		ch.sampleReactor->keyPress(channelId, *ch.shared, ch.samplePlayer->mode, velocity, canQuantize, ch.samplePlayer->isAnyLoopMode(), ch.samplePlayer->velocityAsVol, ch.volume_i, localFrame);
 
 	m_model.swap(model::SwapType::SOFT);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void ChannelManager::keyRelease(ID channelId, bool canRecordActions, Frame currentFrameQuantized)
+void ChannelManager::keyRelease(ID channelId, bool canRecordActions, Frame currentFrameQuantized, Frame localFrame)
 {
 	Channel& ch = m_model.get().channels.get(channelId);
 
 	if (ch.sampleActionRecorder && ch.hasWave() && canRecordActions && !ch.samplePlayer->isAnyLoopMode())
 		ch.sampleActionRecorder->keyRelease(channelId, canRecordActions, currentFrameQuantized, ch.samplePlayer->mode, ch.hasActions);
 	if (ch.sampleReactor && ch.hasWave())
-		ch.sampleReactor->keyRelease(*ch.shared, ch.samplePlayer->mode);
+		ch.sampleReactor->keyRelease(*ch.shared, ch.samplePlayer->mode, localFrame);
 
 	m_model.swap(model::SwapType::SOFT);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void ChannelManager::keyKill(ID channelId, bool canRecordActions, Frame currentFrameQuantized)
+void ChannelManager::keyKill(ID channelId, bool canRecordActions, Frame currentFrameQuantized, Frame localFrame)
 {
 	Channel& ch = m_model.get().channels.get(channelId);
 
@@ -323,7 +401,7 @@ void ChannelManager::keyKill(ID channelId, bool canRecordActions, Frame currentF
 	if (ch.sampleActionRecorder && ch.hasWave() && canRecordActions)
 		ch.sampleActionRecorder->keyKill(channelId, canRecordActions, currentFrameQuantized, ch.samplePlayer->mode, ch.hasActions);
 	if (ch.sampleReactor)
-		ch.sampleReactor->keyKill(*ch.shared, ch.samplePlayer->mode);
+		ch.sampleReactor->keyKill(*ch.shared, ch.samplePlayer->mode, localFrame);
 
 	m_model.swap(model::SwapType::SOFT);
 }
@@ -352,26 +430,36 @@ void ChannelManager::setInputMonitor(ID channelId, bool value)
 
 void ChannelManager::setVolume(ID channelId, float value)
 {
-	m_model.get().channels.get(channelId).volume = std::clamp(value, 0.0f, G_MAX_VOLUME);
-	m_model.swap(model::SwapType::SOFT);
+	/* Continuous parameters go straight to the shared state read by the 
+	realtime thread: no need to swap the whole layout. */
+
+	Channel& ch = m_model.get().channels.get(channelId);
+	ch.volume   = std::clamp(value, 0.0f, G_MAX_VOLUME);
+	ch.shared->volume.store(ch.volume);
+	m_model.notify(model::SwapType::SOFT);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void ChannelManager::setPitch(ID channelId, float value)
 {
-	assert(m_model.get().channels.get(channelId).samplePlayer);
+	Channel& ch = m_model.get().channels.get(channelId);
 
-	m_model.get().channels.get(channelId).samplePlayer->pitch = std::clamp(value, G_MIN_PITCH, G_MAX_PITCH);
-	m_model.swap(model::SwapType::SOFT);
+	assert(ch.samplePlayer);
+
+	ch.samplePlayer->pitch = std::clamp(value, G_MIN_PITCH, G_MAX_PITCH);
+	ch.shared->pitch.store(ch.samplePlayer->pitch);
+	m_model.notify(model::SwapType::SOFT);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void ChannelManager::setPan(ID channelId, float value)
 {
-	m_model.get().channels.get(channelId).pan = std::clamp(value, 0.0f, G_MAX_PAN);
-	m_model.swap(model::SwapType::SOFT);
+	Channel& ch = m_model.get().channels.get(channelId);
+	ch.pan      = std::clamp(value, 0.0f, G_MAX_PAN);
+	ch.shared->pan.store(ch.pan);
+	m_model.notify(model::SwapType::SOFT);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -394,7 +482,7 @@ void ChannelManager::setBeginEnd(ID channelId, Frame b, Frame e)
 
 	c.samplePlayer->begin = b;
 	c.samplePlayer->end   = e;
-	m_model.swap(model::SwapType::HARD);
+	applyBeginEnd(c);
 }
 
 void ChannelManager::resetBeginEnd(ID channelId)
@@ -405,7 +493,7 @@ void ChannelManager::resetBeginEnd(ID channelId)
 
 	c.samplePlayer->begin = 0;
 	c.samplePlayer->end   = c.samplePlayer->getWaveSize();
-	m_model.swap(model::SwapType::HARD);
+	applyBeginEnd(c);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -501,6 +589,7 @@ void ChannelManager::loadWaveInPreviewChannel(ID channelId)
 
 	assert(previewCh.samplePlayer);
 	assert(sourceCh.samplePlayer);
+	assert(!sourceCh.samplePlayer->hasStreamedWave()); // A stream can't be shared
 
 	previewCh.samplePlayer->loadWave(*previewCh.shared, sourceCh.samplePlayer->getWave());
 	m_model.swap(model::SwapType::SOFT);
@@ -563,14 +652,14 @@ bool ChannelManager::saveSample(ID channelId, const std::string& filePath)
 
 	assert(wave != nullptr);
 
-	if (!waveFactory::save(*wave, filePath))
+	if (waveFactory::save(*wave, filePath) != G_RES_OK)
 		return false;
 
 	u::log::print("[saveSample] sample saved to %s\n", filePath);
 
-	/* Reset logical and edited states in Wave. */
+	/* Reset logical and edited states in Wave. The audio thread never reads 
+	them, no need to lock anything. */
 
-	model::DataLock lock = m_model.lockData();
 	wave->setLogical(false);
 	wave->setEdited(false);
 
@@ -628,6 +717,20 @@ void ChannelManager::loadSampleChannel(Channel& ch, Wave* w, Frame begin, Frame
 
 /* -------------------------------------------------------------------------- */
 
+void ChannelManager::applyBeginEnd(const Channel& ch)
+{
+	if (!ch.samplePlayer->hasStreamedWave())
+	{
+		m_model.swap(model::SwapType::HARD);
+		return;
+	}
+
+	model::DataLock lock = m_model.lockData(ch.id, model::SwapType::HARD);
+	ch.samplePlayer->updateStream();
+}
+
+/* -------------------------------------------------------------------------- */
+
 std::vector<Channel*> ChannelManager::getRecordableChannels()
 {
 	return m_model.get().channels.getIf([](const Channel& c) { return c.canInputRec() && !c.hasWave(); });
@@ -635,7 +738,11 @@ std::vector<Channel*> ChannelManager::getRecordableChannels()
 
 std::vector<Channel*> ChannelManager::getOverdubbableChannels()
 {
-	return m_model.get().channels.getIf([](const Channel& c) { return c.canInputRec() && c.hasWave(); });
+	/* Streamed Waves have no audio data in memory to overdub onto. */
+
+	return m_model.get().channels.getIf([](const Channel& c) {
+		return c.canInputRec() && c.hasWave() && !c.samplePlayer->hasStreamedWave();
+	});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -662,7 +769,7 @@ void ChannelManager::recordChannel(Channel& ch, const mcl::AudioBuffer& buffer,
 
 	/* Copy up to wave.getSize() from the mixer's input buffer into wave's. */
 
-	wave->getBuffer().set(buffer, wave->getBuffer().countFrames());
+	wave->getWritableBuffer().set(buffer, wave->getBuffer().countFrames());
 
 	/* Update channel with the new Wave. */
 
@@ -677,17 +784,14 @@ void ChannelManager::recordChannel(Channel& ch, const mcl::AudioBuffer& buffer,
 
 void ChannelManager::overdubChannel(Channel& ch, const mcl::AudioBuffer& buffer, Frame currentFrame)
 {
-	Wave* wave = ch.samplePlayer->getWave();
-
-	/* Need model::DataLock here, as data might be being read by the audio
-	thread at the same time. */
+	/* Audio data might be being read by the audio thread at the same time: sum
+	the recorded audio into a copy of the Wave. */
 
-	model::DataLock lock = m_model.lockData();
-
-	wave->getBuffer().sum(buffer, /*gain=*/1.0f);
-	wave->setLogical(true);
-
-	setupChannelPostRecording(ch, currentFrame);
+	editWave(ch.id, [this, &buffer, currentFrame](Wave& wave, Channel& c) {
+		wave.getWritableBuffer().sum(buffer, /*gain=*/1.0f);
+		wave.setLogical(true);
+		setupChannelPostRecording(c, currentFrame);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
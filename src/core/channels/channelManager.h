@@ -120,6 +120,21 @@ public:
 
 	void loadSampleChannel(ID channelId, Wave&);
 
+	/* setStreaming
+	Reloads the Wave of a Sample Channel, either streamed from disk or fully in
+	memory. Begin/end points and shift are kept. Fails for Waves that only live
+	in memory (i.e. logical or edited). */
+
+	int setStreaming(ID channelId, bool value, int sampleRate, Resampler::Quality);
+
+	/* editWave
+	Edits a copy of the Wave loaded in a Sample Channel with 'f', then swaps it
+	in place of the current one, which the audio thread keeps playing in the 
+	meantime. 'f' can also change the Channel (e.g. begin/end points): changes 
+	are applied along with the new Wave. Streamed Waves can't be edited. */
+
+	void editWave(ID channelId, std::function<void(Wave&, Channel&)> f);
+
 	/* freeChannel
     Unloads existing Wave from a Sample Channel. */
 
@@ -141,9 +156,9 @@ public:
 
 	void finalizeInputRec(const mcl::AudioBuffer&, Frame recordedFrames, Frame currentFrame);
 
-	void keyPress(ID channelId, int velocity, bool canRecordActions, bool canQuantize, Frame currentFrameQuantized);
-	void keyRelease(ID channelId, bool canRecordActions, Frame currentFrameQuantized);
-	void keyKill(ID channelId, bool canRecordActions, Frame currentFrameQuantized);
+	void keyPress(ID channelId, int velocity, bool canRecordActions, bool canQuantize, Frame currentFrameQuantized, Frame localFrame);
+	void keyRelease(ID channelId, bool canRecordActions, Frame currentFrameQuantized, Frame localFrame);
+	void keyKill(ID channelId, bool canRecordActions, Frame currentFrameQuantized, Frame localFrame);
 	void processMidiEvent(ID channelId, const MidiEvent&, bool canRecordActions, Frame currentFrameQuantized);
 	void setInputMonitor(ID channelId, bool value);
 	void setVolume(ID channelId, float value);
@@ -189,6 +204,13 @@ public:
 private:
 	void loadSampleChannel(Channel&, Wave*, Frame begin = -1, Frame end = -1, Frame shift = -1) const;
 
+	/* applyBeginEnd
+	Swaps the model after a begin/end change. A streamed Wave needs to reload
+	its head from disk: the channel is kept away from the audio thread while
+	that happens. */
+
+	void applyBeginEnd(const Channel&);
+
 	std::vector<Channel*> getRecordableChannels();
 	std::vector<Channel*> getOverdubbableChannels();
 
@@ -30,7 +30,11 @@ namespace giada::m
 {
 ChannelShared::ChannelShared(Frame bufferSize)
 : audioBuffer(bufferSize, G_MAX_IO_CHANS)
+, pluginBuffer(G_MAX_IO_CHANS, bufferSize)
 {
+	/* MIDI events are added by the realtime thread: make room in advance. */
+
+	midiBuffer.ensureSize(G_MAX_PLUGIN_MIDI_BYTES);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -47,5 +51,7 @@ bool ChannelShared::isReadingActions() const
 void ChannelShared::setBufferSize(int bufferSize)
 {
 	audioBuffer.alloc(bufferSize, audioBuffer.countChannels());
+	pluginBuffer.setSize(G_MAX_IO_CHANS, bufferSize);
+	idleTracker.reset();
 }
 } // namespace giada::m
\ No newline at end of file
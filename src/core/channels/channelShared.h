@@ -27,12 +27,15 @@
 #ifndef G_CHANNELSHARED_H
 #define G_CHANNELSHARED_H
 
+#include "core/channels/idleTracker.h"
 #include "core/channels/samplePlayer.h"
 #include "core/const.h"
 #include "core/midiEvent.h"
 #include "core/queue.h"
 #include "core/resampler.h"
+#include "core/smoothedParam.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <cstdint>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <optional>
 
@@ -48,7 +51,7 @@ struct ChannelShared final
 	bool isReadingActions() const;
 
 	/* setBufferSize 
-	Sets a new size for the internal audio buffer. */
+	Sets a new size for the internal audio buffers. */
 
 	void setBufferSize(int);
 
@@ -56,11 +59,25 @@ struct ChannelShared final
 	juce::MidiBuffer midiBuffer;
 	MidiQueue        midiQueue;
 
+	/* pluginBuffer
+	Working buffer for the plug-in stack. Each channel has its own, so that
+	channels can be rendered in parallel. */
+
+	juce::AudioBuffer<float> pluginBuffer;
+
 	WeakAtomic<Frame>         tracker     = 0;
 	WeakAtomic<ChannelStatus> playStatus  = ChannelStatus::OFF;
 	WeakAtomic<ChannelStatus> recStatus   = ChannelStatus::OFF;
 	WeakAtomic<bool>          readActions = false;
 
+	/* Continuous parameters read by the realtime thread. Changing them doesn't 
+	require a model swap: the values in Channel (and SamplePlayer) are just the
+	non-realtime copies used by the UI and for serialization. */
+
+	SmoothedParam volume = G_DEFAULT_VOL;
+	SmoothedParam pan    = G_DEFAULT_PAN;
+	SmoothedParam pitch  = G_DEFAULT_PITCH;
+
 	std::optional<Quantizer> quantizer;
 
 	/* Optional render queue for sample-based channels. Used by SampleReactor
@@ -74,6 +91,17 @@ struct ChannelShared final
 	changes by the Swapper mechanism). Let's put it in the shared state here. */
 
 	std::optional<Resampler> resampler = {};
+
+	/* Silence tracking, realtime only. An idle channel has a silent buffer and
+	nothing to render until new input comes in. */
+
+	IdleTracker idleTracker;
+
+	/* Profiling data, in nanoseconds, written by the rendering thread when the
+	profiler is on. */
+
+	std::int64_t renderTime  = 0;
+	std::int64_t pluginsTime = 0;
 };
 } // namespace giada::m
 
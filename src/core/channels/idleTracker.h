@@ -0,0 +1,119 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_CHANNEL_IDLE_TRACKER_H
+#define G_CHANNEL_IDLE_TRACKER_H
+
+#include "core/dsp.h"
+#include "core/types.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace giada::m
+{
+/* IdleTracker
+Tells when a channel can stop rendering. A channel goes idle once its input is
+gone, its plug-in tails have decayed and its buffer is silent; it wakes up as 
+soon as new input comes in. Realtime only. */
+
+class IdleTracker final
+{
+public:
+	/* SILENCE
+	Peak level below which a buffer is considered silent (-120 dB). */
+
+	static constexpr float SILENCE = 1.0e-6f;
+
+	/* NO_TAIL
+	Value of 'tailLeft' when the plug-in tails haven't been queried yet. */
+
+	static constexpr Frame NO_TAIL = -1;
+
+	bool isIdle() const { return m_idle; }
+
+	/* getTailLeft
+	Returns the number of frames the plug-in stack still needs to decay, or 
+	NO_TAIL if the input is still there. */
+
+	Frame getTailLeft() const { return m_tailLeft; }
+
+	/* wake
+	Brings the channel back to full processing. */
+
+	void wake() { m_idle = false; }
+
+	/* reset
+	Forgets everything, e.g. when the buffer size changes. */
+
+	void reset()
+	{
+		m_idle     = false;
+		m_tailLeft = NO_TAIL;
+	}
+
+	/* update
+	Call once per rendered block, after the buffer has been filled. 'input' 
+	tells whether something fed the channel in this block. 'getTailFrames' 
+	returns the length of the plug-in tails: it's called once, when the input 
+	stops. Infinite tails (std::numeric_limits<Frame>::max()) never expire. 
+	Clears the buffer when going idle. */
+
+	template <typename F>
+	void update(bool input, mcl::AudioBuffer& buffer, F&& getTailFrames)
+	{
+		if (input)
+		{
+			m_tailLeft = NO_TAIL;
+			return;
+		}
+
+		if (m_tailLeft == NO_TAIL)
+			m_tailLeft = getTailFrames();
+		if (m_tailLeft != std::numeric_limits<Frame>::max())
+			m_tailLeft = std::max(0, m_tailLeft - buffer.countFrames());
+		if (m_tailLeft > 0)
+			return;
+
+		/* Some plug-ins report no tail while still ringing, and releases keep 
+		sounding after the input has stopped: wait for actual silence too. */
+
+		const Peak peak = dsp::getPeak(buffer);
+		if (peak.left < SILENCE && peak.right < SILENCE)
+		{
+			buffer.clear();
+			m_idle = true;
+		}
+	}
+
+private:
+	bool  m_idle     = false;
+	Frame m_tailLeft = NO_TAIL;
+};
+} // namespace giada::m
+
+#endif
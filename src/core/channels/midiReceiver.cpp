@@ -34,9 +34,8 @@ void MidiReceiver::advance(ID channelId, ChannelShared::MidiQueue& midiQueue, co
 {
 	if (e.type != Sequencer::EventType::ACTIONS)
 		return;
-	for (const Action& action : *e.actions)
-		if (action.channelId == channelId)
-			sendToPlugins(midiQueue, action.event, e.delta);
+	for (const Action& action : ActionTimeline::getChannelActions(e.actions, channelId))
+		sendToPlugins(midiQueue, action.event, e.delta);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -55,7 +54,7 @@ void MidiReceiver::render(ChannelShared& shared, const std::vector<Plugin*>& plu
 		shared.midiBuffer.addEvent(message, e.getDelta());
 	}
 
-	pluginHost.processStack(shared.audioBuffer, plugins, &shared.midiBuffer);
+	pluginHost.processStack(shared.audioBuffer, plugins, &shared.midiBuffer, &shared.pluginBuffer);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -80,10 +79,11 @@ void MidiReceiver::parseMidi(ChannelShared::MidiQueue& midiQueue, const MidiEven
 {
 	/* Now all messages are turned into Channel-0 messages. Giada doesn't care 
 	about holding MIDI channel information. Moreover, having all internal 
-	messages on channel 0 is way easier. Then send it to plug-ins. */
+	messages on channel 0 is way easier. Then send it to plug-ins, at the
+	offset it was received at. */
 
 	MidiEvent flat(e);
 	flat.setChannel(0);
-	sendToPlugins(midiQueue, flat, /*delta=*/0);
+	sendToPlugins(midiQueue, flat, e.getDelta());
 }
 } // namespace giada::m
@@ -54,7 +54,7 @@ void MidiSender::advance(ID channelId, const Sequencer::Event& e) const
 	if (!enabled)
 		return;
 	if (e.type == Sequencer::EventType::ACTIONS)
-		parseActions(channelId, *e.actions);
+		parseActions(channelId, e.actions, e.delta);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -76,12 +76,20 @@ void MidiSender::send(MidiEvent e) const
 	onSend();
 }
 
+void MidiSender::send_RT(MidiEvent e, Frame delta) const
+{
+	assert(onSend != nullptr);
+
+	e.setChannel(filter);
+	kernelMidi->send_RT(e, delta);
+	onSend();
+}
+
 /* -------------------------------------------------------------------------- */
 
-void MidiSender::parseActions(ID channelId, const std::vector<Action>& as) const
+void MidiSender::parseActions(ID channelId, ActionTimeline::Span as, Frame delta) const
 {
-	for (const Action& a : as)
-		if (a.channelId == channelId)
-			send(a.event);
+	for (const Action& a : ActionTimeline::getChannelActions(as, channelId))
+		send_RT(a.event, delta);
 }
 } // namespace giada::m
\ No newline at end of file
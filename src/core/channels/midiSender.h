@@ -62,8 +62,14 @@ public:
 	std::function<void()> onSend;
 
 private:
+	/* send, send_RT
+	Sends a MIDI event right away or schedules it at frame 'delta' of the current
+	audio block (realtime thread only). */
+
 	void send(MidiEvent e) const;
-	void parseActions(ID channelId, const std::vector<Action>& as) const;
+	void send_RT(MidiEvent e, Frame delta) const;
+
+	void parseActions(ID channelId, ActionTimeline::Span as, Frame delta) const;
 };
 } // namespace giada::m
 
@@ -79,7 +79,7 @@ void SampleAdvancer::advance(ID channelId, ChannelShared& shared,
 
 	case Sequencer::EventType::ACTIONS:
 		if (!isLoop && shared.isReadingActions())
-			parseActions(channelId, shared, *e.actions, e.delta, mode);
+			parseActions(channelId, shared, e.actions, e.delta, mode);
 		break;
 
 	default:
@@ -191,13 +191,10 @@ void SampleAdvancer::onNoteOn(ChannelShared& shared, Frame localFrame, SamplePla
 /* -------------------------------------------------------------------------- */
 
 void SampleAdvancer::parseActions(ID channelId, ChannelShared& shared,
-    const std::vector<Action>& as, Frame localFrame, SamplePlayerMode mode) const
+    ActionTimeline::Span as, Frame localFrame, SamplePlayerMode mode) const
 {
-	for (const Action& a : as)
+	for (const Action& a : ActionTimeline::getChannelActions(as, channelId))
 	{
-		if (a.channelId != channelId)
-			continue;
-
 		switch (a.event.getStatus())
 		{
 		case MidiEvent::CHANNEL_NOTE_ON:
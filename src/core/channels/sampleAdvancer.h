@@ -45,7 +45,7 @@ private:
 	void onFirstBeat(ChannelShared&, Frame localFrame, bool isLoop) const;
 	void onBar(ChannelShared&, Frame localFrame, SamplePlayerMode) const;
 	void onNoteOn(ChannelShared&, Frame localFrame, SamplePlayerMode) const;
-	void parseActions(ID channelId, ChannelShared&, const std::vector<Action>&, Frame localFrame, SamplePlayerMode) const;
+	void parseActions(ID channelId, ChannelShared&, ActionTimeline::Span, Frame localFrame, SamplePlayerMode) const;
 };
 } // namespace giada::m
 
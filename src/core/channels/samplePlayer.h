@@ -68,6 +68,7 @@ public:
 	bool  hasWave() const;
 	bool  hasLogicalWave() const;
 	bool  hasEditedWave() const;
+	bool  hasStreamedWave() const;
 	bool  isAnyLoopMode() const;
 	ID    getWaveId() const;
 	Frame getWaveSize() const;
@@ -87,12 +88,22 @@ public:
 
 	void setWave(Wave* w, float samplerateRatio);
 
+	/* updateStream
+	Makes the disk stream follow the current begin/end points, if the Wave is
+	streamed. The realtime thread must not be reading the Wave meanwhile. */
+
+	void updateStream() const;
+
 	/* kickIn
 	Starts the player right away at frame 'f'. Used when launching a loop after
 	being live recorded. */
 
 	void kickIn(ChannelShared&, Frame f);
 
+	/* pitch
+	Non-realtime copy of the pitch value. The realtime thread reads it from
+	ChannelShared::pitch instead, once per block. */
+
 	float            pitch;
 	SamplePlayerMode mode;
 	Frame            shift;
@@ -115,7 +126,7 @@ private:
 	into the audio buffer at position 'offset'. May fire 'onLastFrame' callback
 	if the sample end is reached. */
 
-	Frame render(mcl::AudioBuffer&, Frame tracker, Frame offset, ChannelStatus, bool seqIsRunning) const;
+	Frame render(mcl::AudioBuffer&, Frame tracker, Frame offset, float pitch, ChannelStatus, bool seqIsRunning) const;
 
 	/* stop
 	Silences the last part of the audio buffer, starting at 'offset'. Used to
@@ -123,7 +134,7 @@ private:
 
 	Frame stop(mcl::AudioBuffer&, Frame offset, bool seqIsRunning) const;
 
-	WaveReader::Result fillBuffer(mcl::AudioBuffer&, Frame start, Frame offset) const;
+	WaveReader::Result fillBuffer(mcl::AudioBuffer&, Frame start, Frame offset, float pitch) const;
 	bool               shouldLoop(ChannelStatus) const;
 };
 } // namespace giada::m
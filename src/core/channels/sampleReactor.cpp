@@ -27,6 +27,7 @@
 #include "core/channels/sampleReactor.h"
 #include "core/channels/channelShared.h"
 #include "utils/math.h"
+#include <atomic>
 
 namespace giada::m
 {
@@ -64,21 +65,26 @@ void SampleReactor::rewind(ChannelShared& shared, Frame localFrame) const
 
 void SampleReactor::play(ChannelShared& shared, Frame localFrame) const
 {
-	shared.playStatus.store(ChannelStatus::PLAY);
+	/* Push the Render first and publish the new status last: the audio thread
+	pops Renders only from a playing channel, so it can't start rendering 
+	before the offset is there. */
+
 	shared.renderQueue->push({SamplePlayer::Render::Mode::NORMAL, localFrame});
+	std::atomic_thread_fence(std::memory_order_release);
+	shared.playStatus.store(ChannelStatus::PLAY);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void SampleReactor::stop(ChannelShared& shared) const
+void SampleReactor::stop(ChannelShared& shared, Frame localFrame) const
 {
-	shared.renderQueue->push({SamplePlayer::Render::Mode::STOP, 0});
+	shared.renderQueue->push({SamplePlayer::Render::Mode::STOP, localFrame});
 }
 
 /* -------------------------------------------------------------------------- */
 
 ChannelStatus SampleReactor::pressWhileOff(ID channelId, ChannelShared& shared,
-    int velocity, bool canQuantize, bool velocityAsVol, float& volume_i) const
+    int velocity, bool canQuantize, bool velocityAsVol, float& volume_i, Frame localFrame) const
 {
 	if (velocityAsVol)
 		volume_i = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME);
@@ -88,14 +94,18 @@ ChannelStatus SampleReactor::pressWhileOff(ID channelId, ChannelShared& shared,
 		shared.quantizer->trigger(Q_ACTION_PLAY + channelId);
 		return ChannelStatus::OFF;
 	}
-	else
-		return ChannelStatus::PLAY;
+
+	/* Start rendering at 'localFrame' rather than at the beginning of the next
+	block. */
+
+	play(shared, localFrame);
+	return ChannelStatus::PLAY;
 }
 
 /* -------------------------------------------------------------------------- */
 
 ChannelStatus SampleReactor::pressWhilePlay(ID channelId, ChannelShared& shared,
-    SamplePlayerMode mode, bool canQuantize) const
+    SamplePlayerMode mode, bool canQuantize, Frame localFrame) const
 {
 	switch (mode)
 	{
@@ -103,14 +113,14 @@ ChannelStatus SampleReactor::pressWhilePlay(ID channelId, ChannelShared& shared,
 		if (canQuantize)
 			shared.quantizer->trigger(Q_ACTION_REWIND + channelId);
 		else
-			rewind(shared, /*localFrame=*/0);
+			rewind(shared, localFrame);
 		return ChannelStatus::PLAY;
 
 	case SamplePlayerMode::SINGLE_ENDLESS:
 		return ChannelStatus::ENDING;
 
 	case SamplePlayerMode::SINGLE_BASIC:
-		stop(shared);
+		stop(shared, localFrame);
 		return ChannelStatus::PLAY; // Let SamplePlayer stop it once done
 
 	default:
@@ -121,9 +131,10 @@ ChannelStatus SampleReactor::pressWhilePlay(ID channelId, ChannelShared& shared,
 /* -------------------------------------------------------------------------- */
 
 void SampleReactor::keyPress(ID channelId, ChannelShared& shared, SamplePlayerMode mode,
-    int velocity, bool canQuantize, bool isLoop, bool velocityAsVol, float& volume_i) const
+    int velocity, bool canQuantize, bool isLoop, bool velocityAsVol, float& volume_i, Frame localFrame) const
 {
-	ChannelStatus playStatus = shared.playStatus.load();
+	ChannelStatus oldStatus  = shared.playStatus.load();
+	ChannelStatus playStatus = oldStatus;
 
 	switch (playStatus)
 	{
@@ -131,14 +142,14 @@ void SampleReactor::keyPress(ID channelId, ChannelShared& shared, SamplePlayerMo
 		if (isLoop)
 			playStatus = ChannelStatus::WAIT;
 		else
-			playStatus = pressWhileOff(channelId, shared, velocity, canQuantize, velocityAsVol, volume_i);
+			playStatus = pressWhileOff(channelId, shared, velocity, canQuantize, velocityAsVol, volume_i, localFrame);
 		break;
 
 	case ChannelStatus::PLAY:
 		if (isLoop)
 			playStatus = ChannelStatus::ENDING;
 		else
-			playStatus = pressWhilePlay(channelId, shared, mode, canQuantize);
+			playStatus = pressWhilePlay(channelId, shared, mode, canQuantize, localFrame);
 		break;
 
 	case ChannelStatus::WAIT:
@@ -153,23 +164,28 @@ void SampleReactor::keyPress(ID channelId, ChannelShared& shared, SamplePlayerMo
 		break;
 	}
 
-	shared.playStatus.store(playStatus);
+	/* Publish the new status only if nobody else has changed it in the 
+	meantime: play() has already done it, or the audio thread might have (e.g.
+	a channel that stopped on its own). */
+
+	if (playStatus != oldStatus)
+		shared.playStatus.compare_exchange_strong(oldStatus, playStatus);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void SampleReactor::keyKill(ChannelShared& shared, SamplePlayerMode mode) const
+void SampleReactor::keyKill(ChannelShared& shared, SamplePlayerMode mode, Frame localFrame) const
 {
 	const ChannelStatus playStatus = shared.playStatus.load();
 	if (playStatus == ChannelStatus::PLAY || playStatus == ChannelStatus::ENDING)
-		stop(shared);
+		stop(shared, localFrame);
 	if (mode == SamplePlayerMode::SINGLE_BASIC_PAUSE)
 		shared.tracker.store(0); // Hard rewind
 }
 
 /* -------------------------------------------------------------------------- */
 
-void SampleReactor::keyRelease(ChannelShared& shared, SamplePlayerMode mode) const
+void SampleReactor::keyRelease(ChannelShared& shared, SamplePlayerMode mode, Frame localFrame) const
 {
 	/* Key release is meaningful only for SINGLE_PRESS modes. */
 
@@ -181,7 +197,7 @@ void SampleReactor::keyRelease(ChannelShared& shared, SamplePlayerMode mode) con
 	disable it. */
 
 	if (shared.playStatus.load() == ChannelStatus::PLAY)
-		stop(shared); // Let SamplePlayer stop it once done
+		stop(shared, localFrame); // Let SamplePlayer stop it once done
 	else if (shared.quantizer->hasBeenTriggered())
 		shared.quantizer->clear();
 }
@@ -204,7 +220,7 @@ void SampleReactor::stopBySeq(ChannelShared& shared, bool chansStopOnSeqHalt, bo
 
 	case ChannelStatus::PLAY:
 		if (chansStopOnSeqHalt && (isLoop || isReadingActions))
-			stop(shared);
+			stop(shared, /*localFrame=*/0);
 		break;
 
 	default:
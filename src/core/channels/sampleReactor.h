@@ -55,16 +55,20 @@ public:
 	SampleReactor(ChannelShared&, ID channelId);
 
 	void stopBySeq(ChannelShared&, bool chansStopOnSeqHalt, bool isLoop) const;
-	void keyPress(ID channelId, ChannelShared&, SamplePlayerMode, int velocity, bool canQuantize, bool isLoop, bool velocityAsVol, float& volume_i) const;
-	void keyRelease(ChannelShared&, SamplePlayerMode) const;
-	void keyKill(ChannelShared&, SamplePlayerMode) const;
+	/* keyPress, keyRelease, keyKill
+	Manual events. 'localFrame' is the offset in the next audio block the event
+	takes effect at, when not quantized. */
+
+	void keyPress(ID channelId, ChannelShared&, SamplePlayerMode, int velocity, bool canQuantize, bool isLoop, bool velocityAsVol, float& volume_i, Frame localFrame) const;
+	void keyRelease(ChannelShared&, SamplePlayerMode, Frame localFrame) const;
+	void keyKill(ChannelShared&, SamplePlayerMode, Frame localFrame) const;
 
 private:
-	ChannelStatus pressWhilePlay(ID channelId, ChannelShared&, SamplePlayerMode, bool canQuantize) const;
-	ChannelStatus pressWhileOff(ID channelId, ChannelShared&, int velocity, bool canQuantize, bool velocityAsVol, float& volume_i) const;
+	ChannelStatus pressWhilePlay(ID channelId, ChannelShared&, SamplePlayerMode, bool canQuantize, Frame localFrame) const;
+	ChannelStatus pressWhileOff(ID channelId, ChannelShared&, int velocity, bool canQuantize, bool velocityAsVol, float& volume_i, Frame localFrame) const;
 	void          rewind(ChannelShared&, Frame localFrame) const;
 	void          play(ChannelShared&, Frame localFrame) const;
-	void          stop(ChannelShared&) const;
+	void          stop(ChannelShared&, Frame localFrame) const;
 };
 
 } // namespace giada::m
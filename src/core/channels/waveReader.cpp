@@ -28,10 +28,12 @@
 #include "core/const.h"
 #include "core/model/model.h"
 #include "core/wave.h"
+#include "core/waveStream.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "utils/log.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <memory>
 
 namespace giada::m
@@ -49,9 +51,11 @@ WaveReader::Result WaveReader::fill(mcl::AudioBuffer& out, Frame start, Frame ma
 {
 	assert(wave != nullptr);
 	assert(start >= 0);
-	assert(max <= wave->getBuffer().countFrames());
+	assert(max <= wave->getSize());
 	assert(offset < out.countFrames());
 
+	if (wave->isStreamed())
+		return fillStream(out, start, max, offset, pitch);
 	if (pitch == 1.0f)
 		return fillCopy(out, start, max, offset);
 	else
@@ -90,6 +94,40 @@ WaveReader::Result WaveReader::fillCopy(mcl::AudioBuffer& dest, Frame start,
 	return {used, used};
 }
 
+/* -------------------------------------------------------------------------- */
+
+WaveReader::Result WaveReader::fillStream(mcl::AudioBuffer& dest, Frame start,
+    Frame max, Frame offset, float pitch) const
+{
+	const Frame outFrames = dest.countFrames() - offset;
+	const Frame inFrames  = pitch == 1.0f ? outFrames : static_cast<Frame>(std::ceil(outFrames * pitch)) + RESAMPLER_MARGIN;
+
+	WaveStream::Window window = wave->getStream()->acquire_RT(start, std::min(inFrames, max - start));
+	if (window.frames == 0)
+		return {0, 0};
+
+	if (pitch == 1.0f)
+	{
+		const mcl::AudioBuffer src(const_cast<float*>(window.data), window.frames, G_MAX_IO_CHANS);
+		dest.set(src, window.frames, 0, offset);
+		return {window.frames, window.frames};
+	}
+
+	/* The window starts at 'start', so the resampler reads it from 0. */
+
+	Resampler::Result res = m_resampler->process(
+	    /*input=*/const_cast<float*>(window.data),
+	    /*inputPos=*/0,
+	    /*inputLen=*/window.frames,
+	    /*output=*/dest[offset],
+	    /*outputLen=*/outFrames,
+	    /*pitch=*/pitch);
+
+	return {
+	    static_cast<int>(res.used),
+	    static_cast<int>(res.generated)};
+}
+
 void WaveReader::last() const
 {
 	if (m_resampler != nullptr)
@@ -58,7 +58,8 @@ public:
 
 	/* fill
 	Fills audio buffer 'out' with data coming from Wave, copying it from 'start'
-	frame up to 'max'. The buffer is filled starting at 'offset'. */
+	frame up to 'max'. The buffer is filled starting at 'offset'. Streamed Waves
+	are read through their disk stream. */
 
 	Result fill(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
 	    float pitch) const;
@@ -84,6 +85,14 @@ private:
 	Result fillResampled(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
 	    float pitch) const;
 	Result fillCopy(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset) const;
+	Result fillStream(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
+	    float pitch) const;
+
+	/* RESAMPLER_MARGIN
+	Extra input frames fetched from a stream when resampling, to make up for the
+	resampler's own internal buffering. */
+
+	static constexpr Frame RESAMPLER_MARGIN = 4096;
 
 	Resampler* m_resampler;
 };
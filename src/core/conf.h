@@ -55,6 +55,8 @@ struct Conf final
 	int                buffersize       = G_DEFAULT_BUFSIZE;
 	bool               limitOutput      = false;
 	Resampler::Quality rsmpQuality      = Resampler::Quality::SINC_BEST;
+	int                renderThreads    = 0;
+	int                waveCacheSize    = G_DEFAULT_WAVE_CACHE_SIZE; // MiB
 
 	RtMidi::Api midiSystem  = G_DEFAULT_MIDI_API;
 	int         midiPortOut = G_DEFAULT_MIDI_PORT_OUT;
@@ -67,6 +69,8 @@ struct Conf final
 	bool treatRecsAsLoops           = false;
 	bool inputMonitorDefaultOn      = false;
 	bool overdubProtectionDefaultOn = false;
+	bool progressiveLoading         = false;
+	bool compressProjectAudio       = false;
 
 	std::string pluginPath;
 	std::string patchPath;
@@ -42,6 +42,7 @@ void sanitize_(Conf& conf)
 	conf.channelsOutStart = std::max(0, conf.channelsOutStart);
 	conf.channelsInCount  = std::max(1, conf.channelsInCount);
 	conf.channelsInStart  = std::max(0, conf.channelsInStart);
+	conf.renderThreads    = std::clamp(conf.renderThreads, 0, G_MAX_RENDER_THREADS);
 
 	conf.midiPortOut = std::max(-1, conf.midiPortOut);
 	conf.midiPortIn  = std::max(-1, conf.midiPortIn);
@@ -76,6 +77,8 @@ bool serialize(const Conf& conf)
 	j[CONF_KEY_BUFFER_SIZE]                   = conf.buffersize;
 	j[CONF_KEY_LIMIT_OUTPUT]                  = conf.limitOutput;
 	j[CONF_KEY_RESAMPLE_QUALITY]              = conf.rsmpQuality;
+	j[CONF_KEY_RENDER_THREADS]                = conf.renderThreads;
+	j[CONF_KEY_WAVE_CACHE_SIZE]               = conf.waveCacheSize;
 	j[CONF_KEY_MIDI_SYSTEM]                   = conf.midiSystem;
 	j[CONF_KEY_MIDI_PORT_OUT]                 = conf.midiPortOut;
 	j[CONF_KEY_MIDI_PORT_IN]                  = conf.midiPortIn;
@@ -97,6 +100,8 @@ bool serialize(const Conf& conf)
 	j[CONF_KEY_TREAT_RECS_AS_LOOPS]           = conf.treatRecsAsLoops;
 	j[CONF_KEY_INPUT_MONITOR_DEFAULT_ON]      = conf.inputMonitorDefaultOn;
 	j[CONF_KEY_OVERDUB_PROTECTION_DEFAULT_ON] = conf.overdubProtectionDefaultOn;
+	j[CONF_KEY_PROGRESSIVE_LOADING]           = conf.progressiveLoading;
+	j[CONF_KEY_COMPRESS_PROJECT_AUDIO]        = conf.compressProjectAudio;
 	j[CONF_KEY_PLUGINS_PATH]                  = conf.pluginPath;
 	j[CONF_KEY_PATCHES_PATH]                  = conf.patchPath;
 	j[CONF_KEY_SAMPLES_PATH]                  = conf.samplePath;
@@ -190,6 +195,8 @@ Conf deserialize()
 	conf.buffersize                 = j.value(CONF_KEY_BUFFER_SIZE, conf.buffersize);
 	conf.limitOutput                = j.value(CONF_KEY_LIMIT_OUTPUT, conf.limitOutput);
 	conf.rsmpQuality                = j.value(CONF_KEY_RESAMPLE_QUALITY, conf.rsmpQuality);
+	conf.renderThreads              = j.value(CONF_KEY_RENDER_THREADS, conf.renderThreads);
+	conf.waveCacheSize              = j.value(CONF_KEY_WAVE_CACHE_SIZE, conf.waveCacheSize);
 	conf.midiSystem                 = j.value(CONF_KEY_MIDI_SYSTEM, conf.midiSystem);
 	conf.midiPortOut                = j.value(CONF_KEY_MIDI_PORT_OUT, conf.midiPortOut);
 	conf.midiPortIn                 = j.value(CONF_KEY_MIDI_PORT_IN, conf.midiPortIn);
@@ -200,6 +207,8 @@ Conf deserialize()
 	conf.treatRecsAsLoops           = j.value(CONF_KEY_TREAT_RECS_AS_LOOPS, conf.treatRecsAsLoops);
 	conf.inputMonitorDefaultOn      = j.value(CONF_KEY_INPUT_MONITOR_DEFAULT_ON, conf.inputMonitorDefaultOn);
 	conf.overdubProtectionDefaultOn = j.value(CONF_KEY_OVERDUB_PROTECTION_DEFAULT_ON, conf.overdubProtectionDefaultOn);
+	conf.progressiveLoading         = j.value(CONF_KEY_PROGRESSIVE_LOADING, conf.progressiveLoading);
+	conf.compressProjectAudio       = j.value(CONF_KEY_COMPRESS_PROJECT_AUDIO, conf.compressProjectAudio);
 	conf.pluginPath                 = j.value(CONF_KEY_PLUGINS_PATH, conf.pluginPath);
 	conf.patchPath                  = j.value(CONF_KEY_PATCHES_PATH, conf.patchPath);
 	conf.samplePath                 = j.value(CONF_KEY_SAMPLES_PATH, conf.samplePath);
@@ -58,18 +58,6 @@ constexpr int  G_VERSION_PATCH = 0;
 
 constexpr auto G_CONF_FILENAME = "giada.conf";
 
-/* -- Engine ---------------------------------------------------------------- */
-/* G_EVENT_DISPATCHER_RATE_MS
-The amount of sleep between each Event Dispatcher cycle. It should be lower
-than the audio thread sleep time. Note: this value will obviously increase the 
-live input latency, keep it small! */
-constexpr int G_EVENT_DISPATCHER_RATE_MS = 5;
-
-/* G_KERNEL_MIDI_OUTPUT_RATE_MS
-The rate at which KernelMidi spits out MIDI events. Note: this value will 
-obviously increase the MIDI output latency, keep it small!*/
-constexpr int G_KERNEL_MIDI_OUTPUT_RATE_MS = 3;
-
 /* -- GUI ------------------------------------------------------------------- */
 constexpr int   G_GUI_FPS            = 30;
 constexpr float G_GUI_REFRESH_RATE   = 1 / static_cast<float>(G_GUI_FPS);
@@ -112,6 +100,18 @@ constexpr int   G_MAX_DISPATCHER_EVENTS = 32;
 constexpr int   G_MAX_SEQUENCER_EVENTS  = 128;  // Per block
 constexpr float G_MIN_UI_SCALING        = 0.0f; // Auto: FLTK will figure it out
 constexpr float G_MAX_UI_SCALING        = 4.0f;
+constexpr int   G_MAX_RENDER_THREADS    = 16;
+constexpr int   G_MAX_PROFILER_SAMPLES  = 16384; // Pending in the profiler queue
+constexpr int   G_PROFILER_WINDOW       = 4096;  // Samples kept per stage
+constexpr int   G_PROFILER_RATE_MS      = 50;
+constexpr int   G_MAX_XRUNS             = 64;   // Xruns kept in history
+constexpr float G_DSP_LOAD_SMOOTHING    = 0.3f; // DSP load time constant, seconds
+constexpr int   G_MAX_TRACE_THREADS     = 32;
+constexpr int   G_MAX_TRACE_EVENTS      = 4096; // Pending per thread
+constexpr int   G_TRACE_FLUSH_RATE_MS   = 100;
+constexpr int   G_MAX_PLUGIN_MIDI_BYTES = 4096; // Pre-allocated MIDI buffer, per plug-in
+constexpr int   G_MAX_RT_READERS        = 8;    // Concurrent realtime readers of the model
+constexpr int   G_MAX_WAVE_THREADS      = 8;    // Decoding and encoding Waves
 
 /* -- default values -------------------------------------------------------- */
 constexpr RtAudio::Api G_DEFAULT_SOUNDSYS            = RtAudio::Api::RTAUDIO_DUMMY;
@@ -123,6 +123,7 @@ constexpr int          G_DEFAULT_MIDI_PORT_OUT       = -1;
 constexpr int          G_DEFAULT_SAMPLERATE          = 44100;
 constexpr int          G_DEFAULT_BUFSIZE             = 1024;
 constexpr int          G_DEFAULT_BIT_DEPTH           = 32;
+constexpr int          G_DEFAULT_WAVE_CACHE_SIZE     = 2048; // MiB, 0 = disabled
 constexpr float        G_DEFAULT_VOL                 = 1.0f;
 constexpr float        G_DEFAULT_PAN                 = 0.5f;
 constexpr float        G_DEFAULT_PITCH               = 1.0f;
@@ -294,6 +295,8 @@ constexpr auto PATCH_KEY_CHANNEL_ARMED                = "armed";
 constexpr auto PATCH_KEY_WAVES                        = "waves";
 constexpr auto PATCH_KEY_WAVE_ID                      = "id";
 constexpr auto PATCH_KEY_WAVE_PATH                    = "path";
+constexpr auto PATCH_KEY_WAVE_STREAMED                = "streamed";
+constexpr auto PATCH_KEY_WAVE_HASH                    = "hash";
 constexpr auto PATCH_KEY_ACTIONS                      = "actions";
 constexpr auto PATCH_KEY_ACTION_TYPE                  = "type";
 constexpr auto PATCH_KEY_ACTION_FRAME                 = "frame";
@@ -333,6 +336,8 @@ constexpr auto CONF_KEY_BUFFER_SIZE                   = "buffer_size";
 constexpr auto CONF_KEY_DELAY_COMPENSATION            = "delay_compensation";
 constexpr auto CONF_KEY_LIMIT_OUTPUT                  = "limit_output";
 constexpr auto CONF_KEY_RESAMPLE_QUALITY              = "resample_quality";
+constexpr auto CONF_KEY_RENDER_THREADS                = "render_threads";
+constexpr auto CONF_KEY_WAVE_CACHE_SIZE               = "wave_cache_size";
 constexpr auto CONF_KEY_MIDI_SYSTEM                   = "midi_system";
 constexpr auto CONF_KEY_MIDI_PORT_OUT                 = "midi_port_out";
 constexpr auto CONF_KEY_MIDI_PORT_IN                  = "midi_port_in";
@@ -355,6 +360,8 @@ constexpr auto CONF_KEY_CHANS_STOP_ON_SEQ_HALT        = "chans_stop_on_seq_halt"
 constexpr auto CONF_KEY_TREAT_RECS_AS_LOOPS           = "treat_recs_as_loops";
 constexpr auto CONF_KEY_INPUT_MONITOR_DEFAULT_ON      = "input_monitor_default_on";
 constexpr auto CONF_KEY_OVERDUB_PROTECTION_DEFAULT_ON = "overdub_protection_default_on";
+constexpr auto CONF_KEY_PROGRESSIVE_LOADING           = "progressive_loading";
+constexpr auto CONF_KEY_COMPRESS_PROJECT_AUDIO        = "compress_project_audio";
 constexpr auto CONF_KEY_PLUGINS_PATH                  = "plugins_path";
 constexpr auto CONF_KEY_PATCHES_PATH                  = "patches_path";
 constexpr auto CONF_KEY_SAMPLES_PATH                  = "samples_path";
@@ -0,0 +1,611 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/dsp.h"
+#include "core/const.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define G_DSP_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define G_TARGET_AVX2
+#else
+#define G_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace giada::m::dsp
+{
+namespace
+{
+/* Scalar kernels. They also take care of the leftovers of the vectorized ones,
+so the comparisons are written the same way SIMD min/max instructions work. */
+
+void copyScalar_(float* dst, const float* src, int size, float gain)
+{
+	for (int i = 0; i < size; i++)
+		dst[i] = src[i] * gain;
+}
+
+void sumScalar_(float* dst, const float* src, int size, float gain)
+{
+	for (int i = 0; i < size; i++)
+		dst[i] = dst[i] + src[i] * gain;
+}
+
+void sumStereoScalar_(float* dst, const float* src, int frames, float gainL, float gainR)
+{
+	for (int i = 0; i < frames * 2; i += 2)
+	{
+		dst[i]     = dst[i] + src[i] * gainL;
+		dst[i + 1] = dst[i + 1] + src[i + 1] * gainR;
+	}
+}
+
+void sumMonoToStereoScalar_(float* dst, const float* src, int frames, float gainL, float gainR)
+{
+	for (int i = 0; i < frames; i++)
+	{
+		dst[i * 2]     = dst[i * 2] + src[i] * gainL;
+		dst[i * 2 + 1] = dst[i * 2 + 1] + src[i] * gainR;
+	}
+}
+
+void applyGainScalar_(float* data, int size, float gain)
+{
+	for (int i = 0; i < size; i++)
+		data[i] = data[i] * gain;
+}
+
+void clampScalar_(float* data, int size, float min, float max)
+{
+	for (int i = 0; i < size; i++)
+	{
+		const float v = data[i] < max ? data[i] : max;
+		data[i]       = v > min ? v : min;
+	}
+}
+
+float getPeakScalar_(const float* data, int size, float peak = 0.0f)
+{
+	for (int i = 0; i < size; i++)
+	{
+		const float v = std::fabs(data[i]);
+		peak          = v > peak ? v : peak;
+	}
+	return peak;
+}
+
+Peak getStereoPeakScalar_(const float* data, int frames, Peak peak = {0.0f, 0.0f})
+{
+	for (int i = 0; i < frames * 2; i += 2)
+	{
+		const float l = std::fabs(data[i]);
+		const float r = std::fabs(data[i + 1]);
+		peak.left     = l > peak.left ? l : peak.left;
+		peak.right    = r > peak.right ? r : peak.right;
+	}
+	return peak;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef G_DSP_X86
+
+void copySSE2_(float* dst, const float* src, int size, float gain)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	int          i = 0;
+	for (; i + 4 <= size; i += 4)
+		_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+	copyScalar_(dst + i, src + i, size - i, gain);
+}
+
+void sumSSE2_(float* dst, const float* src, int size, float gain)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	int          i = 0;
+	for (; i + 4 <= size; i += 4)
+		_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+	sumScalar_(dst + i, src + i, size - i, gain);
+}
+
+void sumStereoSSE2_(float* dst, const float* src, int frames, float gainL, float gainR)
+{
+	const __m128 g = _mm_setr_ps(gainL, gainR, gainL, gainR);
+	int          f = 0;
+	for (; f + 2 <= frames; f += 2)
+		_mm_storeu_ps(dst + f * 2, _mm_add_ps(_mm_loadu_ps(dst + f * 2), _mm_mul_ps(_mm_loadu_ps(src + f * 2), g)));
+	sumStereoScalar_(dst + f * 2, src + f * 2, frames - f, gainL, gainR);
+}
+
+void sumMonoToStereoSSE2_(float* dst, const float* src, int frames, float gainL, float gainR)
+{
+	const __m128 g = _mm_setr_ps(gainL, gainR, gainL, gainR);
+	int          f = 0;
+	for (; f + 4 <= frames; f += 4)
+	{
+		const __m128 m  = _mm_loadu_ps(src + f);
+		const __m128 lo = _mm_unpacklo_ps(m, m); // m0 m0 m1 m1
+		const __m128 hi = _mm_unpackhi_ps(m, m); // m2 m2 m3 m3
+		float*       d  = dst + f * 2;
+		_mm_storeu_ps(d, _mm_add_ps(_mm_loadu_ps(d), _mm_mul_ps(lo, g)));
+		_mm_storeu_ps(d + 4, _mm_add_ps(_mm_loadu_ps(d + 4), _mm_mul_ps(hi, g)));
+	}
+	sumMonoToStereoScalar_(dst + f * 2, src + f, frames - f, gainL, gainR);
+}
+
+void applyGainSSE2_(float* data, int size, float gain)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	int          i = 0;
+	for (; i + 4 <= size; i += 4)
+		_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+	applyGainScalar_(data + i, size - i, gain);
+}
+
+void clampSSE2_(float* data, int size, float min, float max)
+{
+	const __m128 lo = _mm_set1_ps(min);
+	const __m128 hi = _mm_set1_ps(max);
+	int          i  = 0;
+	for (; i + 4 <= size; i += 4)
+		_mm_storeu_ps(data + i, _mm_max_ps(_mm_min_ps(_mm_loadu_ps(data + i), hi), lo));
+	clampScalar_(data + i, size - i, min, max);
+}
+
+float getPeakSSE2_(const float* data, int size)
+{
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	__m128       acc  = _mm_setzero_ps();
+	int          i    = 0;
+	for (; i + 4 <= size; i += 4)
+		acc = _mm_max_ps(_mm_andnot_ps(sign, _mm_loadu_ps(data + i)), acc);
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, acc);
+	return getPeakScalar_(data + i, size - i, getPeakScalar_(lanes, 4));
+}
+
+Peak getStereoPeakSSE2_(const float* data, int frames)
+{
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	__m128       acc  = _mm_setzero_ps();
+	int          f    = 0;
+	for (; f + 2 <= frames; f += 2)
+		acc = _mm_max_ps(_mm_andnot_ps(sign, _mm_loadu_ps(data + f * 2)), acc);
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, acc);
+	return getStereoPeakScalar_(data + f * 2, frames - f, getStereoPeakScalar_(lanes, 2));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* AVX2 kernels clear the upper half of the registers before leaving: the 
+compiler won't do it before tail-calling the scalar leftovers, and mixing dirty
+AVX state with SSE code is slow. */
+
+G_TARGET_AVX2 void copyAVX2_(float* dst, const float* src, int size, float gain)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+	int          i = 0;
+	for (; i + 8 <= size; i += 8)
+		_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+	_mm256_zeroupper();
+	copyScalar_(dst + i, src + i, size - i, gain);
+}
+
+G_TARGET_AVX2 void sumAVX2_(float* dst, const float* src, int size, float gain)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+	int          i = 0;
+	for (; i + 8 <= size; i += 8)
+		_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+	_mm256_zeroupper();
+	sumScalar_(dst + i, src + i, size - i, gain);
+}
+
+G_TARGET_AVX2 void sumStereoAVX2_(float* dst, const float* src, int frames, float gainL, float gainR)
+{
+	const __m256 g = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, gainL, gainR);
+	int          f = 0;
+	for (; f + 4 <= frames; f += 4)
+		_mm256_storeu_ps(dst + f * 2, _mm256_add_ps(_mm256_loadu_ps(dst + f * 2), _mm256_mul_ps(_mm256_loadu_ps(src + f * 2), g)));
+	_mm256_zeroupper();
+	sumStereoScalar_(dst + f * 2, src + f * 2, frames - f, gainL, gainR);
+}
+
+G_TARGET_AVX2 void sumMonoToStereoAVX2_(float* dst, const float* src, int frames, float gainL, float gainR)
+{
+	const __m256  g     = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, gainL, gainR);
+	const __m256i idxLo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	const __m256i idxHi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+	int           f     = 0;
+	for (; f + 8 <= frames; f += 8)
+	{
+		const __m256 m  = _mm256_loadu_ps(src + f);
+		const __m256 lo = _mm256_permutevar8x32_ps(m, idxLo);
+		const __m256 hi = _mm256_permutevar8x32_ps(m, idxHi);
+		float*       d  = dst + f * 2;
+		_mm256_storeu_ps(d, _mm256_add_ps(_mm256_loadu_ps(d), _mm256_mul_ps(lo, g)));
+		_mm256_storeu_ps(d + 8, _mm256_add_ps(_mm256_loadu_ps(d + 8), _mm256_mul_ps(hi, g)));
+	}
+	_mm256_zeroupper();
+	sumMonoToStereoScalar_(dst + f * 2, src + f, frames - f, gainL, gainR);
+}
+
+G_TARGET_AVX2 void applyGainAVX2_(float* data, int size, float gain)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+	int          i = 0;
+	for (; i + 8 <= size; i += 8)
+		_mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+	_mm256_zeroupper();
+	applyGainScalar_(data + i, size - i, gain);
+}
+
+G_TARGET_AVX2 void clampAVX2_(float* data, int size, float min, float max)
+{
+	const __m256 lo = _mm256_set1_ps(min);
+	const __m256 hi = _mm256_set1_ps(max);
+	int          i  = 0;
+	for (; i + 8 <= size; i += 8)
+		_mm256_storeu_ps(data + i, _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(data + i), hi), lo));
+	_mm256_zeroupper();
+	clampScalar_(data + i, size - i, min, max);
+}
+
+G_TARGET_AVX2 float getPeakAVX2_(const float* data, int size)
+{
+	const __m256 sign = _mm256_set1_ps(-0.0f);
+	__m256       acc  = _mm256_setzero_ps();
+	int          i    = 0;
+	for (; i + 8 <= size; i += 8)
+		acc = _mm256_max_ps(_mm256_andnot_ps(sign, _mm256_loadu_ps(data + i)), acc);
+
+	float lanes[8];
+	_mm256_storeu_ps(lanes, acc);
+	_mm256_zeroupper();
+	return getPeakScalar_(data + i, size - i, getPeakScalar_(lanes, 8));
+}
+
+G_TARGET_AVX2 Peak getStereoPeakAVX2_(const float* data, int frames)
+{
+	const __m256 sign = _mm256_set1_ps(-0.0f);
+	__m256       acc  = _mm256_setzero_ps();
+	int          f    = 0;
+	for (; f + 4 <= frames; f += 4)
+		acc = _mm256_max_ps(_mm256_andnot_ps(sign, _mm256_loadu_ps(data + f * 2)), acc);
+
+	float lanes[8];
+	_mm256_storeu_ps(lanes, acc);
+	_mm256_zeroupper();
+	return getStereoPeakScalar_(data + f * 2, frames - f, getStereoPeakScalar_(lanes, 4));
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool cpuHasAVX2_()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	const bool osxsave = info[2] & (1 << 27);
+	__cpuidex(info, 7, 0);
+	const bool avx2 = info[1] & (1 << 5);
+	return osxsave && avx2 && (_xgetbv(0) & 0x6) == 0x6; // OS saves YMM registers
+#else
+	__builtin_cpu_init(); // Might run before libgcc's own constructors
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // G_DSP_X86
+
+/* -------------------------------------------------------------------------- */
+
+struct Kernels_
+{
+	void (*copy)(float*, const float*, int, float);
+	void (*sum)(float*, const float*, int, float);
+	void (*sumStereo)(float*, const float*, int, float, float);
+	void (*sumMonoToStereo)(float*, const float*, int, float, float);
+	void (*applyGain)(float*, int, float);
+	void (*clamp)(float*, int, float, float);
+	float (*getPeak)(const float*, int);
+	Peak (*getStereoPeak)(const float*, int);
+};
+
+/* -------------------------------------------------------------------------- */
+
+bool isSupported_(Isa isa)
+{
+	switch (isa)
+	{
+	case Isa::SCALAR:
+		return true;
+#ifdef G_DSP_X86
+	case Isa::SSE2:
+		return true; // Part of the x86-64 baseline
+	case Isa::AVX2:
+		return cpuHasAVX2_();
+#endif
+	default:
+		return false;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+Kernels_ makeKernels_(Isa isa)
+{
+	switch (isa)
+	{
+#ifdef G_DSP_X86
+	case Isa::SSE2:
+		return {copySSE2_, sumSSE2_, sumStereoSSE2_, sumMonoToStereoSSE2_,
+		    applyGainSSE2_, clampSSE2_, getPeakSSE2_, getStereoPeakSSE2_};
+	case Isa::AVX2:
+		return {copyAVX2_, sumAVX2_, sumStereoAVX2_, sumMonoToStereoAVX2_,
+		    applyGainAVX2_, clampAVX2_, getPeakAVX2_, getStereoPeakAVX2_};
+#endif
+	default:
+		return {copyScalar_, sumScalar_, sumStereoScalar_, sumMonoToStereoScalar_,
+		    applyGainScalar_, clampScalar_, [](const float* d, int s) { return getPeakScalar_(d, s); },
+		    [](const float* d, int f) { return getStereoPeakScalar_(d, f); }};
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+Isa getBestIsa_()
+{
+	for (Isa isa : {Isa::AVX2, Isa::SSE2})
+		if (isSupported_(isa))
+			return isa;
+	return Isa::SCALAR;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Isa      isa_     = getBestIsa_();
+Kernels_ kernels_ = makeKernels_(isa_);
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Isa getIsa()
+{
+	return isa_;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool setIsa(Isa isa)
+{
+	if (!isSupported_(isa))
+		return false;
+	isa_     = isa;
+	kernels_ = makeKernels_(isa);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void copy(float* dst, const float* src, int size, float gain) { kernels_.copy(dst, src, size, gain); }
+void sum(float* dst, const float* src, int size, float gain) { kernels_.sum(dst, src, size, gain); }
+void applyGain(float* data, int size, float gain) { kernels_.applyGain(data, size, gain); }
+void clamp(float* data, int size, float min, float max) { kernels_.clamp(data, size, min, max); }
+float getPeak(const float* data, int size) { return kernels_.getPeak(data, size); }
+Peak  getStereoPeak(const float* data, int frames) { return kernels_.getStereoPeak(data, frames); }
+
+void sumStereo(float* dst, const float* src, int frames, float gainL, float gainR)
+{
+	kernels_.sumStereo(dst, src, frames, gainL, gainR);
+}
+
+void sumMonoToStereo(float* dst, const float* src, int frames, float gainL, float gainR)
+{
+	kernels_.sumMonoToStereo(dst, src, frames, gainL, gainR);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void set(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, float gain)
+{
+	const int frames = std::min(dst.countFrames(), src.countFrames());
+	if (frames == 0)
+		return;
+	if (dst.countChannels() == src.countChannels())
+		copy(dst[0], src[0], frames * dst.countChannels(), gain);
+	else
+		dst.set(src, gain);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sum(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, float gain, mcl::AudioBuffer::Pan pan)
+{
+	const int frames = std::min(dst.countFrames(), src.countFrames());
+	if (frames == 0)
+		return;
+	if (dst.countChannels() == 2 && src.countChannels() == 2)
+		sumStereo(dst[0], src[0], frames, gain * pan[0], gain * pan[1]);
+	else if (dst.countChannels() == 2 && src.countChannels() == 1)
+		sumMonoToStereo(dst[0], src[0], frames, gain * pan[0], gain * pan[1]);
+	else if (dst.countChannels() == 1 && src.countChannels() == 1)
+		sum(dst[0], src[0], frames, gain * pan[0]);
+	else
+		dst.sum(src, gain, pan);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void applyGain(mcl::AudioBuffer& b, float gain)
+{
+	if (b.countFrames() > 0)
+		applyGain(b[0], b.countFrames() * b.countChannels(), gain);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void clamp(mcl::AudioBuffer& b, float min, float max)
+{
+	if (b.countFrames() > 0)
+		clamp(b[0], b.countFrames() * b.countChannels(), min, max);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Peak getPeak(const mcl::AudioBuffer& b)
+{
+	if (b.countFrames() == 0)
+		return {0.0f, 0.0f};
+	if (b.countChannels() == 2)
+		return getStereoPeak(b[0], b.countFrames());
+	if (b.countChannels() == 1)
+	{
+		const float peak = getPeak(b[0], b.countFrames());
+		return {peak, peak};
+	}
+	return {b.getPeak(0), b.getPeak(1)};
+}
+
+/* -------------------------------------------------------------------------- */
+
+void set(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, SmoothedParam::Ramp gain)
+{
+	if (gain.isFlat())
+	{
+		set(dst, src, gain.to);
+		return;
+	}
+
+	const int frames      = std::min(dst.countFrames(), src.countFrames());
+	const int channels    = dst.countChannels();
+	const int srcChannels = src.countChannels();
+
+	for (int i = 0; i < frames; i++)
+	{
+		const float g = gain.at(i, frames);
+		for (int j = 0; j < channels; j++)
+			dst[i][j] = src[i][std::min(j, srcChannels - 1)] * g;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sum(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, SmoothedParam::Ramp gain,
+    Frame destOffset)
+{
+	if (gain.isFlat() && destOffset == 0)
+	{
+		sum(dst, src, gain.to);
+		return;
+	}
+	if (gain.isFlat())
+	{
+		dst.sum(src, /*framesToCopy=*/-1, /*srcOffset=*/0, destOffset, gain.to);
+		return;
+	}
+
+	const int frames      = std::min(dst.countFrames() - destOffset, src.countFrames());
+	const int channels    = dst.countChannels();
+	const int srcChannels = src.countChannels();
+
+	for (int i = 0; i < frames; i++)
+	{
+		const float g = gain.at(i, src.countFrames());
+		for (int j = 0; j < channels; j++)
+			dst[destOffset + i][j] += src[i][std::min(j, srcChannels - 1)] * g;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sum(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, SmoothedParam::Ramp gain,
+    SmoothedParam::Ramp pan)
+{
+	if (gain.isFlat() && pan.isFlat())
+	{
+		sum(dst, src, gain.to, makePan(pan.to));
+		return;
+	}
+
+	const int frames      = std::min(dst.countFrames(), src.countFrames());
+	const int channels    = std::min(dst.countChannels(), G_MAX_IO_CHANS);
+	const int srcChannels = src.countChannels();
+
+	for (int i = 0; i < frames; i++)
+	{
+		const float                 g = gain.at(i, frames);
+		const mcl::AudioBuffer::Pan p = makePan(pan.at(i, frames));
+		for (int j = 0; j < channels; j++)
+			dst[i][j] += src[i][std::min(j, srcChannels - 1)] * g * p[j];
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void applyGain(mcl::AudioBuffer& b, SmoothedParam::Ramp gain)
+{
+	if (gain.isFlat())
+	{
+		applyGain(b, gain.to);
+		return;
+	}
+
+	const int frames   = b.countFrames();
+	const int channels = b.countChannels();
+
+	for (int i = 0; i < frames; i++)
+	{
+		const float g = gain.at(i, frames);
+		for (int j = 0; j < channels; j++)
+			b[i][j] *= g;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer::Pan makePan(float pan)
+{
+	/* TODO - precompute the AudioBuffer::Pan when pan value changes instead of
+	building it on the fly. */
+
+	/* Center pan (0.5f)? Pass-through. */
+
+	if (pan == 0.5f)
+		return {1.0f, 1.0f};
+	return {1.0f - pan, pan};
+}
+} // namespace giada::m::dsp
@@ -0,0 +1,142 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_DSP_H
+#define G_DSP_H
+
+#include "core/smoothedParam.h"
+#include "core/types.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+
+/* Vectorized kernels for the per-sample loops of the audio thread. The best
+instruction set available (SSE2, AVX2 on x86-64) is picked at startup, with a 
+plain scalar fallback. All variants produce bit-identical results: operations
+are carried out in the same order, with no fused multiply-add. All functions 
+are realtime-safe. */
+
+namespace giada::m::dsp
+{
+enum class Isa
+{
+	SCALAR,
+	SSE2,
+	AVX2
+};
+
+/* getIsa
+Returns the instruction set currently in use. */
+
+Isa getIsa();
+
+/* setIsa
+Forces a specific instruction set, for testing and benchmarking. Returns false
+if the CPU doesn't support it. Not thread-safe: don't call while audio is 
+running. */
+
+bool setIsa(Isa);
+
+/* -------------------------------------------------------------------------- */
+
+/* Kernels on raw interleaved data. 'size' is the number of samples, i.e. 
+frames * channels. */
+
+/* copy
+dst = src * gain. */
+
+void copy(float* dst, const float* src, int size, float gain);
+
+/* sum
+dst += src * gain. */
+
+void sum(float* dst, const float* src, int size, float gain);
+
+/* sumStereo
+Sums 'frames' frames of stereo 'src' into stereo 'dst', with a separate gain
+for each channel. */
+
+void sumStereo(float* dst, const float* src, int frames, float gainL, float gainR);
+
+/* sumMonoToStereo
+Sums 'frames' frames of mono 'src' into both channels of stereo 'dst', with a
+separate gain for each channel. */
+
+void sumMonoToStereo(float* dst, const float* src, int frames, float gainL, float gainR);
+
+/* applyGain
+data *= gain. */
+
+void applyGain(float* data, int size, float gain);
+
+/* clamp
+Clamps data in range [min, max]. NaNs become 'max'. */
+
+void clamp(float* data, int size, float min, float max);
+
+/* getPeak
+Returns the highest absolute value in data. */
+
+float getPeak(const float* data, int size);
+
+/* getStereoPeak
+Returns the highest absolute value of each channel in stereo data. */
+
+Peak getStereoPeak(const float* data, int frames);
+
+/* -------------------------------------------------------------------------- */
+
+/* Same kernels on mcl::AudioBuffer, over the frames both buffers have. Mono
+and stereo layouts take the fast path, any other layout falls back to the 
+AudioBuffer's own methods. */
+
+void set(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, float gain);
+void sum(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, float gain,
+    mcl::AudioBuffer::Pan pan = {1.0f, 1.0f});
+void applyGain(mcl::AudioBuffer&, float gain);
+void clamp(mcl::AudioBuffer&, float min, float max);
+Peak getPeak(const mcl::AudioBuffer&);
+
+/* -------------------------------------------------------------------------- */
+
+/* Ramped variants of the above, with gain (and panning) moving linearly across
+the block as read from a SmoothedParam. They take the steady path when ramps 
+are flat. 'destOffset' is the frame in 'dst' where 'src' starts. Panning goes
+from 0.0 (left) to 1.0 (right), see makePan(). */
+
+void set(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, SmoothedParam::Ramp gain);
+void sum(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, SmoothedParam::Ramp gain,
+    Frame destOffset = 0);
+void sum(mcl::AudioBuffer& dst, const mcl::AudioBuffer& src, SmoothedParam::Ramp gain,
+    SmoothedParam::Ramp pan);
+void applyGain(mcl::AudioBuffer&, SmoothedParam::Ramp gain);
+
+/* makePan
+Turns a pan value in [0.0, 1.0] into per-channel gains. Center is a 
+pass-through. */
+
+mcl::AudioBuffer::Pan makePan(float pan);
+} // namespace giada::m::dsp
+
+#endif
@@ -28,37 +28,60 @@
 #include "core/conf.h"
 #include "core/confFactory.h"
 #include "core/model/model.h"
+#include "core/rtCheck.h"
+#include "core/waveCache.h"
 #include "utils/fs.h"
 #include "utils/log.h"
 #include "utils/string.h"
+#include "utils/trace.h"
+#include <algorithm>
 #include <fmt/core.h>
 #include <memory>
 
 namespace giada::m
 {
+namespace
+{
+/* threadRegistered_
+Whether the calling thread has been registered already. Registration is 
+expensive (string conversion, lookup) and the audio callback asks for it on 
+each block. */
+
+thread_local bool threadRegistered_ = false;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 Engine::Engine()
 : onMidiReceived(nullptr)
 , onMidiSent(nullptr)
 , onModelSwap(nullptr)
+, onWavesLoaded(nullptr)
 , m_kernelAudio(m_model)
 , m_kernelMidi(m_model)
 , m_midiMapper(m_kernelMidi)
 , m_pluginHost(m_model)
 , m_midiSynchronizer(m_model, m_kernelMidi)
 , m_sequencer(m_model, m_midiSynchronizer, m_jackTransport)
-, m_mixer(m_model)
+, m_mixer(m_model, m_profiler)
 , m_channelManager(m_model)
 , m_actionRecorder(m_model)
 , m_recorder(m_sequencer, m_channelManager, m_mixer, m_actionRecorder)
 , m_midiDispatcher(m_model)
-, m_mainApi(m_kernelAudio, m_mixer, m_sequencer, m_midiSynchronizer, m_channelManager, m_recorder)
+, m_offlineRenderer(m_model, m_sequencer)
+, m_mainApi(m_kernelAudio, m_mixer, m_sequencer, m_channelManager, m_recorder, m_profiler, m_eventDispatcher)
 , m_channelsApi(*this, m_model, m_kernelAudio, m_mixer, m_sequencer, m_channelManager, m_recorder, m_actionRecorder, m_pluginHost, m_pluginManager)
 , m_pluginsApi(m_kernelAudio, m_pluginManager, m_pluginHost, m_model)
 , m_sampleEditorApi(m_kernelAudio, m_model, m_channelManager)
 , m_actionEditorApi(*this, m_model, m_sequencer, m_actionRecorder)
 , m_ioApi(m_model, m_midiDispatcher)
-, m_storageApi(*this, m_model, m_patch, m_pluginManager, m_midiSynchronizer, m_mixer, m_channelManager, m_kernelAudio, m_sequencer, m_actionRecorder)
+, m_storageApi(*this, m_model, m_patch, m_pluginManager, m_midiSynchronizer, m_mixer, m_channelManager, m_kernelAudio, m_sequencer, m_actionRecorder, m_offlineRenderer)
 , m_configApi(m_model, m_kernelAudio, m_kernelMidi, m_midiMapper)
+, m_offline(false)
+, m_inCallback(false)
+, m_audioPriority(RenderPool::Priority{})
 {
 	m_kernelAudio.onAudioCallback = [this](mcl::AudioBuffer& out, const mcl::AudioBuffer& in) {
 		return audioCallback(out, in);
@@ -118,43 +141,54 @@ Engine::Engine()
 
 #ifdef WITH_AUDIO_JACK
 	m_jackSynchronizer.onJackRewind = [this]() {
-		m_eventDispatcher.pumpEvent([this]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_sequencer.jack_rewind();
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::EventType::JACK_REWIND});
 	};
 	m_jackSynchronizer.onJackChangeBpm = [this](float bpm) {
-		m_eventDispatcher.pumpEvent([this, bpm]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_sequencer.jack_setBpm(bpm, m_kernelAudio.getSampleRate());
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::EventType::JACK_CHANGE_BPM, bpm});
 	};
 	m_jackSynchronizer.onJackStart = [this]() {
-		m_eventDispatcher.pumpEvent([this]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_sequencer.jack_start();
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::EventType::JACK_START});
 	};
 	m_jackSynchronizer.onJackStop = [this]() {
-		m_eventDispatcher.pumpEvent([this]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_sequencer.jack_stop();
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::EventType::JACK_STOP});
 	};
 #endif
 
 	m_mixer.onSignalTresholdReached = [this]() {
-		m_eventDispatcher.pumpEvent([this]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_recorder.startInputRecOnCallback();
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::EventType::SIGNAL_TRESHOLD_REACHED});
 	};
 	m_mixer.onEndOfRecording = [this]() {
 		if (m_mixer.isRecordingInput())
-			m_eventDispatcher.pumpEvent([this]() {
-				registerThread(Thread::EVENTS, /*realtime=*/false);
-				m_recorder.stopInputRec(m_kernelAudio.getSampleRate());
-			});
+			m_eventDispatcher.pumpEvent({EventDispatcher::EventType::END_OF_RECORDING});
+	};
+
+	m_eventDispatcher.onEvent = [this](const EventDispatcher::Event& e) {
+		registerThread(Thread::EVENTS, /*realtime=*/false);
+		switch (e.type)
+		{
+#ifdef WITH_AUDIO_JACK
+		case EventDispatcher::EventType::JACK_REWIND:
+			m_sequencer.jack_rewind();
+			break;
+		case EventDispatcher::EventType::JACK_CHANGE_BPM:
+			m_sequencer.jack_setBpm(e.value, m_kernelAudio.getSampleRate());
+			break;
+		case EventDispatcher::EventType::JACK_START:
+			m_sequencer.jack_start();
+			break;
+		case EventDispatcher::EventType::JACK_STOP:
+			m_sequencer.jack_stop();
+			break;
+#endif
+		case EventDispatcher::EventType::SIGNAL_TRESHOLD_REACHED:
+			m_recorder.startInputRecOnCallback();
+			break;
+		case EventDispatcher::EventType::END_OF_RECORDING:
+			m_recorder.stopInputRec(m_kernelAudio.getSampleRate());
+			break;
+		default:
+			break;
+		}
 	};
 
 	m_channelManager.onChannelsAltered = [this]() {
@@ -187,8 +221,33 @@ Engine::Engine()
 
 	m_model.onSwap = [this](model::SwapType t) {
 		assert(onModelSwap != nullptr);
+		/* Only HARD swaps change channels and plug-ins (e.g. patch loading).
+		Learned MIDI messages ask for a rebuild on their own. */
+		if (t == model::SwapType::HARD)
+			m_midiDispatcher.requestIndexRebuild();
 		onModelSwap(t);
 	};
+
+	m_offlineRenderer.onAboutToRender = [this]() {
+		m_kernelMidi.setOutputEnabled(false);
+		m_offline.store(true);
+		while (m_inCallback.load())
+			;
+		m_mixer.setRenderPriority(RenderPool::getThreadPriority());
+	};
+	m_offlineRenderer.onRendered = [this]() {
+		m_mixer.setRenderPriority(m_audioPriority.load());
+		m_offline.store(false);
+		m_kernelMidi.setOutputEnabled(true);
+	};
+	m_offlineRenderer.onRenderBlock = [this](mcl::AudioBuffer& out, const mcl::AudioBuffer& in, Mixer::Stems* stems) {
+		renderBlock(out, in, stems);
+	};
+
+	m_storageApi.onWavesLoaded = [this]() {
+		assert(onWavesLoaded != nullptr);
+		onWavesLoaded();
+	};
 }
 
 /* -------------------------------------------------------------------------- */
@@ -232,12 +291,15 @@ void Engine::init(const Conf& conf)
 
 	m_kernelAudio.init();
 
+	waveCache::init(u::fs::getWaveCachePath(), static_cast<std::size_t>(std::max(0, conf.waveCacheSize)) * 1024 * 1024);
+
 	m_mixer.reset(m_sequencer.getMaxFramesInLoop(m_kernelAudio.getSampleRate()), m_kernelAudio.getBufferSize());
 	m_channelManager.reset(m_kernelAudio.getBufferSize());
 	m_sequencer.reset(m_kernelAudio.getSampleRate());
 	m_pluginHost.reset(m_kernelAudio.getBufferSize());
 	m_pluginManager.reset(conf.pluginSortMethod);
 
+	m_mixer.setRenderThreads(layout.kernelAudio.renderThreads);
 	m_mixer.enable();
 	m_kernelAudio.startStream();
 
@@ -246,13 +308,42 @@ void Engine::init(const Conf& conf)
 
 	m_midiMapper.sendInitMessages(m_midiMapper.currentMap);
 	m_eventDispatcher.start();
-	m_midiSynchronizer.startSendClock(G_DEFAULT_BPM);
+	m_midiDispatcher.start();
+	m_midiSynchronizer.startSendClock();
+	m_profiler.start();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Engine::initHeadless(const Conf& conf)
+{
+	registerThread(Thread::MAIN, /*realtime=*/false);
+
+	m_model.init();
+	m_model.load(conf);
+
+	const int sampleRate = m_kernelAudio.getSampleRate();
+	const int bufferSize = m_kernelAudio.getBufferSize();
+
+	m_mixer.reset(m_sequencer.getMaxFramesInLoop(sampleRate), bufferSize);
+	m_channelManager.reset(bufferSize);
+	m_sequencer.reset(sampleRate);
+	m_pluginHost.reset(bufferSize);
+	m_pluginManager.reset(conf.pluginSortMethod);
+
+	m_mixer.setRenderThreads(m_model.get().kernelAudio.renderThreads);
+	m_mixer.enable();
+	m_profiler.start();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Engine::reset(PluginManager::SortMethod pluginSortMethod)
 {
+	/* Stop loading Waves from the previous project, if any. */
+
+	m_storageApi.cancelLoading();
+
 	/* Managers first, due to the internal ID numbering. */
 
 	channelFactory::reset();
@@ -281,9 +372,16 @@ void Engine::shutdown(Conf& conf)
 		m_kernelAudio.shutdown();
 		u::log::print("[Engine::shutdown] KernelAudio closed\n");
 		m_mixer.disable();
+		m_mixer.setRenderThreads(0);
 		u::log::print("[Engine::shutdown] Mixer closed\n");
 	}
 
+	m_storageApi.cancelLoading();
+	m_eventDispatcher.stop();
+	m_kernelMidi.stop();
+	m_midiDispatcher.stop();
+	m_profiler.stop();
+
 	m_model.store(conf);
 
 	/* Currently the Engine is global/static, and so are all of its sub-components,
@@ -300,6 +398,27 @@ int Engine::audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) con
 {
 	registerThread(Thread::AUDIO, /*realtime=*/true);
 
+	const rtCheck::Scope rtCheckScope;
+
+	/* Step aside while the offline renderer is driving the engine. Raising 
+	m_inCallback before reading m_offline guarantees that the offline renderer,
+	which does the opposite, either sees this callback running and waits for it
+	or is seen by it. */
+
+	m_inCallback.store(true);
+	if (m_offline.load())
+		out.clear();
+	else
+		renderBlock(out, in, nullptr);
+	m_inCallback.store(false);
+
+	return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Engine::renderBlock(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, Mixer::Stems* stems) const
+{
 	/* Clean up output buffer before any rendering. Do this even if mixer is
 	disabled to avoid audio leftovers during a temporary suspension (e.g. when
 	loading a new patch). */
@@ -307,7 +426,8 @@ int Engine::audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) con
 	out.clear();
 
 	/* Prepare the LayoutLock. From this point on (until out of scope) the
-	Layout is locked for realtime rendering by the audio thread. Rendering
+	Layout is locked for realtime rendering by the audio thread, and no shared
+	data (Waves, Plugins, Actions) it can reach will be freed. Rendering
 	functions must access the realtime layout coming from layoutLock.get(). */
 
 	const model::LayoutLock   layoutLock  = m_model.get_RT();
@@ -317,20 +437,36 @@ int Engine::audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) con
 	const model::Sequencer&   sequencer   = layout_RT.sequencer;
 	const model::Channels&    channels    = layout_RT.channels;
 
+	const Profiler::Scope callbackScope(m_profiler, Profiler::Stage::CALLBACK);
+
+	/* Let the MIDI scheduler know a new block has started, so that MIDI events
+	sent during this block can be timestamped with sample accuracy. Then 
+	generate MIDI clock pulses for this block, if in MIDI clock MASTER mode. 
+	Pulses are derived from the sample clock, not from a timer. None of this 
+	while rendering offline: blocks are not paced by the wall clock and MIDI
+	output is disabled altogether, as it would run way faster than the tempo. */
+
+	if (!m_offline.load())
+	{
+		m_kernelMidi.beginBlock_RT(kernelAudio.samplerate, out.countFrames());
+		m_midiSynchronizer.advance_RT(layout_RT, out.countFrames());
+	}
+
 	/* Mixer disabled or Kernel Audio not ready: nothing to do here. */
 
 	if (!mixer.a_isActive())
-		return 0;
+		return;
 
 #ifdef WITH_AUDIO_JACK
 	if (kernelAudio.api == RtAudio::Api::UNIX_JACK)
+	{
+		const Profiler::Scope scope(m_profiler, Profiler::Stage::JACK_SYNC);
 		m_jackSynchronizer.recvJackSync(m_jackTransport.getState());
+	}
 #endif
 
 	/* If the m_sequencer is running, advance it first (i.e. parse it for events).
-	Also advance channels (i.e. let them react to m_sequencer events), only if the
-	layout is not locked: another thread might altering channel's data in the
-	meantime (e.g. Plugins or Waves). */
+	Also advance channels (i.e. let them react to m_sequencer events). */
 
 	if (sequencer.isRunning())
 	{
@@ -339,18 +475,22 @@ int Engine::audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) con
 		const int          quantizerStep = m_sequencer.getQuantizerStep();            // TODO pass this to m_sequencer.advance - or better, Advancer class
 		const Range<Frame> renderRange   = {currentFrame, currentFrame + bufferSize}; // TODO pass this to m_sequencer.advance - or better, Advancer class
 
-		const Sequencer::EventBuffer& events = m_sequencer.advance(sequencer, bufferSize, kernelAudio.samplerate, m_actionRecorder);
-		m_sequencer.render(out);
-		if (!layout_RT.locked)
-			m_mixer.advanceChannels(events, channels, renderRange, quantizerStep);
+		const Sequencer::EventBuffer* events = nullptr;
+		{
+			const Profiler::Scope scope(m_profiler, Profiler::Stage::SEQUENCER);
+			events = &m_sequencer.advance(sequencer, bufferSize, kernelAudio.samplerate, m_actionRecorder);
+			m_sequencer.render(out);
+		}
+		{
+			const Profiler::Scope scope(m_profiler, Profiler::Stage::ADVANCE_CHANNELS);
+			m_mixer.advanceChannels(*events, channels, renderRange, quantizerStep);
+		}
 	}
 
 	/* Then render Mixer: render channels, process I/O. */
 
 	const int maxFramesToRec = mixer.inputRecMode == InputRecMode::FREE ? sequencer.getMaxFramesInLoop(kernelAudio.samplerate) : sequencer.framesInLoop;
-	m_mixer.render(out, in, layout_RT, maxFramesToRec);
-
-	return 0;
+	m_mixer.render(out, in, layout_RT, maxFramesToRec, stems);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -367,6 +507,13 @@ void Engine::resume()
 
 /* -------------------------------------------------------------------------- */
 
+void Engine::collectGarbage()
+{
+	m_model.collect();
+}
+
+/* -------------------------------------------------------------------------- */
+
 #ifdef G_DEBUG_MODE
 void Engine::debug()
 {
@@ -378,11 +525,27 @@ void Engine::debug()
 
 void Engine::registerThread(Thread t, bool isRealtime) const
 {
+	if (threadRegistered_)
+		return;
 	if (!m_model.registerThread(t, isRealtime))
 	{
 		u::log::print("[Engine::registerThread] Can't register thread %s! Aborting\n", u::string::toString(t).c_str());
 		std::abort();
 	}
+	u::trace::setThread(t);
+
+	/* A new audio thread, i.e. the stream has (re)started: render threads must
+	follow its priority. Read it here, once, not on each block: it might be a 
+	system call. */
+
+	if (t == Thread::AUDIO)
+	{
+		m_audioPriority.store(RenderPool::getThreadPriority());
+		if (!m_offline.load())
+			m_mixer.setRenderPriority(m_audioPriority.load());
+	}
+
+	threadRegistered_ = true;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -49,12 +49,15 @@
 #include "core/midiSynchronizer.h"
 #include "core/mixer.h"
 #include "core/model/model.h"
+#include "core/offlineRenderer.h"
 #include "core/patch.h"
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
+#include "core/profiler.h"
 #include "core/recorder.h"
 #include "core/sequencer.h"
 #include "core/waveFactory.h"
+#include <atomic>
 #ifdef WITH_AUDIO_JACK
 #include "core/jackSynchronizer.h"
 #endif
@@ -88,6 +91,12 @@ public:
 
 	void init(const Conf&);
 
+	/* initHeadless
+	Same as init(), without any audio or MIDI device: rendering must then be 
+	driven by hand with renderBlock(). Used by benchmarks. */
+
+	void initHeadless(const Conf&);
+
 	/* reset
 	Resets all sub-components to the initial state. Useful when Giada needs to
 	be brought back to the startup state. */
@@ -105,6 +114,20 @@ public:
 	void suspend();
 	void resume();
 
+	/* collectGarbage
+	Frees model data removed in the meantime by any thread. Main thread only,
+	to be called periodically. */
+
+	void collectGarbage();
+
+	/* renderBlock
+	Renders a single block of audio, i.e. what the audio callback does on each
+	cycle. Stems are optional (see Mixer::render). Call it directly only on a
+	headless engine or when the audio callback is kept out of the way (e.g. by
+	the offline renderer). */
+
+	void renderBlock(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, Mixer::Stems* = nullptr) const;
+
 #ifdef G_DEBUG_MODE
 	void debug();
 #endif
@@ -138,12 +161,19 @@ public:
 
 	std::function<void(model::SwapType)> onModelSwap;
 
+	/* onWavesLoaded
+	Callback fired when some project Waves have been loaded in background and
+	are ready to be attached to their channels. */
+
+	std::function<void()> onWavesLoaded;
+
 private:
 	int  audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) const;
 	void registerThread(Thread, bool isRealtime) const;
 
 	Patch                  m_patch;
 	model::Model           m_model;
+	Profiler               m_profiler;
 	KernelAudio            m_kernelAudio;
 	KernelMidi             m_kernelMidi;
 	MidiMapper<KernelMidi> m_midiMapper;
@@ -158,6 +188,7 @@ private:
 	PluginManager          m_pluginManager;
 	EventDispatcher        m_eventDispatcher;
 	MidiDispatcher         m_midiDispatcher;
+	OfflineRenderer        m_offlineRenderer;
 #ifdef WITH_AUDIO_JACK
 	JackSynchronizer m_jackSynchronizer;
 #endif
@@ -170,6 +201,19 @@ private:
 	IOApi           m_ioApi;
 	StorageApi      m_storageApi;
 	ConfigApi       m_configApi;
+
+	/* m_offline, m_inCallback
+	Handshake between the offline renderer and the realtime audio callback: 
+	the latter steps aside while the former is running. */
+
+	std::atomic<bool>         m_offline;
+	mutable std::atomic<bool> m_inCallback;
+
+	/* m_audioPriority
+	Scheduling priority of the audio thread, read once when it's registered. 
+	Render threads go back to it when offline rendering is over. */
+
+	mutable std::atomic<RenderPool::Priority> m_audioPriority;
 };
 } // namespace giada::m
 
@@ -24,38 +24,96 @@
  *
  * -------------------------------------------------------------------------- */
 
+
 #include "core/eventDispatcher.h"
-#include "core/const.h"
+#include "utils/log.h"
+#include "utils/trace.h"
 #include <cassert>
 
 namespace giada::m
 {
 EventDispatcher::EventDispatcher()
-: m_worker(G_EVENT_DISPATCHER_RATE_MS)
-, m_eventQueue(G_MAX_DISPATCHER_EVENTS)
+: onEvent(nullptr)
+, m_running(false)
+, m_semaphore(0)
+, m_droppedEvents(0)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+EventDispatcher::~EventDispatcher()
 {
+	stop();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void EventDispatcher::start()
 {
-	m_worker.start([this]() { process(); });
+	assert(onEvent != nullptr);
+
+	m_running.store(true);
+	m_thread = std::thread([this]() { process(); });
 }
 
 /* -------------------------------------------------------------------------- */
 
-bool EventDispatcher::pumpEvent(const std::function<void()>& f)
+void EventDispatcher::stop()
 {
-	return m_eventQueue.try_enqueue(f);
+	if (!m_thread.joinable())
+		return;
+	m_running.store(false);
+	m_semaphore.release();
+	m_thread.join();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool EventDispatcher::pumpEvent(Event e)
+{
+	const bool pushed = m_eventQueue.push(e);
+	if (!pushed)
+		m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+
+	/* Wake up the worker anyway: if the queue is full it's already late. */
+
+	m_semaphore.release();
+	return pushed;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int EventDispatcher::countDroppedEvents() const
+{
+	return m_droppedEvents.load(std::memory_order_relaxed);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void EventDispatcher::process()
 {
-	Event e;
-	while (m_eventQueue.try_dequeue(e))
-		e();
+	int droppedEvents = 0;
+
+	while (true)
+	{
+		m_semaphore.acquire();
+
+		if (!m_running.load())
+			return;
+
+		Event e;
+		while (m_eventQueue.pop(e))
+		{
+			const u::trace::Scope trace("event_dispatcher");
+			onEvent(e);
+		}
+
+		if (const int count = countDroppedEvents(); count != droppedEvents)
+		{
+			u::log::print("[EventDispatcher::process] event queue full, %d events dropped so far\n", count);
+			droppedEvents = count;
+		}
+	}
 }
-} // namespace giada::m
\ No newline at end of file
+} // namespace giada::m
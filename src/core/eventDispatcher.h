@@ -24,52 +24,97 @@
  *
  * -------------------------------------------------------------------------- */
 
+
 #ifndef G_EVENT_DISPATCHER_H
 #define G_EVENT_DISPATCHER_H
 
-#include "core/worker.h"
-#include "deps/concurrentqueue/concurrentqueue.h"
+#include "core/const.h"
+#include "core/queue.h"
+#include <atomic>
 #include <functional>
+#include <semaphore>
+#include <thread>
 
 /* giada::m::EventDispatcher
-Performs Events (a.k.a. function callbacks) in a separate worker thread. Used by
-the realtime thread (via Engine) to talk to other non-realtime threads. */
+Performs Events in a separate worker thread. Used by the realtime thread (via 
+Engine) to talk to other non-realtime threads. */
 
 namespace giada::m
 {
 class EventDispatcher
 {
 public:
+	/* EventType
+	All the things the realtime thread can ask the dispatcher to do. */
+
+	enum class EventType
+	{
+		NONE,
+		JACK_REWIND,
+		JACK_CHANGE_BPM,
+		JACK_START,
+		JACK_STOP,
+		SIGNAL_TRESHOLD_REACHED,
+		END_OF_RECORDING
+	};
+
 	/* Event
-	Alias for a std::function type. All events are just functions to be performed
-	by the EventDispatcher. */
+	Plain data describing an event, with an optional payload 'value' (e.g. the
+	new bpm). Cheap to copy, never allocates. */
 
-	using Event = std::function<void()>;
+	struct Event
+	{
+		EventType type  = EventType::NONE;
+		float     value = 0.0f;
+	};
 
 	EventDispatcher();
+	~EventDispatcher();
 
 	/* start
 	Starts the internal worker on a separate thread. Call this on startup. */
 
 	void start();
 
+	/* stop
+	Wakes up and joins the worker thread. */
+
+	void stop();
+
 	/* pumpEvent
-	Inserts a new event in the event queue. Returns false if the queue is full. */
+	Inserts a new event in the event queue and wakes up the worker. Returns false
+	if the queue is full: the event is dropped and counted. Never allocates nor
+	locks, so it's safe to call from the realtime thread. Single producer only. */
+
+	bool pumpEvent(Event);
 
-	bool pumpEvent(const Event&);
+	/* countDroppedEvents
+	Returns the number of events dropped so far because the queue was full. */
+
+	int countDroppedEvents() const;
+
+	/* onEvent
+	Callback fired by the worker thread for each event in the queue. */
+
+	std::function<void(const Event&)> onEvent;
 
 private:
 	void process();
 
-	/* m_worker
-	A separate thread responsible for the event processing. */
+	/* m_thread
+	A separate thread responsible for the event processing. It sleeps on 
+	m_semaphore until a new event is pumped in. */
 
-	Worker m_worker;
+	std::thread               m_thread;
+	std::atomic<bool>         m_running;
+	std::counting_semaphore<> m_semaphore;
 
 	/* m_eventQueue
-	Collects events coming from the UI or MIDI devices. */
+	Collects events coming from the realtime thread. */
+
+	Queue<Event, G_MAX_DISPATCHER_EVENTS> m_eventQueue;
 
-	moodycamel::ConcurrentQueue<Event> m_eventQueue;
+	std::atomic<int> m_droppedEvents;
 };
 } // namespace giada::m
 
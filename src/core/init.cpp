@@ -29,28 +29,47 @@
 #endif
 #include "core/confFactory.h"
 #include "core/engine.h"
+#include "core/rtCheck.h"
+#include "glue/storage.h"
 #include "gui/elems/mainWindow/mainIO.h"
 #include "gui/ui.h"
 #include "gui/updater.h"
 #include "utils/log.h"
+#include "utils/trace.h"
 #include "utils/ver.h"
 #ifdef WITH_TESTS
 #define CATCH_CONFIG_RUNNER
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "tests/actionRecorder.cpp"
+#include "tests/actionTimeline.cpp"
 #include "tests/channelFactory.cpp"
+#include "tests/dsp.cpp"
+#include "tests/idleTracker.cpp"
 #include "tests/midiEvent.cpp"
 #include "tests/midiLighter.cpp"
+#include "tests/midiScheduler.cpp"
+#include "tests/offlineRenderer.cpp"
+#include "tests/profiler.cpp"
+#include "tests/reclaimer.cpp"
+#include "tests/rtCheck.cpp"
 #include "tests/samplePlayer.cpp"
+#include "tests/sequencer.cpp"
+#include "tests/smoothedParam.cpp"
+#include "tests/threadPool.cpp"
 #include "tests/utils.cpp"
 #include "tests/wave.cpp"
+#include "tests/waveCache.cpp"
 #include "tests/waveFactory.cpp"
 #include "tests/waveFx.cpp"
+#include "tests/waveLoader.cpp"
 #include "tests/waveReader.cpp"
+#include "tests/waveStream.cpp"
 #include <catch2/catch.hpp>
-#include <string>
-#include <vector>
 #endif
 #include <FL/Fl.H>
+#include <cstring>
+#include <string>
+#include <vector>
 
 extern giada::m::Engine g_engine;
 extern giada::v::Ui     g_ui;
@@ -81,6 +100,26 @@ void printBuildInfo_()
 	KernelAudio::logCompiledAPIs();
 	KernelMidi::logCompiledAPIs();
 }
+
+/* -------------------------------------------------------------------------- */
+
+/* parseTraceArg_
+Looks for the '--trace <path>' command line option and removes it from 'args',
+which is then passed to the UI toolkit (FLTK quits on unknown options). 
+Returns the trace path, or an empty string if the option is not present. */
+
+std::string parseTraceArg_(std::vector<char*>& args)
+{
+	for (std::size_t i = 1; i + 1 < args.size(); i++)
+	{
+		if (strcmp(args[i], "--trace") != 0)
+			continue;
+		const std::string path = args[i + 1];
+		args.erase(args.begin() + i, args.begin() + i + 2);
+		return path;
+	}
+	return "";
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -127,6 +166,10 @@ void startup(int argc, char** argv)
 		g_ui.pumpEvent([type]() { type == model::SwapType::HARD ? g_ui.rebuild() : g_ui.refresh(); });
 	};
 
+	g_engine.onWavesLoaded = []() {
+		g_ui.pumpEvent([] { c::storage::attachLoadedWaves(); });
+	};
+
 	Conf conf = confFactory::deserialize();
 
 	if (!conf.valid)
@@ -135,9 +178,18 @@ void startup(int argc, char** argv)
 	if (!u::log::init(conf.logMode))
 		u::log::print("[init::startup] log init failed! Using default stdout\n");
 
+	/* Start tracing before anything else, so that threads spawned from now on
+	are recorded too. */
+
+	std::vector<char*> args(argv, argv + argc);
+	if (const std::string tracePath = parseTraceArg_(args); !tracePath.empty())
+		u::trace::init(tracePath);
+
+	rtCheck::init();
+
 	juce::initialiseJuce_GUI();
 	g_engine.init(conf);
-	g_ui.init(argc, argv, conf, G_DEFAULT_PATCH_NAME, g_engine.isAudioReady());
+	g_ui.init(static_cast<int>(args.size()), args.data(), conf, G_DEFAULT_PATCH_NAME, g_engine.isAudioReady());
 
 	printBuildInfo_();
 }
@@ -158,6 +210,8 @@ void shutdown()
 	g_ui.shutdown(conf);
 	g_engine.shutdown(conf);
 	juce::shutdownJuce_GUI();
+	u::trace::close();
+	rtCheck::close();
 
 	if (!confFactory::serialize(conf))
 		u::log::print("[init::shutdown] error while saving configuration file!\n");
@@ -32,6 +32,7 @@
 #include "core/kernelMidi.h"
 #include "core/model/model.h"
 #include "utils/log.h"
+#include "utils/trace.h"
 
 namespace giada::m
 {
@@ -58,20 +59,20 @@ void JackSynchronizer::recvJackSync(const JackTransport::State& state) const
 	{
 		if (jackStateCurr.frame != m_jackStatePrev.frame && jackStateCurr.frame == 0)
 		{
-			G_DEBUG("JackState received - rewind to frame 0", );
+			u::trace::instant("jack_rewind");
 			onJackRewind();
 		}
 
 		// jackStateCurr.bpm == 0 if JACK doesn't send that info
 		if (jackStateCurr.bpm != m_jackStatePrev.bpm && jackStateCurr.bpm > 1.0f)
 		{
-			G_DEBUG("JackState received - bpm={}", jackStateCurr.bpm);
+			u::trace::instant("jack_change_bpm");
 			onJackChangeBpm(jackStateCurr.bpm);
 		}
 
 		if (jackStateCurr.running != m_jackStatePrev.running)
 		{
-			G_DEBUG("JackState received - running={}", jackStateCurr.running);
+			u::trace::instant(jackStateCurr.running ? "jack_start" : "jack_stop");
 			jackStateCurr.running ? onJackStart() : onJackStop();
 		}
 	}
@@ -34,7 +34,10 @@
 #include "utils/log.h"
 #include "utils/string.h"
 #include "utils/vector.h"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 
 namespace giada::m
@@ -44,6 +47,9 @@ KernelAudio::KernelAudio(model::Model& model)
 , onStreamAboutToOpen(nullptr)
 , onStreamOpened(nullptr)
 , m_model(model)
+, m_dspLoad(0.0f)
+, m_dspLoadPeak(0.0f)
+, m_xrunsCount(0)
 {
 }
 
@@ -373,7 +379,19 @@ KernelAudio::OpenStreamResult KernelAudio::openStream_(
 	m_callbackInfo = {
 	    /* rtAudio */ this,
 	    /* channelsOutCount */ out.channelsCount,
-	    /* channelsInCount */ in.channelsCount};
+	    /* channelsInCount */ in.channelsCount,
+	    /* sampleRate */ actualSampleRate};
+
+	/* Stream is closed here, so the audio thread is not running: safe to start
+	measuring from scratch. */
+
+	Xrun xrun;
+	while (m_xrunsQueue.pop(xrun))
+		;
+	m_xruns.clear();
+	m_xrunsCount.store(0);
+	m_dspLoad.store(0.0f);
+	m_dspLoadPeak.store(0.0f);
 
 	RtAudioErrorType res = m_rtAudio->openStream(
 	    &outParams,                           // output params
@@ -396,15 +414,77 @@ KernelAudio::OpenStreamResult KernelAudio::openStream_(
 /* -------------------------------------------------------------------------- */
 
 int KernelAudio::audioCallback(void* outBuf, void* inBuf, unsigned bufferSize,
-    double /*streamTime*/, RtAudioStreamStatus /*status*/, void*   data)
+    double /*streamTime*/, RtAudioStreamStatus status, void* data)
 {
-	const CallbackInfo& info = *static_cast<CallbackInfo*>(data);
+	using Clock = std::chrono::steady_clock;
+
+	const CallbackInfo&     info  = *static_cast<CallbackInfo*>(data);
+	const Clock::time_point start = Clock::now();
 
 	mcl::AudioBuffer out(static_cast<float*>(outBuf), bufferSize, info.channelsOutCount);
 	mcl::AudioBuffer in;
 	if (info.channelsInCount > 0)
 		in = mcl::AudioBuffer(static_cast<float*>(inBuf), bufferSize, info.channelsInCount);
 
-	return info.kernelAudio->onAudioCallback(out, in);
+	const int res = info.kernelAudio->onAudioCallback(out, in);
+
+	const std::int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+	info.kernelAudio->measure_RT(elapsed, bufferSize, info.sampleRate, status);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void KernelAudio::measure_RT(std::int64_t elapsedNs, unsigned bufferSize, unsigned sampleRate, RtAudioStreamStatus status)
+{
+	if (bufferSize == 0 || sampleRate == 0)
+		return;
+
+	/* Load is smoothed with a one-pole filter, whose coefficient depends on how
+	many blocks per second are rendered. The peak decays with the same time
+	constant, ten times slower. */
+
+	const double period = bufferSize / static_cast<double>(sampleRate); // Seconds
+	const float  load   = static_cast<float>(elapsedNs / (period * 1e9));
+	const float  alpha  = static_cast<float>(1.0 - std::exp(-period / G_DSP_LOAD_SMOOTHING));
+
+	const float dspLoad = m_dspLoad.load();
+	m_dspLoad.store(dspLoad + (load - dspLoad) * alpha);
+	m_dspLoadPeak.store(std::max(load, m_dspLoadPeak.load() * (1.0f - alpha * 0.1f)));
+
+	if (status == 0)
+		return;
+
+	const auto now = std::chrono::system_clock::now().time_since_epoch();
+
+	/* Push first, count later: whoever sees the new count will also find the
+	xrun in the queue. If the queue is full the xrun is counted anyway. */
+
+	m_xrunsQueue.push({
+	    /* time */ std::chrono::duration_cast<std::chrono::milliseconds>(now).count(),
+	    /* inputOverflow */ (status & RTAUDIO_INPUT_OVERFLOW) != 0,
+	    /* outputUnderflow */ (status & RTAUDIO_OUTPUT_UNDERFLOW) != 0});
+	m_xrunsCount.fetch_add(1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+float KernelAudio::getDspLoad() const { return m_dspLoad.load(); }
+float KernelAudio::getDspLoadPeak() const { return m_dspLoadPeak.load(); }
+int   KernelAudio::countXruns() const { return m_xrunsCount.load(); }
+
+/* -------------------------------------------------------------------------- */
+
+const std::vector<KernelAudio::Xrun>& KernelAudio::getXruns()
+{
+	Xrun xrun;
+	while (m_xrunsQueue.pop(xrun))
+	{
+		if (m_xruns.size() == G_MAX_XRUNS)
+			m_xruns.erase(m_xruns.begin());
+		m_xruns.push_back(xrun);
+	}
+	return m_xruns;
 }
 } // namespace giada::m
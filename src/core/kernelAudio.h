@@ -27,10 +27,14 @@
 #ifndef G_KERNELAUDIO_H
 #define G_KERNELAUDIO_H
 
+#include "core/const.h"
 #include "core/model/model.h"
+#include "core/queue.h"
 #include "core/weakAtomic.h"
 #include "deps/rtaudio/RtAudio.h"
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -81,6 +85,17 @@ public:
 		unsigned int bufferSize       = G_DEFAULT_BUFSIZE;
 	};
 
+	/* Xrun
+	An over/underflow reported by the audio driver. 'time' is the wall-clock
+	time it was detected at, in milliseconds since epoch. */
+
+	struct Xrun
+	{
+		std::int64_t time            = 0;
+		bool         inputOverflow   = false;
+		bool         outputUnderflow = false;
+	};
+
 	KernelAudio(model::Model&);
 
 	static void logCompiledAPIs();
@@ -127,6 +142,24 @@ public:
 	jack_client_t* getJackHandle() const;
 #endif
 
+	/* getDspLoad, getDspLoadPeak
+	Time spent in the audio callback relative to the buffer period: 1.0 means
+	the whole period was used. getDspLoad() is smoothed over time, 
+	getDspLoadPeak() holds the highest recent value. */
+
+	float getDspLoad() const;
+	float getDspLoadPeak() const;
+
+	/* countXruns
+	Number of over/underflows reported since the stream was opened. */
+
+	int countXruns() const;
+
+	/* getXruns
+	Returns the latest G_MAX_XRUNS xruns, oldest first. Main thread only. */
+
+	const std::vector<Xrun>& getXruns();
+
 	/* onAudioCallback
 	Main callback invoked on each audio block. */
 
@@ -148,6 +181,7 @@ private:
 		KernelAudio* kernelAudio      = nullptr;
 		int          channelsOutCount = 0;
 		int          channelsInCount  = 0;
+		unsigned int sampleRate       = 0;
 	};
 
 	struct OpenStreamResult
@@ -167,6 +201,12 @@ private:
 
 	static int audioCallback(void*, void*, unsigned, double, RtAudioStreamStatus, void*);
 
+	/* measure_RT
+	Updates DSP load given the time spent rendering a block, and records any
+	xrun flagged by the driver. */
+
+	void measure_RT(std::int64_t elapsedNs, unsigned bufferSize, unsigned sampleRate, RtAudioStreamStatus);
+
 	Device fetchDevice(size_t deviceIndex) const;
 	void   printDevices(const std::vector<Device>& devices) const;
 
@@ -176,6 +216,15 @@ private:
 	std::unique_ptr<RtAudio> m_rtAudio;
 	CallbackInfo             m_callbackInfo;
 	model::Model&            m_model;
+
+	/* m_dspLoad, m_dspLoadPeak, m_xrunsCount, m_xrunsQueue
+	Written by the audio thread, read by anyone. */
+
+	WeakAtomic<float>        m_dspLoad;
+	WeakAtomic<float>        m_dspLoadPeak;
+	std::atomic<int>         m_xrunsCount;
+	Queue<Xrun, G_MAX_XRUNS> m_xrunsQueue;
+	std::vector<Xrun>        m_xruns;
 };
 } // namespace giada::m
 
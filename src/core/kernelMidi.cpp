@@ -29,6 +29,7 @@
 #include "core/midiEvent.h"
 #include "core/model/kernelAudio.h"
 #include "utils/log.h"
+#include "utils/trace.h"
 #include <algorithm>
 #include <cassert>
 #include <chrono>
@@ -38,10 +39,8 @@ namespace giada::m
 {
 namespace
 {
-constexpr auto OUTPUT_NAME       = "Giada MIDI output";
-constexpr auto INPUT_NAME        = "Giada MIDI input";
-constexpr int  MAX_RTMIDI_EVENTS = 8;
-constexpr int  MAX_NUM_PRODUCERS = 2; // Real-time thread and MIDI sync thread
+constexpr auto OUTPUT_NAME = "Giada MIDI output";
+constexpr auto INPUT_NAME  = "Giada MIDI input";
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -52,9 +51,8 @@ KernelMidi::KernelMidi(model::Model& m)
 : onMidiReceived(nullptr)
 , onMidiSent(nullptr)
 , m_model(m)
-, m_worker(G_KERNEL_MIDI_OUTPUT_RATE_MS)
-, m_midiQueue(MAX_RTMIDI_EVENTS, 0, MAX_NUM_PRODUCERS) // See https://github.com/cameron314/concurrentqueue#preallocation-correctly-using-try_enqueue
 , m_elpsedTime(0.0)
+, m_outputEnabled(true)
 {
 }
 
@@ -119,11 +117,22 @@ void KernelMidi::start()
 {
 	if (m_midiOut == nullptr)
 		return;
-	m_worker.start([this]() {
-		RtMidiMessage msg;
-		while (m_midiQueue.try_dequeue(msg))
-			m_midiOut->sendMessage(&msg);
-	});
+	/* onMidiSent is fired here, by the sender thread, rather than by send_RT():
+	listeners are free to allocate or lock (e.g. the UI). */
+
+	m_scheduler.onSend = [this](const MidiScheduler::Message& msg) {
+		assert(onMidiSent != nullptr);
+		m_midiOut->sendMessage(msg.data.data(), msg.size);
+		onMidiSent();
+	};
+	m_scheduler.start();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void KernelMidi::stop()
+{
+	m_scheduler.stop();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -204,25 +213,38 @@ std::vector<std::string> KernelMidi::getInPorts() const
 
 bool KernelMidi::send(const MidiEvent& event) const
 {
-	if (m_midiOut == nullptr)
+	if (m_midiOut == nullptr || !m_outputEnabled.load())
 		return false;
 
-	assert(event.getNumBytes() > 0 && event.getNumBytes() <= 3);
-	assert(onMidiSent != nullptr);
+	G_DEBUG("Send MIDI msg=0x{:0X}", event.getRaw());
 
-	RtMidiMessage msg;
-	if (event.getNumBytes() == 1)
-		msg = {event.getByte1()};
-	else if (event.getNumBytes() == 2)
-		msg = {event.getByte1(), event.getByte2()};
-	else
-		msg = {event.getByte1(), event.getByte2(), event.getByte3()};
+	u::trace::instant("midi_out");
 
-	G_DEBUG("Send MIDI msg=0x{:0X}", event.getRaw());
+	return m_scheduler.send(event);
+}
+
+bool KernelMidi::send_RT(const MidiEvent& event, Frame delta) const
+{
+	if (m_midiOut == nullptr || !m_outputEnabled.load())
+		return false;
 
-	onMidiSent();
+	u::trace::instant("midi_out");
 
-	return m_midiQueue.try_enqueue(msg);
+	return m_scheduler.schedule_RT(event, delta);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void KernelMidi::beginBlock_RT(int sampleRate, int bufferSize) const
+{
+	m_scheduler.beginBlock_RT(sampleRate, bufferSize);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void KernelMidi::setOutputEnabled(bool v)
+{
+	m_outputEnabled.store(v);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -244,6 +266,8 @@ void KernelMidi::callback(double deltatime, RtMidiMessage* msg)
 	assert(onMidiReceived != nullptr);
 	assert(msg->size() > 0);
 
+	const u::trace::Scope trace("midi_in");
+
 	m_elpsedTime += deltatime;
 
 	MidiEvent event;
@@ -256,6 +280,12 @@ void KernelMidi::callback(double deltatime, RtMidiMessage* msg)
 	else
 		assert(false); // MIDI messages longer than 3 bytes are not supported
 
+	/* Map the arrival time onto a frame in the next audio block, so that the
+	event can be rendered with sample accuracy. RtMidi delta times are relative
+	to the previous message and can't be aligned with the audio clock. */
+
+	event.setDelta(m_scheduler.getBlockOffset(MidiScheduler::Clock::now()));
+
 	onMidiReceived(event);
 
 	G_DEBUG("Recv MIDI msg=0x{:0X}, timestamp={}", event.getRaw(), m_elpsedTime);
@@ -27,11 +27,11 @@
 #ifndef G_KERNELMIDI_H
 #define G_KERNELMIDI_H
 
+#include "core/midiScheduler.h"
 #include "core/model/model.h"
-#include "core/worker.h"
-#include "deps/concurrentqueue/concurrentqueue.h"
 #include "midiMapper.h"
 #include <RtMidi.h>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -76,15 +76,35 @@ public:
 	int         getCurrentInPort() const;
 
 	/* send
-    Sends a MIDI message to the outside world. Returns false if MIDI out is not
-	enabled or the internal queue is full. */
+    Sends a MIDI message to the outside world as soon as possible. Returns false
+	if MIDI out is not enabled or the internal queue is full. */
 
 	bool send(const MidiEvent&) const;
 
-	/* start
-	Starts the internal worker on a separate thread. Call this on startup. */
+	/* send_RT
+    Schedules a MIDI message at frame 'delta' of the current audio block. 
+	Sample-accurate and allocation-free, for the realtime thread only. Returns
+	false if MIDI out is not enabled or the internal queue is full. */
+
+	bool send_RT(const MidiEvent&, Frame delta) const;
+
+	/* beginBlock_RT
+	Tells the MIDI scheduler that a new audio block is about to be rendered. 
+	Call this once per block from the realtime thread, before any send_RT(). */
+
+	void beginBlock_RT(int sampleRate, int bufferSize) const;
+
+	/* setOutputEnabled
+	Messages sent while output is disabled are dropped, instead of reaching the
+	devices. Used by the offline renderer, which runs faster than realtime. */
+
+	void setOutputEnabled(bool);
+
+	/* start, stop
+	Starts/stops the MIDI output thread. Call start() on startup. */
 
 	void start();
+	void stop();
 
 	std::function<void(const MidiEvent&)> onMidiReceived;
 	std::function<void()>                 onMidiSent;
@@ -113,22 +133,19 @@ private:
 	std::unique_ptr<RtMidiOut> m_midiOut;
 	std::unique_ptr<RtMidiIn>  m_midiIn;
 
-	/* m_worker
-	A separate thread responsible for the MIDI output, so that multiple threads
-	can access the output device simultaneously. */
-
-	Worker m_worker;
+	/* m_scheduler
+	Collects MIDI messages from multiple threads and sends them to the outside
+	world on a separate thread, at the time they are due. */
 
-	/* m_midiQueue
-	Collects MIDI messages to be sent to the outside world. */
-
-	mutable moodycamel::ConcurrentQueue<RtMidiMessage> m_midiQueue;
+	mutable MidiScheduler m_scheduler;
 
 	/* m_elpsedTime
 	Time elapsed on received MIDI events. Used to compute the absolute timestamp
 	to pass to MidiEvent class. */
 
 	double m_elpsedTime;
+
+	std::atomic<bool> m_outputEnabled;
 };
 } // namespace giada::m
 
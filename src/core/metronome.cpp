@@ -25,7 +25,9 @@
  * -------------------------------------------------------------------------- */
 
 #include "metronome.h"
+#include "core/dsp.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <algorithm>
 
 namespace giada::m
 {
@@ -41,11 +43,20 @@ void Metronome::trigger(Click c, Frame o) const
 void Metronome::render(mcl::AudioBuffer& outBuf) const
 {
 	const float* data = m_click == Click::BEAT ? beat : bar;
-	for (Frame f = m_offset; f < outBuf.countFrames() && m_rendering; f++)
+	for (Frame f = m_offset; f < outBuf.countFrames() && m_rendering;)
 	{
-		for (int c = 0; c < outBuf.countChannels(); c++)
-			outBuf[f][c] += data[m_tracker];
-		m_tracker = (m_tracker + 1) % CLICK_SIZE;
+		/* Render the click in one go, up to its end or the end of the block. */
+
+		const Frame frames = std::min(outBuf.countFrames() - f, CLICK_SIZE - m_tracker);
+		if (outBuf.countChannels() == 2)
+			dsp::sumMonoToStereo(outBuf[f], data + m_tracker, frames, 1.0f, 1.0f);
+		else
+			for (Frame i = 0; i < frames; i++)
+				for (int c = 0; c < outBuf.countChannels(); c++)
+					outBuf[f + i][c] += data[m_tracker + i];
+
+		f += frames;
+		m_tracker = (m_tracker + frames) % CLICK_SIZE;
 		if (m_tracker == 0)
 			m_rendering = false;
 	}
@@ -37,8 +37,12 @@
 #include "glue/plugin.h"
 #include "utils/log.h"
 #include "utils/math.h"
+#include "utils/trace.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 namespace giada::m
@@ -46,11 +50,49 @@ namespace giada::m
 MidiDispatcher::MidiDispatcher(model::Model& m)
 : m_learnCb(nullptr)
 , m_model(m)
+, m_running(false)
+, m_pending(false)
+, m_semaphore(0)
 {
 }
 
 /* -------------------------------------------------------------------------- */
 
+MidiDispatcher::~MidiDispatcher()
+{
+	stop();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiDispatcher::start()
+{
+	m_running.store(true);
+	m_thread = std::thread([this]() {
+		while (true)
+		{
+			m_semaphore.acquire();
+			if (!m_running.load())
+				break;
+			m_pending.store(false);
+			rebuildIndex();
+		}
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiDispatcher::stop()
+{
+	if (!m_thread.joinable())
+		return;
+	m_running.store(false);
+	m_semaphore.release();
+	m_thread.join();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void MidiDispatcher::startChannelLearn(int param, ID channelId, std::function<void()> f)
 {
 	m_learnCb = [this, param, channelId, f](MidiEvent e) { learnChannel(e, param, channelId, f); };
@@ -92,6 +134,8 @@ void MidiDispatcher::clearPluginLearn(std::size_t paramIndex, ID pluginId, std::
 
 void MidiDispatcher::dispatch(const MidiEvent& e)
 {
+	const u::trace::Scope trace("midi_dispatcher");
+
 	/* Fix the velocity zero issue for those devices that sends NOTE OFF events 
 	as NOTE ON + velocity zero. Let's make it a real NOTE OFF event. */
 
@@ -109,6 +153,75 @@ void MidiDispatcher::dispatch(const MidiEvent& e)
 
 /* -------------------------------------------------------------------------- */
 
+void MidiDispatcher::requestIndexRebuild()
+{
+	if (!m_pending.exchange(true))
+		m_semaphore.release();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiDispatcher::rebuildIndex()
+{
+	/* Reads the non-realtime layout, as the MIDI thread does. */
+
+	auto index = std::make_shared<Index>();
+
+	const std::vector<Channel>& channels = m_model.get().channels.getAll();
+
+	for (std::size_t i = 0; i < channels.size(); i++)
+	{
+		const Channel&     c   = channels[i];
+		const ChannelRef   ref = {i, c.id};
+		const MidiLearner& ml  = c.midiLearner;
+
+		/* Same precedence as the learner fields: if a message is bound to more
+		than one of them, only the first one is triggered. Empty (0x0) values
+		mean 'not learned'. */
+
+		const std::pair<Binding::Type, uint32_t> params[] = {
+		    {Binding::Type::KEY_PRESS, ml.keyPress.getValue()},
+		    {Binding::Type::KEY_RELEASE, ml.keyRelease.getValue()},
+		    {Binding::Type::MUTE, ml.mute.getValue()},
+		    {Binding::Type::KILL, ml.kill.getValue()},
+		    {Binding::Type::ARM, ml.arm.getValue()},
+		    {Binding::Type::SOLO, ml.solo.getValue()},
+		    {Binding::Type::VOLUME, ml.volume.getValue()},
+		    {Binding::Type::PITCH, ml.pitch.getValue()},
+		    {Binding::Type::READ_ACTIONS, ml.readActions.getValue()}};
+
+		for (auto it = std::begin(params); it != std::end(params); ++it)
+		{
+			const uint32_t value    = it->second;
+			const bool     shadowed = std::any_of(std::begin(params), it, [value](const auto& p) { return p.second == value; });
+			if (value != 0x0 && !shadowed)
+				index->bindings[value].push_back({it->first, ref});
+		}
+
+		for (const Plugin* p : c.plugins)
+			for (const MidiLearnParam& param : p->midiInParams)
+				if (param.getValue() != 0x0)
+					index->bindings[param.getValue()].push_back({Binding::Type::PLUGIN_PARAM, ref, p->id, param.getIndex()});
+
+		if (c.midiReceiver || c.midiActionRecorder)
+			index->midiChannels.push_back(ref);
+	}
+
+	m_index.store(std::move(index));
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Channel* MidiDispatcher::getChannel(const ChannelRef& ref) const
+{
+	const std::vector<Channel>& channels = m_model.get().channels.getAll();
+	if (ref.index >= channels.size() || channels[ref.index].id != ref.id)
+		return nullptr;
+	return &channels[ref.index];
+}
+
+/* -------------------------------------------------------------------------- */
+
 void MidiDispatcher::learn(const MidiEvent& e)
 {
 	assert(m_learnCb != nullptr);
@@ -152,27 +265,73 @@ bool MidiDispatcher::isChannelMidiInAllowed(ID channelId, int c)
 
 /* -------------------------------------------------------------------------- */
 
-void MidiDispatcher::processPlugins(ID channelId, const std::vector<Plugin*>& plugins,
-    const MidiEvent& midiEvent)
+void MidiDispatcher::processBinding(const Binding& binding, const Channel& c, const MidiEvent& midiEvent)
 {
 	const uint32_t pure = midiEvent.getRawNoVelocity();
-	const float    vf   = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f);
 
-	/* Plugins' parameters layout reflects the structure of the matrix
-	Channel::midiInPlugins. It is safe to assume then that Plugin 'p' and 
-	parameter indexes match both the structure of Channel::midiInPlugins and the 
-	vector of plugins. */
+	switch (binding.type)
+	{
+	case Binding::Type::KEY_PRESS:
+		G_DEBUG("   keyPress, ch={} (pure=0x{:0X})", c.id, pure);
+		c::channel::pressChannel(c.id, midiEvent.getVelocity(), Thread::MIDI, midiEvent.getDelta());
+		break;
+
+	case Binding::Type::KEY_RELEASE:
+		G_DEBUG("   keyRel ch={} (pure=0x{:0X})", c.id, pure);
+		c::channel::releaseChannel(c.id, Thread::MIDI, midiEvent.getDelta());
+		break;
 
-	for (Plugin* p : plugins)
+	case Binding::Type::MUTE:
+		G_DEBUG("   mute ch={} (pure=0x{:0X})", c.id, pure);
+		c::channel::toggleMuteChannel(c.id, Thread::MIDI);
+		break;
+
+	case Binding::Type::KILL:
+		G_DEBUG("   kill ch={} (pure=0x{:0X})", c.id, pure);
+		c::channel::killChannel(c.id, Thread::MIDI, midiEvent.getDelta());
+		break;
+
+	case Binding::Type::ARM:
+		G_DEBUG("   arm ch={} (pure=0x{:0X})", c.id, pure);
+		c::channel::toggleArmChannel(c.id, Thread::MIDI);
+		break;
+
+	case Binding::Type::SOLO:
+		G_DEBUG("   solo ch={} (pure=0x{:0X})", c.id, pure);
+		c::channel::toggleSoloChannel(c.id, Thread::MIDI);
+		break;
+
+	case Binding::Type::VOLUME:
 	{
-		for (const MidiLearnParam& param : p->midiInParams)
-		{
-			if (pure != param.getValue())
-				continue;
-			c::plugin::setParameter(channelId, p->id, param.getIndex(), vf, Thread::MIDI);
-			G_DEBUG("   [pluginId={} paramIndex={}] (pure=0x{:0X}, value={}, float={})",
-			    p->id, param.getIndex(), pure, midiEvent.getVelocity(), vf);
-		}
+		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
+		G_DEBUG("   volume ch={} (pure=0x{:0X}, value={}, float={})",
+		    c.id, pure, midiEvent.getVelocity(), vf);
+		c::channel::setChannelVolume(c.id, vf, Thread::MIDI);
+		break;
+	}
+
+	case Binding::Type::PITCH:
+	{
+		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH);
+		G_DEBUG("   pitch ch={} (pure=0x{:0X}, value={}, float={})",
+		    c.id, pure, midiEvent.getVelocity(), vf);
+		c::channel::setChannelPitch(c.id, vf, Thread::MIDI);
+		break;
+	}
+
+	case Binding::Type::READ_ACTIONS:
+		G_DEBUG("   toggle read actions ch={} (pure=0x{:0X})", c.id, pure);
+		c::channel::toggleReadActionsChannel(c.id, Thread::MIDI);
+		break;
+
+	case Binding::Type::PLUGIN_PARAM:
+	{
+		const float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f);
+		c::plugin::setParameter(c.id, binding.pluginId, binding.paramIndex, vf, Thread::MIDI);
+		G_DEBUG("   [pluginId={} paramIndex={}] (pure=0x{:0X}, value={}, float={})",
+		    binding.pluginId, binding.paramIndex, pure, midiEvent.getVelocity(), vf);
+		break;
+	}
 	}
 }
 
@@ -180,73 +339,32 @@ void MidiDispatcher::processPlugins(ID channelId, const std::vector<Plugin*>& pl
 
 void MidiDispatcher::processChannels(const MidiEvent& midiEvent)
 {
-	const uint32_t pure = midiEvent.getRawNoVelocity();
-
-	for (const Channel& c : m_model.get().channels.getAll())
-	{
-		/* Do nothing on this channel if MIDI in is disabled or filtered out for
-		the current MIDI channel. */
+	const std::shared_ptr<const Index> index = m_index.load();
+	if (index == nullptr)
+		return;
 
-		if (!c.midiLearner.isAllowed(midiEvent.getChannel()))
-			continue;
+	/* Only bindings for this very message are visited, instead of scanning all
+	channels and plug-ins. Do nothing on a channel if MIDI in is disabled or 
+	filtered out for the current MIDI channel. */
 
-		if (pure == c.midiLearner.keyPress.getValue())
-		{
-			G_DEBUG("   keyPress, ch={} (pure=0x{:0X})", c.id, pure);
-			c::channel::pressChannel(c.id, midiEvent.getVelocity(), Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.keyRelease.getValue())
-		{
-			G_DEBUG("   keyRel ch={} (pure=0x{:0X})", c.id, pure);
-			c::channel::releaseChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.mute.getValue())
-		{
-			G_DEBUG("   mute ch={} (pure=0x{:0X})", c.id, pure);
-			c::channel::toggleMuteChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.kill.getValue())
-		{
-			G_DEBUG("   kill ch={} (pure=0x{:0X})", c.id, pure);
-			c::channel::killChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.arm.getValue())
-		{
-			G_DEBUG("   arm ch={} (pure=0x{:0X})", c.id, pure);
-			c::channel::toggleArmChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.solo.getValue())
-		{
-			G_DEBUG("   solo ch={} (pure=0x{:0X})", c.id, pure);
-			c::channel::toggleSoloChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.volume.getValue())
-		{
-			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-			G_DEBUG("   volume ch={} (pure=0x{:0X}, value=%d, float=%f)",
-			    c.id, pure, midiEvent.getVelocity(), vf);
-			c::channel::setChannelVolume(c.id, vf, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.pitch.getValue())
-		{
-			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH);
-			G_DEBUG("   pitch ch={} (pure=0x{:0X}, value=%d, float=%f)",
-			    c.id, pure, midiEvent.getVelocity(), vf);
-			c::channel::setChannelPitch(c.id, vf, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.readActions.getValue())
+	if (const auto it = index->bindings.find(midiEvent.getRawNoVelocity()); it != index->bindings.end())
+	{
+		for (const Binding& binding : it->second)
 		{
-			G_DEBUG("   toggle read actions ch={} (pure=0x{:0X})", c.id, pure);
-			c::channel::toggleReadActionsChannel(c.id, Thread::MIDI);
+			const Channel* c = getChannel(binding.channel);
+			if (c != nullptr && c->midiLearner.isAllowed(midiEvent.getChannel()))
+				processBinding(binding, *c, midiEvent);
 		}
+	}
 
-		/* Process learned plugins parameters. */
-		processPlugins(c.id, c.plugins, midiEvent);
+	/* Redirect raw MIDI message (pure + velocity) to plug-ins in armed 
+	channels. */
 
-		/* Redirect raw MIDI message (pure + velocity) to plug-ins in armed
-		channels. */
-		if (c.armed)
-			c::channel::sendMidiToChannel(c.id, midiEvent, Thread::MIDI);
+	for (const ChannelRef& ref : index->midiChannels)
+	{
+		const Channel* c = getChannel(ref);
+		if (c != nullptr && c->armed && c->midiLearner.isAllowed(midiEvent.getChannel()))
+			c::channel::sendMidiToChannel(c->id, midiEvent, Thread::MIDI);
 	}
 }
 
@@ -361,6 +479,7 @@ void MidiDispatcher::learnChannel(MidiEvent e, int param, ID channelId, std::fun
 
 	m_model.swap(model::SwapType::SOFT);
 
+	requestIndexRebuild();
 	stopLearn();
 	doneCb();
 }
@@ -415,14 +534,16 @@ void MidiDispatcher::learnMaster(MidiEvent e, int param, std::function<void()> d
 
 void MidiDispatcher::learnPlugin(MidiEvent e, std::size_t paramIndex, ID pluginId, std::function<void()> doneCb)
 {
-	model::DataLock lock   = m_model.lockData(model::SwapType::NONE);
-	Plugin*         plugin = m_model.findShared<Plugin>(pluginId);
+	Plugin* plugin = m_model.findShared<Plugin>(pluginId);
 
 	assert(plugin != nullptr);
 	assert(paramIndex < plugin->midiInParams.size());
 
 	plugin->midiInParams[paramIndex].setValue(e.getRawNoVelocity());
 
+	m_model.swap(model::SwapType::NONE);
+
+	requestIndexRebuild();
 	stopLearn();
 	doneCb();
 }
@@ -31,9 +31,15 @@
 #include "core/midiEvent.h"
 #include "core/model/model.h"
 #include "core/types.h"
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace giada::m
 {
@@ -41,6 +47,13 @@ class MidiDispatcher
 {
 public:
 	MidiDispatcher(model::Model&);
+	~MidiDispatcher();
+
+	/* start, stop
+	Start and stop the thread that rebuilds the routing index. */
+
+	void start();
+	void stop();
 
 	void startChannelLearn(int param, ID channelId, std::function<void()> f);
 	void startMasterLearn(int param, std::function<void()> f);
@@ -55,12 +68,79 @@ public:
 
 	void dispatch(const MidiEvent&);
 
+	/* requestIndexRebuild
+	Asks the index thread to rebuild the MIDI learn routing index from the 
+	current model. Call this whenever channels, plug-ins or learned MIDI 
+	messages change (e.g. on HARD model swaps). Requests made while a rebuild is
+	pending are merged. The MIDI thread keeps using the old index until the 
+	new one is ready. */
+
+	void requestIndexRebuild();
+
 	/* onEventReceived
 	Callback fired when a MIDI event of type CHANNEL has been received. */
 
 	std::function<void()> onEventReceived;
 
 private:
+	/* ChannelRef
+	Reference to a channel in the model: position in model::Channels for O(1)
+	access, plus its ID to detect stale references. */
+
+	struct ChannelRef
+	{
+		std::size_t index;
+		ID          id;
+	};
+
+	/* Binding
+	What a learned MIDI message is bound to: a channel parameter or a plug-in
+	parameter. */
+
+	struct Binding
+	{
+		enum class Type
+		{
+			KEY_PRESS,
+			KEY_RELEASE,
+			MUTE,
+			KILL,
+			ARM,
+			SOLO,
+			VOLUME,
+			PITCH,
+			READ_ACTIONS,
+			PLUGIN_PARAM
+		};
+
+		Type        type;
+		ChannelRef  channel;
+		ID          pluginId   = 0;
+		std::size_t paramIndex = 0;
+	};
+
+	/* Index
+	Maps each learned MIDI message (pure, i.e. without velocity) to its 
+	bindings, in channel order. Also holds the channels that can receive raw
+	MIDI data when armed. */
+
+	struct Index
+	{
+		std::unordered_map<uint32_t, std::vector<Binding>> bindings;
+		std::vector<ChannelRef>                            midiChannels;
+	};
+
+	/* getChannel
+	Returns the channel referenced by 'ref', or nullptr if the reference is 
+	stale (i.e. channels have changed and the index has not been rebuilt yet). */
+
+	const Channel* getChannel(const ChannelRef&) const;
+
+	/* rebuildIndex
+	Builds a new index and publishes it. Runs on the index thread. */
+
+	void rebuildIndex();
+
 	/* learn
     Learns event 'e'. Called by the Event Dispatcher. */
 
@@ -81,7 +161,7 @@ private:
 	void learnChannel(MidiEvent, int param, ID channelId, std::function<void()> doneCb);
 	void learnMaster(MidiEvent, int param, std::function<void()> doneCb);
 
-	void processPlugins(ID channelId, const std::vector<Plugin*>& plugins, const MidiEvent&);
+	void processBinding(const Binding&, const Channel&, const MidiEvent&);
 	void learnPlugin(MidiEvent, std::size_t paramIndex, ID pluginId, std::function<void()> doneCb);
 
 	/* cb_midiLearn
@@ -91,6 +171,21 @@ private:
 	std::function<void(MidiEvent)> m_learnCb;
 
 	model::Model& m_model;
+
+	/* m_index
+	Current routing index, immutable once published. The MIDI thread takes a
+	copy of the pointer for each event, so it never waits for a rebuild. */
+
+	std::atomic<std::shared_ptr<const Index>> m_index;
+
+	/* m_thread
+	Rebuilds the index. It sleeps on m_semaphore until a new request comes in;
+	m_pending merges requests made in the meantime. */
+
+	std::thread               m_thread;
+	std::atomic<bool>         m_running;
+	std::atomic<bool>         m_pending;
+	std::counting_semaphore<> m_semaphore;
 };
 } // namespace giada::m
 
@@ -0,0 +1,314 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/midiScheduler.h"
+#include "core/midiEvent.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace giada::m
+{
+namespace
+{
+/* DLL_BANDWIDTH_
+Bandwidth of the delay-locked loop, in Hz. Lower values filter more jitter out,
+but take longer to follow a change in the audio clock rate. */
+
+constexpr double DLL_BANDWIDTH_ = 0.25;
+
+/* DLL_MAX_ERROR_
+Errors bigger than this, in seconds, are not jitter: the stream has stopped or
+restarted, so the block clock starts over. */
+
+constexpr double DLL_MAX_ERROR_ = 0.1;
+
+/* -------------------------------------------------------------------------- */
+
+double toSeconds_(MidiScheduler::Clock::time_point t)
+{
+	return std::chrono::duration<double>(t.time_since_epoch()).count();
+}
+
+MidiScheduler::Clock::time_point toTimePoint_(double seconds)
+{
+	using namespace std::chrono;
+	return MidiScheduler::Clock::time_point(duration_cast<MidiScheduler::Clock::duration>(duration<double>(seconds)));
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MidiScheduler::MidiScheduler()
+: onSend(nullptr)
+, m_running(false)
+, m_semaphore(0)
+, m_queue(MAX_MESSAGES, 0, MAX_NUM_PRODUCERS) // See https://github.com/cameron314/concurrentqueue#preallocation-correctly-using-try_enqueue
+, m_droppedMessages(0)
+, m_blockTime(0.0)
+, m_nextBlockTime(0.0)
+, m_period(0.0)
+, m_dllB(0.0)
+, m_dllC(0.0)
+, m_sampleRate(0)
+, m_bufferSize(0)
+, m_sharedSeq(0)
+, m_sharedBlockTime(0.0)
+, m_sharedPeriod(0.0)
+, m_sharedBufferSize(0)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+MidiScheduler::~MidiScheduler()
+{
+	stop();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiScheduler::start()
+{
+	assert(onSend != nullptr);
+
+	if (m_thread.joinable())
+		return;
+	m_running.store(true);
+	m_thread = std::thread([this]() { process(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiScheduler::stop()
+{
+	if (!m_thread.joinable())
+		return;
+	m_running.store(false);
+	m_semaphore.release();
+	m_thread.join();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiScheduler::beginBlock_RT(int sampleRate, int bufferSize)
+{
+	beginBlock_RT(sampleRate, bufferSize, Clock::now());
+}
+
+void MidiScheduler::beginBlock_RT(int sampleRate, int bufferSize, Clock::time_point now)
+{
+	assert(sampleRate > 0 && bufferSize > 0);
+
+	/* Second-order delay-locked loop, as described by F. Adriaensen in "Using
+	a DLL to filter time". The error between the actual and the predicted 
+	callback time slowly corrects both the next block time and the block 
+	length, which converges to the actual one of the audio clock. */
+
+	const double t     = toSeconds_(now);
+	const double error = t - m_nextBlockTime;
+
+	if (sampleRate != m_sampleRate || bufferSize != m_bufferSize || std::abs(error) > DLL_MAX_ERROR_)
+		resetBlockClock_RT(t, sampleRate, bufferSize);
+	else
+	{
+		m_blockTime = m_nextBlockTime;
+		m_nextBlockTime += m_dllB * error + m_period;
+		m_period += m_dllC * error;
+	}
+
+	publishBlock_RT();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiScheduler::publishBlock_RT()
+{
+	const uint32_t seq = m_sharedSeq.load(std::memory_order_relaxed);
+
+	m_sharedSeq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	m_sharedBlockTime.store(m_blockTime, std::memory_order_relaxed);
+	m_sharedPeriod.store(m_period, std::memory_order_relaxed);
+	m_sharedBufferSize.store(m_bufferSize, std::memory_order_relaxed);
+
+	m_sharedSeq.store(seq + 2, std::memory_order_release);
+}
+
+/* -------------------------------------------------------------------------- */
+
+MidiScheduler::Block MidiScheduler::loadBlock() const
+{
+	Block    block;
+	uint32_t seq;
+	do
+	{
+		seq              = m_sharedSeq.load(std::memory_order_acquire);
+		block.time       = m_sharedBlockTime.load(std::memory_order_relaxed);
+		block.period     = m_sharedPeriod.load(std::memory_order_relaxed);
+		block.bufferSize = m_sharedBufferSize.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while ((seq & 1) != 0 || seq != m_sharedSeq.load(std::memory_order_relaxed));
+
+	return block;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiScheduler::resetBlockClock_RT(double t, int sampleRate, int bufferSize)
+{
+	const double period = bufferSize / static_cast<double>(sampleRate);
+	const double omega  = 2.0 * std::numbers::pi * DLL_BANDWIDTH_ * period;
+
+	m_sampleRate    = sampleRate;
+	m_bufferSize    = bufferSize;
+	m_blockTime     = t;
+	m_nextBlockTime = t + period;
+	m_period        = period;
+	m_dllB          = std::sqrt(2.0) * omega;
+	m_dllC          = omega * omega;
+}
+
+/* -------------------------------------------------------------------------- */
+
+MidiScheduler::Clock::time_point MidiScheduler::getTime_RT(Frame delta) const
+{
+	if (m_bufferSize <= 0)
+		return Clock::now();
+	return toTimePoint_(m_nextBlockTime + std::max(0, delta) * m_period / m_bufferSize);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool MidiScheduler::schedule_RT(const MidiEvent& e, Frame delta)
+{
+	const bool pushed = m_rtQueue.push(makeMessage(e, getTime_RT(delta)));
+	if (!pushed)
+		m_droppedMessages.fetch_add(1, std::memory_order_relaxed);
+
+	/* Wake up the sender anyway: it reports dropped messages. */
+
+	m_semaphore.release();
+	return pushed;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame MidiScheduler::getBlockOffset(Clock::time_point t) const
+{
+	const Block block = loadBlock();
+
+	if (block.bufferSize <= 0 || block.period <= 0.0)
+		return 0;
+
+	const double elapsed = toSeconds_(t) - block.time;
+
+	return std::clamp(static_cast<Frame>(elapsed / block.period * block.bufferSize), 0, block.bufferSize - 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool MidiScheduler::send(const MidiEvent& e)
+{
+	const bool pushed = m_queue.try_enqueue(makeMessage(e, Clock::now()));
+	if (!pushed)
+		m_droppedMessages.fetch_add(1, std::memory_order_relaxed);
+	m_semaphore.release();
+	return pushed;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MidiScheduler::countDroppedMessages() const
+{
+	return m_droppedMessages.load(std::memory_order_relaxed);
+}
+
+/* -------------------------------------------------------------------------- */
+
+MidiScheduler::Message MidiScheduler::makeMessage(const MidiEvent& e, Clock::time_point time)
+{
+	assert(e.getNumBytes() > 0 && e.getNumBytes() <= 3);
+
+	return {{e.getByte1(), e.getByte2(), e.getByte3()}, static_cast<std::size_t>(e.getNumBytes()), time};
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiScheduler::process()
+{
+	/* Messages waiting to be sent, sorted by time. Messages with the same time
+	keep their arrival order. */
+
+	std::vector<Message> pending;
+	pending.reserve(MAX_PENDING_MESSAGES);
+
+	int droppedMessages = 0;
+
+	const auto enqueue = [&pending](const Message& m) {
+		const auto it = std::upper_bound(pending.begin(), pending.end(), m,
+		    [](const Message& a, const Message& b) { return a.time < b.time; });
+		pending.insert(it, m);
+	};
+
+	while (true)
+	{
+		if (pending.empty())
+			m_semaphore.acquire();
+		else
+			m_semaphore.try_acquire_until(pending.front().time);
+
+		if (!m_running.load())
+			return;
+
+		Message m;
+		while (m_rtQueue.pop(m))
+			enqueue(m);
+		while (m_queue.try_dequeue(m))
+			enqueue(m);
+
+		const Clock::time_point now = Clock::now();
+
+		auto it = pending.begin();
+		for (; it != pending.end() && it->time <= now; ++it)
+			onSend(*it);
+		pending.erase(pending.begin(), it);
+
+		if (const int count = countDroppedMessages(); count != droppedMessages)
+		{
+			u::log::print("[MidiScheduler::process] MIDI queue full, %d messages dropped so far\n", count);
+			droppedMessages = count;
+		}
+	}
+}
+} // namespace giada::m
@@ -0,0 +1,202 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_MIDI_SCHEDULER_H
+#define G_MIDI_SCHEDULER_H
+
+#include "core/queue.h"
+#include "core/types.h"
+#include "deps/concurrentqueue/concurrentqueue.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <semaphore>
+#include <thread>
+
+namespace giada::m
+{
+class MidiEvent;
+class MidiScheduler final
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/* Message
+	A fixed-size raw MIDI message, with the time it must be sent at. */
+
+	struct Message
+	{
+		std::array<uint8_t, 3> data = {};
+		std::size_t            size = 0;
+		Clock::time_point      time = {};
+	};
+
+	MidiScheduler();
+	~MidiScheduler();
+
+	/* start
+	Starts the sender thread. Call this on startup. */
+
+	void start();
+
+	/* stop
+	Wakes up and joins the sender thread. Pending messages are discarded. */
+
+	void stop();
+
+	/* beginBlock_RT
+	Marks the start of a new audio block, at time 'now'. Callback times are 
+	jittery and the audio clock drifts apart from the system one: the block 
+	time is filtered through a delay-locked loop, which follows the actual 
+	sample clock smoothly. It is resynced only after a discontinuity that can't
+	be jitter (e.g. the stream has been restarted). */
+
+	void beginBlock_RT(int sampleRate, int bufferSize);
+	void beginBlock_RT(int sampleRate, int bufferSize, Clock::time_point now);
+
+	/* getTime_RT
+	Returns the time frame 'delta' of the current block is due at. That is one
+	block later than the block time, so that MIDI lines up with the audio being
+	rendered. Realtime thread only. */
+
+	Clock::time_point getTime_RT(Frame delta) const;
+
+	/* schedule_RT
+	Schedules a MIDI event at frame 'delta' of the current audio block. Messages
+	are delayed by one block, so that they line up with the audio being rendered.
+	Never allocates. Realtime thread only. Returns false if the queue is full. */
+
+	bool schedule_RT(const MidiEvent&, Frame delta);
+
+	/* getBlockOffset
+	Maps time 't' to a frame offset in the next audio block, assuming 't' falls
+	within the current one. An event received halfway through the current block
+	is then rendered halfway through the next one: constant latency of one 
+	block, no jitter. Never waits: an event racing with the block being 
+	rendered might still be picked up by it, one block early. Any thread but 
+	the realtime one. */
+
+	Frame getBlockOffset(Clock::time_point t) const;
+
+	/* send
+	Sends a MIDI event as soon as possible. Any non-realtime thread listed in
+	MAX_NUM_PRODUCERS. Returns false if the queue is full. */
+
+	bool send(const MidiEvent&);
+
+	/* countDroppedMessages
+	Returns the number of messages dropped so far because a queue was full. 
+	The sender thread logs them too. */
+
+	int countDroppedMessages() const;
+
+	/* onSend
+	Callback fired by the sender thread when a message is due. */
+
+	std::function<void(const Message&)> onSend;
+
+private:
+	static constexpr std::size_t MAX_RT_MESSAGES      = 256;
+	static constexpr std::size_t MAX_MESSAGES         = 64;
+	static constexpr std::size_t MAX_NUM_PRODUCERS    = 3; // Main, MIDI input and event dispatcher threads
+	static constexpr std::size_t MAX_PENDING_MESSAGES = MAX_RT_MESSAGES + MAX_MESSAGES;
+
+	/* Block
+	A consistent snapshot of the current block, for other threads. */
+
+	struct Block
+	{
+		double time       = 0.0;
+		double period     = 0.0;
+		int    bufferSize = 0;
+	};
+
+	static Message makeMessage(const MidiEvent&, Clock::time_point);
+
+	/* publishBlock_RT, loadBlock
+	Write and read the shared block snapshot through a sequence lock: the 
+	realtime thread never waits, readers retry if they overlapped with a 
+	write. */
+
+	void  publishBlock_RT();
+	Block loadBlock() const;
+
+	/* resetBlockClock_RT
+	Restarts the delay-locked loop from time 't'. */
+
+	void resetBlockClock_RT(double t, int sampleRate, int bufferSize);
+
+	void process();
+
+	/* m_thread
+	A separate thread responsible for the MIDI output. It sleeps until the next
+	message is due or a new message comes in, whichever comes first. */
+
+	std::thread               m_thread;
+	std::atomic<bool>         m_running;
+	std::counting_semaphore<> m_semaphore;
+
+	/* m_rtQueue, m_queue
+	Messages coming from the realtime thread and from all other threads. */
+
+	Queue<Message, MAX_RT_MESSAGES>       m_rtQueue;
+	moodycamel::ConcurrentQueue<Message> m_queue;
+	std::atomic<int>                     m_droppedMessages;
+
+	/* m_blockTime, m_nextBlockTime, m_period
+	Delay-locked loop state, in seconds: filtered time of the current and of 
+	the next audio block, and filtered block length. Realtime thread only. */
+
+	double m_blockTime;
+	double m_nextBlockTime;
+	double m_period;
+
+	/* m_dllB, m_dllC
+	Delay-locked loop coefficients, depending on the block length. */
+
+	double m_dllB;
+	double m_dllC;
+
+	int m_sampleRate;
+	int m_bufferSize;
+
+	/* m_sharedSeq, m_shared[...]
+	Shared block snapshot, guarded by the sequence number 'm_sharedSeq' (odd 
+	while being written). Fields are atomics so that a torn read is not a data
+	race: it's just retried. */
+
+	std::atomic<uint32_t> m_sharedSeq;
+	std::atomic<double>   m_sharedBlockTime;
+	std::atomic<double>   m_sharedPeriod;
+	std::atomic<int>      m_sharedBufferSize;
+};
+} // namespace giada::m
+
+#endif
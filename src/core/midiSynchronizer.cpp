@@ -28,13 +28,38 @@
 #include "core/conf.h"
 #include "core/kernelMidi.h"
 #include "core/midiEvent.h"
-#include "core/model/sequencer.h"
+#include "core/model/model.h"
 #include "utils/log.h"
 #include "utils/time.h"
 #include <numeric>
 
 namespace giada::m
 {
+namespace
+{
+/* MIDI_CLOCK_PPQ
+Number of MIDI clock pulses in a quarter note (i.e. in a beat). */
+
+constexpr Frame MIDI_CLOCK_PPQ = 24;
+
+/* getNextPulse_
+Returns the position of the first MIDI clock pulse at or after 'position', 
+within a beat of 'framesInBeat' frames. Pulse 'k' lies on frame
+ceil(k * framesInBeat / 24): computed with integer math, so pulses never drift
+from the beat grid. The result is framesInBeat if the next pulse is the first
+one of the following beat. */
+
+Frame getNextPulse_(Frame position, Frame framesInBeat)
+{
+	const Frame pulse = position == 0 ? 0 : ((position - 1) * MIDI_CLOCK_PPQ / framesInBeat) + 1;
+	return (pulse * framesInBeat + MIDI_CLOCK_PPQ - 1) / MIDI_CLOCK_PPQ;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 MidiSynchronizer::MidiSynchronizer(const model::Model& m, KernelMidi& k)
 : onChangePosition(nullptr)
 , onChangeBpm(nullptr)
@@ -42,7 +67,8 @@ MidiSynchronizer::MidiSynchronizer(const model::Model& m, KernelMidi& k)
 , onStop(nullptr)
 , m_kernelMidi(k)
 , m_model(m)
-, m_worker(1000) // Default sleep time, will be reset anyway on startSendClock()
+, m_sendClock(false)
+, m_clockPosition(0)
 , m_timeElapsed(0.0)
 , m_lastTimestamp(0.0)
 , m_lastDelta(0.0)
@@ -93,33 +119,53 @@ void MidiSynchronizer::receive(const MidiEvent& e, int numBeatsInLoop)
 
 /* -------------------------------------------------------------------------- */
 
-void MidiSynchronizer::startSendClock(float bpm)
+void MidiSynchronizer::startSendClock()
 {
-	if (m_model.get().kernelMidi.sync != G_MIDI_SYNC_CLOCK_MASTER)
-		return;
-
-	setClockBpm(bpm);
-	const MidiEvent clockEvent = MidiEvent::makeFrom1Byte(MidiEvent::SYSTEM_CLOCK);
-
-	m_worker.start([this, clockEvent]() {
-		if (!m_kernelMidi.send(clockEvent))
-			G_DEBUG("KernelMidi queue full!", );
-	});
+	m_sendClock.store(true);
 }
 
-void MidiSynchronizer::stopSendClock() const
+void MidiSynchronizer::stopSendClock()
 {
-	if (m_model.get().kernelMidi.sync != G_MIDI_SYNC_CLOCK_MASTER)
-		return;
-	m_worker.stop();
+	m_sendClock.store(false);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void MidiSynchronizer::setClockBpm(float bpm)
+void MidiSynchronizer::advance_RT(const model::Layout& layout, Frame bufferSize) const
 {
-	const float rateMs = 60000.0 / (24.0 * bpm);
-	m_worker.setSleep(rateMs);
+	if (!m_sendClock.load() || layout.kernelMidi.sync != G_MIDI_SYNC_CLOCK_MASTER)
+		return;
+
+	const model::Sequencer& sequencer    = layout.sequencer;
+	const Frame             framesInBeat = sequencer.framesInBeat;
+
+	if (framesInBeat <= 0)
+		return;
+
+	/* Follow the sequencer position while running, so that pulses stay in 
+	phase with beats. Keep the internal position going otherwise, so that 
+	slaved devices still receive a steady clock. */
+
+	Frame position = sequencer.isRunning() ? sequencer.a_getCurrentFrame() % framesInBeat : m_clockPosition;
+	Frame local    = 0;
+
+	const MidiEvent clockEvent = MidiEvent::makeFrom1Byte(MidiEvent::SYSTEM_CLOCK);
+
+	while (true)
+	{
+		const Frame pulse = getNextPulse_(position, framesInBeat);
+		const Frame delta = local + pulse - position;
+
+		if (delta >= bufferSize)
+			break;
+
+		m_kernelMidi.send_RT(clockEvent, delta);
+
+		local    = delta + 1;
+		position = (pulse + 1) % framesInBeat;
+	}
+
+	m_clockPosition = (position + bufferSize - local) % framesInBeat;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -29,7 +29,12 @@
 
 #include "core/model/model.h"
 #include "core/types.h"
-#include "core/worker.h"
+#include <atomic>
+
+namespace giada::m::model
+{
+struct Layout;
+}
 
 namespace giada::m
 {
@@ -46,18 +51,24 @@ public:
 	void receive(const MidiEvent&, int numBeatsInLoop);
 
 	/* startSendClock, stopSendClock
-	Sends MIDI clock data for synchronization with other MIDI devices. Valid only
-	when in MASTER mode. */
+	Enables or disables MIDI clock output for synchronization with other MIDI
+	devices. Valid only when in MASTER mode. */
+
+	void startSendClock();
+	void stopSendClock();
+
+	/* advance_RT
+	Generates MIDI clock pulses (24 per quarter note) falling in the current 
+	audio block, and schedules them with their exact frame offset. Pulses are 
+	derived from the sequencer position when running, from an internal 
+	free-running position otherwise. Call this on each new audio block. */
 
-	void startSendClock(float bpm);
-	void stopSendClock() const;
+	void advance_RT(const model::Layout&, Frame bufferSize) const;
 
 	void sendRewind();
 	void sendStart();
 	void sendStop();
 
-	void setClockBpm(float);
-
 	std::function<void(int)>   onChangePosition;
 	std::function<void(float)> onChangeBpm;
 	std::function<void()>      onStart;
@@ -78,10 +89,16 @@ private:
 	KernelMidi&         m_kernelMidi;
 	const model::Model& m_model;
 
-	/* m_worker
-	A separate thread responsible for the MIDI Clock output. */
+	/* m_sendClock
+	Whether MIDI clock output is enabled. Read by the realtime thread. */
+
+	std::atomic<bool> m_sendClock;
+
+	/* m_clockPosition
+	Free-running position within a beat, used to generate MIDI clock pulses
+	while the sequencer is stopped. Realtime thread only. */
 
-	Worker m_worker;
+	mutable Frame m_clockPosition;
 
 	double m_timeElapsed;
 	double m_lastTimestamp;
@@ -26,29 +26,20 @@
 
 #include "core/mixer.h"
 #include "core/const.h"
+#include "core/dsp.h"
 #include "core/model/model.h"
 #include "utils/log.h"
 #include "utils/math.h"
+#include "utils/trace.h"
+#include <algorithm>
 
 namespace giada::m
 {
-namespace
-{
-/* CH_LEFT, CH_RIGHT
-Channels identifiers. */
-
-constexpr int CH_LEFT  = 0;
-constexpr int CH_RIGHT = 1;
-} // namespace
-
-/* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
-
-Mixer::Mixer(model::Model& m)
+Mixer::Mixer(model::Model& m, const Profiler& p)
 : onSignalTresholdReached(nullptr)
 , onEndOfRecording(nullptr)
 , m_model(m)
+, m_profiler(p)
 , m_signalCbFired(false)
 , m_endOfRecCbFired(false)
 {
@@ -79,8 +70,12 @@ void Mixer::enable()
 void Mixer::disable()
 {
 	m_model.get().mixer.a_setActive(false);
-	while (m_model.isLocked())
-		;
+
+	/* Callers are about to rebuild the whole model (e.g. loading a project):
+	wait for the block being rendered, if any, to end. Later blocks see the 
+	mixer as inactive. This is not a lock: the realtime thread never waits. */
+
+	m_model.synchronize();
 	u::log::print("[mixer::disable] disabled\n");
 }
 
@@ -107,12 +102,24 @@ void Mixer::advanceChannels(const Sequencer::EventBuffer& events,
     const model::Channels& channels, Range<Frame> block, int quantizerStep) const
 {
 	for (const Channel& c : channels.getAll())
-		if (!c.isInternal())
+		if (!c.isInternal() && !c.locked)
 			c.advance(events, block, quantizerStep);
 }
 
 /* -------------------------------------------------------------------------- */
 
+void Mixer::setRenderThreads(int numThreads)
+{
+	m_renderPool.start(numThreads);
+}
+
+void Mixer::setRenderPriority(RenderPool::Priority p) const
+{
+	m_renderPool.setPriority(p);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Mixer::updateSoloCount(bool hasSolos)
 {
 	m_model.get().mixer.hasSolos = hasSolos;
@@ -143,7 +150,8 @@ void Mixer::setInputRecMode(InputRecMode m)
 
 /* -------------------------------------------------------------------------- */
 
-void Mixer::render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const model::Layout& layout_RT, int maxFramesToRec) const
+void Mixer::render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const model::Layout& layout_RT,
+    int maxFramesToRec, Stems* stems) const
 {
 	const model::Mixer&       mixer       = layout_RT.mixer;
 	const model::Sequencer&   sequencer   = layout_RT.sequencer;
@@ -164,6 +172,13 @@ void Mixer::render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const mode
 	const bool  allowsOverdub   = mixer.inputRecMode == InputRecMode::RIGID;
 	const bool  limitOutput     = kernelAudio.limitOutput;
 
+	/* Master volumes move across the block, as channel ones do. Advance them
+	here once per block, even with no input, so that they don't ramp from a 
+	stale value later on. */
+
+	const SmoothedParam::Ramp inVol  = masterInCh.shared->volume.advance_RT();
+	const SmoothedParam::Ramp outVol = masterOutCh.shared->volume.advance_RT();
+
 	mixer.getInBuffer().clear();
 
 	/* Reset peak computation. */
@@ -173,32 +188,36 @@ void Mixer::render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const mode
 
 	if (hasInput)
 	{
-		processLineIn(mixer, in, masterInCh.volume, recTriggerLevel, seqIsActive);
+		processLineIn(mixer, in, inVol, recTriggerLevel, seqIsActive);
 		renderMasterIn(masterInCh, mixer.getInBuffer(), seqIsRunning);
 	}
 
 	if (shouldLineInRec)
 	{
 		const Frame newTrackerPos = lineInRec(in, mixer.getRecBuffer(),
-		    mixer.a_getInputTracker(), maxFramesToRec, masterInCh.volume,
-		    allowsOverdub);
+		    mixer.a_getInputTracker(), maxFramesToRec, inVol, allowsOverdub);
 		mixer.a_setInputTracker(newTrackerPos);
 	}
 
-	/* Channel processing. Don't do it if layout is locked: another thread is 
-	changing data (e.g. Plugins or Waves). */
+	/* Channel processing. */
 
-	if (!layout_RT.locked)
-		renderChannels(channels.getAll(), out, mixer.getInBuffer(), hasSolos, seqIsRunning);
+	{
+		const Profiler::Scope scope(m_profiler, Profiler::Stage::RENDER_CHANNELS);
+		renderChannels(channels.getAll(), out, mixer.getInBuffer(), hasSolos, seqIsRunning, stems);
+	}
 
 	/* Render remaining internal channels. */
 
-	renderMasterOut(masterOutCh, out, seqIsRunning);
+	{
+		const Profiler::Scope scope(m_profiler, Profiler::Stage::MASTER_OUT);
+		renderMasterOut(masterOutCh, out, outVol);
+	}
 	renderPreview(previewCh, out, seqIsRunning);
 
 	/* Post processing. */
 
-	finalizeOutput(mixer, out, inToOut, limitOutput, masterOutCh.volume);
+	const Profiler::Scope scope(m_profiler, Profiler::Stage::FINALIZE);
+	finalizeOutput(mixer, out, inToOut, limitOutput, outVol);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -291,13 +310,13 @@ Peak Mixer::makePeak(const mcl::AudioBuffer& b) const
 {
 	if (!b.isAllocd())
 		return {0.0f, 0.0f};
-	return {b.getPeak(CH_LEFT), b.getPeak(b.countChannels() == 1 ? CH_LEFT : CH_RIGHT)};
+	return dsp::getPeak(b);
 }
 
 /* -------------------------------------------------------------------------- */
 
 int Mixer::lineInRec(const mcl::AudioBuffer& inBuf, mcl::AudioBuffer& recBuf, Frame inputTracker,
-    int maxFrames, float inVol, bool allowsOverdub) const
+    int maxFrames, SmoothedParam::Ramp inVol, bool allowsOverdub) const
 {
 	assert(maxFrames > 0 && maxFrames <= recBuf.countFrames());
 	assert(onEndOfRecording != nullptr);
@@ -309,11 +328,9 @@ int Mixer::lineInRec(const mcl::AudioBuffer& inBuf, mcl::AudioBuffer& recBuf, Fr
 		return 0;
 	}
 
-	const int   framesToCopy = -1; // copy everything
-	const Frame srcOffset    = 0;
-	const Frame destOffset   = inputTracker % maxFrames; // loop over at maxFrames
+	const Frame destOffset = inputTracker % maxFrames; // loop over at maxFrames
 
-	recBuf.sum(inBuf, framesToCopy, srcOffset, destOffset, inVol);
+	dsp::sum(recBuf, inBuf, inVol, destOffset);
 
 	return inputTracker + inBuf.countFrames();
 }
@@ -321,7 +338,7 @@ int Mixer::lineInRec(const mcl::AudioBuffer& inBuf, mcl::AudioBuffer& recBuf, Fr
 /* -------------------------------------------------------------------------- */
 
 void Mixer::processLineIn(const model::Mixer& mixer, const mcl::AudioBuffer& inBuf,
-    float inVol, float recTriggerLevel, bool isSeqActive) const
+    SmoothedParam::Ramp inVol, float recTriggerLevel, bool isSeqActive) const
 {
 	const Peak peak = makePeak(inBuf);
 
@@ -329,7 +346,7 @@ void Mixer::processLineIn(const model::Mixer& mixer, const mcl::AudioBuffer& inB
 	{
 		m_signalCbFired = true;
 		onSignalTresholdReached();
-		G_DEBUG("Signal > threshold!", );
+		u::trace::instant("signal_threshold");
 	}
 
 	mixer.a_setPeakIn(peak);
@@ -339,17 +356,102 @@ void Mixer::processLineIn(const model::Mixer& mixer, const mcl::AudioBuffer& inB
 
 	assert(inBuf.countChannels() <= mixer.getInBuffer().countChannels());
 
-	mixer.getInBuffer().set(inBuf, inVol);
+	dsp::set(mixer.getInBuffer(), inBuf, inVol);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Mixer::renderChannels(const std::vector<Channel>& channels, mcl::AudioBuffer& out,
-    mcl::AudioBuffer& in, bool hasSolos, bool seqIsRunning) const
+    mcl::AudioBuffer& in, bool hasSolos, bool seqIsRunning, Stems* stems) const
 {
-	for (const Channel& c : channels)
-		if (!c.isInternal())
-			c.render(&out, &in, hasSolos, seqIsRunning);
+	const bool profile = m_profiler.isEnabled();
+
+	if (!m_renderPool.isEnabled())
+	{
+		for (const Channel& c : channels)
+		{
+			if (c.isInternal())
+				continue;
+			renderChannel(c, in, seqIsRunning, profile);
+			mixChannel(c, out, hasSolos, stems);
+		}
+	}
+	else
+	{
+		/* Parallel rendering. Channels don't share any state while rendering 
+		(each one has its own plug-in working buffer, MIDI buffer and queues), so
+		all of them are handed over to the render pool, with the audio thread
+		taking part in the processing. Buffers are then mixed in the very same 
+		order of the serial path above, so that the final output is 
+		bit-identical. */
+
+		const auto job = [this, &channels, &in, seqIsRunning, profile](int i) {
+			const Channel& c = channels[i];
+			if (!c.isInternal())
+				renderChannel(c, in, seqIsRunning, profile);
+		};
+
+		m_renderPool.dispatch_RT(static_cast<int>(channels.size()), job);
+		m_renderPool.wait_RT();
+
+		for (const Channel& c : channels)
+			if (!c.isInternal())
+				mixChannel(c, out, hasSolos, stems);
+	}
+
+	/* Timings have been stored by the rendering threads: hand them over to the
+	profiler from here, its only producer. */
+
+	if (profile)
+		for (const Channel& c : channels)
+		{
+			if (c.isInternal())
+				continue;
+			m_profiler.push_RT(Profiler::Stage::CHANNEL, c.shared->renderTime, c.id);
+			if (!c.plugins.empty())
+				m_profiler.push_RT(Profiler::Stage::CHANNEL_PLUGINS, c.shared->pluginsTime, c.id);
+		}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Mixer::renderChannel(const Channel& c, mcl::AudioBuffer& in, bool seqIsRunning, bool profile) const
+{
+	const u::trace::Scope trace("render_channel");
+
+	if (!profile)
+	{
+		c.renderBuffer(in, seqIsRunning);
+		return;
+	}
+
+	const Profiler::Time start = Profiler::now();
+	c.renderBuffer(in, seqIsRunning, /*profile=*/true);
+	c.shared->renderTime = Profiler::elapsed(start);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Mixer::mixChannel(const Channel& c, mcl::AudioBuffer& out, bool hasSolos, Stems* stems) const
+{
+	Stem* stem = nullptr;
+	if (stems != nullptr)
+		for (Stem& s : *stems)
+			if (s.channelId == c.id)
+				stem = &s;
+
+	if (stem == nullptr)
+	{
+		c.mixBuffer(out, hasSolos);
+		return;
+	}
+
+	/* Mixing into a silent buffer first and then summing it to the output gives
+	the very same result as mixing into the output directly. */
+
+	stem->buffer.clear();
+	c.mixBuffer(stem->buffer, hasSolos);
+	dsp::sum(out, stem->buffer, /*gain=*/1.0f);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -359,9 +461,9 @@ void Mixer::renderMasterIn(const Channel& ch, mcl::AudioBuffer& in, bool seqIsRu
 	ch.render(nullptr, &in, true, seqIsRunning);
 }
 
-void Mixer::renderMasterOut(const Channel& ch, mcl::AudioBuffer& out, bool seqIsRunning) const
+void Mixer::renderMasterOut(const Channel& ch, mcl::AudioBuffer& out, SmoothedParam::Ramp vol) const
 {
-	ch.render(&out, nullptr, true, seqIsRunning);
+	ch.renderMasterOut(out, vol);
 }
 
 void Mixer::renderPreview(const Channel& ch, mcl::AudioBuffer& out, bool seqIsRunning) const
@@ -373,24 +475,22 @@ void Mixer::renderPreview(const Channel& ch, mcl::AudioBuffer& out, bool seqIsRu
 
 void Mixer::limit(mcl::AudioBuffer& outBuf) const
 {
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			outBuf[i][j] = std::max(-1.0f, std::min(outBuf[i][j], 1.0f));
+	dsp::clamp(outBuf, -1.0f, 1.0f);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Mixer::finalizeOutput(const model::Mixer& mixer, mcl::AudioBuffer& buf,
-    bool inToOut, bool shouldLimit, float vol) const
+    bool inToOut, bool shouldLimit, SmoothedParam::Ramp vol) const
 {
 	if (inToOut)
-		buf.sum(mixer.getInBuffer(), vol);
+		dsp::sum(buf, mixer.getInBuffer(), vol);
 	else
-		buf.applyGain(vol);
+		dsp::applyGain(buf, vol);
 
 	if (shouldLimit)
 		limit(buf);
 
-	mixer.a_setPeakOut({buf.getPeak(CH_LEFT), buf.getPeak(CH_RIGHT)});
+	mixer.a_setPeakOut(dsp::getPeak(buf));
 }
 } // namespace giada::m
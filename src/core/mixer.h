@@ -28,14 +28,18 @@
 #define G_MIXER_H
 
 #include "core/midiEvent.h"
+#include "core/profiler.h"
 #include "core/queue.h"
+#include "core/renderPool.h"
 #include "core/ringBuffer.h"
 #include "core/sequencer.h"
+#include "core/smoothedParam.h"
 #include "core/types.h"
 #include "core/weakAtomic.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "src/core/actions/actions.h"
 #include <functional>
+#include <vector>
 
 namespace mcl
 {
@@ -69,7 +73,20 @@ public:
 		int   maxLength;
 	};
 
-	Mixer(model::Model&);
+	/* Stem
+	Output of a single channel, after volume and pan, captured by render() on
+	request (e.g. when bouncing stems offline). 'buffer' must have the same
+	size of the output buffer. */
+
+	struct Stem
+	{
+		ID               channelId;
+		mcl::AudioBuffer buffer;
+	};
+
+	using Stems = std::vector<Stem>;
+
+	Mixer(model::Model&, const Profiler&);
 
 	Peak getPeakOut() const;
 	Peak getPeakIn() const;
@@ -87,10 +104,11 @@ public:
 	InputRecMode   getInputRecMode() const;
 
 	/* render
-	Core rendering function. */
+	Core rendering function. Channels listed in 'stems', if any, have their own
+	contribution to 'out' copied to the matching Stem buffer as well. */
 
 	void render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const model::Layout&,
-	    int maxFramesToRec) const;
+	    int maxFramesToRec, Stems* stems = nullptr) const;
 
 	/* reset
 	Brings everything back to the initial state. Must be called only when mixer
@@ -138,6 +156,19 @@ public:
 	void advanceChannels(const Sequencer::EventBuffer&, const model::Channels&,
 	    Range<Frame>, int quantizerStep) const;
 
+	/* setRenderThreads
+	Sets the number of helper threads used to render channels in parallel. 0 
+	means serial rendering on the audio thread. Must be called only when the
+	audio stream is not running. */
+
+	void setRenderThreads(int numThreads);
+
+	/* setRenderPriority
+	Sets the scheduling priority of the helper threads, which must match the
+	one of the thread rendering blocks. See RenderPool::setPriority(). */
+
+	void setRenderPriority(RenderPool::Priority) const;
+
 	/* updateSoloCount
     Updates the number of solo-ed channels in mixer. */
 
@@ -181,19 +212,31 @@ private:
 	recording in RIGID or FREE mode. Returns the number of recorded frames. */
 
 	int lineInRec(const mcl::AudioBuffer& inBuf, mcl::AudioBuffer& recBuf,
-	    Frame inputTracker, int maxFrames, float inVol, bool allowsOverdub) const;
+	    Frame inputTracker, int maxFrames, SmoothedParam::Ramp inVol, bool allowsOverdub) const;
 
 	/* processLineIn
 	Computes line in peaks and prepares the internal working buffer for input
 	recording. */
 
 	void processLineIn(const model::Mixer& mixer, const mcl::AudioBuffer& inBuf,
-	    float inVol, float recTriggerLevel, bool isSeqActive) const;
+	    SmoothedParam::Ramp inVol, float recTriggerLevel, bool isSeqActive) const;
 
 	void renderChannels(const std::vector<Channel>& channels, mcl::AudioBuffer& out,
-	    mcl::AudioBuffer& in, bool hasSolos, bool seqIsRunning) const;
+	    mcl::AudioBuffer& in, bool hasSolos, bool seqIsRunning, Stems*) const;
+
+	/* mixChannel
+	Mixes the rendered buffer of a channel into 'out', going through its Stem
+	first if it has one. */
+
+	void mixChannel(const Channel&, mcl::AudioBuffer& out, bool hasSolos, Stems*) const;
+
+	/* renderChannel
+	Renders a channel's buffer, measuring how long it takes if 'profile' is
+	true. Can run on any rendering thread. */
+
+	void renderChannel(const Channel&, mcl::AudioBuffer& in, bool seqIsRunning, bool profile) const;
 	void renderMasterIn(const Channel&, mcl::AudioBuffer& in, bool seqIsRunning) const;
-	void renderMasterOut(const Channel&, mcl::AudioBuffer& out, bool seqIsRunning) const;
+	void renderMasterOut(const Channel&, mcl::AudioBuffer& out, SmoothedParam::Ramp vol) const;
 	void renderPreview(const Channel&, mcl::AudioBuffer& out, bool seqIsRunning) const;
 
 	/* limit
@@ -206,9 +249,11 @@ private:
 	output volume, compute peak. */
 
 	void finalizeOutput(const model::Mixer&, mcl::AudioBuffer&, bool inToOut,
-	    bool limit, float vol) const;
+	    bool limit, SmoothedParam::Ramp vol) const;
 
-	model::Model& m_model;
+	model::Model&   m_model;
+	const Profiler& m_profiler;
+	RenderPool      m_renderPool;
 
 	/* m_signalCbFired, m_endOfRecCbFired
 	Boolean guards to determine whether the callbacks have been fired or not, 
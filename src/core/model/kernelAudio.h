@@ -50,6 +50,7 @@ struct KernelAudio
 	bool               limitOutput     = false;
 	Resampler::Quality rsmpQuality     = Resampler::Quality::LINEAR;
 	float              recTriggerLevel = 0.0f;
+	int                renderThreads   = 0;
 };
 } // namespace giada::m::model
 
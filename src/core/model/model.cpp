@@ -27,6 +27,8 @@
 #include "core/model/model.h"
 #include "utils/log.h"
 #include "utils/string.h"
+#include "utils/trace.h"
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #ifdef G_DEBUG_MODE
@@ -58,10 +60,24 @@ auto* get_(S& source, ID id)
 
 /* -------------------------------------------------------------------------- */
 
-template <typename D, typename T>
-void remove_(D& dest, T& ref)
+template <typename T>
+void remove_(std::vector<std::unique_ptr<T>>& dest, const T& ref, Reclaimer& reclaimer)
+{
+	auto it = std::find_if(dest.begin(), dest.end(), [&ref](const std::unique_ptr<T>& other) { return other.get() == &ref; });
+	if (it == dest.end())
+		return;
+	reclaimer.retire(std::move(*it));
+	dest.erase(it);
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename T>
+void clear_(std::vector<std::unique_ptr<T>>& dest, Reclaimer& reclaimer)
 {
-	u::vector::removeIf(dest, [&ref](const auto& other) { return other.get() == &ref; });
+	for (std::unique_ptr<T>& p : dest)
+		reclaimer.retire(std::move(p));
+	dest.clear();
 }
 } // namespace
 
@@ -83,17 +99,40 @@ void Layout::debug() const
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-DataLock::DataLock(Model& m, SwapType t)
+LayoutLock::LayoutLock(const Reclaimer& r, const AtomicSwapper& s)
+: m_guard(r)
+, m_lock(s)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Layout& LayoutLock::get() const
+{
+	return m_lock.get();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+DataLock::DataLock(Model& m, ID channelId, SwapType t)
 : m_model(m)
+, m_channelId(channelId)
 , m_swapType(t)
 {
-	m_model.get().locked = true;
+	m_model.get().channels.get(m_channelId).locked = true;
 	m_model.swap(SwapType::NONE);
+
+	/* Wait for the realtime thread to be done with any layout where the 
+	channel was still unlocked. */
+
+	m_model.m_reclaimer.synchronize();
 }
 
 DataLock::~DataLock()
 {
-	m_model.get().locked = false;
+	m_model.get().channels.get(m_channelId).locked = false;
 	m_model.swap(m_swapType);
 }
 
@@ -103,7 +142,15 @@ DataLock::~DataLock()
 
 Model::Model()
 : onSwap(nullptr)
+, m_actions(new ActionTimeline())
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+Model::~Model()
 {
+	delete m_actions.load();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -111,6 +158,7 @@ Model::Model()
 void Model::init()
 {
 	m_shared = {};
+	replaceShared(ActionTimeline());
 
 	Layout& layout          = get();
 	layout                  = {};
@@ -125,6 +173,7 @@ void Model::init()
 void Model::reset()
 {
 	m_shared = {};
+	replaceShared(ActionTimeline());
 
 	Layout& layout          = get();
 	layout.sequencer        = {};
@@ -154,6 +203,7 @@ void Model::load(const Conf& conf)
 	layout.kernelAudio.limitOutput             = conf.limitOutput;
 	layout.kernelAudio.rsmpQuality             = conf.rsmpQuality;
 	layout.kernelAudio.recTriggerLevel         = conf.recTriggerLevel;
+	layout.kernelAudio.renderThreads           = conf.renderThreads;
 
 	layout.kernelMidi.api         = conf.midiSystem;
 	layout.kernelMidi.portOut     = conf.midiPortOut;
@@ -180,6 +230,8 @@ void Model::load(const Conf& conf)
 	layout.treatRecsAsLoops           = conf.treatRecsAsLoops;
 	layout.inputMonitorDefaultOn      = conf.inputMonitorDefaultOn;
 	layout.overdubProtectionDefaultOn = conf.overdubProtectionDefaultOn;
+	layout.progressiveLoading         = conf.progressiveLoading;
+	layout.compressProjectAudio       = conf.compressProjectAudio;
 
 	swap(model::SwapType::NONE);
 }
@@ -202,6 +254,7 @@ void Model::store(Conf& conf) const
 	conf.limitOutput      = layout.kernelAudio.limitOutput;
 	conf.rsmpQuality      = layout.kernelAudio.rsmpQuality;
 	conf.recTriggerLevel  = layout.kernelAudio.recTriggerLevel;
+	conf.renderThreads    = layout.kernelAudio.renderThreads;
 
 	conf.midiSystem  = layout.kernelMidi.api;
 	conf.midiPortOut = layout.kernelMidi.portOut;
@@ -228,6 +281,8 @@ void Model::store(Conf& conf) const
 	conf.treatRecsAsLoops           = layout.treatRecsAsLoops;
 	conf.inputMonitorDefaultOn      = layout.inputMonitorDefaultOn;
 	conf.overdubProtectionDefaultOn = layout.overdubProtectionDefaultOn;
+	conf.progressiveLoading         = layout.progressiveLoading;
+	conf.compressProjectAudio       = layout.compressProjectAudio;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -241,7 +296,7 @@ bool Model::registerThread(Thread t, bool realtime) const
 
 Layout&       Model::get() { return m_swapper.get(); }
 const Layout& Model::get() const { return m_swapper.get(); }
-LayoutLock    Model::get_RT() const { return LayoutLock(m_swapper); }
+LayoutLock    Model::get_RT() const { return LayoutLock(m_reclaimer, m_swapper); }
 
 /* -------------------------------------------------------------------------- */
 
@@ -255,23 +310,40 @@ void Model::set(const Layout& layout)
 
 void Model::swap(SwapType t)
 {
+	const u::trace::Scope trace(t == SwapType::HARD ? "model_swap_hard" : "model_swap");
+
 	m_swapper.swap();
+	m_reclaimer.collect();
+	notify(t);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Model::collect()
+{
+	m_reclaimer.collect();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Model::notify(SwapType t)
+{
 	if (onSwap != nullptr)
 		onSwap(t);
 }
 
 /* -------------------------------------------------------------------------- */
 
-DataLock Model::lockData(SwapType t)
+DataLock Model::lockData(ID channelId, SwapType t)
 {
-	return DataLock(*this, t);
+	return DataLock(*this, channelId, t);
 }
 
 /* -------------------------------------------------------------------------- */
 
-bool Model::isLocked() const
+void Model::synchronize()
 {
-	return m_swapper.isRtLocked();
+	m_reclaimer.synchronize();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -283,8 +355,8 @@ T& Model::getAllShared()
 		return m_shared.plugins;
 	if constexpr (std::is_same_v<T, WavePtrs>)
 		return m_shared.waves;
-	if constexpr (std::is_same_v<T, Actions::Map>)
-		return m_shared.actions;
+	if constexpr (std::is_same_v<T, ActionTimeline>)
+		return *m_actions.load();
 	if constexpr (std::is_same_v<T, ChannelSharedPtrs>)
 		return m_shared.channelsShared;
 
@@ -293,7 +365,7 @@ T& Model::getAllShared()
 
 template PluginPtrs&        Model::getAllShared<PluginPtrs>();
 template WavePtrs&          Model::getAllShared<WavePtrs>();
-template Actions::Map&      Model::getAllShared<Actions::Map>();
+template ActionTimeline&    Model::getAllShared<ActionTimeline>();
 template ChannelSharedPtrs& Model::getAllShared<ChannelSharedPtrs>();
 
 /* -------------------------------------------------------------------------- */
@@ -335,9 +407,9 @@ template <typename T>
 void Model::removeShared(const T& ref)
 {
 	if constexpr (std::is_same_v<T, Plugin>)
-		remove_(m_shared.plugins, ref);
+		remove_(m_shared.plugins, ref, m_reclaimer);
 	if constexpr (std::is_same_v<T, Wave>)
-		remove_(m_shared.waves, ref);
+		remove_(m_shared.waves, ref, m_reclaimer);
 }
 
 template void Model::removeShared<Plugin>(const Plugin& t);
@@ -345,6 +417,20 @@ template void Model::removeShared<Wave>(const Wave& t);
 
 /* -------------------------------------------------------------------------- */
 
+template <typename T>
+void Model::replaceShared(T obj)
+{
+	if constexpr (std::is_same_v<T, ActionTimeline>)
+	{
+		ActionTimeline* old = m_actions.exchange(new ActionTimeline(std::move(obj)));
+		m_reclaimer.retire(std::unique_ptr<ActionTimeline>(old));
+	}
+}
+
+template void Model::replaceShared<ActionTimeline>(ActionTimeline t);
+
+/* -------------------------------------------------------------------------- */
+
 template <typename T>
 T& Model::backShared()
 {
@@ -366,9 +452,9 @@ template <typename T>
 void Model::clearShared()
 {
 	if constexpr (std::is_same_v<T, PluginPtrs>)
-		m_shared.plugins.clear();
+		clear_(m_shared.plugins, m_reclaimer);
 	if constexpr (std::is_same_v<T, WavePtrs>)
-		m_shared.waves.clear();
+		clear_(m_shared.waves, m_reclaimer);
 }
 
 template void Model::clearShared<PluginPtrs>();
@@ -402,13 +488,9 @@ void Model::debug()
 
 	puts("model::shared.actions");
 
-	for (const auto& [frame, actions] : getAllShared<Actions::Map>())
-	{
-		fmt::print("\tframe: {}\n", frame);
-		for (const Action& a : actions)
-			fmt::print("\t\t({}) - ID={}, frame={}, channel={}, value=0x{}, prevId={}, prev={}, nextId={}, next={}\n",
-			    (void*)&a, a.id, a.frame, a.channelId, a.event.getRaw(), a.prevId, (void*)a.prev, a.nextId, (void*)a.next);
-	}
+	for (const Action& a : getAllShared<ActionTimeline>().getAll())
+		fmt::print("\t({}) - ID={}, frame={}, channel={}, value=0x{}, prevId={}, nextId={}\n",
+		    (void*)&a, a.id, a.frame, a.channelId, a.event.getRaw(), a.prevId, a.nextId);
 
 	puts("model::shared.plugins");
 
@@ -34,6 +34,7 @@
 #include "core/model/kernelMidi.h"
 #include "core/model/midiIn.h"
 #include "core/model/mixer.h"
+#include "core/model/reclaimer.h"
 #include "core/model/sequencer.h"
 #include "core/plugins/plugin.h"
 #include "core/wave.h"
@@ -41,6 +42,7 @@
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "src/core/actions/actions.h"
 #include "utils/vector.h"
+#include <atomic>
 #include <memory>
 
 namespace giada::m::model
@@ -51,12 +53,6 @@ struct Layout
 	void debug() const;
 #endif
 
-	/* locked
-	If locked, Mixer won't process channels. This is used to allow editing the 
-	shared data (e.g. Plugins, Waves) by the rendering engine without data races. */
-
-	bool locked = false;
-
 	KernelAudio kernelAudio;
 	KernelMidi  kernelMidi;
 	Sequencer   sequencer;
@@ -68,14 +64,31 @@ struct Layout
 	bool treatRecsAsLoops           = false;
 	bool inputMonitorDefaultOn      = false;
 	bool overdubProtectionDefaultOn = false;
+	bool progressiveLoading         = false;
+	bool compressProjectAudio       = false;
 };
 
+using AtomicSwapper = mcl::AtomicSwapper<Layout, /*size=*/6>;
+
 /* LayoutLock
-Alias for a REALTIME scoped lock provided by the Swapper class. Use this in the
-real-time thread to lock the Layout. */
+REALTIME scoped lock over the Layout provided by the Swapper class. It also
+keeps alive the shared data (e.g. Plugins, Waves, Actions) reachable while it
+exists. Use this in the real-time thread to lock the Layout. */
 
-using AtomicSwapper = mcl::AtomicSwapper<Layout, /*size=*/6>;
-using LayoutLock    = AtomicSwapper::RtLock;
+class LayoutLock
+{
+public:
+	LayoutLock(const Reclaimer&, const AtomicSwapper&);
+
+	const Layout& get() const;
+
+private:
+	/* Order matters: the Reclaimer guard must be in place before the Layout is
+	read. */
+
+	Reclaimer::Guard      m_guard;
+	AtomicSwapper::RtLock m_lock;
+};
 
 /* SwapType
 Type of Layout change. 
@@ -107,14 +120,22 @@ class Model
 {
 public:
 	Model();
+	~Model();
 
-	bool isLocked() const;
+	/* synchronize
+	Waits until the realtime thread is done with any layout it was rendering 
+	before the call. Never blocks the realtime thread. */
+
+	void synchronize();
 
 	/* lockData
-	Returns a scoped locker DataLock object. Use this when you want to lock
-	the model: a locked model won't be processed by Mixer. */
+	Returns a scoped locker DataLock object. Use this when you want to edit in
+	place the shared data of channel 'channelId' (e.g. a streamed Wave): a
+	locked channel won't be processed by Mixer, the others keep playing. This 
+	is the only lock left on the shared data: everything else is replaced and 
+	retired instead, which is always preferable. */
 
-	[[nodiscard]] DataLock lockData(SwapType t = SwapType::HARD);
+	[[nodiscard]] DataLock lockData(ID channelId, SwapType t = SwapType::HARD);
 
 	/* init
 	Initializes the internal layout. All values go back to default. */
@@ -158,6 +179,26 @@ public:
 
 	void swap(SwapType t);
 
+	/* collect
+	Releases the memory of shared data removed so far, if the realtime thread
+	can't see it anymore. Swaps do it too, but only the main thread actually 
+	frees anything: call this periodically from there, so that data removed by
+	other threads (e.g. plug-ins deleted by a MIDI message) is not kept around 
+	for too long. */
+
+	void collect();
+
+	/* notify
+	Fires the onSwap callback without swapping the layout. Use it when a change
+	doesn't need to reach the realtime thread through the layout (e.g. values
+	stored in ChannelShared), but listeners still have to know about it. */
+
+	void notify(SwapType t);
+
+	/* getAllShared
+	Returns all shared data of a kind. The ActionTimeline is read-only: use 
+	replaceShared() to change it. */
+
 	template <typename T>
 	T& getAllShared();
 
@@ -174,9 +215,21 @@ public:
 	template <typename T>
 	void addShared(T);
 
+	/* removeShared
+	Removes some shared data. Its memory is released later on, once the 
+	realtime thread can't see it anymore: swap the layout first if it is still
+	referenced there. */
+
 	template <typename T>
 	void removeShared(const T&);
 
+	/* replaceShared
+	Replaces some shared data (by moving it) and publishes it to the realtime
+	thread straight away. The old one is released as in removeShared(). */
+
+	template <typename T>
+	void replaceShared(T);
+
 	/* backShared
 	Returns a reference to the last added shared item. */
 
@@ -197,6 +250,8 @@ public:
 	std::function<void(SwapType)> onSwap;
 
 private:
+	friend class DataLock;
+
 	struct Shared
 	{
 		Sequencer::Shared                           sequencerShared;
@@ -204,12 +259,18 @@ private:
 		std::vector<std::unique_ptr<ChannelShared>> channelsShared;
 
 		std::vector<std::unique_ptr<Wave>>   waves;
-		Actions::Map                         actions;
 		std::vector<std::unique_ptr<Plugin>> plugins;
 	};
 
 	AtomicSwapper m_swapper;
+	Reclaimer     m_reclaimer;
 	Shared        m_shared;
+
+	/* m_actions
+	Owned by the Model. Read directly by the realtime thread (not through the 
+	Layout), hence atomic. */
+
+	std::atomic<ActionTimeline*> m_actions;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -217,11 +278,12 @@ private:
 class DataLock
 {
 public:
-	DataLock(Model&, SwapType t);
+	DataLock(Model&, ID channelId, SwapType t);
 	~DataLock();
 
 private:
 	Model&   m_model;
+	ID       m_channelId;
 	SwapType m_swapType;
 };
 } // namespace giada::m::model
@@ -0,0 +1,184 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/model/reclaimer.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <thread>
+
+namespace giada::m::model
+{
+namespace
+{
+/* FREE_
+Value of a reader slot not in use. Epochs start from 1. */
+
+constexpr uint64_t FREE_ = 0;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Reclaimer::Guard::Guard(const Reclaimer& r)
+: m_slot(nullptr)
+{
+	uint64_t epoch = r.m_epoch.load();
+
+	for (std::atomic<uint64_t>& slot : r.m_readers)
+	{
+		uint64_t expected = FREE_;
+		if (slot.compare_exchange_strong(expected, epoch))
+		{
+			m_slot = &slot;
+			break;
+		}
+	}
+
+	assert(m_slot != nullptr); // Too many realtime readers, raise G_MAX_RT_READERS
+
+	if (m_slot == nullptr)
+		return;
+
+	/* A writer might have moved the epoch forward right before the slot was
+	published, without noticing this reader: publish the new epoch again, until 
+	it's stable. */
+
+	uint64_t current;
+	while ((current = r.m_epoch.load()) != epoch)
+	{
+		epoch = current;
+		m_slot->store(epoch);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+Reclaimer::Guard::~Guard()
+{
+	if (m_slot != nullptr)
+		m_slot->store(FREE_);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Reclaimer::Reclaimer()
+: m_epoch(1)
+, m_collector(std::this_thread::get_id())
+{
+	for (std::atomic<uint64_t>& slot : m_readers)
+		slot.store(FREE_);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Reclaimer::~Reclaimer()
+{
+	assert(getOldestReader() == m_epoch.load());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Reclaimer::retire(std::shared_ptr<void> data)
+{
+	const uint64_t epoch = advance();
+	{
+		std::scoped_lock lock(m_mutex);
+		m_garbage.push_back({epoch, std::move(data)});
+	}
+	collect();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Reclaimer::collect()
+{
+	/* Objects are deleted outside the lock: destructors might be slow (e.g. 
+	plug-ins) and must not hold up other writers. */
+
+	if (std::this_thread::get_id() != m_collector)
+		return;
+
+	std::vector<Garbage> deletable;
+	{
+		std::scoped_lock lock(m_mutex);
+
+		if (m_garbage.empty())
+			return;
+
+		/* Objects retired while the oldest reader was already around (i.e. in
+		its epoch or later) might still be in use: keep them. */
+
+		const uint64_t oldest = getOldestReader();
+		const auto     it     = std::partition(m_garbage.begin(), m_garbage.end(),
+		    [oldest](const Garbage& g) { return g.epoch >= oldest; });
+
+		deletable.insert(deletable.end(), std::make_move_iterator(it), std::make_move_iterator(m_garbage.end()));
+		m_garbage.erase(it, m_garbage.end());
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Reclaimer::synchronize()
+{
+	const uint64_t epoch = advance();
+	while (getOldestReader() <= epoch)
+		std::this_thread::yield();
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t Reclaimer::countRetired() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_garbage.size();
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t Reclaimer::advance()
+{
+	return m_epoch.fetch_add(1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t Reclaimer::getOldestReader() const
+{
+	uint64_t oldest = m_epoch.load();
+	for (const std::atomic<uint64_t>& slot : m_readers)
+	{
+		const uint64_t epoch = slot.load();
+		if (epoch != FREE_ && epoch < oldest)
+			oldest = epoch;
+	}
+	return oldest;
+}
+} // namespace giada::m::model
@@ -0,0 +1,137 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_MODEL_RECLAIMER_H
+#define G_MODEL_RECLAIMER_H
+
+#include "core/const.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace giada::m::model
+{
+/* Reclaimer
+Epoch-based memory reclamation for data shared with the realtime thread. Once
+an object has been unpublished (e.g. a Wave replaced in a channel and the 
+layout swapped), it is retired here instead of being deleted. Retired objects
+are deleted by collect() as soon as no realtime reader that might still see 
+them is around. Realtime readers never wait and never block writers. 
+
+Deletion only ever happens on the collector thread, i.e. the one that built 
+the Reclaimer (the main thread): some objects, such as plug-ins, must be 
+destroyed there. Objects retired by other threads just wait for it. */
+
+class Reclaimer
+{
+public:
+	/* Guard
+	Scoped realtime reader. Objects retired while a Guard is alive are not
+	deleted until the Guard goes out of scope. Lock-free, it never allocates. */
+
+	class Guard
+	{
+	public:
+		Guard(const Reclaimer&);
+		Guard(const Guard&) = delete;
+		~Guard();
+
+		Guard& operator=(const Guard&) = delete;
+
+	private:
+		std::atomic<uint64_t>* m_slot;
+	};
+
+	Reclaimer();
+	~Reclaimer();
+
+	/* retire
+	Hands over an object that new readers can't reach anymore. It will be 
+	deleted later on by collect(), on the collector thread. */
+
+	template <typename T>
+	void retire(std::unique_ptr<T> p)
+	{
+		if (p != nullptr)
+			retire(std::shared_ptr<void>(std::move(p)));
+	}
+
+	void retire(std::shared_ptr<void>);
+
+	/* collect
+	Deletes the retired objects no reader can see anymore. Does nothing if not
+	called by the collector thread. */
+
+	void collect();
+
+	/* synchronize
+	Waits until all readers that might have seen the data as it was before the
+	call have gone. Blocks the caller only, never the readers. */
+
+	void synchronize();
+
+	/* countRetired
+	Returns the number of retired objects still waiting to be deleted. */
+
+	std::size_t countRetired() const;
+
+private:
+	struct Garbage
+	{
+		uint64_t              epoch;
+		std::shared_ptr<void> data;
+	};
+
+	/* advance
+	Moves the global epoch forward. Returns the epoch that readers which might
+	have seen the data as it was before the call belong to. */
+
+	uint64_t advance();
+
+	/* getOldestReader
+	Returns the oldest epoch a reader is currently in, or the current epoch if
+	there are no readers around. */
+
+	uint64_t getOldestReader() const;
+
+	std::atomic<uint64_t> m_epoch;
+
+	/* m_readers
+	Epoch each realtime reader has entered, 0 if the slot is free. */
+
+	mutable std::array<std::atomic<uint64_t>, G_MAX_RT_READERS> m_readers;
+
+	std::vector<Garbage> m_garbage;
+	mutable std::mutex   m_mutex;
+	std::thread::id      m_collector;
+};
+} // namespace giada::m::model
+
+#endif
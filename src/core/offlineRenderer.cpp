@@ -0,0 +1,220 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/offlineRenderer.h"
+#include "core/const.h"
+#include "core/model/model.h"
+#include "core/sequencer.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <cassert>
+#include <sndfile.h>
+
+namespace giada::m
+{
+namespace
+{
+/* File_
+An audio file being written, together with the buffer it's fed from. */
+
+struct File_
+{
+	SNDFILE*          file;
+	mcl::AudioBuffer* buffer;
+};
+
+/* -------------------------------------------------------------------------- */
+
+/* openFile_
+Opens a new file for writing. Bounces are floating point data: WAV files keep
+them as they are, FLAC files are 24-bit with values out of range clipped. */
+
+SNDFILE* openFile_(const std::string& path, WaveFormat format, int sampleRate)
+{
+	SF_INFO header;
+	header.samplerate = sampleRate;
+	header.channels   = G_MAX_IO_CHANS;
+	header.format     = format == WaveFormat::FLAC
+	                        ? SF_FORMAT_FLAC | SF_FORMAT_PCM_24
+	                        : SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &header);
+	if (file == nullptr)
+	{
+		u::log::print("[OfflineRenderer] unable to open %s for writing: %s\n",
+		    path.c_str(), sf_strerror(file));
+		return nullptr;
+	}
+
+	if (format == WaveFormat::FLAC)
+		sf_command(file, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+
+	return file;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+OfflineRenderer::OfflineRenderer(model::Model& m, Sequencer& s)
+: onAboutToRender(nullptr)
+, onRendered(nullptr)
+, onRenderBlock(nullptr)
+, m_model(m)
+, m_sequencer(s)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool OfflineRenderer::isValid(const Request& req) const
+{
+	const model::Layout& layout = m_model.get();
+
+	if (req.range.getBegin() < 0 || req.range.getLength() <= 0 || req.targets.empty())
+		return false;
+
+	/* Line in is silent while rendering offline: an ongoing recording would 
+	be spoiled. */
+
+	if (layout.mixer.isRecordingInput || layout.mixer.isRecordingActions || !layout.mixer.a_isActive())
+		return false;
+
+	return std::all_of(req.targets.begin(), req.targets.end(), [&layout](const Target& t) {
+		return t.channelId == Mixer::MASTER_OUT_CHANNEL_ID ||
+		       layout.channels.anyOf([id = t.channelId](const Channel& c) { return c.id == id && !c.isInternal(); });
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+int OfflineRenderer::render(const Request& req, int sampleRate, int bufferSize,
+    std::function<void(float)> progress) const
+{
+	assert(onAboutToRender != nullptr);
+	assert(onRendered != nullptr);
+	assert(onRenderBlock != nullptr);
+
+	if (!isValid(req))
+		return G_RES_ERR_WRONG_DATA;
+
+	mcl::AudioBuffer out(bufferSize, G_MAX_IO_CHANS);
+	mcl::AudioBuffer in(bufferSize, G_MAX_IO_CHANS);
+	Mixer::Stems     stems;
+
+	/* Allocate all stems upfront: File_ objects point to their buffers. */
+
+	for (const Target& t : req.targets)
+		if (t.channelId != Mixer::MASTER_OUT_CHANNEL_ID)
+			stems.push_back({t.channelId, mcl::AudioBuffer(bufferSize, G_MAX_IO_CHANS)});
+
+	std::vector<File_> files;
+	for (const Target& t : req.targets)
+	{
+		SNDFILE* file = openFile_(t.path, req.format, sampleRate);
+		if (file == nullptr)
+		{
+			for (const File_& f : files)
+				sf_close(f.file);
+			return G_RES_ERR_IO;
+		}
+
+		mcl::AudioBuffer* buffer = &out;
+		for (Mixer::Stem& s : stems)
+			if (s.channelId == t.channelId)
+				buffer = &s.buffer;
+
+		files.push_back({file, buffer});
+	}
+
+	onAboutToRender();
+
+	/* Start from the first beat, with no metronome. The sequencer status is
+	changed in the layout directly, without going through Sequencer::start():
+	no MIDI clock messages, no recording logic. */
+
+	model::Sequencer& sequencer = m_model.get().sequencer;
+
+	const SeqStatus oldStatus    = sequencer.status;
+	const bool      oldMetronome = m_sequencer.isMetronomeOn();
+
+	sequencer.status = SeqStatus::RUNNING;
+	sequencer.a_setCurrentFrame(0, sampleRate);
+	m_model.swap(model::SwapType::SOFT);
+	m_sequencer.setMetronome(false);
+
+	const Frame begin        = req.range.getBegin();
+	const Frame end          = req.range.getEnd();
+	const Frame progressStep = std::max<Frame>(end / 100, bufferSize);
+
+	bool  ok           = true;
+	Frame lastProgress = 0;
+	for (Frame frame = 0; frame < end && ok; frame += bufferSize)
+	{
+		onRenderBlock(out, in, stems.empty() ? nullptr : &stems);
+
+		/* Write only the part of the block that falls into the range. */
+
+		const Frame from = std::max(begin, frame);
+		const Frame to   = std::min(end, frame + bufferSize);
+
+		if (from < to)
+			for (const File_& f : files)
+				ok &= sf_writef_float(f.file, (*f.buffer)[from - frame], to - from) == to - from;
+
+		if (progress != nullptr && frame - lastProgress >= progressStep)
+		{
+			progress(frame / static_cast<float>(end));
+			lastProgress = frame;
+		}
+	}
+
+	/* Back to the previous state, with the sequencer on the first beat. */
+
+	m_sequencer.setMetronome(oldMetronome);
+	sequencer.status = oldStatus;
+	sequencer.a_setCurrentFrame(0, sampleRate);
+	m_model.swap(model::SwapType::SOFT);
+
+	onRendered();
+
+	for (const File_& f : files)
+		sf_close(f.file);
+
+	if (!ok)
+	{
+		u::log::print("[OfflineRenderer::render] unable to write bounced audio\n");
+		return G_RES_ERR_IO;
+	}
+
+	u::log::print("[OfflineRenderer::render] %d frames bounced to %d file(s)\n",
+	    req.range.getLength(), static_cast<int>(files.size()));
+
+	return G_RES_OK;
+}
+} // namespace giada::m
@@ -0,0 +1,114 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_OFFLINE_RENDERER_H
+#define G_OFFLINE_RENDERER_H
+
+#include "core/mixer.h"
+#include "core/range.h"
+#include "core/types.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace giada::m::model
+{
+class Model;
+}
+
+namespace giada::m
+{
+class Sequencer;
+
+/* OfflineRenderer
+Drives the rendering engine from a non-realtime loop, as fast as the CPU 
+allows, and bounces the result to audio files. The realtime audio callback is
+kept out of the way for the whole process. */
+
+class OfflineRenderer
+{
+public:
+	/* Target
+	What to bounce and where. Mixer::MASTER_OUT_CHANNEL_ID stands for the final
+	master output, any other ID for the output of that channel (i.e. a stem). */
+
+	struct Target
+	{
+		ID          channelId;
+		std::string path;
+	};
+
+	/* Request
+	Frames in 'range' are counted from the beginning of the sequencer, which
+	always starts from the first beat: frames before range's begin are rendered
+	but not written. Ranges longer than the loop wrap around it, so that 
+	bouncing N loops means asking for [0, framesInLoop * N). */
+
+	struct Request
+	{
+		Range<Frame>        range;
+		WaveFormat          format;
+		std::vector<Target> targets;
+	};
+
+	OfflineRenderer(model::Model&, Sequencer&);
+
+	/* render
+	Renders the request with the current sample rate and buffer size, which must
+	match the ones of the audio stream. Blocks until done. Returns G_RES_OK on
+	success or an error code. Must be called on the main thread. */
+
+	int render(const Request&, int sampleRate, int bufferSize,
+	    std::function<void(float)> progress) const;
+
+	/* onAboutToRender, onRendered
+	Callbacks fired right before and after the offline rendering. The former 
+	must return only when the realtime audio callback has stopped touching the
+	engine. */
+
+	std::function<void()> onAboutToRender;
+	std::function<void()> onRendered;
+
+	/* onRenderBlock
+	Callback fired for each block to be rendered. Must run the very same path
+	of the realtime audio callback. */
+
+	std::function<void(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, Mixer::Stems*)> onRenderBlock;
+
+private:
+	/* isValid
+	Tells whether the request can be rendered with the current layout. */
+
+	bool isValid(const Request&) const;
+
+	model::Model& m_model;
+	Sequencer&    m_sequencer;
+};
+} // namespace giada::m
+
+#endif
@@ -114,6 +114,8 @@ struct Patch
 	{
 		ID          id;
 		std::string path;
+		bool        streamed = false;
+		uint64_t    hash     = 0; // Content hash as saved, 0 if unknown
 	};
 
 	struct Plugin
@@ -101,8 +101,10 @@ void readWaves_(Patch& patch, const nlohmann::json& j, const std::string& basePa
 	for (const auto& jwave : j[PATCH_KEY_WAVES])
 	{
 		Patch::Wave w;
-		w.id   = jwave.value(PATCH_KEY_WAVE_ID, ++id);
-		w.path = u::fs::join(basePath, jwave.value(PATCH_KEY_WAVE_PATH, ""));
+		w.id       = jwave.value(PATCH_KEY_WAVE_ID, ++id);
+		w.path     = u::fs::join(basePath, jwave.value(PATCH_KEY_WAVE_PATH, ""));
+		w.streamed = jwave.value(PATCH_KEY_WAVE_STREAMED, false);
+		w.hash     = jwave.value(PATCH_KEY_WAVE_HASH, uint64_t{0});
 		patch.waves.push_back(w);
 	}
 }
@@ -255,8 +257,10 @@ void writeWaves_(const Patch& patch, nlohmann::json& j)
 	for (const Patch::Wave& w : patch.waves)
 	{
 		nlohmann::json jwave;
-		jwave[PATCH_KEY_WAVE_ID]   = w.id;
-		jwave[PATCH_KEY_WAVE_PATH] = w.path;
+		jwave[PATCH_KEY_WAVE_ID]       = w.id;
+		jwave[PATCH_KEY_WAVE_PATH]     = w.path;
+		jwave[PATCH_KEY_WAVE_STREAMED] = w.streamed;
+		jwave[PATCH_KEY_WAVE_HASH]     = w.hash;
 
 		j[PATCH_KEY_WAVES].push_back(jwave);
 	}
@@ -26,10 +26,14 @@
 
 #include "core/plugins/plugin.h"
 #include "core/const.h"
+#include "core/rtCheck.h"
 #include "utils/log.h"
 #include "utils/time.h"
 #include <FL/Fl.H>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include <memory>
 
 namespace giada::m
@@ -64,6 +68,7 @@ Plugin::Plugin(ID id, std::unique_ptr<juce::AudioPluginInstance> plugin,
 		midiInParams.emplace_back(0x0, i);
 
 	m_buffer.setSize(G_MAX_IO_CHANS, buffersize);
+	m_midiBuffer.ensureSize(G_MAX_PLUGIN_MIDI_BYTES);
 
 	/* Try to set the main bus to the current number of channels. In the future
 	this setup will be performed manually through a proper channel matrix. */
@@ -180,6 +185,19 @@ std::string Plugin::getName() const
 
 /* -------------------------------------------------------------------------- */
 
+Frame Plugin::getTailFrames() const
+{
+	if (!valid)
+		return 0;
+
+	const double frames = std::ceil(m_plugin->getTailLengthSeconds() * m_plugin->getSampleRate());
+	if (!(frames < std::numeric_limits<Frame>::max())) // Infinite or NaN too
+		return std::numeric_limits<Frame>::max();
+	return std::max(0, static_cast<Frame>(frames));
+}
+
+/* -------------------------------------------------------------------------- */
+
 bool Plugin::isSuspended() const
 {
 	if (!valid)
@@ -214,14 +232,19 @@ void Plugin::setBypass(bool b) { m_bypass.store(b); }
 
 /* -------------------------------------------------------------------------- */
 
-const Plugin::Buffer& Plugin::process(const Plugin::Buffer& out, juce::MidiBuffer m)
+const Plugin::Buffer& Plugin::process(const Plugin::Buffer& out, const juce::MidiBuffer& m)
 {
 	/* Copy the incoming buffer data into the temporary one. This way FXes will 
 	process	existing audio data on the private buffer. This is needed later on
-	when merging it back into the incoming buffer. */
+	when merging it back into the incoming buffer. Both copies reuse existing 
+	memory. */
+
+	m_buffer.makeCopyOf(out, /*avoidReallocating=*/true);
+	m_midiBuffer.clear();
+	m_midiBuffer.addEvents(m, 0, -1, 0);
 
-	m_buffer = out;
-	m_plugin->processBlock(m_buffer, m);
+	const rtCheck::PluginScope rtCheckScope(*this);
+	m_plugin->processBlock(m_buffer, m_midiBuffer);
 	return m_buffer;
 }
 
@@ -88,14 +88,21 @@ public:
 
 	int countMainOutChannels() const;
 
+	/* getTailFrames
+	Returns how long the plug-in keeps producing sound after its input went 
+	silent, as reported by the plug-in itself. Infinite tails are returned as
+	the largest Frame. */
+
+	Frame getTailFrames() const;
+
 	/* process
-	Process the plug-in with audio and MIDI data. The audio buffer is a 
-	reference, while the MIDI buffer must be passed by copy: each plug-in must 
-	receive its own copy of the event set, so that any attempt to change/clear 
-	the MIDI buffer will only modify the local copy. Returns a reference of the
+	Process the plug-in with audio and MIDI data. Each plug-in receives its own
+	copy of the event set, so that any attempt to change/clear the MIDI buffer 
+	will only modify the local copy. The copy goes into a pre-allocated buffer,
+	to keep the realtime thread allocation-free. Returns a reference of the 
 	local buffer filled with processed data. */
 
-	const Buffer& process(const Buffer& b, juce::MidiBuffer m);
+	const Buffer& process(const Buffer& b, const juce::MidiBuffer& m);
 
 	void setState(PluginState p);
 	void setBypass(bool b);
@@ -140,6 +147,7 @@ private:
 	std::unique_ptr<juce::AudioPluginInstance> m_plugin;
 	std::unique_ptr<PluginHost::Info>          m_playHead;
 	Buffer                                     m_buffer;
+	juce::MidiBuffer                           m_midiBuffer;
 
 	std::atomic<bool> m_bypass;
 
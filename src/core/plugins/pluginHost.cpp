@@ -35,6 +35,7 @@
 #include "utils/vector.h"
 #include <cassert>
 #include <cstddef>
+#include <limits>
 #include <memory>
 
 namespace giada::m
@@ -93,21 +94,40 @@ void PluginHost::setBufferSize(int bufferSize)
 /* -------------------------------------------------------------------------- */
 
 void PluginHost::processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
-    juce::MidiBuffer* events)
+    juce::MidiBuffer* events, juce::AudioBuffer<float>* workBuf)
 {
-	assert(outBuf.countFrames() == m_audioBuffer.getNumSamples());
+	juce::AudioBuffer<float>& buf = workBuf != nullptr ? *workBuf : m_audioBuffer;
 
-	giadaToJuceTempBuf(outBuf);
+	assert(outBuf.countFrames() == buf.getNumSamples());
+
+	giadaToJuceTempBuf(outBuf, buf);
 
 	if (events == nullptr)
 	{
 		juce::MidiBuffer dummyEvents; // empty
-		processPlugins(plugins, dummyEvents);
+		processPlugins(plugins, dummyEvents, buf);
 	}
 	else
-		processPlugins(plugins, *events);
+		processPlugins(plugins, *events, buf);
+
+	juceToGiadaOutBuf(outBuf, buf);
+}
 
-	juceToGiadaOutBuf(outBuf);
+/* -------------------------------------------------------------------------- */
+
+Frame PluginHost::getTailFrames(const std::vector<Plugin*>& plugins) const
+{
+	Frame tail = 0;
+	for (const Plugin* p : plugins)
+	{
+		if (!p->valid || p->isSuspended() || p->isBypassed())
+			continue;
+		const Frame t = p->getTailFrames();
+		if (t > std::numeric_limits<Frame>::max() - tail)
+			return std::numeric_limits<Frame>::max();
+		tail += t;
+	}
+	return tail;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -171,56 +191,56 @@ void PluginHost::toggleBypass(ID pluginId)
 
 /* -------------------------------------------------------------------------- */
 
-void PluginHost::giadaToJuceTempBuf(const mcl::AudioBuffer& outBuf)
+void PluginHost::giadaToJuceTempBuf(const mcl::AudioBuffer& outBuf, juce::AudioBuffer<float>& workBuf) const
 {
-	assert(outBuf.countChannels() == m_audioBuffer.getNumChannels());
+	assert(outBuf.countChannels() == workBuf.getNumChannels());
 
 	using namespace juce;
 	using Format = AudioData::Format<AudioData::Float32, AudioData::BigEndian>;
 
 	AudioData::deinterleaveSamples(
 	    AudioData::InterleavedSource<Format>{outBuf[0], outBuf.countChannels()},
-	    AudioData::NonInterleavedDest<Format>{m_audioBuffer.getArrayOfWritePointers(), m_audioBuffer.getNumChannels()},
+	    AudioData::NonInterleavedDest<Format>{workBuf.getArrayOfWritePointers(), workBuf.getNumChannels()},
 	    outBuf.countFrames());
 }
 
-void PluginHost::juceToGiadaOutBuf(mcl::AudioBuffer& outBuf) const
+void PluginHost::juceToGiadaOutBuf(mcl::AudioBuffer& outBuf, const juce::AudioBuffer<float>& workBuf) const
 {
-	assert(outBuf.countChannels() == m_audioBuffer.getNumChannels());
+	assert(outBuf.countChannels() == workBuf.getNumChannels());
 
 	using namespace juce;
 	using Format = AudioData::Format<AudioData::Float32, AudioData::BigEndian>;
 
 	AudioData::interleaveSamples(
-	    AudioData::NonInterleavedSource<Format>{m_audioBuffer.getArrayOfReadPointers(), m_audioBuffer.getNumChannels()},
+	    AudioData::NonInterleavedSource<Format>{workBuf.getArrayOfReadPointers(), workBuf.getNumChannels()},
 	    AudioData::InterleavedDest<Format>{outBuf[0], outBuf.countChannels()},
 	    outBuf.countFrames());
 }
 
 /* -------------------------------------------------------------------------- */
 
-void PluginHost::processPlugins(const std::vector<Plugin*>& plugins, juce::MidiBuffer& events)
+void PluginHost::processPlugins(const std::vector<Plugin*>& plugins, juce::MidiBuffer& events, juce::AudioBuffer<float>& workBuf) const
 {
 	for (Plugin* p : plugins)
 	{
 		if (!p->valid || p->isSuspended() || p->isBypassed())
 			continue;
-		processPlugin(p, events);
+		processPlugin(p, events, workBuf);
 	}
 	events.clear();
 }
 
 /* -------------------------------------------------------------------------- */
 
-void PluginHost::processPlugin(Plugin* p, const juce::MidiBuffer& events)
+void PluginHost::processPlugin(Plugin* p, const juce::MidiBuffer& events, juce::AudioBuffer<float>& workBuf) const
 {
-	const Plugin::Buffer& pluginBuffer = p->process(m_audioBuffer, events);
+	const Plugin::Buffer& pluginBuffer = p->process(workBuf, events);
 	const bool            isInstrument = p->isInstrument();
 
 	/* Merge the plugin buffer back into the local one. Special care is needed
 	if audio channels mismatch. */
 
-	for (int i = 0, j = 0; i < m_audioBuffer.getNumChannels(); i++)
+	for (int i = 0, j = 0; i < workBuf.getNumChannels(); i++)
 	{
 		/* If instrument (i.e. a plug-in that accepts MIDI and produces audio 
 		out of it), SUM the local working buffer to the main one. This allows
@@ -229,9 +249,9 @@ void PluginHost::processPlugin(Plugin* p, const juce::MidiBuffer& events)
 		working buffer is simply copied over the main one. */
 
 		if (isInstrument)
-			m_audioBuffer.addFrom(i, 0, pluginBuffer, j, 0, pluginBuffer.getNumSamples());
+			workBuf.addFrom(i, 0, pluginBuffer, j, 0, pluginBuffer.getNumSamples());
 		else
-			m_audioBuffer.copyFrom(i, 0, pluginBuffer, j, 0, pluginBuffer.getNumSamples());
+			workBuf.copyFrom(i, 0, pluginBuffer, j, 0, pluginBuffer.getNumSamples());
 		if (i < p->countMainOutChannels() - 1)
 			j++;
 	}
@@ -87,10 +87,18 @@ public:
 	const Plugin& addPlugin(std::unique_ptr<Plugin> p);
 
 	/* processStack
-	Applies the fx list to the buffer. */
+	Applies the fx list to the buffer. 'workBuf' is the JUCE buffer used for 
+	processing: pass one owned by the caller to process multiple stacks in 
+	parallel. If nullptr, the one of the Plugin Host is used. */
 
 	void processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
-	    juce::MidiBuffer* events = nullptr);
+	    juce::MidiBuffer* events = nullptr, juce::AudioBuffer<float>* workBuf = nullptr);
+
+	/* getTailFrames
+	Returns how long the fx list keeps producing sound after its input went
+	silent, i.e. the sum of the tails of the plug-ins that get processed. */
+
+	Frame getTailFrames(const std::vector<Plugin*>& plugins) const;
 
 	/* swapPlugin 
 	Swaps plug-in 1 with plug-in 2 in the plug-in vector. */
@@ -118,19 +126,19 @@ public:
 
 private:
 	/* giadaToJuceTempBuf
-	Copies the Giada buffer 'outBuf' to the private JUCE buffer for local
+	Copies the Giada buffer 'outBuf' to the JUCE buffer 'workBuf' for local
 	processing. */
 
-	void giadaToJuceTempBuf(const mcl::AudioBuffer& outBuf);
+	void giadaToJuceTempBuf(const mcl::AudioBuffer& outBuf, juce::AudioBuffer<float>& workBuf) const;
 
 	/* juceToGiadaOutBuf
-	Copies the private JUCE buffer to Giada buffer 'outBuf'. */
+	Copies the JUCE buffer 'workBuf' to Giada buffer 'outBuf'. */
 
-	void juceToGiadaOutBuf(mcl::AudioBuffer& outBuf) const;
+	void juceToGiadaOutBuf(mcl::AudioBuffer& outBuf, const juce::AudioBuffer<float>& workBuf) const;
 
-	void processPlugins(const std::vector<Plugin*>&, juce::MidiBuffer& events);
+	void processPlugins(const std::vector<Plugin*>&, juce::MidiBuffer& events, juce::AudioBuffer<float>& workBuf) const;
 
-	void processPlugin(Plugin*, const juce::MidiBuffer& events);
+	void processPlugin(Plugin*, const juce::MidiBuffer& events, juce::AudioBuffer<float>& workBuf) const;
 
 	model::Model& m_model;
 
@@ -0,0 +1,187 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/profiler.h"
+#include <algorithm>
+
+namespace giada::m
+{
+Profiler::Profiler()
+: m_enabled(false)
+, m_droppedSamples(0)
+, m_worker(G_PROFILER_RATE_MS)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+Profiler::Time Profiler::now()
+{
+	return Clock::now();
+}
+
+std::int64_t Profiler::elapsed(Time start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+std::int64_t Profiler::toNanoseconds(Time t)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+/* -------------------------------------------------------------------------- */
+
+const char* Profiler::getName(Stage stage)
+{
+	switch (stage)
+	{
+	case Stage::CALLBACK:
+		return "callback";
+	case Stage::JACK_SYNC:
+		return "jack_sync";
+	case Stage::SEQUENCER:
+		return "sequencer";
+	case Stage::ADVANCE_CHANNELS:
+		return "advance_channels";
+	case Stage::RENDER_CHANNELS:
+		return "render_channels";
+	case Stage::CHANNEL:
+		return "channel";
+	case Stage::CHANNEL_PLUGINS:
+		return "channel_plugins";
+	case Stage::MASTER_OUT:
+		return "master_out";
+	case Stage::FINALIZE:
+		return "finalize";
+	default:
+		return "(unknown)";
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int Profiler::countDroppedSamples() const
+{
+	return m_droppedSamples.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Profiler::start()
+{
+	m_worker.start([this]() {
+		std::scoped_lock lock(m_mutex);
+		collect();
+	});
+}
+
+void Profiler::stop()
+{
+	m_worker.stop();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Profiler::setEnabled(bool v)
+{
+	if (v)
+	{
+		/* Start from scratch: forget anything from a previous session, including
+		samples still pending in the queue. */
+
+		std::scoped_lock lock(m_mutex);
+		Sample           s;
+		while (m_queue.pop(s))
+			;
+		m_windows.clear();
+		m_droppedSamples.store(0);
+	}
+	m_enabled.store(v);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Profiler::push_RT(Stage stage, std::int64_t ns, ID channelId) const
+{
+	if (!m_queue.push({stage, channelId, ns}))
+		m_droppedSamples.fetch_add(1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Profiler::collect()
+{
+	Sample s;
+	while (m_queue.pop(s))
+	{
+		Window& w = m_windows[{s.stage, s.channelId}];
+		if (w.samples.size() < G_PROFILER_WINDOW)
+			w.samples.push_back(s.ns);
+		else
+			w.samples[w.next] = s.ns;
+		w.next = (w.next + 1) % G_PROFILER_WINDOW;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::vector<Profiler::Stats> Profiler::getStats()
+{
+	std::scoped_lock lock(m_mutex);
+
+	collect();
+
+	std::vector<Stats>        out;
+	std::vector<std::int64_t> sorted;
+
+	for (const auto& [key, w] : m_windows)
+	{
+		sorted = w.samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		std::int64_t sum = 0;
+		for (std::int64_t ns : sorted)
+			sum += ns;
+
+		const std::size_t count = sorted.size();
+		const std::size_t p99   = (count * 99 + 99) / 100 - 1; // Nearest rank
+
+		out.push_back({
+		    key.first,
+		    key.second,
+		    static_cast<int>(count),
+		    sorted.front() / 1000.0f,
+		    sum / static_cast<float>(count) / 1000.0f,
+		    sorted[p99] / 1000.0f,
+		    sorted.back() / 1000.0f,
+		});
+	}
+
+	return out;
+}
+} // namespace giada::m
@@ -0,0 +1,205 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_PROFILER_H
+#define G_PROFILER_H
+
+#include "core/const.h"
+#include "core/queue.h"
+#include "core/types.h"
+#include "core/worker.h"
+#include "utils/trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace giada::m
+{
+/* Profiler
+Collects timings of the rendering stages, as measured by the audio thread. The
+audio thread pushes raw samples into a lock-free queue, a worker thread drains
+it and keeps a window of the latest samples for each stage and channel, from 
+which statistics are computed on request. When disabled, the cost on the audio
+thread is a single branch per measured stage. */
+
+class Profiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using Time  = Clock::time_point;
+
+	enum class Stage : int
+	{
+		CALLBACK = 0,     // The whole audio callback
+		JACK_SYNC,        // JACK transport sync
+		SEQUENCER,        // Sequencer::advance() plus metronome
+		ADVANCE_CHANNELS, // Mixer::advanceChannels()
+		RENDER_CHANNELS,  // All channels, rendered and mixed
+		CHANNEL,          // A single channel, plug-ins included
+		CHANNEL_PLUGINS,  // The plug-in stack of a single channel
+		MASTER_OUT,       // Master out channel and its plug-ins
+		FINALIZE          // Mixer::finalizeOutput()
+	};
+
+	/* Stats
+	Timings of a stage in microseconds, over the latest G_PROFILER_WINDOW
+	samples. 'channelId' is 0 for stages not related to a channel. */
+
+	struct Stats
+	{
+		Stage stage;
+		ID    channelId;
+		int   count;
+		float min;
+		float mean;
+		float p99;
+		float max;
+	};
+
+	/* Scope
+	Measures the time spent in a C++ scope, for the profiler and for the trace
+	timeline (see u::trace). Does nothing but a branch if both are disabled: 
+	defined inline for this reason. */
+
+	class Scope
+	{
+	public:
+		Scope(const Profiler& p, Stage s)
+		: m_profiler(p.isEnabled() ? &p : nullptr)
+		, m_trace(u::trace::isEnabled())
+		, m_stage(s)
+		{
+			if (m_profiler != nullptr || m_trace)
+				m_start = now();
+		}
+
+		~Scope()
+		{
+			if (m_profiler == nullptr && !m_trace)
+				return;
+			const std::int64_t ns = elapsed(m_start);
+			if (m_profiler != nullptr)
+				m_profiler->push_RT(m_stage, ns);
+			if (m_trace)
+				u::trace::push(getName(m_stage), toNanoseconds(m_start), ns);
+		}
+
+	private:
+		const Profiler* m_profiler;
+		bool            m_trace;
+		Stage           m_stage;
+		Time            m_start;
+	};
+
+	Profiler();
+
+	/* now, elapsed
+	Time helpers for measuring stages by hand. elapsed() returns nanoseconds. */
+
+	static Time         now();
+	static std::int64_t elapsed(Time start);
+	static std::int64_t toNanoseconds(Time);
+
+	/* getName
+	Returns the name of a stage, e.g. "render_channels". Realtime-safe. */
+
+	static const char* getName(Stage);
+
+	/* isEnabled
+	Tells whether profiling is active. Realtime-safe. */
+
+	bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+	/* start, stop
+	Starts/stops the worker thread that collects samples from the audio 
+	thread. */
+
+	void start();
+	void stop();
+
+	/* setEnabled
+	Turns profiling on or off. Statistics are cleared when turning it on. */
+
+	void setEnabled(bool);
+
+	/* push_RT
+	Records a sample of 'ns' nanoseconds for the given stage. Realtime-safe,
+	single producer (the audio thread). Samples are dropped if the queue is 
+	full. */
+
+	void push_RT(Stage, std::int64_t ns, ID channelId = 0) const;
+
+	/* getStats
+	Returns statistics for all stages and channels seen so far, sorted by stage
+	and channel. */
+
+	std::vector<Stats> getStats();
+
+	/* countDroppedSamples
+	Returns the number of samples lost because the queue was full. */
+
+	int countDroppedSamples() const;
+
+private:
+	struct Sample
+	{
+		Stage        stage     = Stage::CALLBACK;
+		ID           channelId = 0;
+		std::int64_t ns        = 0;
+	};
+
+	/* Window
+	Circular buffer of the latest samples of a stage, in nanoseconds. */
+
+	struct Window
+	{
+		std::vector<std::int64_t> samples;
+		std::size_t               next = 0;
+	};
+
+	/* collect
+	Moves pending samples from the queue to the windows. Must be called with
+	m_mutex locked: this is what makes the queue single consumer. */
+
+	void collect();
+
+	std::atomic<bool>        m_enabled;
+	mutable std::atomic<int> m_droppedSamples;
+
+	mutable Queue<Sample, G_MAX_PROFILER_SAMPLES> m_queue;
+
+	Worker                                 m_worker;
+	std::mutex                             m_mutex;
+	std::map<std::pair<Stage, ID>, Window> m_windows;
+};
+} // namespace giada::m
+
+#endif
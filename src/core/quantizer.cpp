@@ -25,6 +25,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "quantizer.h"
+#include "utils/math.h"
 #include <cassert>
 
 namespace giada::m
@@ -56,16 +57,15 @@ void Quantizer::advance(Range<Frame> block, Frame quantizerStep) const
 
 	assert(m_callbacks.count(pid) > 0);
 
-	for (Frame global = block.getBegin(), local = 0; global < block.getEnd(); global++, local++)
-	{
+	/* Jump straight to the first quantization unit in the block, if any. */
 
-		if (global % quantizerStep != 0) // Skip if it's not on a quantization unit.
-			continue;
+	const Frame global = u::math::nextMultiple(block.getBegin(), quantizerStep);
 
-		m_callbacks.at(pid)(local);
-		m_performId.store(-1);
+	if (global >= block.getEnd())
 		return;
-	}
+
+	m_callbacks.at(pid)(global - block.getBegin());
+	m_performId.store(-1);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -51,6 +51,11 @@ public:
 	Queue& operator=(const Queue&) = delete;
 	Queue& operator=(Queue&&) = delete;
 
+	bool isEmpty() const
+	{
+		return m_head.load() == m_tail.load();
+	}
+
 	bool pop(T& item)
 	{
 		std::size_t curr = m_head.load();
@@ -0,0 +1,262 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/renderPool.h"
+#include "core/const.h"
+#include "core/rtCheck.h"
+#include "utils/log.h"
+#include "utils/trace.h"
+#include <cassert>
+#if defined(G_OS_WINDOWS)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace giada::m
+{
+namespace
+{
+/* pause_
+Tells the CPU this is a spin-wait loop: saves power and lets the sibling 
+hyper-thread, which might be the one being waited for, run faster. */
+
+void pause_()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	asm volatile("yield");
+#endif
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+RenderPool::Priority RenderPool::getThreadPriority()
+{
+#if defined(G_OS_WINDOWS)
+	return {0, GetThreadPriority(GetCurrentThread())};
+#else
+	int         policy;
+	sched_param param;
+	if (pthread_getschedparam(pthread_self(), &policy, &param) != 0)
+		return {};
+	return {policy, param.sched_priority};
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+RenderPool::RenderPool()
+: m_running(false)
+, m_wakeUp(0)
+, m_cursor(0)
+, m_done(0)
+, m_count(0)
+, m_context(nullptr)
+, m_task(nullptr)
+, m_policy(0)
+, m_priority(0)
+, m_priorityVersion(0)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+RenderPool::~RenderPool()
+{
+	stop();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::start(int numThreads)
+{
+	stop();
+
+	if (numThreads <= 0)
+		return;
+
+	m_running.store(true);
+	for (int i = 0; i < numThreads; i++)
+		m_threads.emplace_back([this, i]() { threadLoop(i); });
+
+	u::log::print("[RenderPool::start] %d render threads started\n", numThreads);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::stop()
+{
+	if (m_threads.empty())
+		return;
+
+	/* Wake up all sleeping threads, which will then notice the 'running' flag
+	and quit. */
+
+	m_running.store(false);
+	m_wakeUp.release(static_cast<std::ptrdiff_t>(m_threads.size()));
+
+	for (std::thread& t : m_threads)
+		t.join();
+	m_threads.clear();
+
+	while (m_wakeUp.try_acquire()) // Wake-ups left by batches nobody waited for
+		;
+
+	u::log::print("[RenderPool::stop] render threads stopped\n");
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderPool::isEnabled() const
+{
+	return !m_threads.empty();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::setPriority(Priority p) const
+{
+	m_policy.store(p.policy, std::memory_order_relaxed);
+	m_priority.store(p.value, std::memory_order_relaxed);
+	m_priorityVersion.fetch_add(1, std::memory_order_release);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::publish_RT(int count) const
+{
+	assert(m_task != nullptr);
+
+	const std::uint64_t generation = (m_cursor.load(std::memory_order_relaxed) >> GENERATION_SHIFT) + 1;
+
+	m_count.store(count, std::memory_order_relaxed);
+	m_done.store(0, std::memory_order_relaxed);
+	m_cursor.store(generation << GENERATION_SHIFT, std::memory_order_release);
+
+	if (isEnabled())
+		m_wakeUp.release(static_cast<std::ptrdiff_t>(m_threads.size()));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::wait_RT() const
+{
+	process(m_cursor.load(std::memory_order_relaxed) >> GENERATION_SHIFT);
+
+	/* All jobs have been claimed at this point. Just spin until helper threads
+	are done with the ones they own: it's a matter of a single job duration. If
+	it takes longer, a helper might have been preempted, maybe on this very CPU:
+	give it a chance to run. */
+
+	const int count = m_count.load(std::memory_order_relaxed);
+	for (int spins = 0; m_done.load(std::memory_order_acquire) < count; spins++)
+	{
+		if (spins < MAX_SPINS)
+			pause_();
+		else
+			std::this_thread::yield();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+int RenderPool::adoptPriority(int version) const
+{
+	const int current = m_priorityVersion.load(std::memory_order_acquire);
+	if (current == version)
+		return version;
+
+#if defined(G_OS_WINDOWS)
+	const bool ok = SetThreadPriority(GetCurrentThread(), m_priority.load(std::memory_order_relaxed)) != 0;
+#else
+	sched_param param{};
+	param.sched_priority = m_priority.load(std::memory_order_relaxed);
+	const bool ok        = pthread_setschedparam(pthread_self(), m_policy.load(std::memory_order_relaxed), &param) == 0;
+#endif
+	if (!ok)
+		u::log::print("[RenderPool::adoptPriority] Unable to set render thread priority\n");
+	return current;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::process(std::uint64_t generation) const
+{
+	while (true)
+	{
+		std::uint64_t cursor = m_cursor.load(std::memory_order_acquire);
+
+		if ((cursor >> GENERATION_SHIFT) != generation)
+			return;
+
+		const int index = static_cast<int>(cursor & INDEX_MASK);
+		if (index >= m_count.load(std::memory_order_relaxed))
+			return;
+
+		if (!m_cursor.compare_exchange_weak(cursor, cursor + 1, std::memory_order_acq_rel))
+			continue;
+
+		/* Job claimed: the batch can't complete until this job is done, so
+		task and context are guaranteed to be valid here. */
+
+		{
+			const rtCheck::Scope rtCheckScope;
+			m_task(m_context, index);
+		}
+		m_done.fetch_add(1, std::memory_order_release);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::threadLoop(int index) const
+{
+	u::trace::setThread(Thread::RENDER, index + 1);
+
+	int priorityVersion = 0;
+
+	/* A wake-up might belong to a batch already completed by other threads: 
+	process() just finds no jobs left in that case. */
+
+	while (true)
+	{
+		m_wakeUp.acquire();
+		if (!m_running.load())
+			return;
+		priorityVersion = adoptPriority(priorityVersion);
+		process(m_cursor.load(std::memory_order_acquire) >> GENERATION_SHIFT);
+	}
+}
+} // namespace giada::m
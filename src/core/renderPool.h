@@ -0,0 +1,170 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_RENDER_POOL_H
+#define G_RENDER_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace giada::m
+{
+/* RenderPool
+Fixed set of pre-spawned threads that helps the audio thread in processing
+independent jobs (e.g. channels) within a single audio block. Jobs are handed
+over through atomics only: no locks and no memory allocation take place in the
+realtime methods. The calling thread takes part in the processing as well. 
+Helper threads run with the same scheduling priority of the calling thread (see
+setPriority()), so that they are not preempted by anything it wouldn't be 
+preempted by. */
+
+class RenderPool
+{
+public:
+	/* Priority
+	Scheduling policy and priority of a thread. */
+
+	struct Priority
+	{
+		int policy = 0;
+		int value  = 0;
+	};
+
+	/* getThreadPriority
+	Returns the scheduling priority of the calling thread. Non-realtime: it 
+	might be a system call. */
+
+	static Priority getThreadPriority();
+
+	RenderPool();
+	RenderPool(const RenderPool&) = delete;
+	RenderPool& operator=(const RenderPool&) = delete;
+	~RenderPool();
+
+	/* start
+	Spawns 'numThreads' helper threads. Passing 0 leaves the pool disabled: all
+	jobs will be processed serially by the calling thread. Non-realtime. */
+
+	void start(int numThreads);
+
+	/* stop
+	Stops and joins all helper threads. Non-realtime. */
+
+	void stop();
+
+	/* isEnabled
+	True if there is at least one helper thread running. */
+
+	bool isEnabled() const;
+
+	/* setPriority
+	Makes helper threads adopt priority 'p' before processing the next batch.
+	Call it whenever the thread that dispatches jobs changes (audio stream 
+	started, offline rendering started or ended). Lock-free. */
+
+	void setPriority(Priority p) const;
+
+	/* dispatch_RT
+	Publishes a new batch of 'count' jobs to the helper threads. 'f' is a
+	callable taking the job index and must stay alive until wait_RT() returns.
+	Only one batch at a time can be in flight. */
+
+	template <typename F>
+	void dispatch_RT(int count, const F& f) const
+	{
+		m_context = &f;
+		m_task    = [](const void* ctx, int index) { (*static_cast<const F*>(ctx))(index); };
+		publish_RT(count);
+	}
+
+	/* wait_RT
+	Processes remaining jobs of the current batch on the calling thread, then
+	waits for the helper threads to finish theirs. Spins for a while, then 
+	yields the CPU in case a helper thread is waiting for it. */
+
+	void wait_RT() const;
+
+private:
+	/* Cursor layout: upper 32 bits hold the batch generation, lower 32 bits the
+	next job index to be claimed. Packing both in a single atomic prevents a
+	late helper thread from claiming a job that belongs to a newer batch. */
+
+	static constexpr int           GENERATION_SHIFT = 32;
+	static constexpr std::uint64_t INDEX_MASK       = 0xFFFFFFFF;
+
+	/* MAX_SPINS
+	How many times wait_RT() polls the helper threads before falling back to
+	yielding. */
+
+	static constexpr int MAX_SPINS = 4096;
+
+	void publish_RT(int count) const;
+
+	/* adoptPriority
+	Applies the published scheduling priority to the current helper thread, if
+	changed since 'version'. Returns the version applied. */
+
+	int adoptPriority(int version) const;
+
+	/* process
+	Claims and runs jobs belonging to 'generation' until there are none left. */
+
+	void process(std::uint64_t generation) const;
+
+	/* threadLoop
+	Body of the helper thread number 'index'. */
+
+	void threadLoop(int index) const;
+
+	std::vector<std::thread> m_threads;
+	std::atomic<bool>        m_running;
+
+	/* m_wakeUp
+	Helper threads sleep here between batches. Released once per helper thread
+	by each new batch. */
+
+	mutable std::counting_semaphore<> m_wakeUp;
+
+	mutable std::atomic<std::uint64_t> m_cursor;
+	mutable std::atomic<int>           m_done;
+	mutable std::atomic<int>           m_count;
+	mutable const void*                m_context;
+	mutable void (*m_task)(const void*, int);
+
+	/* m_policy, m_priority, m_priorityVersion
+	Scheduling policy and priority of the thread that dispatches jobs, 
+	published by bumping 'm_priorityVersion'. */
+
+	mutable std::atomic<int> m_policy;
+	mutable std::atomic<int> m_priority;
+	mutable std::atomic<int> m_priorityVersion;
+};
+} // namespace giada::m
+
+#endif
@@ -0,0 +1,626 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_RT_CHECK
+
+/* Fortified builds turn some of the hooked functions (read, open, fprintf, ...)
+into inline wrappers, which can't be redefined. */
+
+#undef _FORTIFY_SOURCE
+
+#include "core/rtCheck.h"
+#include "core/plugins/plugin.h"
+#include "utils/log.h"
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace giada::m::rtCheck
+{
+namespace
+{
+constexpr int MAX_FRAMES     = 32;
+constexpr int MAX_CALL_SITES = 1024;
+constexpr int SKIP_FRAMES    = 2; // check_() and the hook itself
+
+/* depth_, plugin_, busy_
+Per-thread state: how many Scopes are open, which plug-in is running, and
+whether the detector itself is at work (hooks must pass through then, as 
+reporting does allocate and write). */
+
+thread_local int           depth_  = 0;
+thread_local const Plugin* plugin_ = nullptr;
+thread_local bool          busy_   = false;
+
+std::atomic<bool> enabled_          = false;
+std::atomic<bool> abort_            = false;
+std::atomic<int>  violations_       = 0;
+std::atomic<int>  pluginViolations_ = 0;
+
+/* callSites_
+Hashes of the stack traces reported so far, so that each call site is 
+reported once. Open addressing, lock-free. */
+
+std::array<std::atomic<std::uint64_t>, MAX_CALL_SITES> callSites_ = {};
+
+/* -------------------------------------------------------------------------- */
+
+std::uint64_t hash_(void* const* frames, int count)
+{
+	std::uint64_t h = 14695981039346656037ull; // FNV-1a
+	for (int i = 0; i < count; i++)
+	{
+		h ^= reinterpret_cast<std::uintptr_t>(frames[i]);
+		h *= 1099511628211ull;
+	}
+	return h == 0 ? 1 : h;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* isNewCallSite_
+Returns true if the call site has never been seen before, and remembers it. 
+When the table is full all call sites are considered known. */
+
+bool isNewCallSite_(std::uint64_t h)
+{
+	for (int i = 0; i < MAX_CALL_SITES; i++)
+	{
+		std::atomic<std::uint64_t>& slot = callSites_[(h + i) % MAX_CALL_SITES];
+		std::uint64_t               curr = slot.load();
+		if (curr == h)
+			return false;
+		if (curr == 0 && slot.compare_exchange_strong(curr, h))
+			return true;
+		if (curr == h)
+			return false;
+	}
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void report_(const char* what)
+{
+	violations_.fetch_add(1);
+	if (plugin_ != nullptr)
+		pluginViolations_.fetch_add(1);
+
+	void*     frames[MAX_FRAMES];
+	const int count = backtrace(frames, MAX_FRAMES);
+
+	if (!isNewCallSite_(hash_(frames + SKIP_FRAMES, count - SKIP_FRAMES)))
+		return;
+
+	if (plugin_ != nullptr)
+		std::fprintf(stderr, "[rtCheck] Realtime violation: %s, in plug-in '%s' (ID=%d)\n",
+		    what, plugin_->getName().c_str(), static_cast<int>(plugin_->id));
+	else
+		std::fprintf(stderr, "[rtCheck] Realtime violation: %s\n", what);
+	std::fflush(stderr);
+	backtrace_symbols_fd(frames + SKIP_FRAMES, count - SKIP_FRAMES, STDERR_FILENO);
+
+	if (abort_.load())
+		std::abort();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* check_
+Called by every hook. Reports a violation if the calling thread is running 
+realtime code. */
+
+inline void check_(const char* what)
+{
+	if (depth_ == 0 || busy_ || !enabled_.load(std::memory_order_relaxed))
+		return;
+	busy_ = true;
+	report_(what);
+	busy_ = false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* next_
+Returns the next definition of a hooked function, i.e. the one from libc. 
+Resolved lazily and cached. dlsym() may allocate, but only through the malloc
+hooks below, which don't depend on it. */
+
+template <typename F>
+F next_(std::atomic<void*>& cache, const char* name)
+{
+	void* f = cache.load(std::memory_order_relaxed);
+	if (f == nullptr)
+	{
+		f = dlsym(RTLD_NEXT, name);
+		cache.store(f, std::memory_order_relaxed);
+	}
+	return reinterpret_cast<F>(f);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* openMode_
+Returns the optional 'mode' argument of open() and friends, which is only 
+there when a file may be created. */
+
+mode_t openMode_(int flags, va_list args)
+{
+	if ((flags & O_CREAT) == 0 && (flags & O_TMPFILE) != O_TMPFILE)
+		return 0;
+	return va_arg(args, mode_t);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void init()
+{
+	/* Warm up backtrace(): its first call loads libgcc, which allocates. */
+
+	void* frames[1];
+	backtrace(frames, 1);
+
+	const char* mode = std::getenv("GIADA_RT_CHECK");
+	abort_.store(mode != nullptr && std::strcmp(mode, "abort") == 0);
+	enabled_.store(true);
+
+	u::log::print("[rtCheck::init] Realtime-safety checks enabled%s\n", abort_.load() ? ", abort on violation" : "");
+}
+
+/* -------------------------------------------------------------------------- */
+
+void close()
+{
+	enabled_.store(false);
+	u::log::print("[rtCheck::close] %d realtime violations, %d in plug-ins\n",
+	    violations_.load(), pluginViolations_.load());
+}
+
+/* -------------------------------------------------------------------------- */
+
+int countViolations()
+{
+	return violations_.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool getAbort()
+{
+	return abort_.load();
+}
+
+void setAbort(bool v)
+{
+	abort_.store(v);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Scope::Scope() { depth_++; }
+Scope::~Scope() { depth_--; }
+
+/* -------------------------------------------------------------------------- */
+
+PluginScope::PluginScope(const Plugin& p)
+: m_prev(plugin_)
+{
+	plugin_ = &p;
+}
+
+PluginScope::~PluginScope()
+{
+	plugin_ = m_prev;
+}
+} // namespace giada::m::rtCheck
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+/* Hooks
+Definitions here take precedence over the libc ones, for the executable and
+all shared libraries loaded by it (plug-ins included). Memory functions call
+glibc's internal entry points, the others are looked up with dlsym(). */
+
+using giada::m::rtCheck::check_;
+using giada::m::rtCheck::next_;
+using giada::m::rtCheck::openMode_;
+
+extern "C"
+{
+	void* __libc_malloc(std::size_t);
+	void* __libc_calloc(std::size_t, std::size_t);
+	void* __libc_realloc(void*, std::size_t);
+	void* __libc_memalign(std::size_t, std::size_t);
+	void  __libc_free(void*);
+
+	void* malloc(std::size_t size) noexcept
+	{
+		check_("malloc");
+		return __libc_malloc(size);
+	}
+
+	void* calloc(std::size_t count, std::size_t size) noexcept
+	{
+		check_("calloc");
+		return __libc_calloc(count, size);
+	}
+
+	void* realloc(void* p, std::size_t size) noexcept
+	{
+		check_("realloc");
+		return __libc_realloc(p, size);
+	}
+
+	void* memalign(std::size_t alignment, std::size_t size) noexcept
+	{
+		check_("memalign");
+		return __libc_memalign(alignment, size);
+	}
+
+	void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+	{
+		check_("aligned_alloc");
+		return __libc_memalign(alignment, size);
+	}
+
+	int posix_memalign(void** out, std::size_t alignment, std::size_t size) noexcept
+	{
+		check_("posix_memalign");
+		void* p = __libc_memalign(alignment, size);
+		if (p == nullptr)
+			return ENOMEM;
+		*out = p;
+		return 0;
+	}
+
+	void free(void* p) noexcept
+	{
+		if (p != nullptr)
+			check_("free");
+		__libc_free(p);
+	}
+
+	int pthread_mutex_lock(pthread_mutex_t* m) noexcept
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("pthread_mutex_lock");
+		return next_<int (*)(pthread_mutex_t*)>(f, "pthread_mutex_lock")(m);
+	}
+
+	int pthread_rwlock_rdlock(pthread_rwlock_t* l) noexcept
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("pthread_rwlock_rdlock");
+		return next_<int (*)(pthread_rwlock_t*)>(f, "pthread_rwlock_rdlock")(l);
+	}
+
+	int pthread_rwlock_wrlock(pthread_rwlock_t* l) noexcept
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("pthread_rwlock_wrlock");
+		return next_<int (*)(pthread_rwlock_t*)>(f, "pthread_rwlock_wrlock")(l);
+	}
+
+	int pthread_cond_wait(pthread_cond_t* c, pthread_mutex_t* m)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("pthread_cond_wait");
+		return next_<int (*)(pthread_cond_t*, pthread_mutex_t*)>(f, "pthread_cond_wait")(c, m);
+	}
+
+	int pthread_cond_timedwait(pthread_cond_t* c, pthread_mutex_t* m, const struct timespec* t)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("pthread_cond_timedwait");
+		return next_<int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*)>(f, "pthread_cond_timedwait")(c, m, t);
+	}
+
+	int pthread_cond_clockwait(pthread_cond_t* c, pthread_mutex_t* m, clockid_t clock, const struct timespec* t)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("pthread_cond_clockwait");
+		return next_<int (*)(pthread_cond_t*, pthread_mutex_t*, clockid_t, const struct timespec*)>(f, "pthread_cond_clockwait")(c, m, clock, t);
+	}
+
+	int pthread_mutex_timedlock(pthread_mutex_t* m, const struct timespec* t) noexcept
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("pthread_mutex_timedlock");
+		return next_<int (*)(pthread_mutex_t*, const struct timespec*)>(f, "pthread_mutex_timedlock")(m, t);
+	}
+
+	int pthread_mutex_clocklock(pthread_mutex_t* m, clockid_t clock, const struct timespec* t) noexcept
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("pthread_mutex_clocklock");
+		return next_<int (*)(pthread_mutex_t*, clockid_t, const struct timespec*)>(f, "pthread_mutex_clocklock")(m, clock, t);
+	}
+
+	int sem_wait(sem_t* s)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("sem_wait");
+		return next_<int (*)(sem_t*)>(f, "sem_wait")(s);
+	}
+
+	int sem_timedwait(sem_t* s, const struct timespec* t)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("sem_timedwait");
+		return next_<int (*)(sem_t*, const struct timespec*)>(f, "sem_timedwait")(s, t);
+	}
+
+	int sem_clockwait(sem_t* s, clockid_t clock, const struct timespec* t)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("sem_clockwait");
+		return next_<int (*)(sem_t*, clockid_t, const struct timespec*)>(f, "sem_clockwait")(s, clock, t);
+	}
+
+	/* syscall
+	Catches futex waits, i.e. std::atomic::wait(), std::counting_semaphore and
+	friends, which the C++ library performs with raw system calls. Wakes are 
+	fine. All system calls take up to six register-sized arguments. */
+
+	long syscall(long number, ...) noexcept
+	{
+		static std::atomic<void*> f = nullptr;
+
+		va_list args;
+		va_start(args, number);
+		long a[6];
+		for (long& arg : a)
+			arg = va_arg(args, long);
+		va_end(args);
+
+		if (number == SYS_futex)
+		{
+			const int op = static_cast<int>(a[1]) & FUTEX_CMD_MASK;
+			if (op == FUTEX_WAIT || op == FUTEX_WAIT_BITSET || op == FUTEX_LOCK_PI)
+				check_("futex wait");
+		}
+		return next_<long (*)(long, ...)>(f, "syscall")(number, a[0], a[1], a[2], a[3], a[4], a[5]);
+	}
+
+	int nanosleep(const struct timespec* req, struct timespec* rem)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("nanosleep");
+		return next_<int (*)(const struct timespec*, struct timespec*)>(f, "nanosleep")(req, rem);
+	}
+
+	int clock_nanosleep(clockid_t clock, int flags, const struct timespec* req, struct timespec* rem)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("clock_nanosleep");
+		return next_<int (*)(clockid_t, int, const struct timespec*, struct timespec*)>(f, "clock_nanosleep")(clock, flags, req, rem);
+	}
+
+	int usleep(useconds_t usec)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("usleep");
+		return next_<int (*)(useconds_t)>(f, "usleep")(usec);
+	}
+
+	int poll(struct pollfd* fds, nfds_t count, int timeout)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("poll");
+		return next_<int (*)(struct pollfd*, nfds_t, int)>(f, "poll")(fds, count, timeout);
+	}
+
+	int select(int n, fd_set* r, fd_set* w, fd_set* e, struct timeval* t)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("select");
+		return next_<int (*)(int, fd_set*, fd_set*, fd_set*, struct timeval*)>(f, "select")(n, r, w, e, t);
+	}
+
+	ssize_t read(int fd, void* buf, std::size_t count)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("read");
+		return next_<ssize_t (*)(int, void*, std::size_t)>(f, "read")(fd, buf, count);
+	}
+
+	ssize_t write(int fd, const void* buf, std::size_t count)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("write");
+		return next_<ssize_t (*)(int, const void*, std::size_t)>(f, "write")(fd, buf, count);
+	}
+
+	int open(const char* path, int flags, ...)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("open");
+
+		va_list args;
+		va_start(args, flags);
+		const mode_t mode = openMode_(flags, args);
+		va_end(args);
+		return next_<int (*)(const char*, int, ...)>(f, "open")(path, flags, mode);
+	}
+
+	int open64(const char* path, int flags, ...)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("open64");
+
+		va_list args;
+		va_start(args, flags);
+		const mode_t mode = openMode_(flags, args);
+		va_end(args);
+		return next_<int (*)(const char*, int, ...)>(f, "open64")(path, flags, mode);
+	}
+
+	int openat(int dir, const char* path, int flags, ...)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("openat");
+
+		va_list args;
+		va_start(args, flags);
+		const mode_t mode = openMode_(flags, args);
+		va_end(args);
+		return next_<int (*)(int, const char*, int, ...)>(f, "openat")(dir, path, flags, mode);
+	}
+
+	FILE* fopen(const char* path, const char* mode)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("fopen");
+		return next_<FILE* (*)(const char*, const char*)>(f, "fopen")(path, mode);
+	}
+
+	/* stdio
+	Printing may lock the stream, allocate its buffer and write to the file. 
+	std::cout and std::cerr end up in fwrite() and putc(). The __*_chk variants
+	are the ones called by fortified code. */
+
+	int vfprintf(FILE* stream, const char* format, va_list args)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("vfprintf");
+		return next_<int (*)(FILE*, const char*, va_list)>(f, "vfprintf")(stream, format, args);
+	}
+
+	int fprintf(FILE* stream, const char* format, ...)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("fprintf");
+
+		va_list args;
+		va_start(args, format);
+		const int res = next_<int (*)(FILE*, const char*, va_list)>(f, "vfprintf")(stream, format, args);
+		va_end(args);
+		return res;
+	}
+
+	int printf(const char* format, ...)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("printf");
+
+		va_list args;
+		va_start(args, format);
+		const int res = next_<int (*)(FILE*, const char*, va_list)>(f, "vfprintf")(stdout, format, args);
+		va_end(args);
+		return res;
+	}
+
+	int __fprintf_chk(FILE* stream, int flag, const char* format, ...)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("fprintf");
+
+		va_list args;
+		va_start(args, format);
+		const int res = next_<int (*)(FILE*, int, const char*, va_list)>(f, "__vfprintf_chk")(stream, flag, format, args);
+		va_end(args);
+		return res;
+	}
+
+	int __printf_chk(int flag, const char* format, ...)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("printf");
+
+		va_list args;
+		va_start(args, format);
+		const int res = next_<int (*)(FILE*, int, const char*, va_list)>(f, "__vfprintf_chk")(stdout, flag, format, args);
+		va_end(args);
+		return res;
+	}
+
+	int fputs(const char* str, FILE* stream)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("fputs");
+		return next_<int (*)(const char*, FILE*)>(f, "fputs")(str, stream);
+	}
+
+	int puts(const char* str)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("puts");
+		return next_<int (*)(const char*)>(f, "puts")(str);
+	}
+
+	int fputc(int c, FILE* stream)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("fputc");
+		return next_<int (*)(int, FILE*)>(f, "fputc")(c, stream);
+	}
+
+	int putc(int c, FILE* stream)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("putc");
+		return next_<int (*)(int, FILE*)>(f, "putc")(c, stream);
+	}
+
+	std::size_t fwrite(const void* buf, std::size_t size, std::size_t count, FILE* stream)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("fwrite");
+		return next_<std::size_t (*)(const void*, std::size_t, std::size_t, FILE*)>(f, "fwrite")(buf, size, count, stream);
+	}
+
+	int fflush(FILE* stream)
+	{
+		static std::atomic<void*> f = nullptr;
+		check_("fflush");
+		return next_<int (*)(FILE*)>(f, "fflush")(stream);
+	}
+}
+
+#endif
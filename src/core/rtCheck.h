@@ -0,0 +1,112 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_RT_CHECK_H
+#define G_RT_CHECK_H
+
+/* giada::m::rtCheck
+Realtime-safety violation detector, for debugging and CI. When built with 
+WITH_RT_CHECK (Linux only), memory allocations, mutex locks, waits on 
+condition variables, semaphores and futexes (std::atomic::wait), sleeps, file
+I/O and stdio printing performed by a thread while inside a rtCheck::Scope are
+reported to stderr with a stack trace, once per call site. Violations inside a 
+PluginScope are attributed to the plug-in. Set the GIADA_RT_CHECK=abort 
+environment variable to abort on the first violation. Without WITH_RT_CHECK
+everything here compiles to nothing. */
+
+namespace giada::m
+{
+class Plugin;
+}
+
+namespace giada::m::rtCheck
+{
+#ifdef WITH_RT_CHECK
+
+void init();
+void close();
+
+/* countViolations
+Returns the number of violations detected so far, duplicates included. */
+
+int countViolations();
+
+/* getAbort, setAbort
+Whether the process aborts on the first violation. Initialized by init() from
+the GIADA_RT_CHECK environment variable. */
+
+bool getAbort();
+void setAbort(bool);
+
+/* Scope
+Marks the calling thread as running realtime code until the end of the scope.
+Nestable. */
+
+class Scope
+{
+public:
+	Scope();
+	~Scope();
+};
+
+/* PluginScope
+Attributes violations to the given plug-in until the end of the scope. */
+
+class PluginScope
+{
+public:
+	PluginScope(const Plugin&);
+	~PluginScope();
+
+private:
+	const Plugin* m_prev;
+};
+
+#else
+
+inline void init() {}
+inline void close() {}
+inline int  countViolations() { return 0; }
+inline bool getAbort() { return false; }
+inline void setAbort(bool) {}
+
+class Scope
+{
+public:
+	Scope() {}
+};
+
+class PluginScope
+{
+public:
+	PluginScope(const Plugin&) {}
+};
+
+#endif
+} // namespace giada::m::rtCheck
+
+#endif
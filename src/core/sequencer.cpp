@@ -35,6 +35,7 @@
 #include "utils/log.h"
 #include "utils/math.h"
 #include "utils/time.h"
+#include <algorithm>
 
 namespace giada::m
 {
@@ -128,35 +129,20 @@ const Sequencer::EventBuffer& Sequencer::advance(const model::Sequencer& sequenc
 	const Frame start        = sequencer.a_getCurrentFrame();
 	const Frame end          = start + bufferSize;
 	const Frame framesInLoop = sequencer.framesInLoop;
-	const Frame framesInBar  = sequencer.framesInBar;
-	const Frame framesInBeat = sequencer.framesInBeat;
 	const Frame nextFrame    = end % framesInLoop;
 
-	/* Process events in the current block. */
+	/* Process events in the current block. The block is split into segments
+	that never cross the loop boundary, i.e. where global frames grow 
+	linearly. */
 
-	for (Frame i = start, local = 0; i < end; i++, local++)
+	for (Frame local = 0; local < bufferSize;)
 	{
+		const Frame global = (start + local) % framesInLoop; // wraps around 'framesInLoop'
+		const Frame length = std::min(bufferSize - local, framesInLoop - global);
 
-		Frame global = i % framesInLoop; // wraps around 'framesInLoop'
-
-		if (global == 0)
-		{
-			m_eventBuffer.push_back({EventType::FIRST_BEAT, global, local});
-			m_metronome.trigger(Metronome::Click::BEAT, local);
-		}
-		else if (global % framesInBar == 0)
-		{
-			m_eventBuffer.push_back({EventType::BAR, global, local});
-			m_metronome.trigger(Metronome::Click::BAR, local);
-		}
-		else if (global % framesInBeat == 0)
-		{
-			m_metronome.trigger(Metronome::Click::BEAT, local);
-		}
+		advanceSegment(sequencer, global, global + length, local, actionRecorder);
 
-		const std::vector<Action>* as = actionRecorder.getActionsOnFrame(global);
-		if (as != nullptr)
-			m_eventBuffer.push_back({EventType::ACTIONS, global, local, as});
+		local += length;
 	}
 
 	/* Advance this and quantizer after the event parsing. */
@@ -169,6 +155,69 @@ const Sequencer::EventBuffer& Sequencer::advance(const model::Sequencer& sequenc
 
 /* -------------------------------------------------------------------------- */
 
+void Sequencer::advanceSegment(const model::Sequencer& sequencer, Frame from,
+    Frame to, Frame local, const ActionRecorder& actionRecorder) const
+{
+	const Frame framesInBar  = sequencer.framesInBar;
+	const Frame framesInBeat = sequencer.framesInBeat;
+
+	/* Jump from one event to the next one instead of scanning each frame:
+	'nextBeat' and 'nextBar' point to the upcoming grid lines, 'action' to the
+	upcoming action in the timeline. Actions sharing the same frame are grouped
+	together into a single event. Grid events come first when they share the 
+	same frame with actions. */
+
+	Frame nextBeat = u::math::nextMultiple(from, framesInBeat);
+	Frame nextBar  = u::math::nextMultiple(from, framesInBar);
+
+	const ActionTimeline::Span actions = actionRecorder.getActionsInRange(from, to);
+	std::size_t                action  = 0;
+
+	while (true)
+	{
+		const Frame nextGrid   = std::min(nextBeat, nextBar);
+		const Frame nextAction = action < actions.size() ? actions[action].frame : to;
+
+		if (nextGrid >= to && nextAction >= to)
+			break;
+
+		if (nextGrid <= nextAction)
+		{
+			const Frame delta = local + nextGrid - from;
+
+			if (nextGrid == 0)
+			{
+				m_eventBuffer.push_back({EventType::FIRST_BEAT, nextGrid, delta});
+				m_metronome.trigger(Metronome::Click::BEAT, delta);
+			}
+			else if (nextGrid == nextBar)
+			{
+				m_eventBuffer.push_back({EventType::BAR, nextGrid, delta});
+				m_metronome.trigger(Metronome::Click::BAR, delta);
+			}
+			else
+			{
+				m_metronome.trigger(Metronome::Click::BEAT, delta);
+			}
+
+			if (nextGrid == nextBeat)
+				nextBeat += framesInBeat;
+			if (nextGrid == nextBar)
+				nextBar += framesInBar;
+		}
+		else
+		{
+			const std::size_t first = action;
+			while (action < actions.size() && actions[action].frame == nextAction)
+				++action;
+			m_eventBuffer.push_back({EventType::ACTIONS, nextAction, local + nextAction - from,
+			    actions.subspan(first, action - first)});
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Sequencer::render(mcl::AudioBuffer& outBuf) const
 {
 	if (m_metronome.running)
@@ -27,7 +27,7 @@
 #ifndef G_SEQUENCER_H
 #define G_SEQUENCER_H
 
-#include "core/actions/action.h"
+#include "core/actions/actionTimeline.h"
 #include "core/eventDispatcher.h"
 #include "core/metronome.h"
 #include "core/quantizer.h"
@@ -64,10 +64,10 @@ public:
 
 	struct Event
 	{
-		EventType                  type    = EventType::NONE;
-		Frame                      global  = 0;
-		Frame                      delta   = 0;
-		const std::vector<Action>* actions = nullptr;
+		EventType            type    = EventType::NONE;
+		Frame                global  = 0;
+		Frame                delta   = 0;
+		ActionTimeline::Span actions = {};
 	};
 
 	using EventBuffer = RingBuffer<Event, G_MAX_SEQUENCER_EVENTS>;
@@ -185,6 +185,13 @@ private:
 	void rawSetBpm(float v, int sampleRate);
 	void rawGoToBeat(int beat, int sampleRate);
 
+	/* advanceSegment
+	Parses events in the global range [from, to), which must not wrap around 
+	the loop boundary. 'local' is the block offset that corresponds to 'from'. */
+
+	void advanceSegment(const model::Sequencer&, Frame from, Frame to, Frame local,
+	    const ActionRecorder&) const;
+
 	model::Model&     m_model;
 	MidiSynchronizer& m_midiSynchronizer;
 	JackTransport&    m_jackTransport;
@@ -0,0 +1,113 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_SMOOTHED_PARAM_H
+#define G_SMOOTHED_PARAM_H
+
+#include <atomic>
+
+namespace giada
+{
+/* SmoothedParam
+A continuous parameter (e.g. volume, pan) written by a non-realtime thread and
+read by the realtime one, without going through a model swap. The realtime 
+thread reads it once per block as a Ramp that goes from the value used in the
+previous block to the latest one, so that sudden changes don't produce zipper
+noise. */
+
+class SmoothedParam
+{
+public:
+	struct Ramp
+	{
+		/* isFlat
+		True if the value doesn't change across the block. */
+
+		bool isFlat() const { return from == to; }
+
+		/* at
+		Returns the interpolated value at 'frame', in a block of 'frames'. */
+
+		float at(int frame, int frames) const
+		{
+			return from + (to - from) * (static_cast<float>(frame) / frames);
+		}
+
+		float from;
+		float to;
+	};
+
+	SmoothedParam(float v)
+	: m_target(v)
+	, m_current(v)
+	{
+	}
+
+	/* load
+	Returns the latest value set. Safe to call from any thread. */
+
+	float load() const
+	{
+		return m_target.load(std::memory_order_relaxed);
+	}
+
+	/* store
+	Sets a new value. The realtime thread will reach it at the end of the next 
+	block. */
+
+	void store(float v)
+	{
+		m_target.store(v, std::memory_order_relaxed);
+	}
+
+	/* reset
+	Sets a new value with no ramp. Only call this when the realtime thread is
+	not reading the parameter yet (e.g. right after construction). */
+
+	void reset(float v)
+	{
+		m_target.store(v, std::memory_order_relaxed);
+		m_current = v;
+	}
+
+	/* advance_RT
+	Returns the ramp for the current block. Call it once per block. */
+
+	Ramp advance_RT()
+	{
+		const Ramp ramp{m_current, load()};
+		m_current = ramp.to;
+		return ramp;
+	}
+
+private:
+	std::atomic<float> m_target;
+	float              m_current;
+};
+} // namespace giada
+
+#endif
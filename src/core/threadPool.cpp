@@ -0,0 +1,92 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/threadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace giada::m
+{
+ThreadPool::ThreadPool(int numThreads)
+: m_running(true)
+{
+	assert(numThreads > 0);
+
+	for (int i = 0; i < numThreads; i++)
+		m_threads.emplace_back([this]() { run(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_running = false;
+	}
+	m_cond.notify_all();
+	for (std::thread& t : m_threads)
+		t.join();
+}
+
+/* -------------------------------------------------------------------------- */
+
+int ThreadPool::getNumThreads() const
+{
+	return static_cast<int>(m_threads.size());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ThreadPool::submit(std::function<void()> job)
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_jobs.push_back(std::move(job));
+	}
+	m_cond.notify_one();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ThreadPool::run()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock lock(m_mutex);
+			m_cond.wait(lock, [this]() { return !m_running || !m_jobs.empty(); });
+			if (m_jobs.empty())
+				return; // Not running anymore, nothing left to do
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+		job();
+	}
+}
+} // namespace giada::m
@@ -0,0 +1,68 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_THREAD_POOL_H
+#define G_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace giada::m
+{
+/* ThreadPool
+A fixed set of threads running jobs in submission order, for non-realtime 
+work that would otherwise spawn threads on each call (e.g. decoding and 
+encoding Waves). Callers wait for their own jobs, e.g. with a std::latch. */
+
+class ThreadPool
+{
+public:
+	ThreadPool(int numThreads);
+	~ThreadPool();
+
+	int getNumThreads() const;
+
+	/* submit
+	Queues a job. Any thread but the pool ones. */
+
+	void submit(std::function<void()>);
+
+private:
+	void run();
+
+	std::vector<std::thread>          m_threads;
+	std::mutex                        m_mutex;
+	std::condition_variable           m_cond;
+	std::deque<std::function<void()>> m_jobs;
+	bool                              m_running;
+};
+} // namespace giada::m
+
+#endif
@@ -38,7 +38,8 @@ enum class Thread
 	MAIN,
 	MIDI,
 	AUDIO,
-	EVENTS
+	EVENTS,
+	RENDER
 };
 
 /* Windows fix */
@@ -72,7 +73,8 @@ enum class ChannelStatus : int
 	OFF,
 	EMPTY,
 	MISSING,
-	WRONG
+	WRONG,
+	LOADING
 };
 
 enum class SamplePlayerMode : int
@@ -100,6 +102,12 @@ enum class InputRecMode : int
 	FREE
 };
 
+enum class WaveFormat : int
+{
+	WAV = 0,
+	FLAC
+};
+
 /* Peak
 Audio peak information for two In/Out channels. */
 
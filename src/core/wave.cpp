@@ -26,7 +26,9 @@
 
 #include "wave.h"
 #include "const.h"
+#include "core/waveStream.h"
 #include "utils/fs.h"
+#include "utils/math.h"
 #include <cassert>
 #include <fmt/core.h>
 
@@ -34,10 +36,13 @@ namespace giada::m
 {
 Wave::Wave(ID id)
 : id(id)
+, m_buffer(std::make_shared<mcl::AudioBuffer>())
 , m_rate(0)
 , m_bits(0)
 , m_logical(false)
 , m_edited(false)
+, m_dirty(true)
+, m_hash(0)
 {
 }
 
@@ -45,23 +50,34 @@ Wave::Wave(ID id)
 
 Wave::Wave(const Wave& other)
 : id(other.id)
-, m_buffer(other.getBuffer())
+, m_buffer(other.m_buffer)
 , m_rate(other.m_rate)
 , m_bits(other.m_bits)
 , m_logical(false)
 , m_edited(false)
+, m_dirty(other.m_dirty)
+, m_hash(other.m_hash)
 , m_path(other.m_path)
 {
+	assert(!other.isStreamed()); // Streams can't be shared, reopen the file instead
 }
 
 /* -------------------------------------------------------------------------- */
 
+Wave::Wave(Wave&& o)            = default;
+Wave::~Wave()                   = default;
+Wave& Wave::operator=(Wave&& o) = default;
+
+/* -------------------------------------------------------------------------- */
+
 void Wave::alloc(Frame size, int channels, int rate, int bits, const std::string& path)
 {
-	m_buffer.alloc(size, channels);
-	m_rate = rate;
-	m_bits = bits;
-	m_path = path;
+	m_buffer = std::make_shared<mcl::AudioBuffer>();
+	m_buffer->alloc(size, channels);
+	m_dirty = true;
+	m_rate  = rate;
+	m_bits  = bits;
+	m_path  = path;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -78,17 +94,53 @@ std::string Wave::getPath() const { return m_path; }
 int         Wave::getBits() const { return m_bits; }
 bool        Wave::isLogical() const { return m_logical; }
 bool        Wave::isEdited() const { return m_edited; }
+bool        Wave::isDirty() const { return m_dirty; }
+uint64_t    Wave::getHash() const { return m_hash; }
+bool        Wave::isStreamed() const { return m_stream != nullptr; }
+WaveStream* Wave::getStream() const { return m_stream.get(); }
+
+/* -------------------------------------------------------------------------- */
+
+const mcl::AudioBuffer& Wave::getBuffer() const { return *m_buffer; }
+
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer& Wave::getWritableBuffer()
+{
+	if (m_buffer.use_count() > 1)
+		m_buffer = std::make_shared<mcl::AudioBuffer>(*m_buffer);
+	m_dirty = true;
+	return *m_buffer;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Wave::isSharingBuffer(const Wave& o) const
+{
+	return m_buffer == o.m_buffer;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t Wave::computeHash() const
+{
+	if (isStreamed() || m_buffer->countFrames() == 0)
+		return 0;
+	return u::math::hash((*m_buffer)[0], m_buffer->countFrames() * m_buffer->countChannels() * sizeof(float));
+}
 
 /* -------------------------------------------------------------------------- */
 
-mcl::AudioBuffer&       Wave::getBuffer() { return m_buffer; }
-const mcl::AudioBuffer& Wave::getBuffer() const { return m_buffer; }
+Frame Wave::getSize() const
+{
+	return isStreamed() ? m_stream->countFrames() : m_buffer->countFrames();
+}
 
 /* -------------------------------------------------------------------------- */
 
 int Wave::getDuration() const
 {
-	return m_buffer.countFrames() / m_rate;
+	return getSize() / m_rate;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -103,6 +155,8 @@ std::string Wave::getExtension() const
 void Wave::setRate(int v) { m_rate = v; }
 void Wave::setLogical(bool l) { m_logical = l; }
 void Wave::setEdited(bool e) { m_edited = e; }
+void Wave::setDirty(bool d) { m_dirty = d; }
+void Wave::setHash(uint64_t h) { m_hash = h; }
 
 /* -------------------------------------------------------------------------- */
 
@@ -118,6 +172,14 @@ void Wave::setPath(const std::string& p, int wid)
 
 void Wave::replaceData(mcl::AudioBuffer&& b)
 {
-	m_buffer = std::move(b);
+	m_buffer = std::make_shared<mcl::AudioBuffer>(std::move(b));
+	m_dirty  = true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::setStream(std::unique_ptr<WaveStream> s)
+{
+	m_stream = std::move(s);
 }
 } // namespace giada::m
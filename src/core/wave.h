@@ -29,18 +29,22 @@
 
 #include "core/types.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <cstdint>
+#include <memory>
 #include <string>
 
 namespace giada::m
 {
+class WaveStream;
 class Wave
 {
 public:
 	Wave(ID id);
 	Wave(const Wave& o);
-	Wave(Wave&& o) = default;
+	Wave(Wave&& o);
+	~Wave();
 
-	Wave& operator=(Wave&& o) = default;
+	Wave& operator=(Wave&& o);
 
 	std::string getBasename(bool ext = false) const;
 	std::string getExtension() const;
@@ -51,12 +55,58 @@ public:
 	bool        isLogical() const;
 	bool        isEdited() const;
 
+	/* isDirty
+	True if the audio data has changed since it was last read from or written
+	to the file at getPath(). */
+
+	bool isDirty() const;
+
+	/* getHash
+	Returns the content hash recorded when the Wave was last saved, 0 if 
+	unknown. */
+
+	uint64_t getHash() const;
+
+	/* computeHash
+	Hashes the audio data currently in memory. Returns 0 for streamed Waves. */
+
+	uint64_t computeHash() const;
+
+	/* isStreamed
+	True if audio data is read from disk while playing. The audio buffer is
+	empty in that case: use getStream() to access data. */
+
+	bool isStreamed() const;
+
+	/* getSize
+	Returns the length of the Wave in frames, streamed or not. */
+
+	Frame getSize() const;
+
+	/* getStream
+	Returns the disk stream, or nullptr if the Wave is not streamed. */
+
+	WaveStream* getStream() const;
+
 	/* getBuffer
-	Returns a (non-)const reference to the underlying audio buffer. */
+	Returns a read-only reference to the underlying audio buffer, which might be
+	shared with other Waves. */
 
-	mcl::AudioBuffer&       getBuffer();
 	const mcl::AudioBuffer& getBuffer() const;
 
+	/* getWritableBuffer
+	Returns a writable reference to the underlying audio buffer. If shared with
+	other Waves, the buffer is copied first (copy-on-write). Don't call this while
+	the audio thread might be reading the Wave: either edit a copy of it (see 
+	ChannelManager::editWave()) or do it before the Wave is added to the model. */
+
+	mcl::AudioBuffer& getWritableBuffer();
+
+	/* isSharingBuffer
+	True if this Wave and 'o' read from the same audio buffer. */
+
+	bool isSharingBuffer(const Wave& o) const;
+
 	/* setPath
 	Sets new path 'p'. If 'id' != -1 inserts a numeric id next to the file 
 	extension, e.g. : /path/to/sample-[id].wav */
@@ -66,23 +116,39 @@ public:
 	void setRate(int v);
 	void setLogical(bool l);
 	void setEdited(bool e);
+	void setDirty(bool d);
+	void setHash(uint64_t h);
 
 	/* replaceData
 	Replaces internal audio buffer with 'b' by moving it. */
 
 	void replaceData(mcl::AudioBuffer&& b);
 
+	/* setStream
+	Makes this Wave read its data from disk through 's'. */
+
+	void setStream(std::unique_ptr<WaveStream> s);
+
 	void alloc(Frame size, int channels, int rate, int bits, const std::string& path);
 
 	ID id;
 
 private:
-	mcl::AudioBuffer m_buffer;
-	int              m_rate;
-	int              m_bits;
-	bool             m_logical; // memory only (a take)
-	bool             m_edited;  // edited via editor
-	std::string      m_path;    // E.g. /path/to/my/sample.wav
+	/* m_buffer
+	Immutable as long as it's shared: Waves copied from each other point to the
+	same buffer until one of them gets written. The audio thread never owns a
+	reference to it, so the memory is never released there. */
+
+	std::shared_ptr<mcl::AudioBuffer> m_buffer;
+
+	std::unique_ptr<WaveStream> m_stream;
+	int                         m_rate;
+	int                         m_bits;
+	bool                        m_logical; // memory only (a take)
+	bool                        m_edited;  // edited via editor
+	bool                        m_dirty;   // data differs from file on disk
+	uint64_t                    m_hash;    // content hash as last saved
+	std::string                 m_path;    // E.g. /path/to/my/sample.wav
 };
 } // namespace giada::m
 
@@ -0,0 +1,355 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/waveCache.h"
+#include "core/const.h"
+#include "core/wave.h"
+#include "utils/log.h"
+#include "utils/math.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(G_OS_WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace stdfs = std::filesystem;
+
+namespace giada::m::waveCache
+{
+namespace
+{
+constexpr char     MAGIC_[8] = {'G', 'D', 'W', 'C', 'A', 'C', 'H', 'E'};
+constexpr uint32_t VERSION_  = 1;
+constexpr auto     EXT_      = ".gwc";
+
+/* Header_
+On-disk layout of a cache entry. Interleaved float frames follow right after,
+so the whole file can be mapped and copied in one go. */
+
+struct Header_
+{
+	char     magic[8];
+	uint32_t version;
+	uint32_t channels;
+	uint32_t rate;
+	uint32_t bits;
+	uint64_t frames;
+	uint64_t sourceHash;
+	uint64_t checksum;
+};
+
+static_assert(sizeof(Header_) % sizeof(float) == 0);
+
+std::string path_     = "";
+std::size_t maxBytes_ = 0;
+std::mutex  mutex_;
+
+/* -------------------------------------------------------------------------- */
+
+/* MappedFile_
+Read-only memory map of a whole file. */
+
+class MappedFile_
+{
+public:
+	MappedFile_(const std::string& path)
+	{
+#if defined(G_OS_WINDOWS)
+		m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+			return;
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mapping == nullptr)
+			return;
+		m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+		m_size = m_data != nullptr ? static_cast<std::size_t>(size.QuadPart) : 0;
+#else
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd == -1)
+			return;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED)
+			{
+				m_data = data;
+				m_size = st.st_size;
+				madvise(m_data, m_size, MADV_SEQUENTIAL);
+			}
+		}
+		close(fd); // The mapping stays valid
+#endif
+	}
+
+	~MappedFile_()
+	{
+#if defined(G_OS_WINDOWS)
+		if (m_data != nullptr)
+			UnmapViewOfFile(m_data);
+		if (m_mapping != nullptr)
+			CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE)
+			CloseHandle(m_file);
+#else
+		if (m_data != nullptr)
+			munmap(m_data, m_size);
+#endif
+	}
+
+	MappedFile_(const MappedFile_&)            = delete;
+	MappedFile_& operator=(const MappedFile_&) = delete;
+
+	const std::byte* getData() const { return static_cast<const std::byte*>(m_data); }
+	std::size_t      getSize() const { return m_size; }
+
+private:
+#if defined(G_OS_WINDOWS)
+	HANDLE m_file    = INVALID_HANDLE_VALUE;
+	HANDLE m_mapping = nullptr;
+#endif
+	void*       m_data = nullptr;
+	std::size_t m_size = 0;
+};
+
+/* -------------------------------------------------------------------------- */
+
+std::string makeEntryPath_(const Key& key)
+{
+	return (stdfs::path(path_) / fmt::format("{:016x}-{}-{}{}", key.hash, key.rate, static_cast<int>(key.quality), EXT_)).string();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* evict_
+Removes the least recently used entries until the cache fits in maxBytes_. 
+The modification time of an entry is bumped each time it's read, so it works
+as a last-access time. */
+
+void evict_()
+{
+	struct Entry
+	{
+		stdfs::path           path;
+		std::uintmax_t        size;
+		stdfs::file_time_type time;
+	};
+
+	std::error_code    ec;
+	std::vector<Entry> entries;
+	std::uintmax_t     total = 0;
+
+	for (const stdfs::directory_entry& e : stdfs::directory_iterator(path_, ec))
+	{
+		if (!e.is_regular_file(ec) || e.path().extension() != EXT_)
+			continue;
+		const std::uintmax_t        size = e.file_size(ec);
+		const stdfs::file_time_type time = e.last_write_time(ec);
+		if (ec)
+			continue;
+		entries.push_back({e.path(), size, time});
+		total += size;
+	}
+
+	if (total <= maxBytes_)
+		return;
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+
+	for (const Entry& e : entries)
+	{
+		if (total <= maxBytes_)
+			break;
+		if (stdfs::remove(e.path, ec))
+		{
+			total -= e.size;
+			u::log::print("[waveCache::evict_] Evicted %s\n", e.path.string());
+		}
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void init(const std::string& path, std::size_t maxBytes)
+{
+	std::scoped_lock lock(mutex_);
+
+	path_     = path;
+	maxBytes_ = maxBytes;
+
+	if (maxBytes_ == 0)
+		return;
+
+	std::error_code ec;
+	stdfs::create_directories(path_, ec);
+	if (ec)
+	{
+		u::log::print("[waveCache::init] Unable to create cache folder %s, cache disabled\n", path_);
+		maxBytes_ = 0;
+		return;
+	}
+
+	evict_();
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::optional<Key> makeKey(const std::string& path, int rate, Resampler::Quality quality)
+{
+	if (maxBytes_ == 0)
+		return {};
+
+	const MappedFile_ file(path);
+	if (file.getData() == nullptr)
+		return {};
+
+	return Key{u::math::hash(file.getData(), file.getSize()), rate, quality};
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool load(const Key& key, Wave& w, const std::string& path)
+{
+	const std::string entryPath = makeEntryPath_(key);
+
+	const MappedFile_ file(entryPath);
+	if (file.getData() == nullptr)
+		return false;
+
+	Header_ header;
+	bool    valid = file.getSize() >= sizeof(Header_);
+
+	if (valid)
+	{
+		std::memcpy(&header, file.getData(), sizeof(Header_));
+
+		valid = std::memcmp(header.magic, MAGIC_, sizeof(MAGIC_)) == 0 &&
+		        header.version == VERSION_ &&
+		        header.sourceHash == key.hash &&
+		        header.rate == static_cast<uint32_t>(key.rate) &&
+		        header.channels > 0 && header.channels <= G_MAX_IO_CHANS &&
+		        header.frames > 0 &&
+		        file.getSize() == sizeof(Header_) + header.frames * header.channels * sizeof(float) &&
+		        u::math::hash(file.getData() + sizeof(Header_), file.getSize() - sizeof(Header_)) == header.checksum;
+	}
+
+	if (!valid)
+	{
+		u::log::print("[waveCache::load] Damaged cache entry %s, removing it\n", entryPath);
+		std::error_code ec;
+		stdfs::remove(entryPath, ec);
+		return false;
+	}
+
+	w.alloc(header.frames, header.channels, header.rate, header.bits, path);
+	std::memcpy(w.getWritableBuffer()[0], file.getData() + sizeof(Header_), file.getSize() - sizeof(Header_));
+
+	/* Mark the entry as recently used. */
+
+	std::error_code ec;
+	stdfs::last_write_time(entryPath, stdfs::file_time_type::clock::now(), ec);
+
+	u::log::print("[waveCache::load] %s loaded from cache\n", path);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void store(const Key& key, const Wave& w)
+{
+	const mcl::AudioBuffer& buffer = w.getBuffer();
+
+	if (maxBytes_ == 0 || buffer.countFrames() == 0)
+		return;
+
+	const std::size_t dataSize = buffer.countFrames() * buffer.countChannels() * sizeof(float);
+	const std::byte*  data     = reinterpret_cast<const std::byte*>(buffer[0]);
+
+	if (sizeof(Header_) + dataSize > maxBytes_)
+		return;
+
+	Header_ header;
+	std::memcpy(header.magic, MAGIC_, sizeof(MAGIC_));
+	header.version    = VERSION_;
+	header.channels   = buffer.countChannels();
+	header.rate       = w.getRate();
+	header.bits       = w.getBits();
+	header.frames     = buffer.countFrames();
+	header.sourceHash = key.hash;
+	header.checksum   = u::math::hash(data, dataSize);
+
+	/* Write to a temporary file first and then rename it, so that a reader
+	never sees a half-written entry. Several threads may be storing at once. */
+
+	const std::string entryPath = makeEntryPath_(key);
+	const std::string tmpPath   = fmt::format("{}.{}.tmp", entryPath, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+	{
+		std::ofstream ofs(tmpPath, std::ios::binary | std::ios::trunc);
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(Header_));
+		ofs.write(reinterpret_cast<const char*>(data), dataSize);
+		if (!ofs.good())
+		{
+			u::log::print("[waveCache::store] Unable to write cache entry %s\n", tmpPath);
+			ofs.close();
+			std::error_code ec;
+			stdfs::remove(tmpPath, ec);
+			return;
+		}
+	}
+
+	std::scoped_lock lock(mutex_);
+
+	std::error_code ec;
+	stdfs::rename(tmpPath, entryPath, ec);
+	if (ec)
+	{
+		stdfs::remove(tmpPath, ec);
+		return;
+	}
+
+	evict_();
+}
+} // namespace giada::m::waveCache
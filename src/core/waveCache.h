@@ -0,0 +1,81 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_WAVE_CACHE_H
+#define G_WAVE_CACHE_H
+
+#include "core/resampler.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace giada::m
+{
+class Wave;
+}
+
+namespace giada::m::waveCache
+{
+/* Key
+Identifies a decoded Wave in the cache: content of the source file, plus the
+sample rate and quality it has been converted with. */
+
+struct Key
+{
+	uint64_t           hash;
+	int                rate;
+	Resampler::Quality quality;
+};
+
+/* init
+Enables the cache in folder 'path', holding at most 'maxBytes' of decoded 
+audio. Least recently used entries are evicted first. Zero 'maxBytes' disables
+the cache. */
+
+void init(const std::string& path, std::size_t maxBytes);
+
+/* makeKey
+Hashes the file at 'path'. Returns an empty optional if the cache is disabled
+or the file can't be read. */
+
+std::optional<Key> makeKey(const std::string& path, int rate, Resampler::Quality);
+
+/* load
+Fills 'w' with the cached data for 'key', giving it path 'path'. Returns false
+if there's no such entry or if it is damaged (in which case it gets deleted). */
+
+bool load(const Key& key, Wave& w, const std::string& path);
+
+/* store
+Writes the audio data of 'w' in the cache. Does nothing if the cache is 
+disabled. */
+
+void store(const Key& key, const Wave& w);
+} // namespace giada::m::waveCache
+
+#endif
@@ -29,15 +29,27 @@
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "idManager.h"
 #include "patch.h"
+#include "threadPool.h"
 #include "utils/fs.h"
 #include "utils/log.h"
 #include "wave.h"
+#include "waveCache.h"
 #include "waveFx.h"
+#include "waveStream.h"
+#include "deps/concurrentqueue/concurrentqueue.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cmath>
+#include <filesystem>
 #include <fmt/core.h>
+#include <latch>
 #include <memory>
+#include <optional>
 #include <samplerate.h>
+#include <semaphore>
 #include <sndfile.h>
+#include <thread>
 
 namespace giada::m::waveFactory
 {
@@ -49,74 +61,145 @@ IdManager waveId_;
 
 int getBits_(const SF_INFO& header)
 {
-	if (header.format & SF_FORMAT_PCM_S8)
+	/* Subtypes are plain values, not flags: compare them as a whole. */
+
+	switch (header.format & SF_FORMAT_SUBMASK)
+	{
+	case SF_FORMAT_PCM_S8:
+	case SF_FORMAT_PCM_U8:
 		return 8;
-	else if (header.format & SF_FORMAT_PCM_16)
+	case SF_FORMAT_PCM_16:
 		return 16;
-	else if (header.format & SF_FORMAT_PCM_24)
+	case SF_FORMAT_PCM_24:
 		return 24;
-	else if (header.format & SF_FORMAT_PCM_32)
+	case SF_FORMAT_PCM_32:
+	case SF_FORMAT_FLOAT:
 		return 32;
-	else if (header.format & SF_FORMAT_PCM_U8)
-		return 8;
-	else if (header.format & SF_FORMAT_FLOAT)
-		return 32;
-	else if (header.format & SF_FORMAT_DOUBLE)
+	case SF_FORMAT_DOUBLE:
 		return 64;
-	return 0;
+	default:
+		return 0;
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 
-std::string makeWavePath_(const std::string& base, const m::Wave& w, int k)
+/* getFlacSubtype_
+Returns the FLAC subtype for the given bit depth, 0 if FLAC can't hold it. */
+
+int getFlacSubtype_(int bits)
 {
-	return u::fs::join(base, fmt::format("{}-{}{}", w.getBasename(/*ext=*/false), k, w.getExtension()));
+	switch (bits)
+	{
+	case 8:
+		return SF_FORMAT_PCM_S8;
+	case 16:
+		return SF_FORMAT_PCM_16;
+	case 24:
+		return SF_FORMAT_PCM_24;
+	default:
+		return 0;
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 
-bool isWavePathUnique_(const m::Wave& skip, const std::string& path,
-    const std::vector<std::unique_ptr<Wave>>& waves)
+/* getExtension_
+Returns the file extension for Wave 'w' saved in 'format'. A WAV file keeps the
+extension of the original sample, as it always did. */
+
+std::string getExtension_(const m::Wave& w, WaveFormat format)
 {
-	for (const auto& w : waves)
-		if (w->id != skip.id && w->getPath() == path)
-			return false;
-	return true;
+	if (format == WaveFormat::FLAC)
+		return ".flac";
+	return getFormat(w.getPath()) == WaveFormat::FLAC ? ".wav" : w.getExtension();
 }
-} // namespace
 
 /* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
+
+std::string makeWavePath_(const std::string& base, const m::Wave& w, WaveFormat format, int k)
+{
+	return u::fs::join(base, fmt::format("{}-{}{}", w.getBasename(/*ext=*/false), k, getExtension_(w, format)));
+}
+
 /* -------------------------------------------------------------------------- */
 
-std::string makeUniqueWavePath(const std::string& base, const m::Wave& w,
-    const std::vector<std::unique_ptr<Wave>>& waves)
+Result openStream_(std::unique_ptr<Wave> wave, const std::string& path)
 {
-	std::string path = u::fs::join(base, w.getBasename(/*ext=*/true));
-	if (isWavePathUnique_(w, path, waves))
-		return path;
+	std::unique_ptr<WaveStream> stream = WaveStream::open(path);
+	if (stream == nullptr)
+		return {G_RES_ERR_IO};
 
-	// TODO - just use a timestamp. e.g. makeWavePath_(..., ..., getTimeStamp())
-	int k = 0;
-	path  = makeWavePath_(base, w, k);
-	while (!isWavePathUnique_(w, path, waves))
-		path = makeWavePath_(base, w, k++);
+	wave->alloc(0, G_MAX_IO_CHANS, stream->getRate(), getBits_(stream->getInfo()), path);
+	wave->setStream(std::move(stream));
+	wave->setDirty(false);
 
-	return path;
+	u::log::print("[waveManager::openStream_] new streamed Wave created, %d frames\n", wave->getSize());
+
+	return {G_RES_OK, std::move(wave)};
 }
 
 /* -------------------------------------------------------------------------- */
+
+bool writeStream_(SNDFILE* file, WaveStream& stream)
+{
+	mcl::AudioBuffer block;
+	block.alloc(WaveStream::CHUNK_FRAMES, G_MAX_IO_CHANS);
+
+	for (Frame f = 0; f < stream.countFrames(); f += block.countFrames())
+	{
+		const Frame frames = stream.readFromDisk(block[0], f, std::min(block.countFrames(), stream.countFrames() - f));
+		if (frames == 0 || sf_writef_float(file, block[0], frames) != frames)
+			return false;
+	}
+	return true;
+}
+
 /* -------------------------------------------------------------------------- */
+
+/* writeFlac_
+Writes the audio data in 'buffer' as integers of 'bits' size. Normalization is
+disabled on 'file', so that samples are scaled here with the same factor the 
+reader uses: every value survives the round trip exactly. */
+
+bool writeFlac_(SNDFILE* file, const mcl::AudioBuffer& buffer, int bits)
+{
+	const int   channels = buffer.countChannels();
+	const float scale    = static_cast<float>(1 << (bits - 1));
+
+	sf_command(file, SFC_SET_NORM_FLOAT, nullptr, SF_FALSE);
+
+	mcl::AudioBuffer block;
+	block.alloc(WaveStream::CHUNK_FRAMES, channels);
+
+	for (Frame f = 0; f < buffer.countFrames(); f += block.countFrames())
+	{
+		const Frame  frames = std::min(block.countFrames(), buffer.countFrames() - f);
+		const float* src    = buffer[f];
+		float*       dest   = block[0];
+		for (int i = 0; i < frames * channels; i++)
+			dest[i] = src[i] * scale;
+		if (sf_writef_float(file, dest, frames) != frames)
+			return false;
+	}
+	return true;
+}
+
 /* -------------------------------------------------------------------------- */
 
-void reset()
+ID generateId_(ID id = 0)
 {
-	waveId_ = IdManager();
+	waveId_.set(id);
+	return waveId_.generate(id);
 }
 
 /* -------------------------------------------------------------------------- */
 
-Result createFromFile(const std::string& path, ID id, int samplerate, Resampler::Quality quality)
+/* decode_
+Reads and converts the Wave at 'path'. The Wave is left without ID, so that
+this can run on any thread. */
+
+Result decode_(const std::string& path, int samplerate, Resampler::Quality quality, bool stream)
 {
 	if (path == "" || u::fs::isDir(path))
 	{
@@ -142,12 +225,36 @@ Result createFromFile(const std::string& path, ID id, int samplerate, Resampler:
 		return {G_RES_ERR_WRONG_DATA};
 	}
 
-	waveId_.set(id);
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(/*id=*/0);
+
+	/* Streaming makes sense only for samples longer than the in-memory head. 
+	Resampling on the fly is not supported: a sample with a different rate is 
+	loaded in memory and converted as usual. */
+
+	if (stream)
+	{
+		if (header.samplerate == samplerate && header.frames > WaveStream::HEAD_FRAMES)
+		{
+			sf_close(fileIn);
+			return openStream_(std::move(wave), path);
+		}
+		u::log::print("[waveManager::create] %s can't be streamed, loading it in memory\n", path);
+	}
+
+	/* Decoded and converted data might be in the cache already, from a previous
+	load with the same sample rate and quality. */
+
+	const std::optional<waveCache::Key> cacheKey = waveCache::makeKey(path, samplerate, quality);
+	if (cacheKey && waveCache::load(*cacheKey, *wave, path))
+	{
+		sf_close(fileIn);
+		wave->setDirty(false);
+		return {G_RES_OK, std::move(wave)};
+	}
 
-	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.generate(id));
 	wave->alloc(header.frames, header.channels, header.samplerate, getBits_(header), path);
 
-	if (sf_readf_float(fileIn, wave->getBuffer()[0], header.frames) != header.frames)
+	if (sf_readf_float(fileIn, wave->getWritableBuffer()[0], header.frames) != header.frames)
 		u::log::print("[waveManager::create] warning: incomplete read!\n");
 
 	sf_close(fileIn);
@@ -163,6 +270,13 @@ Result createFromFile(const std::string& path, ID id, int samplerate, Resampler:
 			return {G_RES_ERR_PROCESSING};
 	}
 
+	if (cacheKey)
+		waveCache::store(*cacheKey, *wave);
+
+	/* Converted or not, the Wave still reflects the file it comes from. */
+
+	wave->setDirty(false);
+
 	u::log::print("[waveManager::create] new Wave created, %d frames\n", wave->getBuffer().countFrames());
 
 	return {G_RES_OK, std::move(wave)};
@@ -170,6 +284,92 @@ Result createFromFile(const std::string& path, ID id, int samplerate, Resampler:
 
 /* -------------------------------------------------------------------------- */
 
+/* getPool_
+Threads shared by all decoding and encoding jobs, created on first use and
+reused across loads and saves. */
+
+ThreadPool& getPool_()
+{
+	static ThreadPool pool(std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, G_MAX_WAVE_THREADS));
+	return pool;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+std::string makeUniqueWavePath(const std::string& base, const m::Wave& w,
+    const std::unordered_set<std::string>& taken, WaveFormat format)
+{
+	std::string path = u::fs::join(base, w.getBasename(/*ext=*/false) + getExtension_(w, format));
+	if (!taken.contains(path))
+		return path;
+
+	int k = 0;
+	path  = makeWavePath_(base, w, format, k);
+	while (taken.contains(path))
+		path = makeWavePath_(base, w, format, ++k);
+
+	return path;
+}
+
+/* -------------------------------------------------------------------------- */
+
+WaveFormat getFormat(const std::string& path)
+{
+	std::string ext = u::fs::getExt(path);
+	std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+	return ext == ".flac" ? WaveFormat::FLAC : WaveFormat::WAV;
+}
+
+/* -------------------------------------------------------------------------- */
+
+WaveFormat getSaveFormat(const Wave& w, WaveFormat preferred)
+{
+	/* Streamed Waves stay WAV: seeking in a compressed file is too slow for
+	reading on the fly. Data made of floating point or 32-bit samples doesn't 
+	fit in FLAC. */
+
+	if (preferred == WaveFormat::WAV || w.isStreamed() || getFlacSubtype_(w.getBits()) == 0)
+		return WaveFormat::WAV;
+
+	/* Data must still be made of integer steps at the original bit depth: any
+	edit (gain, fades, ...) usually produces values in between. */
+
+	const float  scale = static_cast<float>(1 << (w.getBits() - 1));
+	const float* data  = w.getBuffer()[0];
+	const int    size  = w.getBuffer().countFrames() * w.getBuffer().countChannels();
+	for (int i = 0; i < size; i++)
+	{
+		const float v = data[i] * scale;
+		if (v != std::nearbyint(v) || v < -scale || v >= scale)
+			return WaveFormat::WAV;
+	}
+	return WaveFormat::FLAC;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void reset()
+{
+	waveId_ = IdManager();
+}
+
+/* -------------------------------------------------------------------------- */
+
+Result createFromFile(const std::string& path, ID id, int samplerate, Resampler::Quality quality, bool stream)
+{
+	Result res = decode_(path, samplerate, quality, stream);
+	if (res.status == G_RES_OK)
+		res.wave->id = generateId_(id);
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
 std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate,
     const std::string& name)
 {
@@ -187,15 +387,33 @@ std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate,
 
 std::unique_ptr<Wave> createFromWave(const Wave& src, int a, int b)
 {
+	/* Streams can't be shared: just open the same file again. */
+
+	if (src.isStreamed())
+		return openStream_(std::make_unique<Wave>(waveId_.generate()), src.getStream()->getPath()).wave;
+
 	a = a == -1 ? 0 : a;
 	b = b == -1 ? src.getBuffer().countFrames() : b;
 
 	const int channels = src.getBuffer().countChannels();
 	const int frames   = b - a;
 
-	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.generate());
-	wave->alloc(frames, channels, src.getRate(), src.getBits(), src.getPath());
-	wave->getBuffer().set(src.getBuffer(), frames);
+	std::unique_ptr<Wave> wave;
+
+	/* A copy of the whole Wave just shares the audio data with the source, 
+	until one of the two gets edited. */
+
+	if (frames == src.getBuffer().countFrames())
+	{
+		wave     = std::make_unique<Wave>(src);
+		wave->id = waveId_.generate();
+	}
+	else
+	{
+		wave = std::make_unique<Wave>(waveId_.generate());
+		wave->alloc(frames, channels, src.getRate(), src.getBits(), src.getPath());
+		wave->getWritableBuffer().set(src.getBuffer(), frames);
+	}
 	wave->setLogical(true);
 
 	u::log::print("[waveManager::createFromWave] new Wave created, %d frames\n", frames);
@@ -207,12 +425,105 @@ std::unique_ptr<Wave> createFromWave(const Wave& src, int a, int b)
 
 std::unique_ptr<Wave> deserializeWave(const Patch::Wave& w, int samplerate, Resampler::Quality quality)
 {
-	return createFromFile(w.path, w.id, samplerate, quality).wave;
+	std::unique_ptr<Wave> wave = createFromFile(w.path, w.id, samplerate, quality, w.streamed).wave;
+	if (wave != nullptr)
+		wave->setHash(w.hash);
+	return wave;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void reserveIds(const std::vector<Patch::Wave>& pwaves)
+{
+	for (const Patch::Wave& pwave : pwaves)
+		generateId_(pwave.id);
+}
+
+void deserializeWaves(const std::vector<Patch::Wave>& pwaves, int samplerate, Resampler::Quality quality,
+    std::function<void(std::size_t, std::unique_ptr<Wave>)> onLoaded, std::stop_token stop)
+{
+	const std::size_t numWaves = pwaves.size();
+
+	/* Waves pointing to the same file are decoded only once and share their
+	audio data. Streamed Waves can't share anything. */
+
+	std::vector<std::size_t> sources(numWaves);
+	std::vector<std::size_t> toDecode;
+	for (std::size_t i = 0; i < numWaves; i++)
+	{
+		const auto it = std::find_if(pwaves.begin(), pwaves.begin() + i, [&pwave = pwaves[i]](const Patch::Wave& p) {
+			return !p.streamed && !pwave.streamed && p.path == pwave.path;
+		});
+		sources[i]    = std::distance(pwaves.begin(), it);
+		if (sources[i] == i)
+			toDecode.push_back(i);
+	}
+
+	ThreadPool&       pool       = getPool_();
+	const std::size_t numDecode  = toDecode.size();
+	const std::size_t numThreads = std::min<std::size_t>(pool.getNumThreads(), numDecode);
+
+	std::vector<std::unique_ptr<Wave>>       waves(numWaves);
+	std::atomic<std::size_t>                 next = 0;
+	moodycamel::ConcurrentQueue<std::size_t> done;
+	std::counting_semaphore<>                doneCount(0);
+
+	/* Decode on the shared pool of threads, each job picking the next Wave to 
+	work on. Results go into their own slot and are handed over to the calling
+	thread by index. */
+
+	std::latch finished(static_cast<std::ptrdiff_t>(numThreads));
+	for (std::size_t i = 0; i < numThreads; i++)
+		pool.submit([&]() {
+			for (std::size_t n = next++; n < numDecode; n = next++)
+			{
+				if (!stop.stop_requested())
+				{
+					const std::size_t  j     = toDecode[n];
+					const Patch::Wave& pwave = pwaves[j];
+					waves[j]                 = decode_(pwave.path, samplerate, quality, pwave.streamed).wave;
+					if (waves[j] != nullptr)
+					{
+						waves[j]->id = pwave.id;
+						waves[j]->setHash(pwave.hash);
+					}
+					done.enqueue(j);
+				}
+				doneCount.release();
+			}
+			finished.count_down();
+		});
+
+	for (std::size_t n = 0; n < numDecode; n++)
+	{
+		doneCount.acquire();
+		std::size_t j;
+		if (!done.try_dequeue(j))
+			continue;
+		for (std::size_t k = j + 1; k < numWaves; k++)
+		{
+			if (sources[k] != j)
+				continue;
+			std::unique_ptr<Wave> copy;
+			if (waves[j] != nullptr)
+			{
+				copy     = std::make_unique<Wave>(*waves[j]);
+				copy->id = pwaves[k].id;
+				copy->setHash(pwaves[k].hash);
+			}
+			onLoaded(k, std::move(copy));
+		}
+		onLoaded(j, std::move(waves[j]));
+	}
+
+	finished.wait();
 }
 
+/* -------------------------------------------------------------------------- */
+
 const Patch::Wave serializeWave(const Wave& w)
 {
-	return {w.id, u::fs::basename(w.getPath())};
+	return {w.id, u::fs::basename(w.getPath()), w.isStreamed(), w.getHash()};
 }
 
 /* -------------------------------------------------------------------------- */
@@ -249,26 +560,84 @@ int resample(Wave& w, Resampler::Quality quality, int samplerate)
 
 /* -------------------------------------------------------------------------- */
 
-int save(const Wave& w, const std::string& path)
+int save(const Wave& w, const std::string& path, WaveFormat format)
 {
+	/* A streamed Wave is already on disk: never write over the file being 
+	streamed. */
+
+	if (w.isStreamed() && w.getStream()->getPath() == path)
+		return G_RES_OK;
+
+	if (format == WaveFormat::FLAC && (w.isStreamed() || getFlacSubtype_(w.getBits()) == 0))
+		return G_RES_ERR_WRONG_DATA;
+
 	SF_INFO header;
 	header.samplerate = w.getRate();
-	header.channels   = w.getBuffer().countChannels();
-	header.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+	header.channels   = w.isStreamed() ? G_MAX_IO_CHANS : w.getBuffer().countChannels();
+	header.format     = format == WaveFormat::FLAC
+	                        ? SF_FORMAT_FLAC | getFlacSubtype_(w.getBits())
+	                        : SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	/* Write to a temporary file, then replace the destination with it in one
+	go: a failure halfway never leaves a truncated sample behind. */
+
+	const std::string tmpPath = path + ".tmp";
 
-	SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &header);
+	SNDFILE* file = sf_open(tmpPath.c_str(), SFM_WRITE, &header);
 	if (file == nullptr)
 	{
 		u::log::print("[waveManager::save] unable to open %s for exporting: %s\n",
-		    path, sf_strerror(file));
+		    tmpPath, sf_strerror(file));
 		return G_RES_ERR_IO;
 	}
 
-	if (sf_writef_float(file, w.getBuffer()[0], w.getBuffer().countFrames()) != w.getBuffer().countFrames())
-		u::log::print("[waveManager::save] warning: incomplete write!\n");
+	bool ok = true;
+	if (w.isStreamed())
+		ok = writeStream_(file, *w.getStream());
+	else if (format == WaveFormat::FLAC)
+		ok = writeFlac_(file, w.getBuffer(), w.getBits());
+	else if (sf_writef_float(file, w.getBuffer()[0], w.getBuffer().countFrames()) != w.getBuffer().countFrames())
+		ok = false;
 
 	sf_close(file);
 
+	std::error_code ec;
+	if (ok)
+		std::filesystem::rename(tmpPath, path, ec);
+	if (!ok || ec)
+	{
+		u::log::print("[waveManager::save] unable to write %s\n", path);
+		std::filesystem::remove(tmpPath, ec);
+		return G_RES_ERR_IO;
+	}
+
 	return G_RES_OK;
 }
+
+/* -------------------------------------------------------------------------- */
+
+std::vector<int> saveWaves(const std::vector<SaveRequest>& requests)
+{
+	ThreadPool&       pool        = getPool_();
+	const std::size_t numRequests = requests.size();
+	const std::size_t numThreads  = std::min<std::size_t>(pool.getNumThreads(), numRequests);
+
+	std::vector<int>         results(numRequests, G_RES_ERR);
+	std::atomic<std::size_t> next = 0;
+
+	/* Same bounded pool as in deserializeWaves(): encoding is CPU bound, 
+	writing each file is independent from the others. */
+
+	std::latch finished(static_cast<std::ptrdiff_t>(numThreads));
+	for (std::size_t i = 0; i < numThreads; i++)
+		pool.submit([&]() {
+			for (std::size_t n = next++; n < numRequests; n = next++)
+				results[n] = save(*requests[n].wave, requests[n].path, requests[n].format);
+			finished.count_down();
+		});
+
+	finished.wait();
+
+	return results;
+}
 } // namespace giada::m::waveFactory
@@ -32,8 +32,12 @@
 #include "core/resampler.h"
 #include "core/types.h"
 #include "core/wave.h"
+#include <functional>
 #include <memory>
+#include <stop_token>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace giada::m::waveFactory
 {
@@ -43,6 +47,13 @@ struct Result
 	std::unique_ptr<Wave> wave = nullptr;
 };
 
+struct SaveRequest
+{
+	const Wave* wave;
+	std::string path;
+	WaveFormat  format = WaveFormat::WAV;
+};
+
 /* reset
     Resets internal ID generator. */
 
@@ -51,9 +62,11 @@ void reset();
 /* create
 	Creates a new Wave object with data read from file 'path'. Pass id = 0 to 
 	auto-generate it. The function converts the Wave sample rate if it doesn't 
-	match the desired one as specified in 'samplerate'. */
+	match the desired one as specified in 'samplerate'. If 'stream' is true the
+	Wave reads its data from disk while playing, when possible. */
 
-Result createFromFile(const std::string& path, ID id, int samplerate, Resampler::Quality);
+Result createFromFile(const std::string& path, ID id, int samplerate, Resampler::Quality,
+    bool stream = false);
 
 /* createEmpty
 	Creates a new silent Wave object. */
@@ -63,7 +76,9 @@ std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate,
 
 /* createFromWave
 	Creates a new Wave from an existing one. If specified, copying the data in 
-	range a - b. Range is [0, sr.buffer.countFrames()] otherwise. */
+	range a - b. Range is [0, sr.buffer.countFrames()] otherwise. A copy of the
+	whole range shares the audio data with 'src' (copy-on-write). A streamed
+	Wave gets a new stream on the same file, range is ignored. */
 
 std::unique_ptr<Wave> createFromWave(const Wave& src, int a = -1, int b = -1);
 
@@ -73,6 +88,23 @@ std::unique_ptr<Wave> createFromWave(const Wave& src, int a = -1, int b = -1);
 std::unique_ptr<Wave> deserializeWave(const Patch::Wave& w, int samplerate, Resampler::Quality);
 const Patch::Wave     serializeWave(const Wave& w);
 
+/* reserveIds
+	Makes sure that the IDs of the Waves in the patch won't be handed out to new
+	Waves. Call this on the main thread after reset(), before any new Wave is 
+	created. */
+
+void reserveIds(const std::vector<Patch::Wave>&);
+
+/* deserializeWaves
+	Same as deserializeWave() for a whole list of Waves, decoded in parallel. 
+	'onLoaded' is called on the calling thread each time a Wave is done, with its
+	index in the list (nullptr if it failed). Waves keep their patch ID. Waves 
+	with the same path are decoded once and share their audio data. Returns when
+	all Waves are done, or as soon as possible if 'stop' is requested. */
+
+void deserializeWaves(const std::vector<Patch::Wave>&, int samplerate, Resampler::Quality,
+    std::function<void(std::size_t, std::unique_ptr<Wave>)> onLoaded, std::stop_token stop = {});
+
 /* resample
 	Change sample rate of 'w' to the desider value. The 'quality' parameter sets 
 	the algorithm to use for the conversion. */
@@ -80,12 +112,36 @@ const Patch::Wave     serializeWave(const Wave& w);
 int resample(Wave&, Resampler::Quality, int samplerate);
 
 /* save
-	Writes Wave data to file 'path'. Only 'wav' format is supported for now. */
+	Writes Wave data to file 'path', as 32-bit float WAV or as FLAC at the 
+	original bit depth. Use getSaveFormat() to know whether FLAC is lossless for
+	'w'. Data goes to a temporary file first, which then atomically replaces 
+	'path'. */
+
+int save(const Wave& w, const std::string& path, WaveFormat format = WaveFormat::WAV);
+
+/* saveWaves
+	Same as save() for a list of Waves, encoded in parallel. Returns the status
+	of each request, in the same order. */
+
+std::vector<int> saveWaves(const std::vector<SaveRequest>&);
+
+/* getSaveFormat
+	Returns 'preferred' if Wave 'w' can be saved in that format without any 
+	loss, WAV otherwise. */
+
+WaveFormat getSaveFormat(const Wave& w, WaveFormat preferred);
+
+/* getFormat
+	Returns the format of the file at 'path', given its extension. */
+
+WaveFormat getFormat(const std::string& path);
 
-int save(const Wave& w, const std::string& path);
+/* makeUniqueWavePath
+	Returns a path for 'w' in folder 'base' that is not in 'taken', with the 
+	extension of 'format'. */
 
 std::string makeUniqueWavePath(const std::string& base, const m::Wave& w,
-    const std::vector<std::unique_ptr<Wave>>& waves);
+    const std::unordered_set<std::string>& taken, WaveFormat format = WaveFormat::WAV);
 } // namespace giada::m::waveFactory
 
 #endif
@@ -43,10 +43,10 @@ namespace giada::m::wfx
 {
 namespace
 {
-void fadeFrame_(Wave& w, int i, float val)
+void fadeFrame_(mcl::AudioBuffer& buffer, int i, float val)
 {
-	for (int j = 0; j < w.getBuffer().countChannels(); j++)
-		w.getBuffer()[i][j] *= val;
+	for (int j = 0; j < buffer.countChannels(); j++)
+		buffer[i][j] *= val;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -78,10 +78,11 @@ void normalize(Wave& w, int a, int b)
 	if (peak == 0.0f || peak > 1.0f)
 		return;
 
+	mcl::AudioBuffer& buffer = w.getWritableBuffer();
 	for (int i = a; i < b; i++)
 	{
-		for (int j = 0; j < w.getBuffer().countChannels(); j++)
-			w.getBuffer()[i][j] = w.getBuffer()[i][j] * (1.0f / peak);
+		for (int j = 0; j < buffer.countChannels(); j++)
+			buffer[i][j] = buffer[i][j] * (1.0f / peak);
 	}
 	w.setEdited(true);
 }
@@ -111,9 +112,10 @@ void silence(Wave& w, int a, int b)
 {
 	u::log::print("[wfx::silence] silencing from %d to %d\n", a, b);
 
+	mcl::AudioBuffer& buffer = w.getWritableBuffer();
 	for (int i = a; i < b; i++)
-		for (int j = 0; j < w.getBuffer().countChannels(); j++)
-			w.getBuffer()[i][j] = 0.0f;
+		for (int j = 0; j < buffer.countChannels(); j++)
+			buffer[i][j] = 0.0f;
 	w.setEdited(true);
 }
 
@@ -200,15 +202,17 @@ void fade(Wave& w, int a, int b, Fade type)
 {
 	u::log::print("[wfx::fade] fade from %d to %d (range = %d)\n", a, b, b - a);
 
+	mcl::AudioBuffer& buffer = w.getWritableBuffer();
+
 	float m = 0.0f;
 	float d = 1.0f / (float)(b - a);
 
 	if (type == Fade::IN)
 		for (int i = a; i <= b; i++, m += d)
-			fadeFrame_(w, i, m);
+			fadeFrame_(buffer, i, m);
 	else
 		for (int i = b; i >= a; i--, m += d)
-			fadeFrame_(w, i, m);
+			fadeFrame_(buffer, i, m);
 
 	w.setEdited(true);
 }
@@ -237,10 +241,12 @@ void shift(Wave& w, Frame offset)
 	if (offset < 0)
 		offset = (w.getBuffer().countFrames() + w.getBuffer().countChannels()) + offset;
 
-	float* begin = w.getBuffer()[0];
-	float* end   = w.getBuffer()[0] + (w.getBuffer().countFrames() * w.getBuffer().countChannels());
+	mcl::AudioBuffer& buffer = w.getWritableBuffer();
+
+	float* begin = buffer[0];
+	float* end   = buffer[0] + (buffer.countFrames() * buffer.countChannels());
 
-	std::rotate(begin, end - (offset * w.getBuffer().countChannels()), end);
+	std::rotate(begin, end - (offset * buffer.countChannels()), end);
 	w.setEdited(true);
 }
 
@@ -249,8 +255,10 @@ void shift(Wave& w, Frame offset)
 void reverse(Wave& w, Frame a, Frame b)
 {
 	/* https://stackoverflow.com/questions/33201528/reversing-an-array-of-structures-in-c */
-	float* begin = w.getBuffer()[0] + (a * w.getBuffer().countChannels());
-	float* end   = w.getBuffer()[0] + (b * w.getBuffer().countChannels());
+	mcl::AudioBuffer& buffer = w.getWritableBuffer();
+
+	float* begin = buffer[0] + (a * buffer.countChannels());
+	float* end   = buffer[0] + (b * buffer.countChannels());
 
 	std::reverse(begin, end);
 
@@ -0,0 +1,129 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/waveLoader.h"
+#include "core/wave.h"
+#include "core/waveFactory.h"
+#include "utils/log.h"
+#include <cassert>
+
+namespace giada::m
+{
+WaveLoader::WaveLoader()
+: onLoaded(nullptr)
+, m_notified(false)
+, m_taken(0)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+WaveLoader::~WaveLoader()
+{
+	cancel();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void WaveLoader::start(std::vector<Patch::Wave> waves, int sampleRate, Resampler::Quality quality)
+{
+	assert(onLoaded != nullptr);
+
+	cancel();
+
+	m_waves = std::move(waves);
+
+	u::log::print("[WaveLoader::start] Loading %d waves in background\n", m_waves.size());
+
+	m_thread = std::jthread([this, sampleRate, quality](std::stop_token stop) {
+		waveFactory::deserializeWaves(m_waves, sampleRate, quality,
+		    [this](std::size_t i, std::unique_ptr<Wave> w) {
+			    {
+				    std::scoped_lock lock(m_mutex);
+				    m_loaded.emplace_back(i, std::move(w));
+			    }
+			    if (!m_notified.exchange(true))
+				    onLoaded();
+		    },
+		    stop);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::vector<WaveLoader::Loaded> WaveLoader::take()
+{
+	m_notified.store(false);
+
+	std::vector<Loaded> loaded;
+	{
+		std::scoped_lock lock(m_mutex);
+		loaded.swap(m_loaded);
+	}
+	m_taken += loaded.size();
+	return loaded;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void WaveLoader::wait()
+{
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void WaveLoader::cancel()
+{
+	if (m_thread.joinable())
+	{
+		m_thread.request_stop();
+		m_thread.join();
+	}
+
+	std::scoped_lock lock(m_mutex);
+	m_loaded.clear();
+	m_waves.clear();
+	m_notified.store(false);
+	m_taken = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool WaveLoader::isDone() const
+{
+	return m_taken == m_waves.size();
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Patch::Wave& WaveLoader::getWave(std::size_t i) const
+{
+	assert(i < m_waves.size());
+	return m_waves[i];
+}
+} // namespace giada::m
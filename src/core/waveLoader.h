@@ -0,0 +1,108 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_WAVE_LOADER_H
+#define G_WAVE_LOADER_H
+
+#include "core/patch.h"
+#include "core/resampler.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace giada::m
+{
+class Wave;
+class WaveLoader final
+{
+public:
+	/* Loaded
+	A decoded Wave, with its index in the list passed to start(). nullptr if
+	the Wave couldn't be loaded. */
+
+	using Loaded = std::pair<std::size_t, std::unique_ptr<Wave>>;
+
+	WaveLoader();
+	~WaveLoader();
+
+	/* start
+	Decodes 'waves' on a background thread. Cancels any previous job. */
+
+	void start(std::vector<Patch::Wave> waves, int sampleRate, Resampler::Quality);
+
+	/* take
+	Returns the Waves decoded since the last call, and re-arms onLoaded. */
+
+	std::vector<Loaded> take();
+
+	/* wait
+	Blocks until all Waves have been decoded. */
+
+	void wait();
+
+	/* cancel
+	Stops decoding and drops the Waves not yet taken. */
+
+	void cancel();
+
+	/* isDone
+	True when all Waves of the current job have been taken, or if there is no
+	job at all. */
+
+	bool isDone() const;
+
+	/* getWave
+	Returns the i-th Patch::Wave of the current job. */
+
+	const Patch::Wave& getWave(std::size_t i) const;
+
+	/* onLoaded
+	Fired by the background thread when new Waves are ready to be taken. Fired
+	once until the next take(), no matter how many Waves come in meanwhile. */
+
+	std::function<void()> onLoaded;
+
+private:
+	/* m_waves is read by the loader thread and left untouched until it is 
+	joined. m_loaded and m_notified are shared with it. m_taken belongs to the
+	caller. */
+
+	std::jthread             m_thread;
+	std::vector<Patch::Wave> m_waves;
+	std::mutex               m_mutex;
+	std::vector<Loaded>      m_loaded;
+	std::atomic<bool>        m_notified;
+	std::size_t              m_taken;
+};
+} // namespace giada::m
+
+#endif
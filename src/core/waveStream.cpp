@@ -0,0 +1,491 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/waveStream.h"
+#include "core/const.h"
+#include "core/worker.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <vector>
+
+namespace giada::m
+{
+namespace
+{
+/* STREAMER_SLEEP_
+How often the I/O thread looks for chunks to refill, in milliseconds. */
+
+constexpr int STREAMER_SLEEP_ = 5;
+
+std::mutex                  streamerMutex_;
+std::weak_ptr<WaveStreamer> streamer_;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+/* WaveStreamer
+The I/O thread shared by all open streams. It is alive as long as there is at
+least one stream around. */
+
+class WaveStreamer final
+{
+public:
+	WaveStreamer()
+	: m_worker(STREAMER_SLEEP_)
+	{
+		m_worker.start([this]() { process(); });
+	}
+
+	~WaveStreamer()
+	{
+		m_worker.stop();
+	}
+
+	static std::shared_ptr<WaveStreamer> get()
+	{
+		std::scoped_lock              lock(streamerMutex_);
+		std::shared_ptr<WaveStreamer> streamer = streamer_.lock();
+		if (streamer == nullptr)
+		{
+			streamer  = std::make_shared<WaveStreamer>();
+			streamer_ = streamer;
+		}
+		return streamer;
+	}
+
+	void add(WaveStream& s)
+	{
+		std::scoped_lock lock(m_mutex);
+		m_streams.push_back(&s);
+	}
+
+	/* remove
+	Unregisters a stream. Waits only if that very stream is being read from disk
+	right now, so that it can be safely destroyed afterwards. */
+
+	void remove(WaveStream& s)
+	{
+		std::unique_lock lock(m_mutex);
+		m_streams.erase(std::remove(m_streams.begin(), m_streams.end(), &s), m_streams.end());
+		m_idle.wait(lock, [this, &s]() { return m_busy != &s; });
+	}
+
+private:
+	/* process
+	Disk reads happen outside of m_mutex, so that adding or removing streams
+	from the main thread is never held back by I/O. */
+
+	void process()
+	{
+		{
+			std::scoped_lock lock(m_mutex);
+			m_snapshot = m_streams;
+		}
+
+		for (WaveStream* s : m_snapshot)
+		{
+			if (!acquire(s)) // Removed in the meantime
+				continue;
+
+			while (s->process())
+				;
+			const int underruns = s->countUnderruns();
+			if (underruns != s->m_loggedUnderruns)
+			{
+				u::log::print("[WaveStreamer::process] %d underrun(s) while streaming from disk\n",
+				    underruns - s->m_loggedUnderruns);
+				s->m_loggedUnderruns = underruns;
+			}
+
+			release();
+		}
+	}
+
+	bool acquire(WaveStream* s)
+	{
+		std::scoped_lock lock(m_mutex);
+		if (std::find(m_streams.begin(), m_streams.end(), s) == m_streams.end())
+			return false;
+		m_busy = s;
+		return true;
+	}
+
+	void release()
+	{
+		{
+			std::scoped_lock lock(m_mutex);
+			m_busy = nullptr;
+		}
+		m_idle.notify_all();
+	}
+
+	std::mutex               m_mutex;
+	std::condition_variable  m_idle;
+	std::vector<WaveStream*> m_streams;
+	std::vector<WaveStream*> m_snapshot; // I/O thread only
+	WaveStream*              m_busy = nullptr;
+	Worker                   m_worker;
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<WaveStream> WaveStream::open(const std::string& path)
+{
+	SF_INFO  header;
+	SNDFILE* file = sf_open(path.c_str(), SFM_READ, &header);
+
+	if (file == nullptr)
+	{
+		u::log::print("[WaveStream::open] unable to read %s. %s\n", path, sf_strerror(file));
+		return nullptr;
+	}
+
+	if (header.channels > G_MAX_IO_CHANS || !header.seekable)
+	{
+		u::log::print("[WaveStream::open] %s can't be streamed\n", path);
+		sf_close(file);
+		return nullptr;
+	}
+
+	std::unique_ptr<WaveStream> stream(new WaveStream(file, header, path));
+	stream->setRange(0, stream->countFrames());
+
+	return stream;
+}
+
+/* -------------------------------------------------------------------------- */
+
+WaveStream::WaveStream(SNDFILE* file, const SF_INFO& header, const std::string& path)
+: m_file(file)
+, m_header(header)
+, m_path(path)
+, m_begin(0)
+, m_end(0)
+, m_headEnd(0)
+, m_seekPosition(0)
+, m_seekGeneration(0)
+, m_underruns(0)
+, m_windowStart(0)
+, m_windowFrames(0)
+, m_currChunk(-1)
+, m_nextPosition(0)
+, m_generation(0)
+, m_readPosition(0)
+, m_readGeneration(0)
+, m_failedChunk(-1)
+, m_loggedUnderruns(0)
+{
+	m_head.alloc(HEAD_FRAMES, G_MAX_IO_CHANS);
+	m_chunkData.alloc(CHUNK_FRAMES * NUM_CHUNKS, G_MAX_IO_CHANS);
+	m_window.alloc(WINDOW_FRAMES, G_MAX_IO_CHANS);
+	if (m_header.channels == 1)
+		m_scratch.alloc(CHUNK_FRAMES, 1);
+
+	for (int i = 0; i < NUM_CHUNKS; i++)
+		m_free.push(i);
+
+	m_streamer = WaveStreamer::get();
+	m_streamer->add(*this);
+}
+
+/* -------------------------------------------------------------------------- */
+
+WaveStream::~WaveStream()
+{
+	m_streamer->remove(*this);
+	sf_close(m_file);
+}
+
+/* -------------------------------------------------------------------------- */
+
+const SF_INFO&     WaveStream::getInfo() const { return m_header; }
+const std::string& WaveStream::getPath() const { return m_path; }
+Frame              WaveStream::countFrames() const { return static_cast<Frame>(m_header.frames); }
+int                WaveStream::getRate() const { return m_header.samplerate; }
+int                WaveStream::countUnderruns() const { return m_underruns.load(); }
+
+/* -------------------------------------------------------------------------- */
+
+void WaveStream::setRange(Frame begin, Frame end)
+{
+	std::scoped_lock lock(m_fileMutex);
+
+	m_begin   = std::clamp(begin, 0, countFrames());
+	m_end     = std::clamp(end, m_begin, countFrames());
+	m_headEnd = std::min(m_begin + HEAD_FRAMES, m_end);
+
+	const Frame headFrames = m_headEnd - m_begin;
+	if (read(m_head[0], m_begin, headFrames) != headFrames)
+		u::log::print("[WaveStream::setRange] warning: incomplete read!\n");
+
+	/* Give all chunks back to the I/O thread and start over right after the
+	head. Both threads are idle here, so queue roles can be swapped safely. */
+
+	releaseChunk_RT();
+	int index;
+	while (m_ready.pop(index))
+		m_free.push(index);
+
+	m_windowStart    = 0;
+	m_windowFrames   = 0;
+	m_nextPosition   = m_headEnd;
+	m_readPosition   = m_headEnd;
+	m_readGeneration = ++m_generation;
+	m_seekPosition.store(m_headEnd);
+	m_seekGeneration.store(m_generation);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool WaveStream::process()
+{
+	std::scoped_lock lock(m_fileMutex);
+
+	const uint32_t generation = m_seekGeneration.load();
+	if (generation != m_readGeneration)
+	{
+		m_readGeneration = generation;
+		m_readPosition   = m_seekPosition.load();
+	}
+
+	if (m_headEnd == m_end) // Everything fits in the head
+		return false;
+	if (m_readPosition < m_headEnd || m_readPosition >= m_end)
+		m_readPosition = m_headEnd;
+
+	/* A chunk that failed to load last time is retried first. It never goes
+	back to m_free from here: the realtime thread is its only producer. */
+
+	int index = m_failedChunk;
+	if (index != -1)
+		m_failedChunk = -1;
+	else if (!m_free.pop(index))
+		return false;
+
+	Chunk& chunk     = m_chunks[index];
+	chunk.position   = m_readPosition;
+	chunk.frames     = read(m_chunkData[index * CHUNK_FRAMES], m_readPosition, std::min(CHUNK_FRAMES, m_end - m_readPosition));
+	chunk.generation = m_readGeneration;
+
+	if (chunk.frames == 0)
+	{
+		u::log::print("[WaveStream::process] unable to read from disk at frame %d\n", m_readPosition);
+		m_failedChunk = index;
+		return false;
+	}
+
+	m_ready.push(index);
+
+	m_readPosition += chunk.frames;
+	if (m_readPosition >= m_end)
+		m_readPosition = m_headEnd;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame WaveStream::readFromDisk(float* dest, Frame position, Frame count)
+{
+	std::scoped_lock lock(m_fileMutex);
+	return read(dest, position, count);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame WaveStream::read(float* dest, Frame position, Frame count)
+{
+	if (count <= 0 || sf_seek(m_file, position, SEEK_SET) == -1)
+		return 0;
+
+	if (m_header.channels == G_MAX_IO_CHANS)
+		return static_cast<Frame>(sf_readf_float(m_file, dest, count));
+
+	Frame done = 0;
+	while (done < count)
+	{
+		const Frame frames = std::min(count - done, m_scratch.countFrames());
+		const Frame read   = static_cast<Frame>(sf_readf_float(m_file, m_scratch[0], frames));
+		for (Frame i = 0; i < read; i++)
+			for (int j = 0; j < G_MAX_IO_CHANS; j++)
+				dest[(done + i) * G_MAX_IO_CHANS + j] = m_scratch[i][0];
+		done += read;
+		if (read < frames)
+			break;
+	}
+	return done;
+}
+
+/* -------------------------------------------------------------------------- */
+
+WaveStream::Window WaveStream::acquire_RT(Frame start, Frame count)
+{
+	count = std::min({count, WINDOW_FRAMES, m_end - start});
+	if (count <= 0)
+		return {};
+
+	/* Reuse what is already in the window, if contiguous. A jump somewhere else
+	(e.g. retrigger, loop) starts a new window. */
+
+	const Frame windowEnd = m_windowStart + m_windowFrames;
+
+	if (start < m_windowStart || start > windowEnd)
+	{
+		m_windowStart  = start;
+		m_windowFrames = 0;
+	}
+	else if (start + count <= windowEnd)
+	{
+		return {m_window[start - m_windowStart], count};
+	}
+	else
+	{
+		const Frame keep = windowEnd - start;
+		std::memmove(m_window[0], m_window[start - m_windowStart], keep * G_MAX_IO_CHANS * sizeof(float));
+		m_windowStart  = start;
+		m_windowFrames = keep;
+	}
+
+	while (m_windowFrames < count)
+	{
+		const Frame copied = copy_RT(m_windowStart + m_windowFrames, count - m_windowFrames);
+		if (copied == 0)
+		{
+			/* Underrun: silence the missing part, which is not kept in the 
+			window so that it can be read again once available. */
+
+			std::fill(m_window[m_windowFrames], m_window[0] + count * G_MAX_IO_CHANS, 0.0f);
+			m_underruns.fetch_add(1);
+			break;
+		}
+		m_windowFrames += copied;
+	}
+
+	return {m_window[0], count};
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame WaveStream::copy_RT(Frame position, Frame count)
+{
+	float* dest = m_window[m_windowFrames];
+
+	if (position < m_begin)
+	{
+		const Frame frames = std::min(count, m_begin - position);
+		std::fill(dest, dest + frames * G_MAX_IO_CHANS, 0.0f);
+		return frames;
+	}
+
+	if (position >= m_headEnd)
+		return copyFromChunk_RT(position, count);
+
+	const Frame frames = std::min(count, m_headEnd - position);
+	std::memcpy(dest, m_head[position - m_begin], frames * G_MAX_IO_CHANS * sizeof(float));
+
+	/* Make sure the I/O thread is ready to take over once the head is over. */
+
+	const bool holdsNext = m_currChunk != -1 && m_chunks[m_currChunk].position == m_headEnd;
+	if (!holdsNext && m_nextPosition != m_headEnd)
+		seek_RT(m_headEnd);
+
+	return frames;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame WaveStream::copyFromChunk_RT(Frame position, Frame count)
+{
+	while (true)
+	{
+		if (m_currChunk != -1)
+		{
+			const Chunk& chunk = m_chunks[m_currChunk];
+			if (position >= chunk.position && position < chunk.position + chunk.frames)
+			{
+				const Frame  frames = std::min(count, chunk.position + chunk.frames - position);
+				const float* src    = m_chunkData[m_currChunk * CHUNK_FRAMES + position - chunk.position];
+				std::memcpy(m_window[m_windowFrames], src, frames * G_MAX_IO_CHANS * sizeof(float));
+				return frames;
+			}
+			releaseChunk_RT();
+		}
+
+		/* Seek if the position is not among the chunks on their way. */
+
+		const bool onItsWay = position >= m_nextPosition && position < m_nextPosition + CHUNK_FRAMES * NUM_CHUNKS;
+		if (!onItsWay)
+		{
+			seek_RT(position);
+			return 0;
+		}
+
+		int index;
+		if (!m_ready.pop(index))
+			return 0;
+
+		const Chunk& chunk = m_chunks[index];
+		if (chunk.generation != m_generation) // Stale chunk from a previous seek
+		{
+			m_free.push(index);
+			continue;
+		}
+
+		m_currChunk    = index;
+		m_nextPosition = chunk.position + chunk.frames;
+		if (m_nextPosition >= m_end)
+			m_nextPosition = m_headEnd;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void WaveStream::seek_RT(Frame position)
+{
+	releaseChunk_RT();
+	m_nextPosition = position;
+	m_seekPosition.store(position);
+	m_seekGeneration.store(++m_generation);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void WaveStream::releaseChunk_RT()
+{
+	if (m_currChunk == -1)
+		return;
+	m_free.push(m_currChunk);
+	m_currChunk = -1;
+}
+} // namespace giada::m
@@ -0,0 +1,190 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_WAVE_STREAM_H
+#define G_WAVE_STREAM_H
+
+#include "core/queue.h"
+#include "core/types.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sndfile.h>
+#include <string>
+
+namespace giada::m
+{
+class WaveStreamer;
+class WaveStream final
+{
+public:
+	/* CHUNK_FRAMES, NUM_CHUNKS
+	Size and number of the chunks read ahead from disk. Roughly 6 seconds of
+	audio at 44.1 kHz. */
+
+	static constexpr Frame CHUNK_FRAMES = 16384;
+	static constexpr int   NUM_CHUNKS   = 16;
+
+	/* HEAD_FRAMES
+	How many frames are kept in memory, starting from the 'begin' point. They
+	cover the time it takes to seek back to the beginning on a retrigger. */
+
+	static constexpr Frame HEAD_FRAMES = 65536;
+
+	/* WINDOW_FRAMES
+	Max number of contiguous frames returned by acquire_RT(). Large enough to 
+	feed the resampler with the biggest buffer at the highest pitch. */
+
+	static constexpr Frame WINDOW_FRAMES = 32768;
+
+	/* Window
+	A contiguous, read-only portion of audio data. Always stereo. */
+
+	struct Window
+	{
+		const float* data   = nullptr;
+		Frame        frames = 0;
+	};
+
+	/* open
+	Opens the file at 'path' for streaming. Returns nullptr on failure. */
+
+	static std::unique_ptr<WaveStream> open(const std::string& path);
+
+	~WaveStream();
+
+	const SF_INFO&     getInfo() const;
+	const std::string& getPath() const;
+	Frame              countFrames() const;
+	int                getRate() const;
+	int                countUnderruns() const;
+
+	/* setRange
+	Sets the region [begin, end) to be streamed, loading its head in memory. The
+	realtime thread must not be reading from this stream in the meantime. */
+
+	void setRange(Frame begin, Frame end);
+
+	/* acquire_RT
+	Returns a window of at most 'count' frames starting at 'start'. Never
+	blocks: data not yet available from disk is zeroed out and counted as an
+	underrun. The window is valid until the next call. Realtime thread only. */
+
+	Window acquire_RT(Frame start, Frame count);
+
+	/* readFromDisk
+	Reads 'count' frames starting at 'position' straight from the file, outside
+	of the streaming machinery. Any thread but the realtime one. */
+
+	Frame readFromDisk(float* dest, Frame position, Frame count);
+
+	/* process
+	Reads the next chunk from disk, if there is room for it. Returns true if
+	there is still work to do. I/O thread only. */
+
+	bool process();
+
+private:
+	friend class WaveStreamer;
+
+	/* Chunk
+	Position, length and seek generation of a chunk read from disk. */
+
+	struct Chunk
+	{
+		Frame    position   = 0;
+		Frame    frames     = 0;
+		uint32_t generation = 0;
+	};
+
+	WaveStream(SNDFILE*, const SF_INFO&, const std::string& path);
+
+	/* read
+	Reads 'count' frames from the file into 'dest', starting at 'position'. Mono
+	files are expanded to stereo. Returns the number of frames read. */
+
+	Frame read(float* dest, Frame position, Frame count);
+
+	/* copy_RT
+	Appends frames to the window from the head or from the chunks. Returns the
+	number of frames appended. */
+
+	Frame copy_RT(Frame position, Frame count);
+	Frame copyFromChunk_RT(Frame position, Frame count);
+
+	/* seek_RT
+	Asks the I/O thread to restart reading from 'position'. Chunks belonging to
+	previous seeks will be discarded. */
+
+	void seek_RT(Frame position);
+
+	void releaseChunk_RT();
+
+	SNDFILE*    m_file;
+	SF_INFO     m_header;
+	std::string m_path;
+	std::mutex  m_fileMutex;
+
+	Frame m_begin;
+	Frame m_end;
+	Frame m_headEnd;
+
+	mcl::AudioBuffer m_head;
+	mcl::AudioBuffer m_chunkData;
+	mcl::AudioBuffer m_scratch; // Mono-to-stereo conversion, under m_fileMutex
+
+	std::array<Chunk, NUM_CHUNKS> m_chunks;
+	Queue<int, NUM_CHUNKS + 1>    m_ready; // I/O thread -> realtime thread
+	Queue<int, NUM_CHUNKS + 1>    m_free;  // Realtime thread -> I/O thread
+	std::atomic<Frame>            m_seekPosition;
+	std::atomic<uint32_t>         m_seekGeneration;
+	std::atomic<int>              m_underruns;
+
+	/* Realtime thread state. */
+
+	mcl::AudioBuffer m_window;
+	Frame            m_windowStart;
+	Frame            m_windowFrames;
+	int              m_currChunk; // -1 if none
+	Frame            m_nextPosition;
+	uint32_t         m_generation;
+
+	/* I/O thread state. */
+
+	Frame    m_readPosition;
+	uint32_t m_readGeneration;
+	int      m_failedChunk; // -1 if none
+	int      m_loggedUnderruns;
+
+	std::shared_ptr<WaveStreamer> m_streamer;
+};
+} // namespace giada::m
+
+#endif
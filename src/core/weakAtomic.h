@@ -76,6 +76,20 @@ public:
 		m_value = t;
 	}
 
+	/* compare_exchange_strong
+	Stores 't' only if the current value is still 'expected'. Otherwise loads the
+	current value into 'expected' and returns false. */
+
+	bool compare_exchange_strong(T& expected, T t)
+	{
+		if (!m_atomic.compare_exchange_strong(expected, t, std::memory_order_relaxed))
+			return false;
+		if (onChange != nullptr && t != m_value)
+			onChange(t);
+		m_value = t;
+		return true;
+	}
+
 	std::function<void(T)> onChange = nullptr;
 
 private:
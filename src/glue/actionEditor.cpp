@@ -86,6 +86,13 @@ Data getData(ID channelId)
 
 /* -------------------------------------------------------------------------- */
 
+m::Action getAction(ID id)
+{
+	return g_engine.getActionEditorApi().getAction(id);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void recordMidiAction(ID channelId, int note, int velocity, Frame f1, Frame f2)
 {
 	g_engine.getActionEditorApi().recordMidiAction(channelId, note, velocity, f1, f2);
@@ -73,6 +73,12 @@ struct Data
 
 Data getData(ID channelId);
 
+/* getAction
+Returns the action with ID 'id', or an invalid one if not found (e.g. orphaned
+composite actions). */
+
+m::Action getAction(ID id);
+
 /* MIDI actions.  */
 
 void recordMidiAction(ID channelId, int note, int velocity, Frame f1,
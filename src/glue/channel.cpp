@@ -99,6 +99,8 @@ SampleData::SampleData(const m::Channel& ch)
 , end(ch.samplePlayer->end)
 , inputMonitor(ch.audioReceiver->inputMonitor)
 , overdubProtection(ch.audioReceiver->overdubProtection)
+, isStreamed(ch.samplePlayer->hasStreamedWave())
+, canStream(!ch.samplePlayer->hasLogicalWave() && !ch.samplePlayer->hasEditedWave())
 , m_tracker(&ch.shared->tracker)
 {
 }
@@ -247,6 +249,17 @@ void setOverdubProtection(ID channelId, bool value)
 
 /* -------------------------------------------------------------------------- */
 
+void setStreaming(ID channelId, bool value)
+{
+	auto progress = g_ui.mainWindow->getScopedProgress(g_ui.getI18Text(v::LangMap::MESSAGE_CHANNEL_LOADINGSAMPLES));
+
+	const int res = g_engine.getChannelsApi().setStreaming(channelId, value);
+	if (res != G_RES_OK)
+		printLoadError_(res);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void cloneChannel(ID channelId)
 {
 	g_engine.getChannelsApi().clone(channelId);
@@ -308,21 +321,21 @@ void setCallbacks(m::Channel& ch)
 
 /* -------------------------------------------------------------------------- */
 
-void pressChannel(ID channelId, int velocity, Thread t)
+void pressChannel(ID channelId, int velocity, Thread t, Frame localFrame)
 {
-	g_engine.getChannelsApi().press(channelId, velocity);
+	g_engine.getChannelsApi().press(channelId, velocity, localFrame);
 	notifyChannelForMidiIn(t, channelId);
 }
 
-void releaseChannel(ID channelId, Thread t)
+void releaseChannel(ID channelId, Thread t, Frame localFrame)
 {
-	g_engine.getChannelsApi().release(channelId);
+	g_engine.getChannelsApi().release(channelId, localFrame);
 	notifyChannelForMidiIn(t, channelId);
 }
 
-void killChannel(ID channelId, Thread t)
+void killChannel(ID channelId, Thread t, Frame localFrame)
 {
-	g_engine.getChannelsApi().kill(channelId);
+	g_engine.getChannelsApi().kill(channelId, localFrame);
 	notifyChannelForMidiIn(t, channelId);
 }
 
@@ -65,6 +65,8 @@ struct SampleData
 	Frame            end;
 	bool             inputMonitor;
 	bool             overdubProtection;
+	bool             isStreamed;
+	bool             canStream;
 
 private:
 	WeakAtomic<Frame>* m_tracker;
@@ -163,6 +165,7 @@ Sets several channel properties. */
 
 void setInputMonitor(ID channelId, bool value);
 void setOverdubProtection(ID channelId, bool value);
+void setStreaming(ID channelId, bool value);
 void setName(ID channelId, const std::string& name);
 void setHeight(ID channelId, Pixel p);
 
@@ -179,9 +182,9 @@ Call this whenever you add a new channel. */
 
 void setCallbacks(m::Channel&);
 
-void  pressChannel(ID channelId, int velocity, Thread t);
-void  releaseChannel(ID channelId, Thread t);
-void  killChannel(ID channelId, Thread t);
+void  pressChannel(ID channelId, int velocity, Thread t, Frame localFrame = 0);
+void  releaseChannel(ID channelId, Thread t, Frame localFrame = 0);
+void  killChannel(ID channelId, Thread t, Frame localFrame = 0);
 float setChannelVolume(ID channelId, float v, Thread t, bool repaintMainUi = false);
 float setChannelPitch(ID channelId, float v, Thread t);
 float sendChannelPan(ID channelId, float v); // FIXME typo: should be setChannelPan
@@ -197,6 +197,8 @@ BehaviorsData getBehaviorsData()
 	behaviorsData.treatRecsAsLoops           = layout.treatRecsAsLoops;
 	behaviorsData.inputMonitorDefaultOn      = layout.inputMonitorDefaultOn;
 	behaviorsData.overdubProtectionDefaultOn = layout.overdubProtectionDefaultOn;
+	behaviorsData.progressiveLoading         = layout.progressiveLoading;
+	behaviorsData.compressProjectAudio       = layout.compressProjectAudio;
 	return behaviorsData;
 }
 
@@ -279,6 +281,8 @@ void save(const BehaviorsData& data)
 	layout.treatRecsAsLoops           = data.treatRecsAsLoops;
 	layout.inputMonitorDefaultOn      = data.inputMonitorDefaultOn;
 	layout.overdubProtectionDefaultOn = data.overdubProtectionDefaultOn;
+	layout.progressiveLoading         = data.progressiveLoading;
+	layout.compressProjectAudio       = data.compressProjectAudio;
 	g_engine.setLayout(layout);
 }
 
@@ -125,6 +125,8 @@ struct BehaviorsData
 	bool treatRecsAsLoops;
 	bool inputMonitorDefaultOn;
 	bool overdubProtectionDefaultOn;
+	bool progressiveLoading;
+	bool compressProjectAudio;
 };
 
 /* get*
@@ -79,6 +79,15 @@ void openBrowserForProjectSave()
 
 /* -------------------------------------------------------------------------- */
 
+void openBrowserForBounce()
+{
+	v::gdWindow* childWin = new v::gdBrowserSave(g_ui.getI18Text(v::LangMap::BROWSER_BOUNCELOOP),
+	    g_ui.model.samplePath, g_engine.getPatch().name, c::storage::bounceLoop, 0, g_ui.model);
+	g_ui.openSubWindow(*g_ui.mainWindow.get(), childWin, WID_FILE_BROWSER);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void openBrowserForSampleLoad(ID channelId)
 {
 	v::gdWindow* w = new v::gdBrowserLoad(g_ui.getI18Text(v::LangMap::BROWSER_OPENSAMPLE),
@@ -50,6 +50,7 @@ namespace giada::c::layout
 {
 void openBrowserForProjectLoad();
 void openBrowserForProjectSave();
+void openBrowserForBounce();
 void openBrowserForSampleLoad(ID channelId);
 void openBrowserForSampleSave(ID channelId);
 void openAboutWindow();
@@ -52,6 +52,7 @@
 #include <FL/Fl.H>
 #include <cassert>
 #include <cmath>
+#include <ctime>
 
 extern giada::v::Ui     g_ui;
 extern giada::m::Engine g_engine;
@@ -100,6 +101,36 @@ bool IO::isKernelReady()
 	return g_engine.isAudioReady();
 }
 
+/* -------------------------------------------------------------------------- */
+
+float IO::getDspLoad() { return g_engine.getMainApi().getDspLoad(); }
+float IO::getDspLoadPeak() { return g_engine.getMainApi().getDspLoadPeak(); }
+int   IO::countXruns() { return g_engine.getMainApi().countXruns(); }
+int   IO::countDroppedEvents() { return g_engine.getMainApi().countDroppedEvents(); }
+
+/* -------------------------------------------------------------------------- */
+
+std::string IO::getXrunsInfo()
+{
+	std::string out;
+	for (const m::KernelAudio::Xrun& xrun : g_engine.getMainApi().getXruns())
+	{
+		const std::time_t time = static_cast<std::time_t>(xrun.time / 1000);
+
+		char buf[32];
+		std::strftime(buf, sizeof(buf), "%H:%M:%S", std::localtime(&time));
+
+		out += u::string::format("%s.%03d ", buf, static_cast<int>(xrun.time % 1000));
+		if (xrun.inputOverflow && xrun.outputUnderflow)
+			out += "input overflow, output underflow\n";
+		else if (xrun.inputOverflow)
+			out += "input overflow\n";
+		else
+			out += "output underflow\n";
+	}
+	return out;
+}
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
@@ -273,6 +304,10 @@ void toggleInputRecording() { g_engine.getMainApi().toggleInputRecording(); }
 
 /* -------------------------------------------------------------------------- */
 
+void collectGarbage() { g_engine.collectGarbage(); }
+
+/* -------------------------------------------------------------------------- */
+
 #ifdef G_DEBUG_MODE
 
 void printDebugInfo()
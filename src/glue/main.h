@@ -28,6 +28,7 @@
 #define G_MAIN_H
 
 #include "core/types.h"
+#include <string>
 
 /* giada::c::main
 Functions to interact with the tools in the main window. Only the main thread 
@@ -69,9 +70,24 @@ struct IO
 	bool  masterInHasPlugins;
 	bool  inToOut;
 
-	Peak getMasterOutPeak();
-	Peak getMasterInPeak();
-	bool isKernelReady();
+	Peak  getMasterOutPeak();
+	Peak  getMasterInPeak();
+	bool  isKernelReady();
+	float getDspLoad();
+	float getDspLoadPeak();
+	int   countXruns();
+
+	/* getXrunsInfo
+	Returns a human-readable list of the latest xruns, one per line, with the 
+	time they occurred at. */
+
+	std::string getXrunsInfo();
+
+	/* countDroppedEvents
+	Returns the number of engine events dropped so far because the event queue
+	was full. */
+
+	int countDroppedEvents();
 };
 
 struct Sequencer
@@ -138,6 +154,12 @@ void toggleActionRecording();
 void stopInputRecording();
 void toggleInputRecording();
 
+/* collectGarbage
+Frees engine data removed in the meantime, such as deleted plug-ins. Called
+periodically by the UI updater. */
+
+void collectGarbage();
+
 #ifdef G_DEBUG_MODE
 void printDebugInfo();
 #endif
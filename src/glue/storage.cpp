@@ -112,6 +112,16 @@ void loadProject(void* data)
 
 /* -------------------------------------------------------------------------- */
 
+void attachLoadedWaves()
+{
+	const m::StorageApi::LoadState state = g_engine.getStorageApi().attachLoadedWaves();
+
+	if (!state.isGood())
+		layout::openMissingAssetsWindow(state);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void saveProject(void* data)
 {
 	v::gdBrowserSave* browser = static_cast<v::gdBrowserSave*>(data);
@@ -191,4 +201,39 @@ void saveSample(void* data)
 
 	browser->do_callback();
 }
+
+/* -------------------------------------------------------------------------- */
+
+void bounceLoop(void* data)
+{
+	v::gdBrowserSave* browser    = static_cast<v::gdBrowserSave*>(data);
+	const std::string name       = browser->getName();
+	const std::string folderPath = browser->getCurrentPath();
+
+	if (name == "")
+	{
+		v::gdAlert(g_ui.getI18Text(v::LangMap::MESSAGE_STORAGE_CHOOSEFILENAME));
+		return;
+	}
+
+	const std::string filePath = u::fs::join(folderPath, u::fs::stripExt(name) + ".wav");
+
+	if (u::fs::fileExists(filePath) &&
+	    !v::gdConfirmWin(g_ui.getI18Text(v::LangMap::COMMON_WARNING),
+	        g_ui.getI18Text(v::LangMap::MESSAGE_STORAGE_FILEEXISTS)))
+		return;
+
+	const Frame                       framesInLoop = g_engine.getMainApi().getFramesInLoop();
+	const m::OfflineRenderer::Request req          = {{0, framesInLoop}, WaveFormat::WAV, {{m::Mixer::MASTER_OUT_CHANNEL_ID, filePath}}};
+
+	auto uiProgress     = g_ui.mainWindow->getScopedProgress(g_ui.getI18Text(v::LangMap::MESSAGE_STORAGE_BOUNCING));
+	auto engineProgress = [&uiProgress](float v) { uiProgress.setProgress(v); };
+
+	if (g_engine.getStorageApi().bounce(req, engineProgress) != G_RES_OK)
+		v::gdAlert(g_ui.getI18Text(v::LangMap::MESSAGE_STORAGE_BOUNCINGERROR));
+	else
+		g_ui.model.samplePath = folderPath;
+
+	browser->do_callback();
+}
 } // namespace giada::c::storage
\ No newline at end of file
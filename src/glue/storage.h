@@ -36,6 +36,17 @@ void loadProject(void* data);
 void saveProject(void* data);
 void saveSample(void* data);
 void loadSample(void* data);
+
+/* bounceLoop
+Renders one loop of the master output to a WAV file, faster than realtime. */
+
+void bounceLoop(void* data);
+
+/* attachLoadedWaves
+Hands the Waves loaded in background to their channels. Opens the missing 
+assets window once loading is over, if some of them failed. */
+
+void attachLoadedWaves();
 } // namespace giada::c::storage
 
 #endif
@@ -68,7 +68,7 @@ void geSampleActionEditor::rebuild(c::actionEditor::Data& d)
 		if (a1.event.getStatus() == m::MidiEvent::CHANNEL_CC || isNoteOffSinglePress(a1))
 			continue;
 
-		const m::Action& a2 = a1.next != nullptr ? *a1.next : m::Action{};
+		const m::Action a2 = c::actionEditor::getAction(a1.nextId);
 
 		Pixel px = x() + m_base->frameToPixel(a1.frame);
 		Pixel py = y() + 4;
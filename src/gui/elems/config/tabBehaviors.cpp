@@ -48,11 +48,15 @@ geTabBehaviors::geTabBehaviors(geompp::Rect<int> bounds)
 		m_treatRecsAsLoops           = new geCheck(0, 0, 0, 0, g_ui.getI18Text(LangMap::CONFIG_BEHAVIORS_TREATRECSASLOOPS));
 		m_inputMonitorDefaultOn      = new geCheck(0, 0, 0, 0, g_ui.getI18Text(LangMap::CONFIG_BEHAVIORS_INPUTMONITORDEFAULTON));
 		m_overdubProtectionDefaultOn = new geCheck(0, 0, 0, 0, g_ui.getI18Text(LangMap::CONFIG_BEHAVIORS_OVERDUBPROTECTIONDEFAULTON));
+		m_progressiveLoading         = new geCheck(0, 0, 0, 0, g_ui.getI18Text(LangMap::CONFIG_BEHAVIORS_PROGRESSIVELOADING));
+		m_compressProjectAudio       = new geCheck(0, 0, 0, 0, g_ui.getI18Text(LangMap::CONFIG_BEHAVIORS_COMPRESSPROJECTAUDIO));
 
 		body->add(m_chansStopOnSeqHalt, 30);
 		body->add(m_treatRecsAsLoops, 20);
 		body->add(m_inputMonitorDefaultOn, 20);
-		body->add(m_overdubProtectionDefaultOn, 30);
+		body->add(m_overdubProtectionDefaultOn, 20);
+		body->add(m_progressiveLoading, 20);
+		body->add(m_compressProjectAudio, 30);
 		body->end();
 	};
 
@@ -70,6 +74,12 @@ geTabBehaviors::geTabBehaviors(geompp::Rect<int> bounds)
 
 	m_overdubProtectionDefaultOn->value(m_data.overdubProtectionDefaultOn);
 	m_overdubProtectionDefaultOn->onChange = [this](bool v) { m_data.overdubProtectionDefaultOn = v; };
+
+	m_progressiveLoading->value(m_data.progressiveLoading);
+	m_progressiveLoading->onChange = [this](bool v) { m_data.progressiveLoading = v; };
+
+	m_compressProjectAudio->value(m_data.compressProjectAudio);
+	m_compressProjectAudio->onChange = [this](bool v) { m_data.compressProjectAudio = v; };
 }
 
 /* -------------------------------------------------------------------------- */
@@ -48,6 +48,8 @@ private:
 	geCheck* m_treatRecsAsLoops;
 	geCheck* m_inputMonitorDefaultOn;
 	geCheck* m_overdubProtectionDefaultOn;
+	geCheck* m_progressiveLoading;
+	geCheck* m_compressProjectAudio;
 };
 } // namespace giada::v
 
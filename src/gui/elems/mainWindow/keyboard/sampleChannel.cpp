@@ -55,6 +55,7 @@ enum class Menu
 {
 	INPUT_MONITOR = 0,
 	OVERDUB_PROTECTION,
+	STREAM_FROM_DISK,
 	LOAD_SAMPLE,
 	EXPORT_SAMPLE,
 	SETUP_KEYBOARD_INPUT,
@@ -165,7 +166,9 @@ void geSampleChannel::openMenu()
 	menu.addItem((ID)Menu::INPUT_MONITOR, g_ui.getI18Text(LangMap::MAIN_CHANNEL_MENU_INPUTMONITOR),
 	    FL_MENU_TOGGLE | (m_channel.sample->inputMonitor ? FL_MENU_VALUE : 0));
 	menu.addItem((ID)Menu::OVERDUB_PROTECTION, g_ui.getI18Text(LangMap::MAIN_CHANNEL_MENU_OVERDUBPROTECTION),
-	    FL_MENU_TOGGLE | FL_MENU_DIVIDER | (m_channel.sample->overdubProtection ? FL_MENU_VALUE : 0));
+	    FL_MENU_TOGGLE | (m_channel.sample->overdubProtection ? FL_MENU_VALUE : 0));
+	menu.addItem((ID)Menu::STREAM_FROM_DISK, g_ui.getI18Text(LangMap::MAIN_CHANNEL_MENU_STREAMFROMDISK),
+	    FL_MENU_TOGGLE | FL_MENU_DIVIDER | (m_channel.sample->isStreamed ? FL_MENU_VALUE : 0));
 	menu.addItem((ID)Menu::LOAD_SAMPLE, g_ui.getI18Text(LangMap::MAIN_CHANNEL_MENU_LOADSAMPLE));
 	menu.addItem((ID)Menu::EXPORT_SAMPLE, g_ui.getI18Text(LangMap::MAIN_CHANNEL_MENU_EXPORTSAMPLE));
 	menu.addItem((ID)Menu::SETUP_KEYBOARD_INPUT, g_ui.getI18Text(LangMap::MAIN_CHANNEL_MENU_KEYBOARDINPUT));
@@ -188,6 +191,14 @@ void geSampleChannel::openMenu()
 		menu.setEnabled((ID)Menu::RENAME_CHANNEL, false);
 	}
 
+	/* Only Waves coming straight from a file can be streamed. Streamed Waves
+	have no audio data in memory to edit. */
+
+	if (m_channel.sample->waveId == 0 || !m_channel.sample->canStream)
+		menu.setEnabled((ID)Menu::STREAM_FROM_DISK, false);
+	if (m_channel.sample->isStreamed)
+		menu.setEnabled((ID)Menu::EDIT_SAMPLE, false);
+
 	if (!m_channel.hasActions)
 		menu.setEnabled((ID)Menu::CLEAR_ACTIONS, false);
 
@@ -202,6 +213,10 @@ void geSampleChannel::openMenu()
 			c::channel::setOverdubProtection(channel.id, !channel.sample->overdubProtection);
 			break;
 
+		case Menu::STREAM_FROM_DISK:
+			c::channel::setStreaming(channel.id, !channel.sample->isStreamed);
+			break;
+
 		case Menu::LOAD_SAMPLE:
 			c::layout::openBrowserForSampleLoad(channel.id);
 			break;
@@ -29,6 +29,7 @@
 #include "glue/channel.h"
 #include "glue/layout.h"
 #include "glue/main.h"
+#include "gui/elems/basics/box.h"
 #include "gui/elems/basics/dial.h"
 #include "gui/elems/basics/imageButton.h"
 #include "gui/elems/basics/textButton.h"
@@ -37,6 +38,8 @@
 #include "gui/graphics.h"
 #include "gui/ui.h"
 #include "utils/gui.h"
+#include "utils/string.h"
+#include <fmt/core.h>
 
 extern giada::v::Ui g_ui;
 
@@ -44,6 +47,9 @@ namespace giada::v
 {
 geMainIO::geMainIO()
 : geFlex(Direction::HORIZONTAL, G_GUI_INNER_MARGIN)
+, m_dspLoadValue(-1)
+, m_xrunsValue(-1)
+, m_droppedEventsValue(-1)
 {
 	m_outMeter     = new geSoundMeter(0, 0, 0, 0);
 	m_inMeter      = new geSoundMeter(0, 0, 0, 0);
@@ -53,6 +59,8 @@ geMainIO::geMainIO()
 	m_masterFxOut  = new geImageButton(graphics::fxOff, graphics::fxOn);
 	m_masterFxIn   = new geImageButton(graphics::fxOff, graphics::fxOn);
 	m_midiActivity = new geMidiActivity();
+	m_dspLoad      = new geBox("", FL_ALIGN_RIGHT | FL_ALIGN_INSIDE);
+	m_xruns        = new geBox("", FL_ALIGN_RIGHT | FL_ALIGN_INSIDE);
 
 	add(m_masterFxIn, G_GUI_UNIT);
 	add(m_inVol, G_GUI_UNIT);
@@ -62,6 +70,8 @@ geMainIO::geMainIO()
 	add(m_outVol, G_GUI_UNIT);
 	add(m_masterFxOut, G_GUI_UNIT);
 	add(m_midiActivity, 10);
+	add(m_dspLoad, 36);
+	add(m_xruns, 36);
 	end();
 
 	m_outMeter->copy_tooltip(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_OUTMETER));
@@ -72,6 +82,8 @@ geMainIO::geMainIO()
 	m_masterFxOut->copy_tooltip(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_FXOUT));
 	m_masterFxIn->copy_tooltip(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_FXIN));
 	m_midiActivity->copy_tooltip(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_MIDIACTIVITY));
+	m_dspLoad->copy_tooltip(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_DSPLOAD));
+	m_xruns->copy_tooltip(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_XRUNS));
 
 	m_outVol->onChange = [](float v) {
 		c::main::setMasterOutVolume(v, Thread::MAIN);
@@ -119,6 +131,34 @@ void geMainIO::refresh()
 	m_outMeter->redraw();
 	m_inMeter->redraw();
 	m_midiActivity->redraw();
+
+	/* DSP load and xruns labels are updated only on change, to avoid a costly 
+	label copy and redraw on each refresh. Dropped events are reported along 
+	with xruns: both mean the engine couldn't keep up. */
+
+	const int dspLoad = static_cast<int>(m_io.getDspLoad() * 100.0f);
+	if (dspLoad != m_dspLoadValue)
+	{
+		m_dspLoadValue = dspLoad;
+		m_dspLoad->copy_label(u::string::format("%d%%", dspLoad).c_str());
+		m_dspLoad->labelcolor(m_io.getDspLoadPeak() >= 1.0f ? G_COLOR_BLUE : G_COLOR_LIGHT_2);
+	}
+
+	const int xruns         = m_io.countXruns();
+	const int droppedEvents = m_io.countDroppedEvents();
+	if (xruns != m_xrunsValue || droppedEvents != m_droppedEventsValue)
+	{
+		m_xrunsValue         = xruns;
+		m_droppedEventsValue = droppedEvents;
+
+		std::string tooltip = std::string(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_XRUNS)) + "\n\n" + m_io.getXrunsInfo();
+		if (droppedEvents > 0)
+			tooltip += "\n" + fmt::format(fmt::runtime(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_DROPPED)), droppedEvents);
+
+		m_xruns->copy_label(fmt::format(fmt::runtime(g_ui.getI18Text(LangMap::MAIN_IO_LABEL_XRUNS_COUNT)), xruns).c_str());
+		m_xruns->labelcolor(xruns > 0 || droppedEvents > 0 ? G_COLOR_BLUE : G_COLOR_LIGHT_2);
+		m_xruns->copy_tooltip(tooltip.c_str());
+	}
 }
 
 /* -------------------------------------------------------------------------- */
@@ -32,6 +32,7 @@
 
 namespace giada::v
 {
+class geBox;
 class geDial;
 class geSoundMeter;
 class geTextButton;
@@ -63,6 +64,12 @@ private:
 	geImageButton*  m_masterFxOut;
 	geImageButton*  m_masterFxIn;
 	geMidiActivity* m_midiActivity;
+	geBox*          m_dspLoad;
+	geBox*          m_xruns;
+
+	int m_dspLoadValue;
+	int m_xrunsValue;
+	int m_droppedEventsValue;
 };
 } // namespace giada::v
 
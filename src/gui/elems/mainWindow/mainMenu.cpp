@@ -46,6 +46,7 @@ enum class FileMenu
 {
 	OPEN_PROJECT = 0,
 	SAVE_PROJECT,
+	BOUNCE_LOOP,
 	CLOSE_PROJECT,
 #ifdef G_DEBUG_MODE
 	DEBUG_STATS,
@@ -92,6 +93,7 @@ void geMainMenu::cb_file()
 
 	menu.addItem((ID)FileMenu::OPEN_PROJECT, g_ui.getI18Text(LangMap::MAIN_MENU_FILE_OPENPROJECT));
 	menu.addItem((ID)FileMenu::SAVE_PROJECT, g_ui.getI18Text(LangMap::MAIN_MENU_FILE_SAVEPROJECT));
+	menu.addItem((ID)FileMenu::BOUNCE_LOOP, g_ui.getI18Text(LangMap::MAIN_MENU_FILE_BOUNCELOOP));
 	menu.addItem((ID)FileMenu::CLOSE_PROJECT, g_ui.getI18Text(LangMap::MAIN_MENU_FILE_CLOSEPROJECT));
 #ifdef G_DEBUG_MODE
 	menu.addItem((ID)FileMenu::DEBUG_STATS, "Debug stats");
@@ -107,6 +109,9 @@ void geMainMenu::cb_file()
 		case FileMenu::SAVE_PROJECT:
 			c::layout::openBrowserForProjectSave();
 			break;
+		case FileMenu::BOUNCE_LOOP:
+			c::layout::openBrowserForBounce();
+			break;
 		case FileMenu::CLOSE_PROJECT:
 			c::main::closeProject();
 			break;
@@ -90,10 +90,13 @@ LangMap::LangMap()
 	m_data[MESSAGE_STORAGE_CHOOSEFILENAME]     = "Please choose a file name.";
 	m_data[MESSAGE_STORAGE_FILEEXISTS]         = "File exists: overwrite?";
 	m_data[MESSAGE_STORAGE_SAVINGFILEERROR]    = "Unable to save this sample!";
+	m_data[MESSAGE_STORAGE_BOUNCING]           = "Bouncing loop...";
+	m_data[MESSAGE_STORAGE_BOUNCINGERROR]      = "Unable to bounce the loop!";
 
 	m_data[MAIN_MENU_FILE]                 = "File";
 	m_data[MAIN_MENU_FILE_OPENPROJECT]     = "Open project...";
 	m_data[MAIN_MENU_FILE_SAVEPROJECT]     = "Save project...";
+	m_data[MAIN_MENU_FILE_BOUNCELOOP]      = "Bounce loop...";
 	m_data[MAIN_MENU_FILE_CLOSEPROJECT]    = "Close project";
 	m_data[MAIN_MENU_FILE_QUIT]            = "Quit Giada";
 	m_data[MAIN_MENU_EDIT]                 = "Edit";
@@ -112,6 +115,11 @@ LangMap::LangMap()
 	m_data[MAIN_IO_LABEL_FXIN]         = "Main input plug-ins";
 	m_data[MAIN_IO_LABEL_MIDIACTIVITY] = "Master MIDI I/O activity\n\nNotifies MIDI messages sent (top) or "
 	                                     "received (bottom) globally.";
+	m_data[MAIN_IO_LABEL_DSPLOAD]      = "DSP load\n\nTime spent rendering audio, relative to the buffer "
+	                                     "period. Approaching 100% leads to xruns: increase the buffer size.";
+	m_data[MAIN_IO_LABEL_XRUNS]        = "Xruns\n\nAudio buffer over/underflows reported by the audio driver.";
+	m_data[MAIN_IO_LABEL_XRUNS_COUNT]  = "{} xr";
+	m_data[MAIN_IO_LABEL_DROPPED]      = "{} engine events dropped (e.g. JACK transport changes): the event queue was full.";
 
 	m_data[MAIN_TIMER_LABEL_BPM]        = "Beats per minute (BPM)";
 	m_data[MAIN_TIMER_LABEL_METER]      = "Beats and bars";
@@ -141,6 +149,7 @@ LangMap::LangMap()
 
 	m_data[MAIN_CHANNEL_NOSAMPLE]          = "-- no sample --";
 	m_data[MAIN_CHANNEL_SAMPLENOTFOUND]    = "* file not found! *";
+	m_data[MAIN_CHANNEL_LOADINGSAMPLE]     = "loading...";
 	m_data[MAIN_CHANNEL_LABEL_PLAY]        = "Play/stop";
 	m_data[MAIN_CHANNEL_LABEL_ARM]         = "Arm for recording";
 	m_data[MAIN_CHANNEL_LABEL_STATUS]      = "Progress bar";
@@ -156,6 +165,7 @@ LangMap::LangMap()
 
 	m_data[MAIN_CHANNEL_MENU_INPUTMONITOR]           = "Input monitor";
 	m_data[MAIN_CHANNEL_MENU_OVERDUBPROTECTION]      = "Overdub protection";
+	m_data[MAIN_CHANNEL_MENU_STREAMFROMDISK]         = "Stream from disk";
 	m_data[MAIN_CHANNEL_MENU_LOADSAMPLE]             = "Load new sample...";
 	m_data[MAIN_CHANNEL_MENU_EXPORTSAMPLE]           = "Export sample to file...";
 	m_data[MAIN_CHANNEL_MENU_KEYBOARDINPUT]          = "Setup keyboard input...";
@@ -235,6 +245,7 @@ LangMap::LangMap()
 	m_data[BROWSER_SAVEPROJECT]     = "Save project";
 	m_data[BROWSER_OPENSAMPLE]      = "Open sample";
 	m_data[BROWSER_SAVESAMPLE]      = "Save sample";
+	m_data[BROWSER_BOUNCELOOP]      = "Bounce loop";
 	m_data[BROWSER_OPENPLUGINSDIR]  = "Open plug-ins directory";
 
 	m_data[MIDIINPUT_MASTER_TITLE]           = "MIDI Input Setup (global)";
@@ -318,6 +329,8 @@ LangMap::LangMap()
 	m_data[CONFIG_BEHAVIORS_TREATRECSASLOOPS]           = "Treat one shot channels with actions as loops";
 	m_data[CONFIG_BEHAVIORS_INPUTMONITORDEFAULTON]      = "New sample channels have input monitor on by default";
 	m_data[CONFIG_BEHAVIORS_OVERDUBPROTECTIONDEFAULTON] = "New sample channels have overdub protection on by default";
+	m_data[CONFIG_BEHAVIORS_PROGRESSIVELOADING]         = "Load project samples in background, channels play as soon as ready";
+	m_data[CONFIG_BEHAVIORS_COMPRESSPROJECTAUDIO]       = "Store project samples as FLAC when lossless";
 
 	m_data[CONFIG_BINDINGS_TITLE]         = "Key Bindings";
 	m_data[CONFIG_BINDINGS_PLAY]          = "Play";
@@ -95,10 +95,13 @@ public:
 	static constexpr auto MESSAGE_STORAGE_CHOOSEFILENAME     = "message_storage_chooseFileName";
 	static constexpr auto MESSAGE_STORAGE_FILEEXISTS         = "message_storage_fileExists";
 	static constexpr auto MESSAGE_STORAGE_SAVINGFILEERROR    = "message_storage_savingFileError";
+	static constexpr auto MESSAGE_STORAGE_BOUNCING           = "message_storage_bouncing";
+	static constexpr auto MESSAGE_STORAGE_BOUNCINGERROR      = "message_storage_bouncingError";
 
 	static constexpr auto MAIN_MENU_FILE                 = "main_menu_file";
 	static constexpr auto MAIN_MENU_FILE_OPENPROJECT     = "main_menu_file_openProject";
 	static constexpr auto MAIN_MENU_FILE_SAVEPROJECT     = "main_menu_file_saveProject";
+	static constexpr auto MAIN_MENU_FILE_BOUNCELOOP      = "main_menu_file_bounceLoop";
 	static constexpr auto MAIN_MENU_FILE_CLOSEPROJECT    = "main_menu_file_closeProject";
 	static constexpr auto MAIN_MENU_FILE_QUIT            = "main_menu_file_quit";
 	static constexpr auto MAIN_MENU_EDIT                 = "main_menu_edit";
@@ -116,6 +119,10 @@ public:
 	static constexpr auto MAIN_IO_LABEL_FXOUT        = "main_IO_label_fxOut";
 	static constexpr auto MAIN_IO_LABEL_FXIN         = "main_IO_label_fxIn";
 	static constexpr auto MAIN_IO_LABEL_MIDIACTIVITY = "main_IO_label_midiActivity";
+	static constexpr auto MAIN_IO_LABEL_DSPLOAD      = "main_IO_label_dspLoad";
+	static constexpr auto MAIN_IO_LABEL_XRUNS        = "main_IO_label_xruns";
+	static constexpr auto MAIN_IO_LABEL_XRUNS_COUNT  = "main_IO_label_xrunsCount";
+	static constexpr auto MAIN_IO_LABEL_DROPPED      = "main_IO_label_dropped";
 
 	static constexpr auto MAIN_TIMER_LABEL_BPM        = "main_mainTimer_label_bpm";
 	static constexpr auto MAIN_TIMER_LABEL_METER      = "main_mainTimer_label_meter";
@@ -140,6 +147,7 @@ public:
 
 	static constexpr auto MAIN_CHANNEL_NOSAMPLE           = "main_channel_noSample";
 	static constexpr auto MAIN_CHANNEL_SAMPLENOTFOUND     = "main_channel_sampleNotFound";
+	static constexpr auto MAIN_CHANNEL_LOADINGSAMPLE      = "main_channel_loadingSample";
 	static constexpr auto MAIN_CHANNEL_LABEL_PLAY         = "main_channel_label_play";
 	static constexpr auto MAIN_CHANNEL_LABEL_ARM          = "main_channel_label_arm";
 	static constexpr auto MAIN_CHANNEL_LABEL_STATUS       = "main_channel_label_status";
@@ -153,6 +161,7 @@ public:
 
 	static constexpr auto MAIN_CHANNEL_MENU_INPUTMONITOR           = "main_channel_menu_inputMonitor";
 	static constexpr auto MAIN_CHANNEL_MENU_OVERDUBPROTECTION      = "main_channel_menu_overdubProtection";
+	static constexpr auto MAIN_CHANNEL_MENU_STREAMFROMDISK         = "main_channel_menu_streamFromDisk";
 	static constexpr auto MAIN_CHANNEL_MENU_LOADSAMPLE             = "main_channel_menu_loadSample";
 	static constexpr auto MAIN_CHANNEL_MENU_EXPORTSAMPLE           = "main_channel_menu_exportSample";
 	static constexpr auto MAIN_CHANNEL_MENU_KEYBOARDINPUT          = "main_channel_menu_keyboardInput";
@@ -232,6 +241,7 @@ public:
 	static constexpr auto BROWSER_SAVEPROJECT     = "browser_saveProject";
 	static constexpr auto BROWSER_OPENSAMPLE      = "browser_openSample";
 	static constexpr auto BROWSER_SAVESAMPLE      = "browser_saveSample";
+	static constexpr auto BROWSER_BOUNCELOOP      = "browser_bounceLoop";
 	static constexpr auto BROWSER_OPENPLUGINSDIR  = "browser_openPluginsDir";
 
 	static constexpr auto MIDIINPUT_MASTER_TITLE           = "midiInput_master_title";
@@ -309,6 +319,8 @@ public:
 	static constexpr auto CONFIG_BEHAVIORS_TREATRECSASLOOPS           = "config_behaviors_treatRecsAsLoops";
 	static constexpr auto CONFIG_BEHAVIORS_INPUTMONITORDEFAULTON      = "config_behaviors_inputMonitorDefaultOn";
 	static constexpr auto CONFIG_BEHAVIORS_OVERDUBPROTECTIONDEFAULTON = "config_behaviors_overdubProtectionDefaultOn";
+	static constexpr auto CONFIG_BEHAVIORS_PROGRESSIVELOADING         = "config_behaviors_progressiveLoading";
+	static constexpr auto CONFIG_BEHAVIORS_COMPRESSPROJECTAUDIO       = "config_behaviors_compressProjectAudio";
 
 	static constexpr auto CONFIG_BINDINGS_TITLE         = "config_bindings_title";
 	static constexpr auto CONFIG_BINDINGS_PLAY          = "config_bindings_play";
@@ -34,6 +34,7 @@
 #include "gui/updater.h"
 #include "utils/gui.h"
 #include "utils/log.h"
+#include "utils/trace.h"
 #include <FL/Fl.H>
 #include <FL/Fl_Tooltip.H>
 #if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
@@ -175,6 +176,8 @@ bool Ui::pumpEvent(const Updater::Event& e)
 
 void Ui::refresh()
 {
+	const u::trace::Scope trace("ui_refresh");
+
 	/* Update dynamic elements inside main window: in and out meters, beat meter
 	and each channel. */
 
@@ -194,6 +197,8 @@ void Ui::refresh()
 
 void Ui::rebuild()
 {
+	const u::trace::Scope trace("ui_rebuild");
+
 	mainWindow->rebuild();
 	rebuildSubWindow(WID_FX_LIST);
 	rebuildSubWindow(WID_SAMPLE_EDITOR);
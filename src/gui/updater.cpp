@@ -27,6 +27,7 @@
 #include "gui/updater.h"
 #include "core/const.h"
 #include "core/model/model.h"
+#include "glue/main.h"
 #include "gui/ui.h"
 #include "utils/gui.h"
 
@@ -64,6 +65,7 @@ void Updater::update(void* p) { static_cast<Updater*>(p)->update(); }
 
 void Updater::update()
 {
+	c::main::collectGarbage();
 	m_ui.refresh();
 	Fl::add_timeout(G_GUI_REFRESH_RATE, update, this); // Repeat
 }
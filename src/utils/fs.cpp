@@ -185,6 +185,12 @@ std::string getLangMapsPath()
 	return out.string();
 }
 
+std::string getWaveCachePath()
+{
+	auto out = stdfs::path(getHomePath()) / "cache";
+	return out.string();
+}
+
 /* -------------------------------------------------------------------------- */
 
 bool createConfigFolder()
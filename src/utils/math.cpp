@@ -26,6 +26,7 @@
 
 #include "math.h"
 #include <cmath>
+#include <cstring>
 
 namespace giada
 {
@@ -49,6 +50,39 @@ int quantize(int x, int step)
 
 /* -------------------------------------------------------------------------- */
 
+int nextMultiple(int x, int step)
+{
+	assert(x >= 0 && step > 0);
+	return ((x + step - 1) / step) * step;
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t hash(const void* data, std::size_t size)
+{
+	constexpr uint64_t K = 0x9E3779B97F4A7C15ull;
+
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t             h     = size * K;
+
+	std::size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t w;
+		std::memcpy(&w, bytes + i, sizeof(uint64_t));
+		h = (h ^ w) * K;
+		h ^= h >> 32;
+	}
+	for (; i < size; i++)
+	{
+		h = (h ^ bytes[i]) * K;
+		h ^= h >> 32;
+	}
+	return h;
+}
+
+/* -------------------------------------------------------------------------- */
+
 float dBtoLinear(float f)
 {
 	return std::pow(10, f / 20.0f);
@@ -28,6 +28,8 @@
 #define G_UTILS_MATH_H
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 namespace giada::u::math
@@ -36,6 +38,18 @@ float linearToDB(float f);
 float dBtoLinear(float f);
 int   quantize(int x, int step);
 
+/* nextMultiple
+Returns the smallest multiple of 'step' greater than or equal to 'x'. 'x' must
+be >= 0, 'step' > 0. */
+
+int nextMultiple(int x, int step);
+
+/* hash
+Fast non-cryptographic 64-bit hash of 'size' bytes of 'data'. Good enough to
+tell contents apart, not to defend against malicious input. */
+
+uint64_t hash(const void* data, std::size_t size);
+
 /* -------------------------------------------------------------------------- */
 
 /* map (1)
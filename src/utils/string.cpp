@@ -115,6 +115,8 @@ std::string toString(Thread t)
 		return "AUDIO (rt)";
 	case Thread::EVENTS:
 		return "EVENTS";
+	case Thread::RENDER:
+		return "RENDER";
 	default:
 		return "(unknown)";
 	}
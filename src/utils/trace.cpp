@@ -0,0 +1,292 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "utils/trace.h"
+#include "core/const.h"
+#include "core/queue.h"
+#include "core/worker.h"
+#include "utils/log.h"
+#include "utils/string.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace giada::u::trace
+{
+namespace
+{
+struct Event
+{
+	const char*  name     = nullptr;
+	std::int64_t start    = 0;
+	std::int64_t duration = 0;
+};
+
+/* Buffer
+Events pushed by a single thread. Buffers are recycled: when its thread exits 
+a buffer is RELEASED, then made FREE again by the flusher once its last 
+events have been written. Each thread gets a new 'tid' in the timeline. 'name'
+is the thread name (see makeName_(), -1 if unknown), 'writtenName' the one 
+last written to file, flusher only. */
+
+struct Buffer
+{
+	enum State : int
+	{
+		FREE,
+		CLAIMING,
+		TAKEN,
+		RELEASED
+	};
+
+	m::Queue<Event, G_MAX_TRACE_EVENTS> queue;
+	std::atomic<int>                    state       = FREE;
+	std::atomic<int>                    name        = -1;
+	int                                 tid         = 0;
+	int                                 writtenName = -1;
+};
+
+/* Owner
+Releases the buffer of a thread when the thread exits. */
+
+struct Owner
+{
+	~Owner()
+	{
+		if (buffer != nullptr)
+			buffer->state.store(Buffer::RELEASED, std::memory_order_release);
+	}
+
+	Buffer* buffer = nullptr;
+};
+
+/* buffers_
+Allocated on the first init() and never freed, so that threads can keep a
+pointer to their own buffer without any synchronization. */
+
+std::unique_ptr<Buffer[]> buffers_;
+std::atomic<int>          nextTid_          = 1;
+std::atomic<int>          droppedEvents_    = 0;
+std::atomic<int>          untracedThreads_  = 0;
+int                       reportedUntraced_ = 0;
+std::FILE*                file_             = nullptr;
+bool                      firstEvent_       = true;
+std::int64_t              origin_           = 0;
+Worker                    worker_(G_TRACE_FLUSH_RATE_MS);
+
+/* buffer_, owner_
+Per-thread state. 'owner_' has a destructor, whose registration might 
+allocate on first use: it's only touched by setThread(), never by push(). */
+
+thread_local Buffer* buffer_ = nullptr;
+thread_local Owner   owner_;
+
+/* -------------------------------------------------------------------------- */
+
+/* makeName_
+Packs a Thread value and its index (0 if none) into a single int, to be 
+stored atomically. */
+
+int makeName_(Thread t, int index)
+{
+	return static_cast<int>(t) | (index << 8);
+}
+
+std::string toString_(int name)
+{
+	if (name == -1)
+		return "(unknown)";
+	const std::string thread = u::string::toString(static_cast<Thread>(name & 0xFF));
+	const int         index  = name >> 8;
+	return index > 0 ? u::string::format("%s %d", thread.c_str(), index) : thread;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* claimBuffer_
+Claims a free buffer for the calling thread, named 'name'. Lock-free. Returns
+nullptr if all buffers are taken. */
+
+Buffer* claimBuffer_(int name)
+{
+	for (int i = 0; i < G_MAX_TRACE_THREADS; i++)
+	{
+		Buffer& b    = buffers_[i];
+		int     free = Buffer::FREE;
+		if (!b.state.compare_exchange_strong(free, Buffer::CLAIMING, std::memory_order_acquire))
+			continue;
+
+		b.tid = nextTid_.fetch_add(1);
+		b.name.store(name, std::memory_order_relaxed);
+		b.state.store(Buffer::TAKEN, std::memory_order_release);
+
+		owner_.buffer = &b;
+		return &b;
+	}
+
+	untracedThreads_.fetch_add(1);
+	return nullptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void write_(const std::string& json)
+{
+	std::fprintf(file_, "%s\n%s", firstEvent_ ? "" : ",", json.c_str());
+	firstEvent_ = false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* flush_
+Writes pending events of all threads to file, then recycles the buffers of
+the threads that have exited. */
+
+void flush_()
+{
+	for (int i = 0; i < G_MAX_TRACE_THREADS; i++)
+	{
+		Buffer&   b     = buffers_[i];
+		const int state = b.state.load(std::memory_order_acquire);
+		if (state == Buffer::FREE || state == Buffer::CLAIMING)
+			continue;
+
+		const int tid = b.tid;
+
+		if (const int name = b.name.load(std::memory_order_relaxed); name != b.writtenName)
+		{
+			write_(u::string::format(R"({"name":"thread_name","ph":"M","pid":1,"tid":%d,"args":{"name":"%s"}})", tid, toString_(name).c_str()));
+			b.writtenName = name;
+		}
+
+		Event e;
+		while (b.queue.pop(e))
+		{
+			const double ts = (e.start - origin_) / 1000.0; // Microseconds
+			if (e.duration < 0)
+				write_(u::string::format(R"({"name":"%s","ph":"i","s":"t","pid":1,"tid":%d,"ts":%.3f})", e.name, tid, ts));
+			else
+				write_(u::string::format(R"({"name":"%s","ph":"X","pid":1,"tid":%d,"ts":%.3f,"dur":%.3f})", e.name, tid, ts, e.duration / 1000.0));
+		}
+
+		if (state == Buffer::RELEASED)
+		{
+			b.writtenName = -1;
+			b.state.store(Buffer::FREE, std::memory_order_release);
+		}
+	}
+	std::fflush(file_);
+
+	if (const int untraced = untracedThreads_.load(); untraced != reportedUntraced_)
+	{
+		u::log::print("[trace] Out of thread buffers, %d threads not traced\n", untraced);
+		reportedUntraced_ = untraced;
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+bool init(const std::string& path)
+{
+	if (isEnabled())
+		return false;
+
+	file_ = std::fopen(path.c_str(), "w");
+	if (file_ == nullptr)
+	{
+		u::log::print("[trace::init] Can't open trace file %s\n", path);
+		return false;
+	}
+
+	if (buffers_ == nullptr)
+		buffers_ = std::make_unique<Buffer[]>(G_MAX_TRACE_THREADS);
+
+	std::fprintf(file_, "[");
+	firstEvent_ = true;
+	origin_     = now();
+	droppedEvents_.store(0);
+
+	worker_.start(flush_);
+	enabled.store(true);
+
+	u::log::print("[trace::init] Recording trace to %s\n", path);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void close()
+{
+	if (!isEnabled())
+		return;
+
+	enabled.store(false);
+	worker_.stop();
+	flush_();
+
+	std::fprintf(file_, "\n]\n");
+	std::fclose(file_);
+	file_ = nullptr;
+
+	u::log::print("[trace::close] Trace closed, %d events dropped, %d threads not traced\n",
+	    droppedEvents_.load(), untracedThreads_.load());
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::int64_t now()
+{
+	const auto t = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void setThread(Thread t, int index)
+{
+	/* Buffers exist only if recording was started, which happens before any 
+	thread is spawned. */
+
+	const int name = makeName_(t, index);
+	if (buffer_ != nullptr)
+		buffer_->name.store(name, std::memory_order_relaxed);
+	else if (buffers_ != nullptr)
+		buffer_ = claimBuffer_(name);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void push(const char* name, std::int64_t start, std::int64_t duration)
+{
+	if (buffer_ == nullptr || !buffer_->queue.push({name, start, duration}))
+		droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace giada::u::trace
@@ -0,0 +1,116 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_UTILS_TRACE_H
+#define G_UTILS_TRACE_H
+
+#include "core/types.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/* giada::u::trace
+Timeline recorder. Writes Chrome trace-event JSON (viewable in Perfetto or
+chrome://tracing) with the events traced by any thread. Each thread pushes 
+events into its own lock-free buffer, a background thread flushes them to 
+file. When not recording, tracing an event costs a single branch. Event names 
+must be string literals: only the pointer is stored. */
+
+namespace giada::u::trace
+{
+inline std::atomic<bool> enabled = false;
+
+/* init
+Starts recording to file 'path'. Returns false if the file can't be opened. */
+
+bool init(const std::string& path);
+
+/* close
+Stops recording, flushes pending events and closes the file. */
+
+void close();
+
+/* isEnabled
+Tells whether recording is active. Realtime-safe. */
+
+inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+/* now
+Returns the current time in nanoseconds, on the trace clock. */
+
+std::int64_t now();
+
+/* setThread
+Names the calling thread in the timeline, followed by 'index' if > 0 (e.g. 
+"RENDER 2"), and claims its buffer if recording. Threads that never call it 
+are not traced. Not realtime-safe: claiming a buffer might allocate once, to
+release it on thread exit. Call it on thread setup. */
+
+void setThread(Thread, int index = 0);
+
+/* push
+Records an event that started at 'start' and lasted 'duration' nanoseconds.
+A negative duration records an instant event. Realtime-safe: events are 
+dropped if the thread buffer is full, or if the thread has no buffer (see 
+setThread(), G_MAX_TRACE_THREADS live threads at most). */
+
+void push(const char* name, std::int64_t start, std::int64_t duration);
+
+/* instant
+Records an event with no duration, e.g. a message sent. */
+
+inline void instant(const char* name)
+{
+	if (isEnabled())
+		push(name, now(), -1);
+}
+
+/* Scope
+Records the time spent in a C++ scope. */
+
+class Scope
+{
+public:
+	Scope(const char* name)
+	: m_name(isEnabled() ? name : nullptr)
+	, m_start(m_name != nullptr ? now() : 0)
+	{
+	}
+
+	~Scope()
+	{
+		if (m_name != nullptr)
+			push(m_name, m_start, now() - m_start);
+	}
+
+private:
+	const char*  m_name;
+	std::int64_t m_start;
+};
+} // namespace giada::u::trace
+
+#endif
@@ -0,0 +1,125 @@
+#include "../src/core/actions/actionTimeline.h"
+#include "../src/core/actions/action.h"
+#include "../src/core/midiEvent.h"
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEST_CASE("ActionTimeline")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const auto makeAction = [](ID id, ID channelId, Frame frame, int note = 0) {
+		Action a;
+		a.id        = id;
+		a.channelId = channelId;
+		a.frame     = frame;
+		a.event     = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_ON, note, 0x7F);
+		return a;
+	};
+
+	/* Not sorted on purpose. Actions 2 and 5 sit on the same frame and channel:
+	they must keep this order. */
+
+	const ActionTimeline timeline({
+	    makeAction(1, /*channel=*/2, /*frame=*/100),
+	    makeAction(2, /*channel=*/1, /*frame=*/50, /*note=*/1),
+	    makeAction(3, /*channel=*/2, /*frame=*/50),
+	    makeAction(4, /*channel=*/1, /*frame=*/0),
+	    makeAction(5, /*channel=*/1, /*frame=*/50, /*note=*/2),
+	});
+
+	const auto getIds = [](const auto& actions) {
+		std::vector<ID> out;
+		for (const Action& a : actions)
+			out.push_back(a.id);
+		return out;
+	};
+
+	SECTION("Test ordering")
+	{
+		REQUIRE(timeline.size() == 5);
+		REQUIRE(getIds(timeline.getAll()) == std::vector<ID>{4, 2, 5, 3, 1});
+	}
+
+	SECTION("Test ranges")
+	{
+		REQUIRE(getIds(timeline.getActionsOnFrame(50)) == std::vector<ID>{2, 5, 3});
+		REQUIRE(timeline.getActionsOnFrame(51).empty());
+		REQUIRE(getIds(timeline.getActionsInRange(1, 101)) == std::vector<ID>{2, 5, 3, 1});
+		REQUIRE(getIds(ActionTimeline::getChannelActions(timeline.getActionsOnFrame(50), 1)) == std::vector<ID>{2, 5});
+		REQUIRE(getIds(ActionTimeline::getChannelActions(timeline.getActionsOnFrame(50), 2)) == std::vector<ID>{3});
+	}
+
+	SECTION("Test find")
+	{
+		for (ID id = 1; id <= 5; id++)
+		{
+			REQUIRE(timeline.find(id) != nullptr);
+			REQUIRE(timeline.find(id)->id == id);
+		}
+		REQUIRE(timeline.find(6) == nullptr);
+	}
+
+	SECTION("Test channel index")
+	{
+		REQUIRE(getIds(timeline.getActionsOnChannel(1)) == std::vector<ID>{4, 2, 5});
+		REQUIRE(getIds(timeline.getActionsOnChannel(2)) == std::vector<ID>{3, 1});
+		REQUIRE(timeline.getActionsOnChannel(3).empty());
+		REQUIRE(timeline.hasActions(1));
+		REQUIRE(timeline.hasActions(1, MidiEvent::CHANNEL_NOTE_ON));
+		REQUIRE(!timeline.hasActions(1, MidiEvent::CHANNEL_CC));
+		REQUIRE(!timeline.hasActions(3));
+		REQUIRE(timeline.contains(1, 50, MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_ON, 2, 0x7F)));
+		REQUIRE(!timeline.contains(2, 50, MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_ON, 2, 0x7F)));
+	}
+
+	SECTION("Test adding actions")
+	{
+		Action a6 = makeAction(6, /*channel=*/1, /*frame=*/50, /*note=*/3);
+		Action a7 = makeAction(7, /*channel=*/2, /*frame=*/200);
+		Action a8 = makeAction(8, /*channel=*/1, /*frame=*/10);
+		a8.nextId = 7;
+		a7.prevId = 8;
+
+		const ActionTimeline added = timeline.withActions({a7, a6, a8});
+
+		/* New actions on the same frame and channel of existing ones come after
+		them. The original timeline is untouched. */
+
+		REQUIRE(getIds(added.getAll()) == std::vector<ID>{4, 8, 2, 5, 6, 3, 1, 7});
+		REQUIRE(getIds(added.getActionsOnChannel(1)) == std::vector<ID>{4, 8, 2, 5, 6});
+		REQUIRE(getIds(added.getActionsOnFrame(50)) == std::vector<ID>{2, 5, 6, 3});
+		REQUIRE(timeline.size() == 5);
+
+		/* Sibling links are kept. */
+
+		REQUIRE(added.find(added.find(8)->nextId)->id == 7);
+		REQUIRE(added.find(added.find(7)->prevId)->id == 8);
+	}
+
+	SECTION("Test removing actions")
+	{
+		const ActionTimeline removed = timeline.withoutActions([](const Action& a) { return a.channelId == 1; });
+
+		REQUIRE(getIds(removed.getAll()) == std::vector<ID>{3, 1});
+		REQUIRE(removed.find(2) == nullptr);
+		REQUIRE(removed.find(1) != nullptr);
+		REQUIRE(!removed.hasActions(1));
+		REQUIRE(getIds(removed.getActionsOnFrame(50)) == std::vector<ID>{3});
+	}
+
+	SECTION("Test editing a copy")
+	{
+		ActionTimeline copy(timeline);
+
+		copy.find(4)->nextId = 1;
+		copy.find(1)->prevId = 4;
+
+		REQUIRE(copy.find(4)->nextId == 1);
+		REQUIRE(copy.find(1)->prevId == 4);
+		REQUIRE(timeline.find(4)->nextId == 0);
+		REQUIRE(timeline.find(1)->prevId == 0);
+		REQUIRE(getIds(copy.getActionsOnChannel(1)) == getIds(timeline.getActionsOnChannel(1)));
+	}
+}
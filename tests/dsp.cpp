@@ -0,0 +1,192 @@
+#include "../src/core/dsp.h"
+#include "../src/core/types.h"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace giada;
+using namespace giada::m;
+
+TEST_CASE("dsp")
+{
+	/* Every kernel must give the very same result of the scalar one, for sizes
+	that don't fit exactly in SIMD registers too. */
+
+	const auto makeData = [](int size, unsigned seed) {
+		std::mt19937                          gen(seed);
+		std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+		std::vector<float>                    v(size);
+		for (float& f : v)
+			f = dist(gen);
+		return v;
+	};
+
+	const auto run = [](dsp::Isa isa, auto f) {
+		REQUIRE(dsp::setIsa(isa));
+		return f();
+	};
+
+	const dsp::Isa best = dsp::getIsa();
+
+	for (dsp::Isa isa : {dsp::Isa::SSE2, dsp::Isa::AVX2})
+	{
+		if (!dsp::setIsa(isa))
+			continue;
+
+		for (int frames : {0, 1, 3, 4, 7, 8, 9, 17, 64, 257})
+		{
+			const std::vector<float> a = makeData(frames * 2, frames);
+			const std::vector<float> b = makeData(frames * 2, frames + 1);
+
+			/* Copy, sum, gain. */
+			{
+				std::vector<float> ref = a, out = a;
+				run(dsp::Isa::SCALAR, [&] { dsp::copy(ref.data(), b.data(), frames * 2, 0.7f); });
+				run(isa, [&] { dsp::copy(out.data(), b.data(), frames * 2, 0.7f); });
+				REQUIRE(out == ref);
+
+				run(dsp::Isa::SCALAR, [&] { dsp::sum(ref.data(), b.data(), frames * 2, 0.3f); });
+				run(isa, [&] { dsp::sum(out.data(), b.data(), frames * 2, 0.3f); });
+				REQUIRE(out == ref);
+
+				run(dsp::Isa::SCALAR, [&] { dsp::applyGain(ref.data(), frames * 2, 1.3f); });
+				run(isa, [&] { dsp::applyGain(out.data(), frames * 2, 1.3f); });
+				REQUIRE(out == ref);
+			}
+
+			/* Pan and sum. */
+			{
+				std::vector<float> ref = a, out = a;
+				run(dsp::Isa::SCALAR, [&] { dsp::sumStereo(ref.data(), b.data(), frames, 0.2f, 0.8f); });
+				run(isa, [&] { dsp::sumStereo(out.data(), b.data(), frames, 0.2f, 0.8f); });
+				REQUIRE(out == ref);
+
+				run(dsp::Isa::SCALAR, [&] { dsp::sumMonoToStereo(ref.data(), b.data(), frames, 0.6f, 0.4f); });
+				run(isa, [&] { dsp::sumMonoToStereo(out.data(), b.data(), frames, 0.6f, 0.4f); });
+				REQUIRE(out == ref);
+			}
+
+			/* Clamp and peak, NaN included. */
+			{
+				std::vector<float> ref = a, out = a;
+				if (frames > 0)
+					ref[0] = out[0] = std::numeric_limits<float>::quiet_NaN();
+
+				run(dsp::Isa::SCALAR, [&] { dsp::clamp(ref.data(), frames * 2, -1.0f, 1.0f); });
+				run(isa, [&] { dsp::clamp(out.data(), frames * 2, -1.0f, 1.0f); });
+				REQUIRE(out == ref);
+
+				const Peak refPeak = run(dsp::Isa::SCALAR, [&] { return dsp::getStereoPeak(a.data(), frames); });
+				const Peak peak    = run(isa, [&] { return dsp::getStereoPeak(a.data(), frames); });
+				REQUIRE(peak.left == refPeak.left);
+				REQUIRE(peak.right == refPeak.right);
+
+				const float refMono = run(dsp::Isa::SCALAR, [&] { return dsp::getPeak(a.data(), frames * 2); });
+				REQUIRE(run(isa, [&] { return dsp::getPeak(a.data(), frames * 2); }) == refMono);
+				REQUIRE(refMono == std::max(refPeak.left, refPeak.right));
+			}
+		}
+	}
+
+	SECTION("test AudioBuffer")
+	{
+		mcl::AudioBuffer out, mono;
+		out.alloc(9, 2);
+		mono.alloc(9, 1);
+		for (int i = 0; i < 9; i++)
+			mono[i][0] = i % 2 == 0 ? 0.5f : -1.5f;
+
+		dsp::sum(out, mono, 0.5f, {1.0f, 0.0f});
+		dsp::clamp(out, -0.5f, 0.5f);
+
+		const Peak peak = dsp::getPeak(out);
+		REQUIRE(out[1][0] == -0.5f);
+		REQUIRE(out[1][1] == 0.0f);
+		REQUIRE(peak.left == 0.5f);
+		REQUIRE(peak.right == 0.0f);
+	}
+
+	SECTION("test ramps")
+	{
+		mcl::AudioBuffer out, src;
+		out.alloc(4, 2);
+		src.alloc(4, 2);
+		src.forEachFrame([](float* f, int) {
+			f[0] = 1.0f;
+			f[1] = 1.0f;
+		});
+
+		dsp::set(out, src, SmoothedParam::Ramp{0.0f, 1.0f});
+		REQUIRE(out[0][0] == 0.0f);
+		REQUIRE(out[2][1] == 0.5f);
+		REQUIRE(out[3][0] == 0.75f);
+
+		dsp::applyGain(out, SmoothedParam::Ramp{1.0f, 0.0f});
+		REQUIRE(out[0][0] == 0.0f);
+		REQUIRE(out[2][1] == 0.25f);
+
+		/* Flat ramps take the steady path. */
+
+		out.clear();
+		dsp::sum(out, src, SmoothedParam::Ramp{0.5f, 0.5f}, SmoothedParam::Ramp{0.5f, 0.5f});
+		REQUIRE(out[3][0] == 0.5f);
+		REQUIRE(out[3][1] == 0.5f);
+
+		/* Panning moves from center (pass-through) to hard right. */
+
+		out.clear();
+		dsp::sum(out, src, SmoothedParam::Ramp{1.0f, 1.0f}, SmoothedParam::Ramp{0.5f, 1.0f});
+		REQUIRE(out[0][0] == 1.0f);
+		REQUIRE(out[0][1] == 1.0f);
+		REQUIRE(out[2][0] == 0.25f);
+		REQUIRE(out[2][1] == 0.75f);
+
+		/* Summing at an offset: the ramp follows the source frames. */
+
+		out.clear();
+		dsp::sum(out, src, SmoothedParam::Ramp{0.0f, 1.0f}, /*destOffset=*/2);
+		REQUIRE(out[1][0] == 0.0f);
+		REQUIRE(out[2][0] == 0.0f);
+		REQUIRE(out[3][0] == 0.25f);
+	}
+
+	dsp::setIsa(best);
+}
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("dsp benchmark", "[.][benchmark]")
+{
+	/* Sums 64 stereo channels into a block, like the Mixer does, then applies 
+	gain, limiter and peak detection. */
+
+	constexpr int CHANNELS = 64;
+	constexpr int FRAMES   = 512;
+
+	std::vector<std::vector<float>> channels(CHANNELS, std::vector<float>(FRAMES * 2, 0.01f));
+	std::vector<float>              out(FRAMES * 2);
+
+	const dsp::Isa best = dsp::getIsa();
+
+	for (const auto& [isa, name] : {std::pair{dsp::Isa::SCALAR, "scalar"}, {dsp::Isa::SSE2, "SSE2"}, {dsp::Isa::AVX2, "AVX2"}})
+	{
+		if (!dsp::setIsa(isa))
+			continue;
+
+		BENCHMARK(std::string("Mix ") + std::to_string(CHANNELS) + " channels, " + name)
+		{
+			std::fill(out.begin(), out.end(), 0.0f);
+			for (const std::vector<float>& c : channels)
+				dsp::sumStereo(out.data(), c.data(), FRAMES, 0.4f, 0.6f);
+			dsp::applyGain(out.data(), FRAMES * 2, 0.9f);
+			dsp::clamp(out.data(), FRAMES * 2, -1.0f, 1.0f);
+			return dsp::getPeak(out.data(), FRAMES * 2);
+		};
+	}
+
+	dsp::setIsa(best);
+}
@@ -0,0 +1,260 @@
+#include "../src/core/channels/idleTracker.h"
+#include "../src/core/channels/channelFactory.h"
+#include "../src/core/midiEvent.h"
+#include <catch2/catch.hpp>
+#include <limits>
+
+TEST_CASE("IdleTracker")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	constexpr int BUFFER_SIZE  = 1024;
+	constexpr int NUM_CHANNELS = 2;
+
+	mcl::AudioBuffer buffer(BUFFER_SIZE, NUM_CHANNELS);
+	IdleTracker      tracker;
+	int              tailQueries = 0;
+
+	/* fill
+	Fills the buffer with a constant level, as if something was rendered. */
+
+	const auto fill = [&buffer](float level) {
+		buffer.forEachFrame([level](float* f, int) {
+			f[0] = level;
+			f[1] = level;
+		});
+	};
+
+	const auto tail = [&tailQueries](Frame frames) {
+		return [&tailQueries, frames]() {
+			tailQueries++;
+			return frames;
+		};
+	};
+
+	SECTION("Test initialization")
+	{
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == IdleTracker::NO_TAIL);
+	}
+
+	SECTION("Test input keeps the channel awake")
+	{
+		for (int i = 0; i < 8; i++)
+			tracker.update(/*input=*/true, buffer, tail(0));
+
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == IdleTracker::NO_TAIL);
+		REQUIRE(tailQueries == 0);
+	}
+
+	SECTION("Test idle on silence, without tail")
+	{
+		tracker.update(/*input=*/false, buffer, tail(0));
+
+		REQUIRE(tracker.isIdle() == true);
+		REQUIRE(tailQueries == 1);
+	}
+
+	SECTION("Test tail countdown")
+	{
+		tracker.update(/*input=*/false, buffer, tail(BUFFER_SIZE * 2 + 10));
+
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == BUFFER_SIZE + 10);
+
+		tracker.update(/*input=*/false, buffer, tail(BUFFER_SIZE * 2 + 10));
+
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == 10);
+
+		tracker.update(/*input=*/false, buffer, tail(BUFFER_SIZE * 2 + 10));
+
+		REQUIRE(tracker.isIdle() == true);
+		REQUIRE(tracker.getTailLeft() == 0);
+		REQUIRE(tailQueries == 1); // Queried once, when the input stops
+	}
+
+	SECTION("Test infinite tail never expires")
+	{
+		for (int i = 0; i < 1000; i++)
+			tracker.update(/*input=*/false, buffer, tail(std::numeric_limits<Frame>::max()));
+
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == std::numeric_limits<Frame>::max());
+	}
+
+	SECTION("Test -120 dB gate")
+	{
+		/* Above the threshold: a release still sounding, or a plug-in that
+		reports no tail while ringing. Never cut. */
+
+		fill(IdleTracker::SILENCE * 2.0f);
+		for (int i = 0; i < 8; i++)
+			tracker.update(/*input=*/false, buffer, tail(0));
+
+		REQUIRE(tracker.isIdle() == false);
+
+		/* Below the threshold: idle, and the residual is cleared. */
+
+		fill(IdleTracker::SILENCE / 2.0f);
+		tracker.update(/*input=*/false, buffer, tail(0));
+
+		REQUIRE(tracker.isIdle() == true);
+		REQUIRE(buffer[0][0] == 0.0f);
+		REQUIRE(buffer[BUFFER_SIZE - 1][1] == 0.0f);
+	}
+
+	SECTION("Test release is not cut")
+	{
+		/* The input stops while the sound decays by -6 dB per block: the
+		channel must stay awake until the level drops below -120 dB. */
+
+		tracker.update(/*input=*/true, buffer, tail(0));
+
+		float level  = 1.0f;
+		int   blocks = 0;
+		while (level >= IdleTracker::SILENCE)
+		{
+			fill(level);
+			tracker.update(/*input=*/false, buffer, tail(0));
+			REQUIRE(tracker.isIdle() == false);
+			level /= 2.0f;
+			blocks++;
+		}
+
+		fill(level);
+		tracker.update(/*input=*/false, buffer, tail(0));
+
+		REQUIRE(tracker.isIdle() == true);
+		REQUIRE(blocks == 20);
+	}
+
+	SECTION("Test wake on input")
+	{
+		tracker.update(/*input=*/false, buffer, tail(BUFFER_SIZE));
+
+		REQUIRE(tracker.isIdle() == true);
+
+		tracker.wake();
+		tracker.update(/*input=*/true, buffer, tail(BUFFER_SIZE));
+
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == IdleTracker::NO_TAIL);
+
+		/* The tail is queried again when the new input stops. */
+
+		tracker.update(/*input=*/false, buffer, tail(BUFFER_SIZE * 2));
+
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == BUFFER_SIZE);
+		REQUIRE(tailQueries == 2);
+	}
+
+	SECTION("Test wake on plug-in tail")
+	{
+		/* A plug-in tail that shows up again after a wake (e.g. a reverb fed by
+		the new input) keeps the channel awake for its whole length. */
+
+		tracker.update(/*input=*/false, buffer, tail(0));
+
+		REQUIRE(tracker.isIdle() == true);
+
+		tracker.wake();
+		tracker.update(/*input=*/true, buffer, tail(0));
+		fill(0.5f);
+		tracker.update(/*input=*/false, buffer, tail(BUFFER_SIZE * 4));
+
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == BUFFER_SIZE * 3);
+	}
+
+	SECTION("Test reset")
+	{
+		tracker.update(/*input=*/false, buffer, tail(BUFFER_SIZE * 4));
+		tracker.reset();
+
+		REQUIRE(tracker.isIdle() == false);
+		REQUIRE(tracker.getTailLeft() == IdleTracker::NO_TAIL);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("IdleTracker - channel input")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	SECTION("Test sample channel")
+	{
+		channelFactory::Data data = channelFactory::create(
+		    /*id=*/0,
+		    ChannelType::SAMPLE,
+		    /*columnId=*/0,
+		    /*position=*/0,
+		    /*bufferSize=*/1024,
+		    Resampler::Quality::LINEAR,
+		    /*overdubProtection=*/false);
+
+		Channel& channel = data.channel;
+
+		REQUIRE(channel.hasInput() == false);
+
+		data.shared->playStatus.store(ChannelStatus::PLAY);
+
+		REQUIRE(channel.hasInput() == true);
+
+		data.shared->playStatus.store(ChannelStatus::ENDING);
+
+		REQUIRE(channel.hasInput() == true);
+
+		data.shared->playStatus.store(ChannelStatus::WAIT);
+
+		REQUIRE(channel.hasInput() == false);
+
+		/* Monitored audio input counts only if the channel is armed. */
+
+		channel.audioReceiver->inputMonitor = true;
+
+		REQUIRE(channel.hasInput() == false);
+
+		channel.armed = true;
+
+		REQUIRE(channel.hasInput() == true);
+	}
+
+	SECTION("Test MIDI channel")
+	{
+		channelFactory::Data data = channelFactory::create(
+		    /*id=*/0,
+		    ChannelType::MIDI,
+		    /*columnId=*/0,
+		    /*position=*/0,
+		    /*bufferSize=*/1024,
+		    Resampler::Quality::LINEAR,
+		    /*overdubProtection=*/false);
+
+		Channel& channel = data.channel;
+
+		REQUIRE(channel.hasInput() == false);
+
+		/* Queued MIDI events wake the channel up. */
+
+		data.shared->midiQueue.push(MidiEvent::makeFrom3Bytes(0x90, 60, 100));
+
+		REQUIRE(channel.hasInput() == true);
+
+		MidiEvent e;
+		data.shared->midiQueue.pop(e);
+
+		REQUIRE(channel.hasInput() == false);
+
+		/* A playing MIDI channel never goes idle. */
+
+		data.shared->playStatus.store(ChannelStatus::PLAY);
+
+		REQUIRE(channel.hasInput() == true);
+	}
+}
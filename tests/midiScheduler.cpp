@@ -0,0 +1,346 @@
+#include "../src/core/midiEvent.h"
+#include "../src/core/midiScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST_CASE("MidiScheduler")
+{
+	using namespace giada;
+	using namespace std::chrono;
+
+	constexpr int SAMPLE_RATE  = 44100;
+	constexpr int BUFFER_SIZE  = 256;
+	constexpr int BLOCKS       = 100;
+	constexpr int DELTAS[]     = {0, 64, 128, 255};
+	constexpr int NUM_MESSAGES = BLOCKS * std::size(DELTAS);
+
+	/* Loopback: the onSend callback records the time each message has been
+	actually sent, which is then compared with the time it was due. */
+
+	struct Sent
+	{
+		m::MidiScheduler::Message           msg;
+		m::MidiScheduler::Clock::time_point time;
+	};
+
+	std::vector<Sent> sent;
+	sent.reserve(NUM_MESSAGES);
+	std::atomic<int> numSent = 0;
+
+	m::MidiScheduler scheduler;
+	scheduler.onSend = [&sent, &numSent](const m::MidiScheduler::Message& msg) {
+		sent.push_back({msg, m::MidiScheduler::Clock::now()});
+		numSent.fetch_add(1);
+	};
+	scheduler.start();
+
+	/* Simulate an audio thread that renders a block every BUFFER_SIZE frames,
+	scheduling some MIDI events in it. Block times are injected and lie in the
+	near future, so that the scheduling math doesn't depend on how fast this
+	thread runs. */
+
+	const auto blockLength = duration_cast<m::MidiScheduler::Clock::duration>(duration<double>(BUFFER_SIZE / static_cast<double>(SAMPLE_RATE)));
+	const auto start       = m::MidiScheduler::Clock::now() + milliseconds(10);
+
+	for (int i = 0; i < BLOCKS; i++)
+	{
+		scheduler.beginBlock_RT(SAMPLE_RATE, BUFFER_SIZE, start + blockLength * i);
+		for (const int delta : DELTAS)
+			REQUIRE(scheduler.schedule_RT(m::MidiEvent::makeFrom3Bytes(0x90, delta, 0x7F), delta));
+
+		/* Don't overflow the realtime queue. */
+
+		while (numSent.load() < (i - 8) * static_cast<int>(std::size(DELTAS)))
+			std::this_thread::yield();
+	}
+
+	while (numSent.load() < NUM_MESSAGES)
+		std::this_thread::sleep_for(milliseconds(1));
+	scheduler.stop();
+
+	REQUIRE(sent.size() == NUM_MESSAGES);
+
+	SECTION("Test ordering and sample accuracy")
+	{
+		for (std::size_t i = 1; i < sent.size(); i++)
+		{
+			REQUIRE(sent[i].msg.time >= sent[i - 1].msg.time);
+
+			/* Messages in the same block are spaced according to their delta. */
+
+			const int delta     = sent[i].msg.data[1];
+			const int prevDelta = sent[i - 1].msg.data[1];
+			if (delta > prevDelta)
+			{
+				const double expected = (delta - prevDelta) / static_cast<double>(SAMPLE_RATE);
+				const double actual   = duration<double>(sent[i].msg.time - sent[i - 1].msg.time).count();
+				REQUIRE(actual == Approx(expected).margin(1e-6));
+			}
+		}
+
+		/* The first message is due one block after the first block time. */
+
+		const double firstDelay = duration<double>(sent[0].msg.time - start).count();
+		REQUIRE(firstDelay == Approx(BUFFER_SIZE / static_cast<double>(SAMPLE_RATE)).margin(1e-6));
+	}
+
+	SECTION("Test timing error")
+	{
+		/* Messages are never sent early. How late they are depends on the
+		thread wake-up latency of the test machine, which is not a realtime
+		system: it's reported, not checked. */
+
+		double maxError = 0.0;
+		double sumError = 0.0;
+		for (const Sent& s : sent)
+		{
+			const double error = duration<double, std::milli>(s.time - s.msg.time).count();
+			REQUIRE(error >= 0.0);
+			maxError = std::max(maxError, error);
+			sumError += error;
+		}
+
+		WARN("Timing error: mean " << sumError / sent.size() << " ms, max " << maxError << " ms");
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("MidiScheduler - block clock")
+{
+	using namespace giada;
+	using namespace std::chrono;
+
+	using Clock = m::MidiScheduler::Clock;
+
+	constexpr int    SAMPLE_RATE = 48000;
+	constexpr int    BUFFER_SIZE = 256;
+	constexpr double PERIOD      = BUFFER_SIZE / static_cast<double>(SAMPLE_RATE);
+
+	const Clock::time_point start = Clock::now();
+
+	const auto toTimePoint = [start](double seconds) {
+		return start + duration_cast<Clock::duration>(duration<double>(seconds));
+	};
+	const auto toSeconds = [start](Clock::time_point t) {
+		return duration<double>(t - start).count();
+	};
+
+	m::MidiScheduler scheduler;
+
+	/* Runs 'blocks' audio callbacks on an audio clock 'ppm' parts per million
+	faster than the system one, with callback times randomly delayed by up to
+	'jitter' seconds. Returns the block times of the scheduler. */
+
+	const auto run = [&](int blocks, double ppm, double jitter) {
+		std::mt19937                           gen(1);
+		std::uniform_real_distribution<double> dist(0.0, jitter);
+		std::vector<double>                    out;
+
+		for (int i = 0; i < blocks; i++)
+		{
+			const double t = i * PERIOD / (1.0 + ppm / 1e6);
+			scheduler.beginBlock_RT(SAMPLE_RATE, BUFFER_SIZE, toTimePoint(t + dist(gen)));
+			out.push_back(toSeconds(scheduler.getTime_RT(0)) - PERIOD);
+		}
+		return out;
+	};
+
+	SECTION("Test jitter is filtered out")
+	{
+		const double              jitter = 0.002; // Almost 8 blocks
+		const std::vector<double> times  = run(20000, 0.0, jitter);
+
+		/* After the loop has settled, block times are evenly spaced: no jumps,
+		the jitter is almost gone. */
+
+		double maxDeviation = 0.0;
+		for (std::size_t i = 2000; i < times.size(); i++)
+			maxDeviation = std::max(maxDeviation, std::abs(times[i] - times[i - 1] - PERIOD));
+
+		REQUIRE(maxDeviation < PERIOD * 0.05);
+	}
+
+	SECTION("Test drift is followed")
+	{
+		constexpr double    PPM   = 200.0;
+		std::vector<double> times = run(200000, PPM, 0.0005); // About 18 minutes
+
+		/* The block length converges to the actual one of the audio clock and
+		the block times never drift away from the callback times. */
+
+		const double actualPeriod = PERIOD / (1.0 + PPM / 1e6);
+
+		double maxError = 0.0;
+		for (std::size_t i = 2000; i < times.size(); i++)
+			maxError = std::max(maxError, std::abs(times[i] - i * actualPeriod));
+
+		REQUIRE(maxError < 0.0005 + PERIOD * 0.05);
+
+		const double meanPeriod = (times.back() - times[times.size() - 10001]) / 10000;
+		REQUIRE(meanPeriod == Approx(actualPeriod).epsilon(1e-5));
+	}
+
+	SECTION("Test resync after a discontinuity")
+	{
+		run(100, 0.0, 0.0);
+
+		/* The stream stops for one second. */
+
+		const Clock::time_point later = toTimePoint(100 * PERIOD + 1.0);
+		scheduler.beginBlock_RT(SAMPLE_RATE, BUFFER_SIZE, later);
+
+		REQUIRE(toSeconds(scheduler.getTime_RT(0)) == Approx(toSeconds(later) + PERIOD).margin(1e-6));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("MidiScheduler - MIDI clock phase")
+{
+	using namespace giada;
+	using namespace std::chrono;
+
+	using Clock = m::MidiScheduler::Clock;
+
+	/* Two hours of MIDI clock at 120 BPM (24 PPQN, a pulse every 1000 frames),
+	on an audio clock 100 ppm faster than the system one, with jittery
+	callbacks. Pulses are timestamped the way MidiSynchronizer does: frame
+	offset within the current block. */
+
+	constexpr int    SAMPLE_RATE  = 48000;
+	constexpr int    BUFFER_SIZE  = 512;
+	constexpr int    PULSE_FRAMES = 1000;
+	constexpr double PPM          = 100.0;
+	constexpr double JITTER       = 0.001;
+	constexpr int    BLOCKS       = 2 * 3600 * SAMPLE_RATE / BUFFER_SIZE;
+	constexpr int    SETTLE       = 2000;
+
+	const double            actualRate = SAMPLE_RATE * (1.0 + PPM / 1e6);
+	const Clock::time_point start      = Clock::now();
+
+	std::mt19937                           gen(1);
+	std::uniform_real_distribution<double> dist(0.0, JITTER);
+
+	m::MidiScheduler scheduler;
+
+	double  minPhase = 1.0, maxPhase = -1.0, maxIntervalError = 0.0;
+	double  prevTime = 0.0;
+	int64_t pulse    = 0;
+
+	for (int64_t block = 0; block < BLOCKS; block++)
+	{
+		const double callbackTime = block * BUFFER_SIZE / actualRate + dist(gen);
+		scheduler.beginBlock_RT(SAMPLE_RATE, BUFFER_SIZE, start + duration_cast<Clock::duration>(duration<double>(callbackTime)));
+
+		for (; pulse < (block + 1) * BUFFER_SIZE; pulse += PULSE_FRAMES)
+		{
+			const Frame  delta = static_cast<Frame>(pulse - block * BUFFER_SIZE);
+			const double time  = duration<double>(scheduler.getTime_RT(delta) - start).count();
+
+			if (block > SETTLE)
+			{
+				/* Distance from where the pulse actually is on the audio clock,
+				one block later. It must not wander off over time. */
+
+				const double phase = time - (pulse + BUFFER_SIZE) / actualRate;
+				minPhase           = std::min(minPhase, phase);
+				maxPhase           = std::max(maxPhase, phase);
+				maxIntervalError   = std::max(maxIntervalError, std::abs(time - prevTime - PULSE_FRAMES / actualRate));
+			}
+			prevTime = time;
+		}
+	}
+
+	/* The phase only moves by the filtered jitter, never in resync jumps, and
+	pulses keep a steady distance from each other. */
+
+	INFO("Phase spread " << (maxPhase - minPhase) * 1000 << " ms, max interval error " << maxIntervalError * 1000 << " ms");
+	REQUIRE(maxPhase - minPhase < JITTER / 2);
+	REQUIRE(maxIntervalError < 0.00005);
+}
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("MidiScheduler - block offset")
+{
+	using namespace giada;
+	using namespace std::chrono;
+
+	constexpr int SAMPLE_RATE = 48000;
+	constexpr int BUFFER_SIZE = 480; // 10 ms
+
+	m::MidiScheduler scheduler;
+
+	SECTION("Test offset before the first block")
+	{
+		REQUIRE(scheduler.getBlockOffset(m::MidiScheduler::Clock::now()) == 0);
+	}
+
+	SECTION("Test offset within block")
+	{
+		const m::MidiScheduler::Clock::time_point now = m::MidiScheduler::Clock::now();
+
+		scheduler.beginBlock_RT(SAMPLE_RATE, BUFFER_SIZE, now);
+
+		/* An event received 5 ms after the block has started falls halfway
+		through it. */
+
+		REQUIRE(scheduler.getBlockOffset(now + milliseconds(5)) == Approx(BUFFER_SIZE / 2).margin(1));
+		REQUIRE(scheduler.getBlockOffset(now - seconds(1)) == 0);
+		REQUIRE(scheduler.getBlockOffset(now + seconds(1)) == BUFFER_SIZE - 1);
+	}
+
+	SECTION("Test offset while the block is being rendered")
+	{
+		/* The block being rendered is the latest one published: the offset is
+		measured from its start. */
+
+		const m::MidiScheduler::Clock::time_point now = m::MidiScheduler::Clock::now();
+
+		scheduler.beginBlock_RT(SAMPLE_RATE, BUFFER_SIZE, now);
+
+		REQUIRE(scheduler.getBlockOffset(now + milliseconds(1)) == Approx(BUFFER_SIZE / 10).margin(1));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("MidiScheduler - dropped messages")
+{
+	using namespace giada;
+
+	/* The sender thread is not running: nothing is drained, so queues fill up
+	sooner or later. Each message refused must be counted. */
+
+	m::MidiScheduler scheduler;
+
+	int refused = 0;
+
+	SECTION("Test send")
+	{
+		for (int i = 0; i < 1000; i++)
+			if (!scheduler.send(m::MidiEvent::makeFrom3Bytes(0x90, 0x40, 0x7F)))
+				refused++;
+	}
+
+	SECTION("Test schedule_RT")
+	{
+		scheduler.beginBlock_RT(44100, 256);
+		for (int i = 0; i < 1000; i++)
+			if (!scheduler.schedule_RT(m::MidiEvent::makeFrom3Bytes(0x90, 0x40, 0x7F), 0))
+				refused++;
+
+		REQUIRE(refused > 0);
+	}
+
+	REQUIRE(scheduler.countDroppedMessages() == refused);
+}
@@ -0,0 +1,89 @@
+#include "src/core/offlineRenderer.h"
+#include "src/core/const.h"
+#include "src/core/jackTransport.h"
+#include "src/core/kernelMidi.h"
+#include "src/core/midiSynchronizer.h"
+#include "src/core/model/model.h"
+#include "src/core/sequencer.h"
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <sndfile.h>
+#include <vector>
+
+TEST_CASE("OfflineRenderer")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	constexpr int SAMPLE_RATE = 44100;
+	constexpr int BUFFER_SIZE = 64;
+
+	model::Model model;
+	model.registerThread(Thread::MAIN, /*realtime=*/false);
+	model.reset();
+	model.get().mixer.a_setActive(true);
+
+	KernelMidi       kernelMidi(model);
+	MidiSynchronizer midiSynchronizer(model, kernelMidi);
+	JackTransport    jackTransport;
+	Sequencer        sequencer(model, midiSynchronizer, jackTransport);
+	OfflineRenderer  offlineRenderer(model, sequencer);
+
+	sequencer.reset(SAMPLE_RATE);
+
+	/* Fake engine: each frame holds its own position since the beginning of
+	the rendering, so that what ends up in the file can be told apart. */
+
+	Frame rendered = 0;
+	bool  running  = false;
+
+	offlineRenderer.onAboutToRender = []() {};
+	offlineRenderer.onRendered      = []() {};
+	offlineRenderer.onRenderBlock   = [&](mcl::AudioBuffer& out, const mcl::AudioBuffer&, Mixer::Stems*) {
+		running = model.get().sequencer.isRunning();
+		for (int i = 0; i < out.countFrames(); i++, rendered++)
+			for (int j = 0; j < out.countChannels(); j++)
+				out[i][j] = static_cast<float>(rendered);
+	};
+
+	const std::string path = (std::filesystem::temp_directory_path() / "giada-bounce-test.wav").string();
+
+	SECTION("Test render range")
+	{
+		const OfflineRenderer::Request req = {{100, 1000}, WaveFormat::WAV, {{Mixer::MASTER_OUT_CHANNEL_ID, path}}};
+
+		REQUIRE(offlineRenderer.render(req, SAMPLE_RATE, BUFFER_SIZE, nullptr) == G_RES_OK);
+		REQUIRE(running);
+		REQUIRE(rendered % BUFFER_SIZE == 0);
+		REQUIRE(rendered >= 1000);
+		REQUIRE(rendered < 1000 + BUFFER_SIZE);
+		REQUIRE(model.get().sequencer.status == SeqStatus::STOPPED);
+
+		SF_INFO  header;
+		SNDFILE* file = sf_open(path.c_str(), SFM_READ, &header);
+
+		REQUIRE(file != nullptr);
+		REQUIRE(header.frames == 900);
+		REQUIRE(header.channels == G_MAX_IO_CHANS);
+		REQUIRE(header.samplerate == SAMPLE_RATE);
+
+		std::vector<float> data(header.frames * header.channels);
+		sf_readf_float(file, data.data(), header.frames);
+		sf_close(file);
+
+		for (Frame i = 0; i < header.frames; i++)
+		{
+			REQUIRE(data[i * G_MAX_IO_CHANS] == 100 + i);
+			REQUIRE(data[i * G_MAX_IO_CHANS + 1] == 100 + i);
+		}
+
+		std::filesystem::remove(path);
+	}
+
+	SECTION("Test invalid request")
+	{
+		REQUIRE(offlineRenderer.render({{0, 1000}, WaveFormat::WAV, {}}, SAMPLE_RATE, BUFFER_SIZE, nullptr) == G_RES_ERR_WRONG_DATA);
+		REQUIRE(offlineRenderer.render({{0, 1000}, WaveFormat::WAV, {{/*channelId=*/999, path}}}, SAMPLE_RATE, BUFFER_SIZE, nullptr) == G_RES_ERR_WRONG_DATA);
+		REQUIRE(rendered == 0);
+	}
+}
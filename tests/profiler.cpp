@@ -0,0 +1,53 @@
+#include "../src/core/profiler.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("Profiler")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	Profiler profiler;
+
+	SECTION("Test disabled")
+	{
+		{
+			const Profiler::Scope scope(profiler, Profiler::Stage::CALLBACK);
+		}
+		REQUIRE(profiler.getStats().empty());
+	}
+
+	SECTION("Test stats")
+	{
+		profiler.setEnabled(true);
+
+		for (int i = 1; i <= 100; i++)
+			profiler.push_RT(Profiler::Stage::CHANNEL, i * 1000, /*channelId=*/5);
+		{
+			const Profiler::Scope scope(profiler, Profiler::Stage::CALLBACK);
+		}
+
+		const std::vector<Profiler::Stats> stats = profiler.getStats();
+
+		REQUIRE(stats.size() == 2);
+		REQUIRE(stats[0].stage == Profiler::Stage::CALLBACK);
+		REQUIRE(stats[0].count == 1);
+		REQUIRE(stats[1].stage == Profiler::Stage::CHANNEL);
+		REQUIRE(stats[1].channelId == 5);
+		REQUIRE(stats[1].count == 100);
+		REQUIRE(stats[1].min == Approx(1.0f));
+		REQUIRE(stats[1].mean == Approx(50.5f));
+		REQUIRE(stats[1].p99 == Approx(99.0f));
+		REQUIRE(stats[1].max == Approx(100.0f));
+		REQUIRE(profiler.countDroppedSamples() == 0);
+	}
+
+	SECTION("Test clear on enable")
+	{
+		profiler.setEnabled(true);
+		profiler.push_RT(Profiler::Stage::FINALIZE, 1000);
+		profiler.setEnabled(false);
+		profiler.setEnabled(true);
+
+		REQUIRE(profiler.getStats().empty());
+	}
+}
@@ -0,0 +1,153 @@
+#include "../src/core/model/reclaimer.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+TEST_CASE("Reclaimer")
+{
+	using namespace giada::m::model;
+
+	/* Flags its own destruction. */
+
+	struct Object
+	{
+		Object(bool& d)
+		: deleted(d)
+		{
+		}
+
+		~Object()
+		{
+			deleted = true;
+		}
+
+		bool& deleted;
+	};
+
+	Reclaimer reclaimer;
+	bool      deleted = false;
+
+	SECTION("Test retire without readers")
+	{
+		reclaimer.retire(std::make_unique<Object>(deleted));
+
+		REQUIRE(deleted);
+		REQUIRE(reclaimer.countRetired() == 0);
+	}
+
+	SECTION("Test retire while reading")
+	{
+		{
+			const Reclaimer::Guard guard(reclaimer);
+
+			reclaimer.retire(std::make_unique<Object>(deleted));
+			reclaimer.collect();
+
+			REQUIRE(!deleted);
+			REQUIRE(reclaimer.countRetired() == 1);
+		}
+
+		reclaimer.collect();
+
+		REQUIRE(deleted);
+		REQUIRE(reclaimer.countRetired() == 0);
+	}
+
+	SECTION("Test readers coming later")
+	{
+		bool deletedLater = false;
+
+		auto guard1 = std::make_unique<Reclaimer::Guard>(reclaimer);
+		reclaimer.retire(std::make_unique<Object>(deleted));
+
+		/* A reader coming after the retirement can't see the object: it doesn't
+		hold it back. */
+
+		auto guard2 = std::make_unique<Reclaimer::Guard>(reclaimer);
+		guard1.reset();
+		reclaimer.collect();
+
+		REQUIRE(deleted);
+
+		reclaimer.retire(std::make_unique<Object>(deletedLater));
+
+		REQUIRE(!deletedLater);
+
+		guard2.reset();
+		reclaimer.collect();
+
+		REQUIRE(deletedLater);
+	}
+
+	SECTION("Test deletion happens on the collector thread only")
+	{
+		/* Records the thread it's destroyed by. */
+
+		struct ThreadObject
+		{
+			ThreadObject(std::thread::id& d)
+			: deletedBy(d)
+			{
+			}
+
+			~ThreadObject()
+			{
+				deletedBy = std::this_thread::get_id();
+			}
+
+			std::thread::id& deletedBy;
+		};
+
+		std::thread::id deletedBy;
+
+		auto guard = std::make_unique<Reclaimer::Guard>(reclaimer);
+
+		std::thread([&reclaimer, &deletedBy, &guard]() {
+			reclaimer.retire(std::make_unique<ThreadObject>(deletedBy));
+			guard.reset();
+			reclaimer.collect();
+		}).join();
+
+		REQUIRE(deletedBy == std::thread::id());
+		REQUIRE(reclaimer.countRetired() == 1);
+
+		reclaimer.collect();
+
+		REQUIRE(deletedBy == std::this_thread::get_id());
+		REQUIRE(reclaimer.countRetired() == 0);
+	}
+
+	SECTION("Test synchronize")
+	{
+		std::atomic<bool> reading      = false;
+		std::atomic<bool> stop         = false;
+		std::atomic<bool> synchronized = false;
+
+		std::thread reader([&reclaimer, &reading, &stop]() {
+			const Reclaimer::Guard guard(reclaimer);
+			reading.store(true);
+			while (!stop.load())
+				;
+		});
+
+		while (!reading.load())
+			;
+
+		std::thread writer([&reclaimer, &synchronized]() {
+			reclaimer.synchronize();
+			synchronized.store(true);
+		});
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		REQUIRE(!synchronized.load());
+
+		stop.store(true);
+		reader.join();
+		writer.join();
+
+		REQUIRE(synchronized.load());
+	}
+}
@@ -0,0 +1,133 @@
+#include "../src/core/rtCheck.h"
+#include "../src/core/queue.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <semaphore.h>
+#include <thread>
+#include <time.h>
+
+#ifdef WITH_RT_CHECK
+
+namespace
+{
+void* volatile rtCheckSink_ = nullptr;
+
+/* NoAbort_
+Violations are expected here: never abort, whatever GIADA_RT_CHECK says. The 
+previous mode is restored afterwards. */
+
+struct NoAbort_
+{
+	NoAbort_()
+	: prev(giada::m::rtCheck::getAbort())
+	{
+		giada::m::rtCheck::setAbort(false);
+	}
+
+	~NoAbort_()
+	{
+		giada::m::rtCheck::setAbort(prev);
+	}
+
+	bool prev;
+};
+} // namespace
+
+TEST_CASE("rtCheck")
+{
+	using namespace giada::m;
+
+	rtCheck::init();
+
+	const NoAbort_ noAbort;
+	const int      violations = rtCheck::countViolations();
+
+	SECTION("Test allocation outside realtime scope")
+	{
+		rtCheckSink_ = std::malloc(16);
+		std::free(rtCheckSink_);
+
+		REQUIRE(rtCheck::countViolations() == violations);
+	}
+
+	SECTION("Test allocation and lock")
+	{
+		std::mutex mutex;
+		{
+			const rtCheck::Scope scope;
+			rtCheckSink_ = std::malloc(16);
+			std::free(rtCheckSink_);
+			const std::scoped_lock lock(mutex);
+		}
+		REQUIRE(rtCheck::countViolations() == violations + 3);
+	}
+
+	SECTION("Test timed waits")
+	{
+		sem_t semaphore;
+		sem_init(&semaphore, 0, 1);
+
+		const timespec zero = {0, 0};
+		{
+			const rtCheck::Scope scope;
+			sem_wait(&semaphore);
+			clock_nanosleep(CLOCK_MONOTONIC, 0, &zero, nullptr);
+		}
+		sem_destroy(&semaphore);
+
+		REQUIRE(rtCheck::countViolations() == violations + 2);
+	}
+
+	SECTION("Test futex wait")
+	{
+		std::atomic<int> flag = 0;
+
+		std::thread notifier([&flag]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			flag.store(1);
+			flag.notify_one();
+		});
+		{
+			const rtCheck::Scope scope;
+			flag.wait(0);
+		}
+		notifier.join();
+
+		REQUIRE(rtCheck::countViolations() > violations);
+	}
+
+	SECTION("Test stdio")
+	{
+		/* The first write allocates the stream buffer: do it outside the scope,
+		so that only the stdio calls are counted below. */
+
+		FILE* file = std::fopen("/dev/null", "w");
+		std::fwrite("x", 1, 1, file);
+		{
+			const rtCheck::Scope scope;
+			std::fwrite("x", 1, 1, file);
+			std::fprintf(file, "%d", 1);
+		}
+		std::fclose(file);
+
+		REQUIRE(rtCheck::countViolations() == violations + 2);
+	}
+
+	SECTION("Test lock-free queue")
+	{
+		Queue<int, 16> queue;
+		int            item;
+		{
+			const rtCheck::Scope scope;
+			queue.push(1);
+			queue.pop(item);
+		}
+		REQUIRE(rtCheck::countViolations() == violations);
+	}
+}
+
+#endif
@@ -10,8 +10,8 @@ TEST_CASE("SamplePlayer")
 
 	// Wave values: [1..BUFFERSIZE*4]
 	m::Wave wave(0);
-	wave.getBuffer().alloc(BUFFER_SIZE * 4, NUM_CHANNELS);
-	wave.getBuffer().forEachFrame([](float* f, int i) {
+	wave.getWritableBuffer().alloc(BUFFER_SIZE * 4, NUM_CHANNELS);
+	wave.getWritableBuffer().forEachFrame([](float* f, int i) {
 		f[0] = static_cast<float>(i + 1);
 		f[1] = static_cast<float>(i + 1);
 	});
@@ -0,0 +1,159 @@
+#include "src/core/sequencer.h"
+#include "src/core/actions/actionRecorder.h"
+#include "src/core/channels/channelFactory.h"
+#include "src/core/jackTransport.h"
+#include "src/core/kernelMidi.h"
+#include "src/core/midiSynchronizer.h"
+#include "src/core/model/model.h"
+#include <catch2/catch.hpp>
+#include <vector>
+
+namespace
+{
+using namespace giada;
+using namespace giada::m;
+
+/* advanceLegacy_
+Reference implementation of the old per-frame Sequencer::advance() scan, used
+to validate and benchmark the event-driven one. Metronome is left out. */
+
+void advanceLegacy_(const model::Sequencer& sequencer, Frame start, Frame bufferSize,
+    const ActionRecorder& actionRecorder, Sequencer::EventBuffer& out)
+{
+	out.clear();
+
+	for (Frame i = start, local = 0; i < start + bufferSize; i++, local++)
+	{
+		const Frame global = i % sequencer.framesInLoop;
+
+		if (global == 0)
+			out.push_back({Sequencer::EventType::FIRST_BEAT, global, local});
+		else if (global % sequencer.framesInBar == 0)
+			out.push_back({Sequencer::EventType::BAR, global, local});
+
+		const ActionTimeline::Span as = actionRecorder.getActionsOnFrame(global);
+		if (!as.empty())
+			out.push_back({Sequencer::EventType::ACTIONS, global, local, as});
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("Sequencer")
+{
+	constexpr int SAMPLE_RATE = 44100;
+	constexpr ID  CHANNEL_ID  = 1;
+
+	model::Model model;
+	model.registerThread(Thread::MAIN, /*realtime=*/false);
+	model.reset();
+
+	channelFactory::Data channel = channelFactory::create(CHANNEL_ID, ChannelType::SAMPLE, 0, 0, 1024, Resampler::Quality::LINEAR, false);
+	model.get().channels.getAll() = {channel.channel};
+	model.addShared(std::move(channel.shared));
+	model.swap(model::SwapType::NONE);
+
+	KernelMidi       kernelMidi(model);
+	MidiSynchronizer midiSynchronizer(model, kernelMidi);
+	JackTransport    jackTransport;
+	Sequencer        sequencer(model, midiSynchronizer, jackTransport);
+	ActionRecorder   actionRecorder(model);
+
+	sequencer.reset(SAMPLE_RATE);
+	sequencer.setBeats(/*beats=*/8, /*bars=*/2, SAMPLE_RATE);
+
+	const model::Sequencer& modelSeq     = model.get().sequencer;
+	const Frame             framesInLoop = modelSeq.framesInLoop;
+	const MidiEvent         event        = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_ON, 0x00, 0x00, 0);
+
+	/* Some actions scattered around, plus a couple sitting right on the first
+	beat and on a bar, to check event ordering. */
+
+	for (Frame f = 123; f < framesInLoop; f += 997)
+		actionRecorder.rec(CHANNEL_ID, f, event);
+	actionRecorder.rec(CHANNEL_ID, 0, event);
+	actionRecorder.rec(CHANNEL_ID, modelSeq.framesInBar, event);
+
+	Sequencer::EventBuffer expected;
+
+	for (const Frame bufferSize : {64, 256, 1024, 4096})
+	{
+		SECTION("Test advance, buffer size = " + std::to_string(bufferSize))
+		{
+			/* Go through a whole loop and a half, so that wrapping around the
+			loop boundary is tested as well. */
+
+			for (Frame f = 0; f < framesInLoop * 1.5; f += bufferSize)
+			{
+				advanceLegacy_(modelSeq, modelSeq.a_getCurrentFrame(), bufferSize, actionRecorder, expected);
+
+				const Sequencer::EventBuffer& events = sequencer.advance(modelSeq, bufferSize, SAMPLE_RATE, actionRecorder);
+
+				REQUIRE(events.size() == expected.size());
+
+				auto it = expected.begin();
+				for (const Sequencer::Event& e : events)
+				{
+					REQUIRE(e.type == it->type);
+					REQUIRE(e.global == it->global);
+					REQUIRE(e.delta == it->delta);
+					REQUIRE(e.actions.data() == it->actions.data());
+					REQUIRE(e.actions.size() == it->actions.size());
+					++it;
+				}
+			}
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("Sequencer advance benchmark", "[.][benchmark]")
+{
+	constexpr int SAMPLE_RATE = 44100;
+	constexpr ID  CHANNEL_ID  = 1;
+
+	model::Model model;
+	model.registerThread(Thread::MAIN, /*realtime=*/false);
+	model.reset();
+
+	channelFactory::Data channel = channelFactory::create(CHANNEL_ID, ChannelType::SAMPLE, 0, 0, 1024, Resampler::Quality::LINEAR, false);
+	model.get().channels.getAll() = {channel.channel};
+	model.addShared(std::move(channel.shared));
+	model.swap(model::SwapType::NONE);
+
+	KernelMidi       kernelMidi(model);
+	MidiSynchronizer midiSynchronizer(model, kernelMidi);
+	JackTransport    jackTransport;
+	Sequencer        sequencer(model, midiSynchronizer, jackTransport);
+	ActionRecorder   actionRecorder(model);
+
+	sequencer.reset(SAMPLE_RATE);
+
+	const model::Sequencer& modelSeq = model.get().sequencer;
+	const MidiEvent         event    = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_ON, 0x00, 0x00, 0);
+
+	for (Frame f = 0; f < modelSeq.framesInLoop; f += 1000)
+		actionRecorder.rec(CHANNEL_ID, f, event);
+
+	Sequencer::EventBuffer legacyEvents;
+
+	for (const Frame bufferSize : {64, 128, 256, 512, 1024, 2048, 4096})
+	{
+		const std::string suffix = ", " + std::to_string(bufferSize) + " frames";
+
+		BENCHMARK("Per-frame scan" + suffix)
+		{
+			const Frame start = modelSeq.a_getCurrentFrame();
+			modelSeq.a_setCurrentFrame((start + bufferSize) % modelSeq.framesInLoop, SAMPLE_RATE);
+			advanceLegacy_(modelSeq, start, bufferSize, actionRecorder, legacyEvents);
+			return legacyEvents.size();
+		};
+
+		BENCHMARK("Event-driven" + suffix)
+		{
+			return sequencer.advance(modelSeq, bufferSize, SAMPLE_RATE, actionRecorder).size();
+		};
+	}
+}
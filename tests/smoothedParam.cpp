@@ -0,0 +1,46 @@
+#include "../src/core/smoothedParam.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("SmoothedParam")
+{
+	using namespace giada;
+
+	SmoothedParam param(1.0f);
+
+	SECTION("Test steady value")
+	{
+		const SmoothedParam::Ramp ramp = param.advance_RT();
+
+		REQUIRE(ramp.isFlat());
+		REQUIRE(ramp.to == 1.0f);
+	}
+
+	SECTION("Test ramp")
+	{
+		param.store(0.0f);
+
+		REQUIRE(param.load() == 0.0f);
+
+		const SmoothedParam::Ramp ramp = param.advance_RT();
+
+		REQUIRE_FALSE(ramp.isFlat());
+		REQUIRE(ramp.from == 1.0f);
+		REQUIRE(ramp.to == 0.0f);
+		REQUIRE(ramp.at(0, 4) == 1.0f);
+		REQUIRE(ramp.at(2, 4) == 0.5f);
+
+		/* Next block: the target has been reached. */
+
+		REQUIRE(param.advance_RT().isFlat());
+	}
+
+	SECTION("Test reset")
+	{
+		param.reset(0.5f);
+
+		const SmoothedParam::Ramp ramp = param.advance_RT();
+
+		REQUIRE(ramp.isFlat());
+		REQUIRE(ramp.to == 0.5f);
+	}
+}
@@ -0,0 +1,70 @@
+#include "../src/core/threadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST_CASE("ThreadPool")
+{
+	using namespace giada;
+
+	m::ThreadPool pool(4);
+
+	REQUIRE(pool.getNumThreads() == 4);
+
+	SECTION("Test all jobs are run")
+	{
+		constexpr int NUM_JOBS = 100;
+
+		std::atomic<int> sum = 0;
+		std::latch       finished(NUM_JOBS);
+
+		for (int i = 0; i < NUM_JOBS; i++)
+			pool.submit([&sum, &finished, i]() {
+				sum += i;
+				finished.count_down();
+			});
+
+		finished.wait();
+
+		REQUIRE(sum.load() == NUM_JOBS * (NUM_JOBS - 1) / 2);
+	}
+
+	SECTION("Test jobs run on the pool threads, reused across batches")
+	{
+		std::vector<std::thread::id> ids;
+		std::mutex                   mutex;
+
+		for (int batch = 0; batch < 3; batch++)
+		{
+			std::latch finished(8);
+			for (int i = 0; i < 8; i++)
+				pool.submit([&]() {
+					{
+						std::scoped_lock lock(mutex);
+						if (std::find(ids.begin(), ids.end(), std::this_thread::get_id()) == ids.end())
+							ids.push_back(std::this_thread::get_id());
+					}
+					finished.count_down();
+				});
+			finished.wait();
+		}
+
+		REQUIRE(ids.size() <= 4);
+		REQUIRE(std::find(ids.begin(), ids.end(), std::this_thread::get_id()) == ids.end());
+	}
+
+	SECTION("Test pending jobs are run before shutting down")
+	{
+		std::atomic<int> count = 0;
+		{
+			m::ThreadPool other(1);
+			for (int i = 0; i < 10; i++)
+				other.submit([&count]() { count++; });
+		}
+		REQUIRE(count.load() == 10);
+	}
+}
@@ -43,5 +43,38 @@ TEST_CASE("Wave")
 			REQUIRE(wave.getBasename() == "sample");
 			REQUIRE(wave.getBasename(true) == "sample.wav");
 		}
+
+		SECTION("test copy-on-write")
+		{
+			wave.getWritableBuffer()[0][0] = 1.0f;
+
+			m::Wave copy(wave);
+
+			REQUIRE(copy.isSharingBuffer(wave));
+			REQUIRE(&copy.getBuffer() == &wave.getBuffer());
+
+			copy.getWritableBuffer()[0][0] = 2.0f;
+
+			REQUIRE(!copy.isSharingBuffer(wave));
+			REQUIRE(wave.getBuffer()[0][0] == 1.0f);
+			REQUIRE(copy.getBuffer()[0][0] == 2.0f);
+			REQUIRE(copy.getBuffer().countFrames() == BUFFER_SIZE);
+		}
+
+		SECTION("test dirty state")
+		{
+			REQUIRE(wave.isDirty());
+
+			wave.setDirty(false);
+			wave.setHash(wave.computeHash());
+
+			REQUIRE(wave.computeHash() != 0);
+			REQUIRE(!wave.isDirty());
+
+			wave.getWritableBuffer()[0][0] = 1.0f;
+
+			REQUIRE(wave.isDirty());
+			REQUIRE(wave.computeHash() != wave.getHash());
+		}
 	}
 }
@@ -0,0 +1,102 @@
+#include "../src/core/waveCache.h"
+#include "../src/core/const.h"
+#include "../src/core/wave.h"
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+TEST_CASE("waveCache")
+{
+	using namespace giada;
+
+	constexpr int SAMPLE_RATE = 44100;
+	constexpr int NUM_FRAMES  = 1024;
+
+	namespace stdfs = std::filesystem;
+
+	const stdfs::path dir    = stdfs::temp_directory_path() / "giada-waveCache-test";
+	const stdfs::path source = stdfs::temp_directory_path() / "giada-waveCache-test.wav";
+
+	stdfs::remove_all(dir);
+	std::ofstream(source) << "some audio file content";
+
+	m::waveCache::init(dir.string(), /*maxBytes=*/1024 * 1024);
+
+	m::Wave wave(/*id=*/1);
+	wave.alloc(NUM_FRAMES, G_MAX_IO_CHANS, SAMPLE_RATE, /*bits=*/16, source.string());
+	wave.getWritableBuffer().forEachFrame([](float* f, int i) {
+		f[0] = static_cast<float>(i);
+		f[1] = static_cast<float>(-i);
+	});
+
+	std::optional<m::waveCache::Key> key = m::waveCache::makeKey(source.string(), SAMPLE_RATE, m::Resampler::Quality::LINEAR);
+	REQUIRE(key.has_value());
+
+	SECTION("Test miss")
+	{
+		m::Wave out(/*id=*/2);
+		REQUIRE(m::waveCache::load(*key, out, source.string()) == false);
+	}
+
+	SECTION("Test store and load")
+	{
+		m::waveCache::store(*key, wave);
+
+		m::Wave out(/*id=*/2);
+		REQUIRE(m::waveCache::load(*key, out, source.string()) == true);
+		REQUIRE(out.getRate() == SAMPLE_RATE);
+		REQUIRE(out.getBits() == 16);
+		REQUIRE(out.getPath() == source.string());
+		REQUIRE(out.getBuffer().countFrames() == NUM_FRAMES);
+		REQUIRE(out.getBuffer().countChannels() == G_MAX_IO_CHANS);
+		REQUIRE(out.getBuffer()[NUM_FRAMES - 1][0] == NUM_FRAMES - 1);
+		REQUIRE(out.getBuffer()[NUM_FRAMES - 1][1] == -(NUM_FRAMES - 1));
+
+		/* Another rate or quality is another entry. */
+
+		m::waveCache::Key other = *key;
+		other.rate              = SAMPLE_RATE * 2;
+		REQUIRE(m::waveCache::load(other, out, source.string()) == false);
+	}
+
+	SECTION("Test damaged entry")
+	{
+		m::waveCache::store(*key, wave);
+
+		for (const stdfs::directory_entry& e : stdfs::directory_iterator(dir))
+		{
+			std::fstream fs(e.path(), std::ios::in | std::ios::out | std::ios::binary);
+			fs.seekp(-4, std::ios::end);
+			fs.write("\x01\x02\x03\x04", 4);
+		}
+
+		m::Wave out(/*id=*/2);
+		REQUIRE(m::waveCache::load(*key, out, source.string()) == false);
+		REQUIRE(stdfs::is_empty(dir));
+	}
+
+	SECTION("Test eviction")
+	{
+		/* Room for one entry only: storing a second one evicts the first. */
+
+		m::waveCache::init(dir.string(), /*maxBytes=*/NUM_FRAMES * G_MAX_IO_CHANS * sizeof(float) + 1024);
+
+		m::waveCache::Key other = *key;
+		other.rate              = SAMPLE_RATE * 2;
+		wave.setRate(other.rate);
+
+		m::waveCache::store(*key, wave);
+		for (const stdfs::directory_entry& e : stdfs::directory_iterator(dir))
+			stdfs::last_write_time(e.path(), stdfs::file_time_type::clock::now() - std::chrono::hours(1));
+		m::waveCache::store(other, wave);
+
+		m::Wave out(/*id=*/2);
+		REQUIRE(m::waveCache::load(*key, out, source.string()) == false);
+		REQUIRE(m::waveCache::load(other, out, source.string()) == true);
+	}
+
+	m::waveCache::init("", 0);
+	stdfs::remove_all(dir);
+	stdfs::remove(source);
+}
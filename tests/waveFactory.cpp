@@ -3,10 +3,12 @@
 #include "../src/core/resampler.h"
 #include "../src/core/wave.h"
 #include <catch2/catch.hpp>
+#include <filesystem>
 #include <memory>
 #include <samplerate.h>
 
 using std::string;
+using namespace giada;
 using namespace giada::m;
 
 #define G_SAMPLE_RATE 44100
@@ -56,4 +58,123 @@ TEST_CASE("waveFactory")
 		REQUIRE(res.wave->isLogical() == false);
 		REQUIRE(res.wave->isEdited() == false);
 	}
+
+	SECTION("test parallel deserialization")
+	{
+		std::vector<Patch::Wave> pwaves = {
+		    {/*id=*/3, TEST_RESOURCES_DIR "test.wav"},
+		    {/*id=*/4, TEST_RESOURCES_DIR "missing.wav"},
+		    {/*id=*/1, TEST_RESOURCES_DIR "test.wav"}};
+
+		std::vector<std::unique_ptr<Wave>> waves(pwaves.size());
+		int                                calls = 0;
+		waveFactory::deserializeWaves(pwaves, G_SAMPLE_RATE, Resampler::Quality::LINEAR,
+		    [&waves, &calls](std::size_t i, std::unique_ptr<Wave> w) {
+			    waves[i] = std::move(w);
+			    calls++;
+		    });
+
+		REQUIRE(calls == 3);
+		REQUIRE(waves[0]->id == 3);
+		REQUIRE(waves[1] == nullptr);
+		REQUIRE(waves[2]->id == 1);
+		REQUIRE(waves[0]->getBuffer().countFrames() == waves[2]->getBuffer().countFrames());
+	}
+
+	SECTION("test save")
+	{
+		waveFactory::Result res = waveFactory::createFromFile(TEST_RESOURCES_DIR "test.wav",
+		    /*ID=*/0, /*sampleRate=*/G_SAMPLE_RATE, Resampler::Quality::LINEAR);
+
+		REQUIRE(res.wave->isDirty() == false);
+
+		const std::string dir  = std::filesystem::temp_directory_path().string();
+		const std::string path = waveFactory::makeUniqueWavePath(dir, *res.wave, {});
+
+		REQUIRE(waveFactory::save(*res.wave, path) == G_RES_OK);
+		REQUIRE(std::filesystem::exists(path));
+		REQUIRE(!std::filesystem::exists(path + ".tmp"));
+		REQUIRE(waveFactory::makeUniqueWavePath(dir, *res.wave, {path}) != path);
+
+		std::filesystem::remove(path);
+	}
+
+	SECTION("test save as FLAC")
+	{
+		Wave wave(/*id=*/1);
+		wave.alloc(G_BUFFER_SIZE, G_CHANNELS, G_SAMPLE_RATE, /*bits=*/16, "test.wav");
+		for (int i = 0; i < G_BUFFER_SIZE; i++)
+			for (int j = 0; j < G_CHANNELS; j++)
+				wave.getWritableBuffer()[i][j] = ((i * 37 + j) % 65536 - 32768) / 32768.0f;
+
+		REQUIRE(waveFactory::getSaveFormat(wave, WaveFormat::WAV) == WaveFormat::WAV);
+		REQUIRE(waveFactory::getSaveFormat(wave, WaveFormat::FLAC) == WaveFormat::FLAC);
+
+		const std::string dir  = std::filesystem::temp_directory_path().string();
+		const std::string path = waveFactory::makeUniqueWavePath(dir, wave, {}, WaveFormat::FLAC);
+
+		REQUIRE(waveFactory::getFormat(path) == WaveFormat::FLAC);
+		REQUIRE(waveFactory::saveWaves({{&wave, path, WaveFormat::FLAC}}) == std::vector<int>{G_RES_OK});
+
+		waveFactory::Result res = waveFactory::createFromFile(path, /*ID=*/0,
+		    /*sampleRate=*/G_SAMPLE_RATE, Resampler::Quality::LINEAR);
+
+		REQUIRE(res.status == G_RES_OK);
+		REQUIRE(res.wave->getBits() == 16);
+		REQUIRE(res.wave->computeHash() == wave.computeHash());
+
+		std::filesystem::remove(path);
+
+		/* Values in between integer steps would be lost. */
+
+		wave.getWritableBuffer()[0][0] = 0.1f / 32768.0f;
+		REQUIRE(waveFactory::getSaveFormat(wave, WaveFormat::FLAC) == WaveFormat::WAV);
+
+		/* Floating point data doesn't fit in FLAC at all. */
+
+		wave.alloc(G_BUFFER_SIZE, G_CHANNELS, G_SAMPLE_RATE, /*bits=*/32, "test.wav");
+		REQUIRE(waveFactory::getSaveFormat(wave, WaveFormat::FLAC) == WaveFormat::WAV);
+		REQUIRE(waveFactory::save(wave, path, WaveFormat::FLAC) == G_RES_ERR_WRONG_DATA);
+	}
+
+	SECTION("test sharing")
+	{
+		waveFactory::Result res = waveFactory::createFromFile(TEST_RESOURCES_DIR "test.wav",
+		    /*ID=*/0, /*sampleRate=*/G_SAMPLE_RATE, Resampler::Quality::LINEAR);
+
+		std::unique_ptr<Wave> whole = waveFactory::createFromWave(*res.wave);
+		std::unique_ptr<Wave> part  = waveFactory::createFromWave(*res.wave, 0, 16);
+
+		REQUIRE(whole->isSharingBuffer(*res.wave));
+		REQUIRE(whole->id != res.wave->id);
+		REQUIRE(!part->isSharingBuffer(*res.wave));
+
+		std::vector<Patch::Wave> pwaves = {
+		    {/*id=*/1, TEST_RESOURCES_DIR "test.wav"},
+		    {/*id=*/2, TEST_RESOURCES_DIR "test.wav"}};
+
+		std::vector<std::unique_ptr<Wave>> waves(pwaves.size());
+		waveFactory::deserializeWaves(pwaves, G_SAMPLE_RATE, Resampler::Quality::LINEAR,
+		    [&waves](std::size_t i, std::unique_ptr<Wave> w) { waves[i] = std::move(w); });
+
+		REQUIRE(waves[0]->id == 1);
+		REQUIRE(waves[1]->id == 2);
+		REQUIRE(waves[0]->isSharingBuffer(*waves[1]));
+	}
+
+	SECTION("test parallel deserialization, stopped")
+	{
+		std::vector<Patch::Wave> pwaves = {
+		    {/*id=*/1, TEST_RESOURCES_DIR "test.wav"},
+		    {/*id=*/2, TEST_RESOURCES_DIR "test.wav"}};
+
+		std::stop_source stop;
+		stop.request_stop();
+
+		int calls = 0;
+		waveFactory::deserializeWaves(pwaves, G_SAMPLE_RATE, Resampler::Quality::LINEAR,
+		    [&calls](std::size_t, std::unique_ptr<Wave>) { calls++; }, stop.get_token());
+
+		REQUIRE(calls == 0);
+	}
 }
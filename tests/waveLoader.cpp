@@ -0,0 +1,82 @@
+#include "../src/core/waveLoader.h"
+#include "../src/core/resampler.h"
+#include "../src/core/wave.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE("WaveLoader")
+{
+	using namespace giada;
+
+	constexpr int SAMPLE_RATE = 44100;
+
+	std::atomic<int> notifications = 0;
+
+	m::WaveLoader loader;
+	loader.onLoaded = [&notifications]() { notifications.fetch_add(1); };
+
+	REQUIRE(loader.isDone());
+
+	SECTION("Test progressive loading")
+	{
+		loader.start({{/*id=*/3, TEST_RESOURCES_DIR "test.wav"},
+		                 {/*id=*/4, TEST_RESOURCES_DIR "missing.wav"},
+		                 {/*id=*/1, TEST_RESOURCES_DIR "test.wav"}},
+		    SAMPLE_RATE, m::Resampler::Quality::LINEAR);
+
+		/* Take Waves as they come, the way the main thread does when notified. */
+
+		std::vector<m::WaveLoader::Loaded> loaded;
+		while (!loader.isDone())
+		{
+			if (notifications.load() == 0)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				continue;
+			}
+			notifications.fetch_sub(1);
+			for (m::WaveLoader::Loaded& l : loader.take())
+				loaded.push_back(std::move(l));
+		}
+
+		REQUIRE(loaded.size() == 3);
+
+		for (const auto& [index, wave] : loaded)
+		{
+			if (index == 1)
+				REQUIRE(wave == nullptr);
+			else
+			{
+				REQUIRE(wave != nullptr);
+				REQUIRE(wave->id == loader.getWave(index).id);
+			}
+		}
+	}
+
+	SECTION("Test one notification until take")
+	{
+		loader.start({{/*id=*/1, TEST_RESOURCES_DIR "test.wav"},
+		                 {/*id=*/2, TEST_RESOURCES_DIR "test.wav"}},
+		    SAMPLE_RATE, m::Resampler::Quality::LINEAR);
+		loader.wait();
+
+		REQUIRE(notifications.load() == 1);
+		REQUIRE(!loader.isDone());
+		REQUIRE(loader.take().size() == 2);
+		REQUIRE(loader.isDone());
+	}
+
+	SECTION("Test cancel")
+	{
+		loader.start({{/*id=*/1, TEST_RESOURCES_DIR "test.wav"}},
+		    SAMPLE_RATE, m::Resampler::Quality::LINEAR);
+		loader.cancel();
+
+		REQUIRE(loader.take().empty());
+		REQUIRE(loader.isDone());
+	}
+}
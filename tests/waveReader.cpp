@@ -13,8 +13,8 @@ TEST_CASE("WaveReader")
 	constexpr int NUM_CHANNELS = 2;
 
 	m::Wave wave(0);
-	wave.getBuffer().alloc(BUFFER_SIZE, NUM_CHANNELS);
-	wave.getBuffer().forEachFrame([](float* f, int i) {
+	wave.getWritableBuffer().alloc(BUFFER_SIZE, NUM_CHANNELS);
+	wave.getWritableBuffer().forEachFrame([](float* f, int i) {
 		f[0] = static_cast<float>(i + 1);
 		f[1] = static_cast<float>(i + 1);
 	});
@@ -0,0 +1,93 @@
+#include "../src/core/waveStream.h"
+#include "../src/core/const.h"
+#include "../src/core/waveFactory.h"
+#include "../src/utils/time.h"
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <memory>
+
+TEST_CASE("WaveStream")
+{
+	using namespace giada;
+
+	constexpr int SAMPLE_RATE = 44100;
+	constexpr int NUM_FRAMES  = m::WaveStream::HEAD_FRAMES * 3;
+	constexpr int BLOCK_SIZE  = 512;
+
+	/* Write a long ramp to disk, so that most of it must be streamed. */
+
+	const std::string path = (std::filesystem::temp_directory_path() / "giada-waveStream-test.wav").string();
+
+	std::unique_ptr<m::Wave> wave = m::waveFactory::createEmpty(NUM_FRAMES, G_MAX_IO_CHANS, SAMPLE_RATE, path);
+	wave->getWritableBuffer().forEachFrame([](float* f, int i) {
+		f[0] = static_cast<float>(i + 1);
+		f[1] = static_cast<float>(i + 1);
+	});
+	REQUIRE(m::waveFactory::save(*wave, path) == G_RES_OK);
+
+	std::unique_ptr<m::WaveStream> stream = m::WaveStream::open(path);
+	REQUIRE(stream != nullptr);
+	REQUIRE(stream->countFrames() == NUM_FRAMES);
+
+	/* Acquires a window, waiting for the I/O thread in case of underruns. Data
+	is never cached when missing, so asking again is fine. */
+
+	auto acquire = [&stream](Frame start, Frame count) {
+		m::WaveStream::Window w;
+		for (int attempt = 0; attempt < 100; attempt++)
+		{
+			w = stream->acquire_RT(start, count);
+			if (w.frames == 0 || w.data[(w.frames - 1) * G_MAX_IO_CHANS] != 0.0f)
+				break;
+			u::time::sleep(10);
+		}
+		return w;
+	};
+
+	auto isRamp = [](const m::WaveStream::Window& w, Frame start) {
+		for (Frame i = 0; i < w.frames; i++)
+			if (w.data[i * G_MAX_IO_CHANS] != static_cast<float>(start + i + 1) ||
+			    w.data[i * G_MAX_IO_CHANS + 1] != static_cast<float>(start + i + 1))
+				return false;
+		return true;
+	};
+
+	SECTION("Test sequential read")
+	{
+		bool ok = true;
+		for (Frame f = 0; f < NUM_FRAMES; f += BLOCK_SIZE)
+		{
+			m::WaveStream::Window w = acquire(f, BLOCK_SIZE);
+			ok &= w.frames == std::min(BLOCK_SIZE, NUM_FRAMES - f) && isRamp(w, f);
+		}
+		REQUIRE(ok);
+	}
+
+	SECTION("Test range and loop")
+	{
+		const Frame begin = 1000;
+		const Frame end   = NUM_FRAMES - 1000;
+		stream->setRange(begin, end);
+
+		bool ok = true;
+		for (int loop = 0; loop < 2; loop++)
+			for (Frame f = begin; f < end; f += BLOCK_SIZE)
+			{
+				m::WaveStream::Window w = acquire(f, BLOCK_SIZE);
+				ok &= w.frames == std::min(BLOCK_SIZE, end - f) && isRamp(w, f);
+			}
+		REQUIRE(ok);
+		REQUIRE(stream->acquire_RT(end, BLOCK_SIZE).frames == 0);
+	}
+
+	SECTION("Test random access")
+	{
+		bool ok = true;
+		for (Frame f : {NUM_FRAMES - BLOCK_SIZE, 0, NUM_FRAMES / 2, 10, NUM_FRAMES / 3})
+			ok &= isRamp(acquire(f, BLOCK_SIZE), f);
+		REQUIRE(ok);
+	}
+
+	stream.reset();
+	std::filesystem::remove(path);
+}